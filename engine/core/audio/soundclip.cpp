@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <chrono>
 
 // Platform specific includes
 #include <sstream>
@@ -35,6 +36,7 @@
 #include "loaders/native/audio/ogg_loader.h"
 
 #include "soundclip.h"
+#include "soundstreamer.h"
 
 namespace FIFE {
 	static Logger _log(LM_AUDIO);
@@ -43,7 +45,8 @@ namespace FIFE {
 		IResource(createUniqueClipName(), loader),
 		m_isStream(false),
 		m_decoder(NULL),
-		m_deleteDecoder(false) {
+		m_deleteDecoder(false),
+		m_size(0) {
 
 	}
 
@@ -51,7 +54,8 @@ namespace FIFE {
 		IResource(name, loader),
 		m_isStream(false),
 		m_decoder(NULL),
-		m_deleteDecoder(false) {
+		m_deleteDecoder(false),
+		m_size(0) {
 
 	}
 
@@ -103,6 +107,7 @@ namespace FIFE {
 				CHECK_OPENAL_LOG(_log, LogManager::LEVEL_ERROR, "error copying data to buffers")
 
 				ptr->usedbufs++;
+				m_size += m_decoder->getBufferSize();
 			}
 
 			m_decoder->releaseBuffer();
@@ -124,6 +129,9 @@ namespace FIFE {
 					if ((*it) && (*it)->buffers[0] != 0) {
 						alDeleteBuffers(BUFFER_NUM, (*it)->buffers);
 					}
+					if (*it) {
+						releaseDecodedStream(*it);
+					}
 					delete (*it);
 				}
 			} else {
@@ -136,6 +144,7 @@ namespace FIFE {
 			}
 			m_buffervec.clear();
 		}
+		m_size = 0;
 		m_state = IResource::RES_NOT_LOADED;
 	}
 
@@ -151,7 +160,7 @@ namespace FIFE {
 		return m_buffervec.at(streamid)->buffers;
 	}
 
-	uint32_t SoundClip::beginStreaming() {
+	uint32_t SoundClip::beginStreaming(SoundStreamer* streamer) {
 		SoundBufferEntry* ptr = NULL;
 		uint32_t id = 0;
 		for (uint32_t i = 0; i < m_buffervec.size(); i++) {
@@ -171,8 +180,21 @@ namespace FIFE {
 
 		ptr->usedbufs=0;
 		ptr->deccursor = 0;
+		ptr->stream = NULL;
+		ptr->streamer = NULL;
+		ptr->seeked = true;
 		alGenBuffers(BUFFER_NUM, ptr->buffers);
 
+		// decode in the background, if the decoder can provide an own decoder for the stream
+		if (streamer) {
+			SoundDecoder* decoder = m_decoder->createStreamDecoder();
+			if (decoder) {
+				ptr->stream = new SoundStream(decoder);
+				ptr->streamer = streamer;
+				streamer->addStream(ptr->stream);
+			}
+		}
+
 		CHECK_OPENAL_LOG(_log, LogManager::LEVEL_ERROR, "error creating streaming-buffers")
 
 		return id;
@@ -192,15 +214,22 @@ namespace FIFE {
 				break;
 		}
 
+		SoundBufferEntry* ptr = m_buffervec.at(streamid);
+		bool eof = false;
 		if (pos > m_decoder->getDecodedLength()) {
 			// EOF!
-			m_buffervec.at(streamid)->deccursor = m_decoder->getDecodedLength();
-			return true;
+			pos = m_decoder->getDecodedLength();
+			eof = true;
 		}
 
 		// set cursor position
-		m_buffervec.at(streamid)->deccursor = pos;
-		return false;
+		ptr->deccursor = pos;
+		if (ptr->stream) {
+			ptr->stream->seek(pos);
+			ptr->streamer->wake();
+			ptr->seeked = true;
+		}
+		return eof;
 	}
 
 	float SoundClip::getStreamPos(uint32_t streamid, SoundPositionType type) const{
@@ -216,26 +245,31 @@ namespace FIFE {
 		return 0.0f;
 	}
 
-	void SoundClip::acquireStream(uint32_t streamid) {
-		SoundBufferEntry* ptr = m_buffervec.at(streamid);
-		for (int32_t i = 0; i < BUFFER_NUM; i++) {
-			if (getStream(streamid, ptr->buffers[i])) {
+	uint32_t SoundClip::acquireStream(uint32_t streamid) {
+		uint32_t filled = 0;
+		for (; filled < static_cast<uint32_t>(BUFFER_NUM); ++filled) {
+			if (getStream(streamid, m_buffervec.at(streamid)->buffers[filled]) != SD_REFILL_DONE) {
 				break;
 			}
 		}
+		return filled;
 	}
 
-	bool SoundClip::getStream(uint32_t streamid, ALuint buffer) {
+	SoundRefillType SoundClip::getStream(uint32_t streamid, ALuint buffer) {
+		touch();
 		SoundBufferEntry* ptr = m_buffervec.at(streamid);
+		if (ptr->stream) {
+			return getDecodedStream(ptr, buffer);
+		}
 
 		if (ptr->deccursor >= m_decoder->getDecodedLength()) {
 			// EOF!
-			return true;
+			return SD_REFILL_EOF;
 		}
 		
 		// set cursor of decoder
 		if (!m_decoder->setCursor(ptr->deccursor)) {
-			return true;
+			return SD_REFILL_EOF;
 		}
 
 		// Error while decoding file?
@@ -254,7 +288,53 @@ namespace FIFE {
 
 		CHECK_OPENAL_LOG(_log, LogManager::LEVEL_ERROR, "error catching stream")
 
-		return false;
+		return SD_REFILL_DONE;
+	}
+
+	SoundRefillType SoundClip::getDecodedStream(SoundBufferEntry* ptr, ALuint buffer) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const SoundStreamBlock* block = ptr->stream->front();
+		if (!block && ptr->seeked) {
+			// nothing to play yet, a short wait is expected
+			block = ptr->streamer->waitForBlock(ptr->stream, STREAM_WAIT_TIMEOUT);
+		}
+		if (!block) {
+			// the streaming thread falls behind, the refill is retried on the next update
+			ptr->streamer->wake();
+			ptr->streamer->addUnderrun();
+			return SD_REFILL_PENDING;
+		}
+		ptr->seeked = false;
+
+		// EOF, the block stays in the ring until the next seek
+		if (block->eof) {
+			return SD_REFILL_EOF;
+		}
+
+		// fill the buffer with data
+		alBufferData(buffer, m_decoder->getALFormat(),
+			&block->data[0], block->data.size(), m_decoder->getSampleRate());
+
+		// update cursor
+		ptr->deccursor += block->data.size();
+
+		ptr->stream->pop();
+		ptr->streamer->wake();
+
+		CHECK_OPENAL_LOG(_log, LogManager::LEVEL_ERROR, "error catching stream")
+
+		std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - start;
+		ptr->streamer->addRefill(latency.count());
+		return SD_REFILL_DONE;
+	}
+
+	void SoundClip::releaseDecodedStream(SoundBufferEntry* ptr) {
+		if (ptr->stream) {
+			// the streaming thread deletes the stream
+			ptr->streamer->removeStream(ptr->stream);
+			ptr->stream = NULL;
+			ptr->streamer = NULL;
+		}
 	}
 
 	void SoundClip::quitStreaming(uint32_t streamid) {
@@ -262,20 +342,31 @@ namespace FIFE {
 		SoundBufferEntry* ptr = m_buffervec.at(streamid);
 		alDeleteBuffers(BUFFER_NUM, ptr->buffers);
 		ptr->buffers[0] = 0;
+		releaseDecodedStream(ptr);
 	}
 
 	void SoundClip::endStreaming(uint32_t streamid) {
 		SoundBufferEntry** ptr = &m_buffervec.at(streamid);
+		if (*ptr) {
+			releaseDecodedStream(*ptr);
+		}
 		delete *ptr;
 		*ptr = NULL;
 	}
 
 	void SoundClip::adobtDecoder(SoundDecoder* decoder) {
+		// a reload replaces the previously adopted decoder
+		if (m_deleteDecoder && m_decoder != NULL && m_decoder != decoder) {
+			delete m_decoder;
+		}
 		m_decoder = decoder;
 		m_deleteDecoder = true;
 	}
 
 	void SoundClip::setDecoder(SoundDecoder* decoder) {
+		if (m_deleteDecoder && m_decoder != NULL && m_decoder != decoder) {
+			delete m_decoder;
+		}
 		m_decoder = decoder;
 		m_deleteDecoder = false;
 	}
@@ -285,7 +376,18 @@ namespace FIFE {
 	}
 
 	size_t SoundClip::getSize() {
-		return 0;
+		if (!m_isStream) {
+			return m_size;
+		}
+		// streams only hold the data of their queued buffers
+		size_t size = 0;
+		std::vector<SoundBufferEntry*>::const_iterator it = m_buffervec.begin();
+		for (; it != m_buffervec.end(); ++it) {
+			if ((*it) && (*it)->buffers[0] != 0) {
+				size += BUFFER_NUM * BUFFER_LEN;
+			}
+		}
+		return size;
 	}
 
 	std::string SoundClip::createUniqueClipName() {
@@ -39,6 +39,9 @@
 
 namespace FIFE {
 
+	class SoundStream;
+	class SoundStreamer;
+
 	/** Different types of audio-file positions
 	 */
 	enum SoundPositionType {
@@ -47,10 +50,23 @@ namespace FIFE {
 		SD_BYTE_POS
 	};
 
+	/** Results of a stream buffer refill
+	 */
+	enum SoundRefillType {
+		SD_REFILL_DONE,
+		SD_REFILL_EOF,
+		SD_REFILL_PENDING
+	};
+
 	struct SoundBufferEntry {
 		ALuint buffers[BUFFER_NUM];
 		uint32_t usedbufs;
 		uint64_t deccursor;
+		// stream decoded by the streaming thread, NULL if decoded on demand
+		SoundStream* stream;
+		SoundStreamer* streamer;
+		// true until the first block after the start or a seek was used
+		bool seeked;
 	};
 
 	/**  Class to handle the buffers of an audio file
@@ -82,15 +98,18 @@ namespace FIFE {
 		ALuint* getBuffers(uint32_t streamid = 0) const;
 
 		/** Starts streaming the soundclip
+		 * @param streamer If given and the decoder supports it, the stream is decoded
+		 * by the streaming thread, otherwise it is decoded when a buffer is refilled.
 		 * @return Returns the streamid
 		 */
-		uint32_t beginStreaming();
+		uint32_t beginStreaming(SoundStreamer* streamer = NULL);
 
 		/** Fills the streaming-buffers with initial data
 		 *
 		 * @param streamid The stream ID
+		 * @return The number of filled buffers, they are at the front of getBuffers()
 		 */
-		void acquireStream(uint32_t streamid);
+		uint32_t acquireStream(uint32_t streamid);
 
 		/** Sets the stream position
 		 * @return True if position is invalid (EOF has been reached)
@@ -103,11 +122,12 @@ namespace FIFE {
 
 		/** Refill a processed buffer with new data
 		 *
-		 *  @return True if file was EOF
+		 *  @return SD_REFILL_EOF if file was EOF, SD_REFILL_PENDING if the streaming
+		 *  thread did not decode the data yet, in both cases the buffer is not filled.
 		 *  @param streamid The stream ID
 		 *  @param buffer The OpenAL buffer ID
 		 */
-		bool getStream(uint32_t streamid, ALuint buffer);
+		SoundRefillType getStream(uint32_t streamid, ALuint buffer);
 
 		/** Quits Streaming
 		 */
@@ -142,8 +162,15 @@ namespace FIFE {
 		// when loadFromDecoder-method is used, decoder shouldn't be deleted
 		bool m_deleteDecoder;
 		std::vector<SoundBufferEntry*> m_buffervec;
+		// size of the decoded data of a non-streaming soundclip
+		size_t m_size;
 
 		std::string createUniqueClipName();
+
+		// refills the buffer with a block of the streaming thread
+		SoundRefillType getDecodedStream(SoundBufferEntry* ptr, ALuint buffer);
+		// stops the streaming thread from decoding the stream
+		void releaseDecodedStream(SoundBufferEntry* ptr);
 	};
 
 	typedef SharedPtr<SoundClip> SoundClipPtr;
@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 #include <map>
 
 // 3rd party library includes
@@ -37,6 +38,12 @@
 namespace FIFE {
 	static Logger _log(LM_RESMGR);
 
+	/** Orders resources from the least to the most recently used one.
+	 */
+	static bool lessRecentlyUsed(IResource* lhs, IResource* rhs) {
+		return lhs->getLastUsed() < rhs->getLastUsed();
+	}
+
 	SoundClipManager::~SoundClipManager() {
 
 	}
@@ -134,6 +141,10 @@ namespace FIFE {
 		returnValue = m_sclipHandleMap.insert ( SoundClipHandleMapPair(res->getHandle(), resptr));
 
 		if (returnValue.second) {
+			// resources added in a loaded state have no source to be reloaded from
+			if (res->getState() == IResource::RES_LOADED) {
+				m_pinned.insert(res->getHandle());
+			}
 			m_sclipNameMap.insert ( SoundClipNameMapPair(returnValue.first->second->getName(), returnValue.first->second) );
 		}
 		else {
@@ -277,6 +288,7 @@ namespace FIFE {
 		SoundClipNameMapIterator nit = m_sclipNameMap.find(resource->getName());
 
 		if (it != m_sclipHandleMap.end()) {
+			m_pinned.erase(it->first);
 			m_sclipHandleMap.erase(it);
 
 			if (nit != m_sclipNameMap.end()) {
@@ -295,6 +307,7 @@ namespace FIFE {
 		SoundClipNameMapIterator nit = m_sclipNameMap.find(name);
 		if (nit != m_sclipNameMap.end()) {
 			handle = nit->second->getHandle();
+			m_pinned.erase(handle);
 			m_sclipNameMap.erase(nit);
 		}
 		else {
@@ -318,6 +331,7 @@ namespace FIFE {
 
 		if (it != m_sclipHandleMap.end()) {
 			name = it->second->getName();
+			m_pinned.erase(handle);
 			m_sclipHandleMap.erase(it);
 		}
 		else {
@@ -342,6 +356,7 @@ namespace FIFE {
 
 		m_sclipHandleMap.clear();
 		m_sclipNameMap.clear();
+		m_pinned.clear();
 
 		FL_DBG(_log, LMsg("SoundClipManager::removeAll() - ") << "Removed all " << count << " resources.");
 	}
@@ -403,4 +418,73 @@ namespace FIFE {
 		return 0;
 	}
 
+	void SoundClipManager::setMemoryBudget(size_t budget) {
+		m_memoryBudget = budget;
+	}
+
+	size_t SoundClipManager::getMemoryBudget() const {
+		return m_memoryBudget;
+	}
+
+	void SoundClipManager::enforceMemoryBudget() {
+		m_lastEvictionCount = 0;
+		if (m_memoryBudget == 0) {
+			return;
+		}
+
+		size_t used = getMemoryUsed();
+		if (used <= m_memoryBudget) {
+			return;
+		}
+
+		// collect all loaded resources which are only referenced by the manager
+		std::vector<SoundClip*> candidates;
+		SoundClipHandleMapIterator it = m_sclipHandleMap.begin(),
+			itend = m_sclipHandleMap.end();
+
+		for ( ; it != itend; ++it) {
+			if (it->second.useCount() != 2 || it->second->getState() != IResource::RES_LOADED) {
+				continue;
+			}
+			if (m_pinned.find(it->first) != m_pinned.end()) {
+				continue;
+			}
+			candidates.push_back(it->second.get());
+		}
+		std::sort(candidates.begin(), candidates.end(), lessRecentlyUsed);
+
+		std::vector<SoundClip*>::iterator cit = candidates.begin();
+		for ( ; cit != candidates.end() && used > m_memoryBudget; ++cit) {
+			size_t size = (*cit)->getSize();
+			(*cit)->free();
+			used -= std::min(used, size);
+			m_evictedBytes += size;
+			++m_lastEvictionCount;
+		}
+		m_evictionCount += m_lastEvictionCount;
+
+		if (used > m_memoryBudget) {
+			FL_DBG(_log, LMsg("SoundClipManager::enforceMemoryBudget() - ") << "Budget of " << m_memoryBudget << " bytes exceeded by referenced resources, " << used << " bytes in use.");
+		}
+		FL_DBG(_log, LMsg("SoundClipManager::enforceMemoryBudget() - ") << "Evicted " << m_lastEvictionCount << " resources.");
+	}
+
+	size_t SoundClipManager::getEvictionCount() const {
+		return m_evictionCount;
+	}
+
+	size_t SoundClipManager::getEvictedBytes() const {
+		return m_evictedBytes;
+	}
+
+	size_t SoundClipManager::getLastEvictionCount() const {
+		return m_lastEvictionCount;
+	}
+
+	void SoundClipManager::resetEvictionStatistics() {
+		m_evictionCount = 0;
+		m_evictedBytes = 0;
+		m_lastEvictionCount = 0;
+	}
+
 } //FIFE
@@ -24,6 +24,7 @@
 
 // Standard C++ library includes
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -56,7 +57,12 @@ namespace FIFE {
 
 		/** Default constructor.
 		 */
-		SoundClipManager() : IResourceManager() { }
+		SoundClipManager() :
+			IResourceManager(),
+			m_memoryBudget(0),
+			m_evictionCount(0),
+			m_evictedBytes(0),
+			m_lastEvictionCount(0) { }
 
 		/** Destructor.
 		 */
@@ -352,6 +358,49 @@ namespace FIFE {
 		 */
 		virtual ResourceHandle getResourceHandle(const std::string& name);
 
+		/** Sets the memory budget of the manager
+		 *
+		 * If the memory used by loaded SoundClips exceeds the budget the
+		 * least recently used SoundClips are freed by enforceMemoryBudget().
+		 * Only SoundClips without external references are freed and they are
+		 * reloaded on the next access.  SoundClips that were added to the
+		 * manager in a loaded state are never freed
+		 * because they can not be reloaded.
+		 *
+		 * @param budget The budget in bytes, 0 disables the budget (default).
+		 *
+		 */
+		void setMemoryBudget(size_t budget);
+
+		/** Returns the memory budget in bytes, 0 if disabled.
+		 */
+		size_t getMemoryBudget() const;
+
+		/** Frees least recently used SoundClips until the memory budget is met
+		 *
+		 * This is called once per frame by the Engine.
+		 *
+		 * @see setMemoryBudget()
+		 *
+		 */
+		void enforceMemoryBudget();
+
+		/** Returns the number of SoundClips freed by the budget since the last reset.
+		 */
+		size_t getEvictionCount() const;
+
+		/** Returns the number of bytes freed by the budget since the last reset.
+		 */
+		size_t getEvictedBytes() const;
+
+		/** Returns the number of SoundClips freed by the last enforceMemoryBudget() call.
+		 */
+		size_t getLastEvictionCount() const;
+
+		/** Resets the eviction statistics.
+		 */
+		void resetEvictionStatistics();
+
 	private:
 		typedef std::map< ResourceHandle, SoundClipPtr > SoundClipHandleMap;
 		typedef std::map< ResourceHandle, SoundClipPtr >::iterator SoundClipHandleMapIterator;
@@ -366,6 +415,15 @@ namespace FIFE {
 		SoundClipHandleMap m_sclipHandleMap;
 
 		SoundClipNameMap m_sclipNameMap;
+
+		// handles of resources which can not be reloaded and are never evicted
+		std::set<ResourceHandle> m_pinned;
+		// memory budget in bytes, 0 if disabled
+		size_t m_memoryBudget;
+		// eviction statistics
+		size_t m_evictionCount;
+		size_t m_evictedBytes;
+		size_t m_lastEvictionCount;
 	};
 
 } //FIFE
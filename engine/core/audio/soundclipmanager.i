@@ -64,5 +64,13 @@ namespace FIFE {
 		virtual SoundClipPtr get(ResourceHandle handle);
 
 		virtual ResourceHandle getResourceHandle(const std::string& name);
+
+		void setMemoryBudget(size_t budget);
+		size_t getMemoryBudget() const;
+		void enforceMemoryBudget();
+		size_t getEvictionCount() const;
+		size_t getEvictedBytes() const;
+		size_t getLastEvictionCount() const;
+		void resetEvictionStatistics();
 	};
 }
@@ -85,6 +85,16 @@ namespace FIFE {
 		 */
 		virtual void releaseBuffer() = 0;
 
+		/** Creates an independent decoder for the same audio file.
+		 *
+		 * The new decoder has its own cursor and is used by the streaming thread,
+		 * so it must not touch data that is shared with this decoder without locking.
+		 *
+		 * @return The new decoder or NULL if the format doesn't support it, the
+		 * caller takes the ownership.
+		 */
+		virtual SoundDecoder* createStreamDecoder() { return 0; }
+
 		/** Tests if the audio data is stereo data or mono.
 		 *
 		 * @return Returns true if the audio data is stereo, false if mono.
@@ -48,6 +48,7 @@ namespace FIFE {
 		m_soundClip(),
 		m_soundClipId(0),
 		m_streamId(0),
+		m_streaming(false),
 		m_emitterId(uid),
 		m_group(""),
 		m_samplesOffset(0),
@@ -59,7 +60,8 @@ namespace FIFE {
 		m_fadeInEndTimestamp(0),
 		m_fadeOutStartTimestamp(0),
 		m_fadeOutEndTimestamp(0),
-		m_playCheckDifference(0) {
+		m_spatialKey(0),
+		m_spatialIndexed(false) {
 
 		if (!m_manager->isActive()) {
 			return;
@@ -84,6 +86,9 @@ namespace FIFE {
 			alSourcei(m_source, AL_BUFFER, AL_NONE);
 			alGetError();
 
+			// the stream is started again when the emitter gets a new source
+			releaseStream();
+
 			deactivateEffects();
 		}
 		m_source = source;
@@ -118,6 +123,9 @@ namespace FIFE {
 			}
 			return;
 		}
+		if (!m_streaming) {
+			return;
+		}
 
 		ALint procs;
 		ALint bufs;
@@ -134,22 +142,44 @@ namespace FIFE {
 			alGetSourcef(m_source, AL_SAMPLE_OFFSET, &newOffset);
 			m_samplesOffset += (samplesOffset - newOffset);
 
-			if (m_soundClip->getStream(m_streamId, buffer)) {
-				// EOF!
+			m_pendingBuffers.push_back(buffer);
+		}
+
+		// buffers the decoder has no data for yet are retried on the next update
+		bool queued = false;
+		while (!m_pendingBuffers.empty()) {
+			buffer = m_pendingBuffers.front();
+			SoundRefillType refill = m_soundClip->getStream(m_streamId, buffer);
+			if (refill == SD_REFILL_EOF) {
 				if (m_internData.loop) {
 					// play again from the beginning
 					m_soundClip->setStreamPos(m_streamId, SD_BYTE_POS, 0);
-					m_soundClip->getStream(m_streamId, buffer);
+					refill = m_soundClip->getStream(m_streamId, buffer);
 				} else {
+					m_pendingBuffers.erase(m_pendingBuffers.begin());
 					// check if the playback has been finished
 					alGetSourcei(m_source, AL_BUFFERS_QUEUED, &bufs);
 					if (bufs == 0) {
 						stop();
+						break;
 					}
 					continue;
 				}
 			}
+			if (refill == SD_REFILL_PENDING) {
+				break;
+			}
+			m_pendingBuffers.erase(m_pendingBuffers.begin());
 			alSourceQueueBuffers(m_source, 1, &buffer);
+			queued = true;
+		}
+		// the source stops if it runs out of buffers, it continues once they are refilled
+		if (queued && m_internData.soundState == SD_PLAYING_STATE) {
+			ALint state;
+			alGetSourcei(m_source, AL_SOURCE_STATE, &state);
+			if (state == AL_STOPPED) {
+				alSourcePlay(m_source);
+			}
 		}
 
 		CHECK_OPENAL_LOG(_log, LogManager::LEVEL_ERROR, "error while streaming")
@@ -226,10 +256,7 @@ namespace FIFE {
 		}
 		// reset clip
 		if (m_soundClip) {
-			if (m_soundClip->isStream()) {
-				m_soundClip->quitStreaming(m_streamId);
-				m_streamId = 0;
-			}
+			releaseStream();
 			m_soundClipId = 0;
 			// release the soundClip
 			//SoundClipManager::instance()->free(m_soundClipId);
@@ -239,6 +266,7 @@ namespace FIFE {
 		// default source properties
 		if (defaultall) {
 			resetInternData();
+			m_manager->updateEmitterPosition(this);
 			if (isActive()) {
 				syncData();
 			}
@@ -281,6 +309,7 @@ namespace FIFE {
 	}
 
 	void SoundEmitter::attachSoundClip() {
+		m_soundClip->touch();
 		if (!m_soundClip->isStream()) {
 			if (!isActive()) {
 				return;
@@ -290,14 +319,15 @@ namespace FIFE {
 			alSourcei(m_source, AL_LOOPING, m_internData.loop ? AL_TRUE : AL_FALSE);
 
 		} else {
-			// streaming
-			m_streamId = m_soundClip->beginStreaming();
-			m_soundClip->acquireStream(m_streamId);
+			// streaming, without source the stream is started once the emitter gets one
 			if (!isActive()) {
 				return;
 			}
+			releaseStream();
+			m_streamId = m_soundClip->beginStreaming(m_manager->getStreamer());
+			m_streaming = true;
 			// queue initial buffers
-			alSourceQueueBuffers(m_source, BUFFER_NUM, m_soundClip->getBuffers(m_streamId));
+			queueStreamBuffers();
 			alSourcei(m_source, AL_LOOPING, AL_FALSE);
 		}
 
@@ -317,10 +347,7 @@ namespace FIFE {
 			alSourcei(m_source, AL_BUFFER, AL_NONE);
 			CHECK_OPENAL_LOG(_log, LogManager::LEVEL_ERROR, "error detaching sound clip");
 		}
-		if (m_soundClip->isStream()) {
-			m_soundClip->quitStreaming(m_streamId);
-			m_streamId = 0;
-		}
+		releaseStream();
 		m_soundClipId = 0;
 		m_soundClip.reset();
 	}
@@ -345,7 +372,6 @@ namespace FIFE {
 			alSourcePlay(m_source);
 		}
 		m_internData.playTimestamp = TimeManager::instance()->getTime();
-		m_playCheckDifference = 0;
 		// resume
 		if (m_internData.soundState == SD_PAUSED_STATE) {
 			m_internData.playTimestamp -= static_cast<uint32_t>(getCursor(SD_TIME_POS) * 1000);
@@ -502,7 +528,7 @@ namespace FIFE {
 			return true;
 		}
 		// roughly check, in the case the clip do not plays (is not active)
-		return (m_internData.playTimestamp + m_playCheckDifference + static_cast<uint32_t>(getDuration())) <= TimeManager::instance()->getTime();
+		return (m_internData.playTimestamp + static_cast<uint32_t>(getDuration())) <= TimeManager::instance()->getTime();
 	}
 
 	void SoundEmitter::setCursor(SoundPositionType type, float value) {
@@ -526,7 +552,7 @@ namespace FIFE {
 			}
 
 			CHECK_OPENAL_LOG(_log, LogManager::LEVEL_ERROR, "error setting cursor position")
-		} else {
+		} else if (m_streaming) {
 			switch (type) {
 			case SD_BYTE_POS:
 				m_samplesOffset = value / (getBitResolution() / 8 * (isStereo() ? 2 : 1));
@@ -549,8 +575,7 @@ namespace FIFE {
 			alSourcei(m_source, AL_BUFFER, 0);
 
 			// queue the buffers with new data
-			m_soundClip->acquireStream(m_streamId);
-			alSourceQueueBuffers(m_source, BUFFER_NUM, m_soundClip->getBuffers(m_streamId));
+			queueStreamBuffers();
 
 			if (state == AL_PLAYING) {
 				alSourcePlay(m_source);
@@ -561,7 +586,23 @@ namespace FIFE {
 	}
 
 	float SoundEmitter::getCursor(SoundPositionType type) {
-		if (!m_soundClip || !isActive()) {
+		if (!m_soundClip) {
+			return 0.0f;
+		}
+		if (!isActive()) {
+			// virtual playback, derived from the play time
+			if (m_internData.soundState != SD_PLAYING_STATE) {
+				return 0.0f;
+			}
+			float time = static_cast<float>(getPlayedTime()) / 1000.0f;
+			switch (type) {
+				case SD_BYTE_POS:
+					return time * getSampleRate() * (getBitResolution() / 8 * (isStereo() ? 2 : 1));
+				case SD_SAMPLE_POS:
+					return time * getSampleRate();
+				case SD_TIME_POS:
+					return time;
+			}
 			return 0.0f;
 		}
 
@@ -603,6 +644,7 @@ namespace FIFE {
 			alSource3f(m_source, AL_POSITION, static_cast<ALfloat>(position.x), static_cast<ALfloat>(position.y), static_cast<ALfloat>(position.z));
 		}
 		m_internData.position = position;
+		m_manager->updateEmitterPosition(this);
 	}
 
 	AudioSpaceCoordinate SoundEmitter::getPosition() const {
@@ -697,6 +739,10 @@ namespace FIFE {
 				return SD_PAUSED_STATE;
 				break;
 			case AL_STOPPED:
+				// a stream that ran out of decoded data continues once the buffers are refilled
+				if (m_streaming && !m_pendingBuffers.empty() && m_internData.soundState == SD_PLAYING_STATE) {
+					return SD_PLAYING_STATE;
+				}
 				return SD_STOPPED_STATE;
 				break;
 			default:
@@ -738,17 +784,50 @@ namespace FIFE {
 		setLooping(m_internData.loop);
 		setRelativePositioning(m_internData.relative);
 		if (m_internData.soundState == SD_PLAYING_STATE) {
-			uint32_t timediff = TimeManager::instance()->getTime() - m_internData.playTimestamp - m_playCheckDifference;
-			if (m_internData.loop) {
-				timediff = timediff % getDuration();
-			}
+			// resume at the position the virtual playback reached
+			uint32_t timediff = getPlayedTime();
 			float time = static_cast<float>(timediff) / 1000.0f;
 			attachSoundClip();
 			setCursor(SD_TIME_POS, time);
 			if (m_soundClip && isActive()) {
+				// keep the time base, so the next resume starts at the same position
 				m_internData.playTimestamp = TimeManager::instance()->getTime() - timediff;
 				alSourcePlay(m_source);
 			}
+		} else if (m_soundClip) {
+			attachSoundClip();
+		}
+	}
+
+	uint32_t SoundEmitter::getPlayedTime() {
+		// derived from the play timestamp alone, so it does not depend on when the emitter is checked first
+		uint32_t timediff = TimeManager::instance()->getTime() - m_internData.playTimestamp;
+		if (m_internData.loop) {
+			uint64_t duration = getDuration();
+			if (duration > 0) {
+				timediff = timediff % duration;
+			}
+		}
+		return timediff;
+	}
+
+	void SoundEmitter::queueStreamBuffers() {
+		uint32_t filled = m_soundClip->acquireStream(m_streamId);
+		ALuint* buffers = m_soundClip->getBuffers(m_streamId);
+		if (filled > 0) {
+			alSourceQueueBuffers(m_source, filled, buffers);
+		}
+		// the rest is filled by update()
+		m_pendingBuffers.assign(buffers + filled, buffers + BUFFER_NUM);
+	}
+
+	void SoundEmitter::releaseStream() {
+		m_pendingBuffers.clear();
+		if (m_streaming) {
+			m_soundClip->quitStreaming(m_streamId);
+			m_soundClip->endStreaming(m_streamId);
+			m_streamId = 0;
+			m_streaming = false;
 		}
 	}
 
@@ -768,6 +847,7 @@ namespace FIFE {
 		m_internData.velocity = AudioSpaceCoordinate(0.0, 0.0, 0.0);
 		m_internData.playTimestamp = 0;
 		m_internData.soundState = SD_UNKNOWN_STATE;
+		m_internData.priority = 0;
 		m_internData.loop = false;
 		m_internData.relative = false;
 	}
@@ -872,10 +952,28 @@ namespace FIFE {
 		}
 	}
 
-	void SoundEmitter::setCheckDifference() {
-		if (m_playCheckDifference == 0 && getState() == SD_PLAYING_STATE) {
-			m_playCheckDifference = TimeManager::instance()->getTime() - m_internData.playTimestamp;
-		}
+	void SoundEmitter::setPriority(int32_t priority) {
+		m_internData.priority = priority;
+	}
+
+	int32_t SoundEmitter::getPriority() const {
+		return m_internData.priority;
+	}
+
+	void SoundEmitter::setSpatialKey(uint64_t key) {
+		m_spatialKey = key;
+	}
+
+	uint64_t SoundEmitter::getSpatialKey() const {
+		return m_spatialKey;
+	}
+
+	void SoundEmitter::setSpatialIndexed(bool indexed) {
+		m_spatialIndexed = indexed;
+	}
+
+	bool SoundEmitter::isSpatialIndexed() const {
+		return m_spatialIndexed;
 	}
 
 	void SoundEmitter::addListener(SoundEmitterListener* listener) {
@@ -23,6 +23,7 @@
 #define FIFE_SOUNDEMITTER_H_
 
 // Standard C++ library includes
+#include <vector>
 
 // Platform specific includes
 
@@ -368,9 +369,31 @@ namespace FIFE {
 		 */
 		void deactivateEffects();
 
-		/** Sets the time difference between play and the first check if it's playable.
+		/** Sets the priority for the source handles.
+		 *  If there are more audible emitters than sources, emitters with a higher priority
+		 *  get a source first, then the loudest ones. Default is 0.
 		 */
-		void setCheckDifference();
+		void setPriority(int32_t priority);
+
+		/** Return the priority.
+		 */
+		int32_t getPriority() const;
+
+		/** Sets the key of the spatial cell. Used from SoundManager.
+		 */
+		void setSpatialKey(uint64_t key);
+
+		/** Return the key of the spatial cell. Used from SoundManager.
+		 */
+		uint64_t getSpatialKey() const;
+
+		/** Sets if the emitter is in the spatial index. Used from SoundManager.
+		 */
+		void setSpatialIndexed(bool indexed);
+
+		/** Return if the emitter is in the spatial index. Used from SoundManager.
+		 */
+		bool isSpatialIndexed() const;
 
 		/** Adds new SoundEmitter listener
 		 * @param listener to add
@@ -407,6 +430,18 @@ namespace FIFE {
 		 */
 		void callOnSoundFinished();
 
+		/** Returns the time in milliseconds the clip played so far, also without a source.
+		 */
+		uint32_t getPlayedTime();
+
+		/** Queues the prefilled stream buffers, the others are refilled by update().
+		 */
+		void queueStreamBuffers();
+
+		/** Releases the stream of a streaming clip.
+		 */
+		void releaseStream();
+
 		//! Access to the SoundManager
 		SoundManager* m_manager;
 		//! The openAL-source
@@ -419,6 +454,10 @@ namespace FIFE {
 		uint32_t m_soundClipId;
 		//! The id of the stream
 		uint32_t m_streamId;
+		//! true if m_streamId is a valid stream of the clip
+		bool m_streaming;
+		//! stream buffers that wait for decoded data, they are refilled by update()
+		std::vector<ALuint> m_pendingBuffers;
 		//! The emitter-id
 		uint32_t m_emitterId;
 
@@ -439,6 +478,7 @@ namespace FIFE {
 			AudioSpaceCoordinate velocity;
 			uint32_t playTimestamp;
 			SoundStateType soundState;
+			int32_t priority;
 			bool loop;
 			bool relative;
 		} m_internData;
@@ -463,8 +503,10 @@ namespace FIFE {
 		uint32_t m_fadeOutStartTimestamp;
 		//! fade out end time
 		uint32_t m_fadeOutEndTimestamp;
-		//! time difference between play and first check
-		uint32_t m_playCheckDifference;
+		//! cell in the spatial index of the SoundManager
+		uint64_t m_spatialKey;
+		//! true if the emitter is in a cell of the spatial index, otherwise it is not positional
+		bool m_spatialIndexed;
 		//! holds pointer to applied SoundEffects
 		std::vector<SoundEffect*> m_effects;
 		//! listeners for sound related events
@@ -113,6 +113,9 @@ namespace FIFE {
 		void setGroup(const std::string& group);
 		const std::string& getGroup();
 
+		void setPriority(int32_t priority);
+		int32_t getPriority() const;
+
 		void addListener(SoundEmitterListener* listener);
 		void removeListener(SoundEmitterListener* listener);
 	
@@ -20,6 +20,8 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
+#include <cmath>
 
 // Platform specific includes
 
@@ -33,10 +35,12 @@
 #include "vfs/vfs.h"
 #include "util/log/logger.h"
 #include "util/base/exception.h"
+#include "util/time/profiler.h"
 
 #include "soundclipmanager.h"
 #include "soundemitter.h"
 #include "soundmanager.h"
+#include "soundstreamer.h"
 
 namespace FIFE {
 	/** Logger to use for this source file.
@@ -44,6 +48,27 @@ namespace FIFE {
 	 */
 	static Logger _log(LM_AUDIO);
 
+	//! Active emitters count as louder by this factor, so similar emitters don't steal each others source
+	static const float VOICE_HYSTERESIS = 1.25f;
+
+	/** Orders voice candidates by priority, then by audibility, the most important first.
+	 */
+	struct VoiceCandidateCompare {
+		template<typename T>
+		bool operator()(const T& a, const T& b) const {
+			if (a.priority != b.priority) {
+				return a.priority > b.priority;
+			}
+			return a.audibility > b.audibility;
+		}
+	};
+
+	/** Packs the cell coordinates of the spatial index into one key, 21 bits per axis.
+	 */
+	static uint64_t packCellKey(int32_t x, int32_t y, int32_t z) {
+		return (static_cast<uint64_t>(x & 0x1FFFFF) << 42) | (static_cast<uint64_t>(y & 0x1FFFFF) << 21) | static_cast<uint64_t>(z & 0x1FFFFF);
+	}
+
 	SoundManager::SoundManager() :
 		m_context(0),
 		m_device(0),
@@ -54,7 +79,9 @@ namespace FIFE {
 		m_state(SM_STATE_INACTIV),
 		m_sources(),
 		m_createdSources(0),
-		m_effectManager(NULL) {
+		m_virtualEmitters(0),
+		m_effectManager(NULL),
+		m_streamer(NULL) {
 	}
 
 	SoundManager::~SoundManager() {
@@ -65,6 +92,8 @@ namespace FIFE {
 			}
 		}
 		m_emitterVec.clear();
+		// stop the streaming thread, the emitters released their streams
+		delete m_streamer;
 		// delete all sources
 		alDeleteSources(m_createdSources, m_sources);
 		// delete effect manager
@@ -106,6 +135,8 @@ namespace FIFE {
 		// create and initialize the effect manager
 		m_effectManager = new SoundEffectManager();
 		m_effectManager->init(m_device);
+		// start the streaming thread
+		m_streamer = new SoundStreamer();
 
 		// set listener position
 		alListener3f(AL_POSITION, 0.0, 0.0, 0.0);
@@ -128,6 +159,32 @@ namespace FIFE {
 		m_state = SM_STATE_PLAY;
 	}
 
+	SoundStreamer* SoundManager::getStreamer() const {
+		return m_streamer;
+	}
+
+	uint32_t SoundManager::getStreamRefills() const {
+		return m_streamer ? m_streamer->getRefillCount() : 0;
+	}
+
+	uint32_t SoundManager::getStreamUnderruns() const {
+		return m_streamer ? m_streamer->getUnderrunCount() : 0;
+	}
+
+	double SoundManager::getAverageStreamRefillLatency() const {
+		return m_streamer ? m_streamer->getAverageRefillLatency() : 0.0;
+	}
+
+	double SoundManager::getMaxStreamRefillLatency() const {
+		return m_streamer ? m_streamer->getMaxRefillLatency() : 0.0;
+	}
+
+	void SoundManager::resetStreamStats() {
+		if (m_streamer) {
+			m_streamer->resetStatistics();
+		}
+	}
+
 	bool SoundManager::isActive() const {
 		return m_state != SM_STATE_INACTIV;
 	}
@@ -305,6 +362,8 @@ namespace FIFE {
 
 	void SoundManager::setListenerMaxDistance(float distance) {
 		m_maxDistance = distance;
+		// the cells have the size of the distance
+		rebuildSpatialIndex();
 	}
 
 	float SoundManager::getListenerMaxDistance() const {
@@ -312,57 +371,185 @@ namespace FIFE {
 	}
 
 	void SoundManager::update() {
+		FIFE_PROFILE_ZONE("SoundManager::update");
 		if (m_state != SM_STATE_PLAY) {
 			return;
 		}
 		AudioSpaceCoordinate listenerPos = getListenerPosition();
-		double maxDistance = static_cast<double>(m_maxDistance);
-
-		// first check emitters
-		for (std::vector<SoundEmitter*>::iterator it = m_emitterVec.begin(); it != m_emitterVec.end(); ++it) {
-			SoundEmitter* emitter = (*it);
-			if (!emitter) {
-				continue;
+		m_candidates.clear();
+
+		// first check emitters that can be in range, emitters in other cells don't need a check.
+		// without source their play time continues, so they resume at the right position.
+		std::vector<SoundEmitter*>::iterator it = m_globalEmitters.begin();
+		for (; it != m_globalEmitters.end(); ++it) {
+			if (!(*it)->isActive()) {
+				checkEmitter(*it, listenerPos);
 			}
-			emitter->setCheckDifference();
-
-			bool active = emitter->isActive();
-			bool clip = emitter->getSoundClip();
-			bool plays = !emitter->isFinished();
-			// remove active without clip or stopped
-			if (!clip || !plays) {
-				if (active) {
-					emitter->update();
-					releaseSource(emitter);
+		}
+		if (!m_emitterCells.empty()) {
+			double cellSize = std::max(static_cast<double>(m_maxDistance), 1.0);
+			int32_t cx = static_cast<int32_t>(std::floor(listenerPos.x / cellSize));
+			int32_t cy = static_cast<int32_t>(std::floor(listenerPos.y / cellSize));
+			int32_t cz = static_cast<int32_t>(std::floor(listenerPos.z / cellSize));
+			for (int32_t z = cz - 1; z <= cz + 1; ++z) {
+				for (int32_t y = cy - 1; y <= cy + 1; ++y) {
+					for (int32_t x = cx - 1; x <= cx + 1; ++x) {
+						EmitterCells::iterator cell = m_emitterCells.find(packCellKey(x, y, z));
+						if (cell == m_emitterCells.end()) {
+							continue;
+						}
+						for (it = cell->second.begin(); it != cell->second.end(); ++it) {
+							if (!(*it)->isActive()) {
+								checkEmitter(*it, listenerPos);
+							}
+						}
+					}
 				}
-				continue;
 			}
+		}
+		// active emitters are checked even if they left the range, checkEmitter can release the source
+		std::vector<SoundEmitter*> active = m_activeEmitters;
+		for (it = active.begin(); it != active.end(); ++it) {
+			checkEmitter(*it, listenerPos);
+		}
 
-			bool inRange = true;
-			if (emitter->isPosition()) {
-				AudioSpaceCoordinate emitterPos = emitter->getPosition();
-				double rx = listenerPos.x - emitterPos.x;
-				double ry = listenerPos.y - emitterPos.y;
-				double rz = listenerPos.z - emitterPos.z;
-				inRange = maxDistance >= Mathd::Sqrt(rx*rx + ry*ry + rz*rz);
-			}
-			// remove active not in range
-			if (!inRange) {
-				if (active) {
-					releaseSource(emitter);
+		// more audible emitters than sources, the less important ones become virtual
+		size_t voices = m_createdSources;
+		m_virtualEmitters = 0;
+		if (m_candidates.size() > voices) {
+			std::nth_element(m_candidates.begin(), m_candidates.begin() + voices, m_candidates.end(), VoiceCandidateCompare());
+			for (size_t i = voices; i < m_candidates.size(); ++i) {
+				if (m_candidates[i].emitter->isActive()) {
+					releaseSource(m_candidates[i].emitter);
 				}
-				continue;
 			}
-			if (!active && !m_freeSources.empty()) {
-				setEmitterSource(emitter);
+			m_virtualEmitters = m_candidates.size() - voices;
+			m_candidates.resize(voices);
+		}
+		std::vector<VoiceCandidate>::iterator cit = m_candidates.begin();
+		for (; cit != m_candidates.end(); ++cit) {
+			if (!cit->emitter->isActive() && !m_freeSources.empty()) {
+				setEmitterSource(cit->emitter);
 			}
 		}
+
 		// then update active
-		for (std::map<SoundEmitter*, ALuint>::iterator it = m_activeEmitters.begin(); it != m_activeEmitters.end(); ++it) {
-			it->first->update();
+		for (size_t i = 0; i < m_activeEmitters.size(); ++i) {
+			m_activeEmitters[i]->update();
+		}
+	}
+
+	void SoundManager::checkEmitter(SoundEmitter* emitter, const AudioSpaceCoordinate& listenerPos) {
+		bool active = emitter->isActive();
+		bool clip = emitter->getSoundClip();
+		bool plays = !emitter->isFinished();
+		// remove active without clip or stopped
+		if (!clip || !plays) {
+			if (active) {
+				emitter->update();
+				releaseSource(emitter);
+			}
+			return;
+		}
+
+		double distanceSq = 0.0;
+		if (emitter->isPosition()) {
+			AudioSpaceCoordinate emitterPos = emitter->getPosition();
+			double rx = listenerPos.x - emitterPos.x;
+			double ry = listenerPos.y - emitterPos.y;
+			double rz = listenerPos.z - emitterPos.z;
+			distanceSq = rx*rx + ry*ry + rz*rz;
+		}
+		double maxDistance = static_cast<double>(m_maxDistance);
+		// remove active not in range
+		if (distanceSq > maxDistance * maxDistance) {
+			if (active) {
+				releaseSource(emitter);
+			}
+			return;
+		}
+
+		// rough loudness after distance attenuation, the clamped inverse model is good enough to rank the emitters
+		float audibility = emitter->getGain();
+		float refDistance = emitter->getReferenceDistance();
+		float distance = static_cast<float>(std::sqrt(distanceSq));
+		if (distance > refDistance && refDistance > 0.0f) {
+			audibility *= refDistance / (refDistance + emitter->getRolloff() * (distance - refDistance));
+		}
+		if (active) {
+			audibility *= VOICE_HYSTERESIS;
+		}
+		VoiceCandidate candidate = { emitter, emitter->getPriority(), audibility };
+		m_candidates.push_back(candidate);
+	}
+
+	uint64_t SoundManager::getSpatialKey(const AudioSpaceCoordinate& position) const {
+		double cellSize = std::max(static_cast<double>(m_maxDistance), 1.0);
+		int32_t x = static_cast<int32_t>(std::floor(position.x / cellSize));
+		int32_t y = static_cast<int32_t>(std::floor(position.y / cellSize));
+		int32_t z = static_cast<int32_t>(std::floor(position.z / cellSize));
+		return packCellKey(x, y, z);
+	}
+
+	void SoundManager::updateEmitterPosition(SoundEmitter* emitter) {
+		if (!isActive()) {
+			return;
+		}
+		bool positional = emitter->isPosition();
+		uint64_t key = positional ? getSpatialKey(emitter->getPosition()) : 0;
+		if (emitter->isSpatialIndexed() == positional && (!positional || emitter->getSpatialKey() == key)) {
+			// still in the same cell
+			return;
+		}
+		removeFromSpatialIndex(emitter);
+		if (positional) {
+			m_emitterCells[key].push_back(emitter);
+			emitter->setSpatialKey(key);
+			emitter->setSpatialIndexed(true);
+		} else {
+			m_globalEmitters.push_back(emitter);
 		}
 	}
 
+	void SoundManager::removeFromSpatialIndex(SoundEmitter* emitter) {
+		if (emitter->isSpatialIndexed()) {
+			EmitterCells::iterator cell = m_emitterCells.find(emitter->getSpatialKey());
+			if (cell != m_emitterCells.end()) {
+				std::vector<SoundEmitter*>::iterator it = std::find(cell->second.begin(), cell->second.end(), emitter);
+				if (it != cell->second.end()) {
+					*it = cell->second.back();
+					cell->second.pop_back();
+				}
+				if (cell->second.empty()) {
+					m_emitterCells.erase(cell);
+				}
+			}
+			emitter->setSpatialIndexed(false);
+		} else {
+			std::vector<SoundEmitter*>::iterator it = std::find(m_globalEmitters.begin(), m_globalEmitters.end(), emitter);
+			if (it != m_globalEmitters.end()) {
+				*it = m_globalEmitters.back();
+				m_globalEmitters.pop_back();
+			}
+		}
+	}
+
+	void SoundManager::rebuildSpatialIndex() {
+		m_emitterCells.clear();
+		m_globalEmitters.clear();
+		std::vector<SoundEmitter*>::iterator it = m_emitterVec.begin();
+		for (; it != m_emitterVec.end(); ++it) {
+			if (*it) {
+				(*it)->setSpatialIndexed(false);
+				updateEmitterPosition(*it);
+			}
+		}
+	}
+
+	uint32_t SoundManager::getVirtualEmitterCount() const {
+		return m_virtualEmitters;
+	}
+
 	SoundEmitter* SoundManager::getEmitter(uint32_t emitterId) const {
 		return m_emitterVec.at(emitterId);
 	}
@@ -380,6 +567,9 @@ namespace FIFE {
 			ptr = new SoundEmitter(this, m_emitterVec.size());
 			m_emitterVec.push_back(ptr);
 		}
+		if (isActive()) {
+			m_globalEmitters.push_back(ptr);
+		}
 		return ptr;
 	}
 
@@ -394,6 +584,9 @@ namespace FIFE {
 		if ((*ptr)->isActive()) {
 			releaseSource(*ptr);
 		}
+		if (isActive()) {
+			removeFromSpatialIndex(*ptr);
+		}
 		delete *ptr;
 		*ptr = NULL;
 	}
@@ -403,21 +596,22 @@ namespace FIFE {
 	}
 
 	void SoundManager::setEmitterSource(SoundEmitter* emitter) {
-		std::pair<std::map<SoundEmitter*, ALuint>::iterator, bool> ret;
-		ret = m_activeEmitters.insert(std::pair<SoundEmitter*, ALuint>(emitter, m_freeSources.front()));
-		if (ret.second == false) {
+		if (emitter->isActive()) {
 			FL_WARN(_log, LMsg() << "SoundEmitter already have an source handler");
+			return;
 		}
+		m_activeEmitters.push_back(emitter);
 		emitter->setSource(m_freeSources.front());
 		m_freeSources.pop();
 	}
 
 	void SoundManager::releaseSource(SoundEmitter* emitter) {
 		if (emitter->isActive()) {
-			std::map<SoundEmitter*, ALuint>::iterator it = m_activeEmitters.find(emitter);
+			std::vector<SoundEmitter*>::iterator it = std::find(m_activeEmitters.begin(), m_activeEmitters.end(), emitter);
 			if (it != m_activeEmitters.end()) {
-				m_freeSources.push(it->second);
-				m_activeEmitters.erase(it);
+				m_freeSources.push(emitter->getSource());
+				*it = m_activeEmitters.back();
+				m_activeEmitters.pop_back();
 				emitter->setSource(0);
 			} else {
 				FL_WARN(_log, LMsg() << "SoundEmitter can not release source handler");
@@ -23,7 +23,9 @@
 #define FIFE_SOUNDMANAGER_H
 
 // Standard C++ library includes
+#include <map>
 #include <queue>
+#include <unordered_map>
 
 // Platform specific includes
 
@@ -66,6 +68,7 @@ namespace FIFE {
 	class SoundEffect;
 	class SoundFilter;
 	class SoundEmitter;
+	class SoundStreamer;
 
 	class SoundManager : public DynamicSingleton<SoundManager> {
 	public:
@@ -173,6 +176,31 @@ namespace FIFE {
 		 */
 		void update();
 
+		/** Returns the streamer that decodes the streaming SoundClips in the background.
+		 *  NULL if the audio module is not active.
+		 */
+		SoundStreamer* getStreamer() const;
+
+		/** Return the number of streaming buffer refills since the last reset.
+		 */
+		uint32_t getStreamRefills() const;
+
+		/** Return the number of refills that had to wait for the streaming thread.
+		 */
+		uint32_t getStreamUnderruns() const;
+
+		/** Return the average time the main thread spent on a refill, in milliseconds.
+		 */
+		double getAverageStreamRefillLatency() const;
+
+		/** Return the longest time the main thread spent on a refill, in milliseconds.
+		 */
+		double getMaxStreamRefillLatency() const;
+
+		/** Resets the streaming statistics.
+		 */
+		void resetStreamStats();
+
 		/** Returns a pointer to an emitter-instance given by emitterId
 		 *
 		 * @param emitterId The id of the Emitter
@@ -208,6 +236,19 @@ namespace FIFE {
 		 */
 		void releaseSource(SoundEmitter* emitter);
 
+		/** Moves the emitter to the cell of its position in the spatial index.
+		 *  Called from the emitter if the position changed.
+		 *
+		 * @param emitter The emitter-instance.
+		 */
+		void updateEmitterPosition(SoundEmitter* emitter);
+
+		/** Return the number of emitters that were in range at the last update but had
+		 *  no source, because louder or more important emitters used all sources.
+		 *  These emitters continue to play virtually and resume once they get a source.
+		 */
+		uint32_t getVirtualEmitterCount() const;
+
 		/** Creates SoundEffect of the specific type.
 		 * @param type See SoundEffectType
 		 */
@@ -365,12 +406,37 @@ namespace FIFE {
 		typedef std::map<std::string, std::vector<SoundEmitter*> > EmitterGroups;
 		typedef EmitterGroups::iterator EmitterGroupsIterator;
 
+		typedef std::unordered_map<uint64_t, std::vector<SoundEmitter*> > EmitterCells;
+
+		//! emitter that is in range and competes for a source
+		struct VoiceCandidate {
+			SoundEmitter* emitter;
+			int32_t priority;
+			float audibility;
+		};
+
 		/** Sets the source handle
 		 *
 		 * @param emitter The Emitter pointer.
 		 */
 		void setEmitterSource(SoundEmitter* emitter);
 
+		/** Checks range and state of the emitter and adds it to the voice candidates if it can be heard.
+		 */
+		void checkEmitter(SoundEmitter* emitter, const AudioSpaceCoordinate& listenerPos);
+
+		/** Returns the key of the spatial cell that contains the position.
+		 */
+		uint64_t getSpatialKey(const AudioSpaceCoordinate& position) const;
+
+		/** Removes the emitter from the spatial index.
+		 */
+		void removeFromSpatialIndex(SoundEmitter* emitter);
+
+		/** Rebuilds the spatial index, called if the cell size changed.
+		 */
+		void rebuildSpatialIndex();
+
 		//! emitter-vector, holds all emitters
 		std::vector<SoundEmitter*> m_emitterVec;
 		//! OpenAL context
@@ -394,11 +460,22 @@ namespace FIFE {
 		uint16_t m_createdSources;
 		//! Holds free handles for sources
 		std::queue<ALuint> m_freeSources;
-		//! Map that holds active Emitters together with the used source handle
-		std::map<SoundEmitter*, ALuint> m_activeEmitters;
+		//! Active Emitters, the used source handle is stored in the emitter
+		std::vector<SoundEmitter*> m_activeEmitters;
+		//! Positional emitters, grouped in cells with the size of the maximal listener distance
+		EmitterCells m_emitterCells;
+		//! Emitters without position, they are always in range
+		std::vector<SoundEmitter*> m_globalEmitters;
+		//! Emitters in range of the last update
+		std::vector<VoiceCandidate> m_candidates;
+		//! Number of emitters in range without source
+		uint32_t m_virtualEmitters;
 
 		SoundEffectManager* m_effectManager;
 
+		//! Decodes the streams in the background
+		SoundStreamer* m_streamer;
+
 		//! A map that holds the groups together with the appended emitters.
 		EmitterGroups m_groups;
 	};
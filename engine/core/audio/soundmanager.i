@@ -196,6 +196,13 @@ namespace FIFE {
 		void setListenerMaxDistance(float distance);
 		float getListenerMaxDistance() const;
 
+		uint32_t getStreamRefills() const;
+		uint32_t getStreamUnderruns() const;
+		double getAverageStreamRefillLatency() const;
+		double getMaxStreamRefillLatency() const;
+		void resetStreamStats();
+		uint32_t getVirtualEmitterCount() const;
+
 		SoundEffect* createSoundEffect(SoundEffectType  type);
 		SoundEffect* createSoundEffectPreset(SoundEffectPreset type);
 		void deleteSoundEffect(SoundEffect* effect);
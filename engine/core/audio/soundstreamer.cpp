@@ -0,0 +1,251 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+#include <chrono>
+
+// Platform specific includes
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/log/logger.h"
+
+#include "sounddecoder.h"
+#include "soundstreamer.h"
+
+namespace FIFE {
+	static Logger _log(LM_AUDIO);
+
+	SoundStream::SoundStream(SoundDecoder* decoder) :
+		m_decoder(decoder),
+		m_head(0),
+		m_tail(0),
+		m_generation(0),
+		m_seekPos(0),
+		m_decodedGeneration(0),
+		m_cursor(0),
+		m_eof(false) {
+		for (uint32_t i = 0; i < STREAM_RING_SIZE; ++i) {
+			m_blocks[i].generation = 0;
+			m_blocks[i].eof = false;
+		}
+	}
+
+	SoundStream::~SoundStream() {
+		delete m_decoder;
+	}
+
+	void SoundStream::seek(uint64_t pos) {
+		m_seekPos.store(pos);
+		m_generation.fetch_add(1, std::memory_order_release);
+	}
+
+	const SoundStreamBlock* SoundStream::front() {
+		uint32_t generation = m_generation.load(std::memory_order_acquire);
+		uint32_t tail = m_tail.load(std::memory_order_relaxed);
+		while (tail != m_head.load(std::memory_order_acquire)) {
+			const SoundStreamBlock& block = m_blocks[tail % STREAM_RING_SIZE];
+			if (block.generation == generation) {
+				return &block;
+			}
+			// decoded before the last seek
+			++tail;
+			m_tail.store(tail, std::memory_order_release);
+		}
+		return NULL;
+	}
+
+	void SoundStream::pop() {
+		m_tail.fetch_add(1, std::memory_order_release);
+	}
+
+	bool SoundStream::produce() {
+		uint32_t generation = m_generation.load(std::memory_order_acquire);
+		if (generation != m_decodedGeneration) {
+			m_decodedGeneration = generation;
+			m_cursor = m_seekPos.load();
+			m_eof = false;
+		}
+		if (m_eof) {
+			return false;
+		}
+		uint32_t head = m_head.load(std::memory_order_relaxed);
+		if (head - m_tail.load(std::memory_order_acquire) >= STREAM_RING_SIZE) {
+			return false;
+		}
+
+		SoundStreamBlock& block = m_blocks[head % STREAM_RING_SIZE];
+		block.generation = generation;
+		block.eof = false;
+		block.data.clear();
+		if (m_cursor >= m_decoder->getDecodedLength() || !m_decoder->setCursor(m_cursor)) {
+			block.eof = true;
+		} else if (m_decoder->decode(BUFFER_LEN)) {
+			FL_ERR(_log, LMsg() << "error while reading from audio file");
+			block.eof = true;
+		} else {
+			const char* data = static_cast<const char*>(m_decoder->getBuffer());
+			block.data.assign(data, data + m_decoder->getBufferSize());
+			m_cursor += m_decoder->getBufferSize();
+			m_decoder->releaseBuffer();
+		}
+		m_eof = block.eof;
+		m_head.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	SoundStreamer::SoundStreamer() :
+		m_wake(false),
+		m_quit(false),
+		m_refills(0),
+		m_underruns(0),
+		m_refillTime(0),
+		m_maxRefillTime(0) {
+		m_thread = std::thread(&SoundStreamer::run, this);
+	}
+
+	SoundStreamer::~SoundStreamer() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_condition.notify_one();
+		m_thread.join();
+
+		std::vector<SoundStream*>::iterator it = m_streams.begin();
+		for (; it != m_streams.end(); ++it) {
+			delete *it;
+		}
+		for (it = m_removedStreams.begin(); it != m_removedStreams.end(); ++it) {
+			delete *it;
+		}
+	}
+
+	void SoundStreamer::addStream(SoundStream* stream) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_streams.push_back(stream);
+			m_wake = true;
+		}
+		m_condition.notify_one();
+	}
+
+	void SoundStreamer::removeStream(SoundStream* stream) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::vector<SoundStream*>::iterator it = std::find(m_streams.begin(), m_streams.end(), stream);
+		if (it != m_streams.end()) {
+			m_streams.erase(it);
+			m_removedStreams.push_back(stream);
+		}
+	}
+
+	void SoundStreamer::wake() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_wake = true;
+		}
+		m_condition.notify_one();
+	}
+
+	const SoundStreamBlock* SoundStreamer::waitForBlock(SoundStream* stream, uint32_t timeout) {
+		std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_wake = true;
+		m_condition.notify_one();
+		// the blocks are decoded without the lock, so holding it does not stall the decoder
+		const SoundStreamBlock* block = stream->front();
+		while (!block) {
+			if (m_decodedCondition.wait_until(lock, end) == std::cv_status::timeout) {
+				return stream->front();
+			}
+			block = stream->front();
+		}
+		return block;
+	}
+
+	void SoundStreamer::run() {
+		std::vector<SoundStream*> streams;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (!m_quit) {
+			// the streams can't be deleted while they are decoded
+			std::vector<SoundStream*>::iterator it = m_removedStreams.begin();
+			for (; it != m_removedStreams.end(); ++it) {
+				delete *it;
+			}
+			m_removedStreams.clear();
+			streams = m_streams;
+			m_wake = false;
+
+			// decode without the lock, removed streams are only deleted above
+			lock.unlock();
+			bool decoded = false;
+			for (it = streams.begin(); it != streams.end(); ++it) {
+				decoded = (*it)->produce() || decoded;
+			}
+			lock.lock();
+
+			if (decoded) {
+				m_decodedCondition.notify_all();
+			} else if (!m_wake && !m_quit) {
+				// the timeout also catches seeks, they don't wake the thread
+				m_condition.wait_for(lock, std::chrono::milliseconds(10));
+			}
+		}
+	}
+
+	void SoundStreamer::addRefill(double latency) {
+		++m_refills;
+		m_refillTime += latency;
+		m_maxRefillTime = std::max(m_maxRefillTime, latency);
+	}
+
+	void SoundStreamer::addUnderrun() {
+		++m_underruns;
+	}
+
+	uint32_t SoundStreamer::getRefillCount() const {
+		return m_refills;
+	}
+
+	uint32_t SoundStreamer::getUnderrunCount() const {
+		return m_underruns;
+	}
+
+	double SoundStreamer::getAverageRefillLatency() const {
+		return m_refills > 0 ? m_refillTime / m_refills : 0.0;
+	}
+
+	double SoundStreamer::getMaxRefillLatency() const {
+		return m_maxRefillTime;
+	}
+
+	void SoundStreamer::resetStatistics() {
+		m_refills = 0;
+		m_underruns = 0;
+		m_refillTime = 0;
+		m_maxRefillTime = 0;
+	}
+}
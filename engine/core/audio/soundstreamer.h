@@ -0,0 +1,195 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_SOUNDSTREAMER_H
+#define FIFE_SOUNDSTREAMER_H
+
+// Standard C++ library includes
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Platform specific includes
+#include "util/base/fife_stdint.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "soundconfig.h"
+
+namespace FIFE {
+
+	class SoundDecoder;
+
+	/** Number of decoded blocks a stream can hold ahead of playback.
+	 */
+	const uint32_t STREAM_RING_SIZE = 2;
+
+	/** Milliseconds the main thread waits at most for the first block after a start or seek.
+	 */
+	const uint32_t STREAM_WAIT_TIMEOUT = 50;
+
+	/** A decoded block of a stream.
+	 */
+	struct SoundStreamBlock {
+		//! the decoded data, at most BUFFER_LEN bytes
+		std::vector<char> data;
+		//! seek generation the block was decoded for
+		uint32_t generation;
+		//! true if the block marks the end of the stream
+		bool eof;
+	};
+
+	/** A stream of a SoundClip that is decoded by the SoundStreamer thread.
+	 *
+	 * The stream has its own decoder, so streams of the same clip don't move
+	 * each others cursor. Decoded blocks are passed to the main thread through
+	 * a single producer, single consumer ring without locks: the streaming
+	 * thread only advances the head, the main thread only advances the tail.
+	 */
+	class SoundStream {
+	public:
+		/** Constructor
+		 * @param decoder The decoder of the stream, the stream takes the ownership.
+		 */
+		SoundStream(SoundDecoder* decoder);
+		~SoundStream();
+
+		/** Called from the main thread. Continues decoding at the given byte position,
+		 * blocks that were decoded before are dropped.
+		 */
+		void seek(uint64_t pos);
+
+		/** Called from the main thread. Returns the next decoded block or NULL if the
+		 * streaming thread didn't decode it yet.
+		 */
+		const SoundStreamBlock* front();
+
+		/** Called from the main thread. Drops the block returned by front().
+		 */
+		void pop();
+
+		/** Called from the streaming thread. Decodes the next block if the ring has space.
+		 * @return True if a block was decoded.
+		 */
+		bool produce();
+
+	private:
+		SoundDecoder* m_decoder;
+		SoundStreamBlock m_blocks[STREAM_RING_SIZE];
+		//! blocks written by the streaming thread
+		std::atomic<uint32_t> m_head;
+		//! blocks consumed by the main thread
+		std::atomic<uint32_t> m_tail;
+		//! seek generation requested by the main thread
+		std::atomic<uint32_t> m_generation;
+		//! position of the last seek
+		std::atomic<uint64_t> m_seekPos;
+
+		// only used by the streaming thread
+		uint32_t m_decodedGeneration;
+		uint64_t m_cursor;
+		bool m_eof;
+	};
+
+	/** Decodes the streams of all playing SoundEmitters on a background thread.
+	 *
+	 * Also keeps the statistics of the buffer refills done by the main thread.
+	 */
+	class SoundStreamer {
+	public:
+		SoundStreamer();
+		~SoundStreamer();
+
+		/** Adds a stream that gets decoded from now on.
+		 */
+		void addStream(SoundStream* stream);
+
+		/** Removes the stream, it is deleted by the streaming thread once it doesn't use it anymore.
+		 */
+		void removeStream(SoundStream* stream);
+
+		/** Wakes up the streaming thread, called when a block was consumed.
+		 */
+		void wake();
+
+		/** Waits until the streaming thread decoded the next block of the stream.
+		 * @param stream The stream, it must be added to the streamer.
+		 * @param timeout Maximal time to wait in milliseconds.
+		 * @return The block, NULL if it was not decoded in time.
+		 */
+		const SoundStreamBlock* waitForBlock(SoundStream* stream, uint32_t timeout);
+
+		/** Records a refill of an OpenAL buffer.
+		 * @param latency Time the main thread spent on the refill in milliseconds.
+		 */
+		void addRefill(double latency);
+
+		/** Records a refill that was postponed, because the decoder fell behind.
+		 */
+		void addUnderrun();
+
+		/** Returns the number of refills since the last reset.
+		 */
+		uint32_t getRefillCount() const;
+
+		/** Returns the number of postponed refills since the last reset.
+		 */
+		uint32_t getUnderrunCount() const;
+
+		/** Returns the average time of a refill in milliseconds.
+		 */
+		double getAverageRefillLatency() const;
+
+		/** Returns the longest refill in milliseconds.
+		 */
+		double getMaxRefillLatency() const;
+
+		/** Resets the refill statistics.
+		 */
+		void resetStatistics();
+
+	private:
+		void run();
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_condition;
+		//! notified by the streaming thread when it decoded blocks
+		std::condition_variable m_decodedCondition;
+		std::vector<SoundStream*> m_streams;
+		std::vector<SoundStream*> m_removedStreams;
+		bool m_wake;
+		bool m_quit;
+
+		uint32_t m_refills;
+		uint32_t m_underruns;
+		double m_refillTime;
+		double m_maxRefillTime;
+	};
+}
+
+#endif
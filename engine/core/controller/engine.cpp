@@ -32,7 +32,9 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "util/base/exception.h"
+#include "util/base/framearena.h"
 #include "util/log/logger.h"
+#include "util/time/profiler.h"
 #include "util/time/timemanager.h"
 #include "audio/soundmanager.h"
 #include "gui/guimanager.h"
@@ -94,6 +96,7 @@ namespace FIFE {
 		m_eventmanager(0),
 		m_soundmanager(0),
 		m_timemanager(0),
+		m_profiler(0),
 		m_imagemanager(0),
 		m_animationmanager(0),
 		m_soundclipmanager(0),
@@ -163,6 +166,7 @@ namespace FIFE {
 		FL_LOG(_log, "================== Engine initialize start =================");
 		m_timemanager = new TimeManager();
 		FL_LOG(_log, "Time manager created");
+		m_profiler = new Profiler();
 
 		FL_LOG(_log, "Creating VFS");
 		m_vfs = new VFS();
@@ -224,6 +228,7 @@ namespace FIFE {
 		m_renderbackend->setMipmappingEnabled(m_settings.isGLUseMipmapping());
 		m_renderbackend->setMonochromeEnabled(m_settings.isGLUseMonochrome());
 		m_renderbackend->setDepthBufferEnabled(m_settings.isGLUseDepthBuffer());
+		m_renderbackend->setVertexBufferObjectsEnabled(m_settings.isGLUseVertexBufferObjects());
 		m_renderbackend->setAlphaTestValue(m_settings.getGLAlphaTestValue());
 		m_renderbackend->setVSyncEnabled(m_settings.isVSync());
 		if (m_settings.isFrameLimitEnabled()) {
@@ -344,6 +349,7 @@ namespace FIFE {
 		delete m_renderbackend;
 		delete m_vfs;
 		delete m_timemanager;
+		delete m_profiler;
 
 		TTF_Quit();
 		SDL_Quit();
@@ -361,6 +367,10 @@ namespace FIFE {
 	}
 
 	void Engine::pump() {
+		m_profiler->endFrame();
+		// temporaries of the last frame are not needed anymore
+		FrameArena::get().reset();
+		FIFE_PROFILE_ZONE("Engine::pump");
 		m_renderbackend->startFrame();
 		m_eventmanager->processEvents();
 		m_timemanager->update();
@@ -375,11 +385,66 @@ namespace FIFE {
 		}
 
 		if (m_guimanager) {
+			FIFE_PROFILE_ZONE("GUIManager::turn");
 			m_guimanager->turn();
 		}
 
+		if (m_profiler->isOverlayEnabled()) {
+			drawProfilerOverlay();
+		}
 		m_cursor->draw();
-		m_renderbackend->endFrame();
+		{
+			FIFE_PROFILE_ZONE("RenderBackend::endFrame");
+			m_renderbackend->endFrame();
+		}
+
+		m_imagemanager->enforceMemoryBudget();
+		m_soundclipmanager->enforceMemoryBudget();
+	}
+
+	void Engine::drawProfilerOverlay() {
+		// frame columns are 2 pixels wide, a millisecond is 3 pixels high
+		const int32_t columnWidth = 2;
+		const int32_t height = 100;
+		const float scale = 3.0f;
+		static const uint8_t colors[8][3] = {
+			{ 230, 25, 75 }, { 60, 180, 75 }, { 255, 225, 25 }, { 0, 130, 200 },
+			{ 245, 130, 48 }, { 145, 30, 180 }, { 70, 240, 240 }, { 240, 50, 230 }
+		};
+
+		const uint32_t frames = m_profiler->getHistorySize();
+		if (frames == 0) {
+			return;
+		}
+
+		// stacks the zones directly below the outermost zone (Engine::pump)
+		std::vector<std::vector<float> > histories;
+		std::vector<std::string> names = m_profiler->getZoneNames();
+		std::vector<std::string>::iterator it = names.begin();
+		for (; it != names.end(); ++it) {
+			if (m_profiler->getZoneDepth(*it) == 1) {
+				histories.push_back(m_profiler->getZoneHistory(*it));
+			}
+		}
+
+		const int32_t width = frames * columnWidth;
+		const Point origin(10, m_renderbackend->getHeight() - height - 10);
+		m_renderbackend->fillRectangle(origin, width, height, 0, 0, 0, 160);
+		for (uint32_t i = 0; i < frames; ++i) {
+			int32_t bottom = origin.y + height;
+			for (uint32_t z = 0; z < histories.size(); ++z) {
+				int32_t h = std::min(static_cast<int32_t>(histories[z][i] * scale + 0.5f), bottom - origin.y);
+				if (h > 0) {
+					bottom -= h;
+					const uint8_t* color = colors[z % 8];
+					m_renderbackend->fillRectangle(Point(origin.x + i * columnWidth, bottom), columnWidth, h,
+						color[0], color[1], color[2], 220);
+				}
+			}
+		}
+		// frame budget of 60 fps
+		const int32_t budget = origin.y + height - static_cast<int32_t>(1000.0f / 60.0f * scale);
+		m_renderbackend->drawLine(Point(origin.x, budget), Point(origin.x + width, budget), 255, 255, 255, 255);
 	}
 
 	void Engine::finalizePumping() {
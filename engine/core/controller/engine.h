@@ -51,6 +51,7 @@ namespace FIFE {
 	class VFSSourceFactory;
 	class EventManager;
 	class TimeManager;
+	class Profiler;
 	class Model;
 	class LogManager;
 	class Cursor;
@@ -139,6 +140,10 @@ namespace FIFE {
 		 */
 		TimeManager* getTimeManager() const { return m_timemanager; }
 
+		/** Provides access point to the Profiler
+		 */
+		Profiler* getProfiler() const { return m_profiler; }
+
 
 		/** Sets the GUI Manager to use.  Engine takes
 		 * ownership of the manager so DONT DELETE IT!
@@ -200,11 +205,16 @@ namespace FIFE {
 		void removeChangeListener(IEngineChangeListener* listener);
 
 	private:
+		/** Draws the frame times of the profiler zones as stacked graph.
+		 */
+		void drawProfilerOverlay();
+
 		RenderBackend* m_renderbackend;
 		IGUIManager* m_guimanager;
 		EventManager* m_eventmanager;
 		SoundManager* m_soundmanager;
 		TimeManager* m_timemanager;
+		Profiler* m_profiler;
 		ImageManager* m_imagemanager;
 		AnimationManager* m_animationmanager;
 		SoundClipManager* m_soundclipmanager;
@@ -29,6 +29,7 @@ namespace FIFE {
 	class SoundManager;
 	class EventManager;
 	class TimeManager;
+	class Profiler;
 	class IGUIManager;
 	class RenderBackend;
 	class Model;
@@ -84,6 +85,8 @@ namespace FIFE {
 		bool isGLUseMonochrome() const;
 		void setGLUseDepthBuffer(bool buffer);
 		bool isGLUseDepthBuffer() const;
+		void setGLUseVertexBufferObjects(bool vbo);
+		bool isGLUseVertexBufferObjects() const;
 		void setGLAlphaTestValue(float alpha);
 		float getGLAlphaTestValue() const;
 		void setScreenWidth(uint16_t screenwidth);
@@ -151,6 +154,7 @@ namespace FIFE {
 		SoundManager* getSoundManager();
 		EventManager* getEventManager();
 		TimeManager* getTimeManager();
+		Profiler* getProfiler();
 		void setGuiManager(IGUIManager* guimanager);
 		IGUIManager* getGuiManager();
 		ImageManager* getImageManager();
@@ -60,6 +60,7 @@ namespace FIFE {
 		m_oglMonochrome(false),
 		m_oglTextureFilter(TEXTURE_FILTER_NONE),
 		m_oglDepthBuffer(false),
+		m_oglVertexBufferObjects(false),
 		m_alphaTestValue(0.3),
 		m_screenwidth(800),
 		m_screenheight(600),
@@ -205,6 +206,14 @@ namespace FIFE {
 		return m_oglDepthBuffer;
 	}
 
+	void EngineSettings::setGLUseVertexBufferObjects(bool vbo) {
+		m_oglVertexBufferObjects = vbo;
+	}
+
+	bool EngineSettings::isGLUseVertexBufferObjects() const {
+		return m_oglVertexBufferObjects;
+	}
+
 	void EngineSettings::setGLAlphaTestValue(float alpha) {
 		m_alphaTestValue = alpha;
 	}
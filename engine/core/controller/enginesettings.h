@@ -238,6 +238,14 @@ namespace FIFE {
 		 */
 		bool isGLUseDepthBuffer() const;
 
+		/** Sets if OpenGL renderbackend should stream the vertex data through buffer objects (when available).
+		 */
+		void setGLUseVertexBufferObjects(bool vbo);
+
+		/** Tells if OpenGL renderbackend should stream the vertex data through buffer objects.
+		 */
+		bool isGLUseVertexBufferObjects() const;
+
 		/** Sets alpha test value for OpenGL renderbackend.
 		 */
 		void setGLAlphaTestValue(float alpha);
@@ -449,6 +457,7 @@ namespace FIFE {
 		bool m_oglMonochrome;
 		TextureFiltering m_oglTextureFilter;
 		bool m_oglDepthBuffer;
+		bool m_oglVertexBufferObjects;
 		float m_alphaTestValue;
 		uint16_t m_screenwidth;
 		uint16_t m_screenheight;
@@ -31,6 +31,7 @@
 #include "util/base/exception.h"
 #include "util/log/logger.h"
 #include "util/math/fife_math.h"
+#include "util/time/profiler.h"
 #include "eventchannel/joystick/joystickmanager.h"
 #include "eventchannel/key/key.h"
 #include "eventchannel/key/keyevent.h"
@@ -331,6 +332,7 @@ namespace FIFE {
 	}
 
 	void EventManager::processEvents() {
+		FIFE_PROFILE_ZONE("EventManager::processEvents");
 		// The double SDL_PollEvent calls don't throw away events,
 		// but try to combine (mouse motion) events.
 		SDL_Event event, next_event;
@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 
 // Platform specific includes
 
@@ -77,6 +78,32 @@ namespace FIFE {
 		}
 	}
 
+	/** Source over the shared encoded data of a SoundDecoderOgg.
+	 *
+	 * The data is read-only, so the stream decoders can read it from the
+	 * streaming thread while the archive the file came from is used elsewhere.
+	 */
+	class RawDataSharedSource : public RawDataSource {
+	public:
+		RawDataSharedSource(const std::shared_ptr<const std::vector<uint8_t> >& data) : m_data(data) {
+		}
+
+		virtual uint32_t getSize() const {
+			return static_cast<uint32_t>(m_data->size());
+		}
+
+		virtual void readInto(uint8_t* buffer, uint32_t start, uint32_t length) {
+			std::copy(m_data->begin() + start, m_data->begin() + start + length, buffer);
+		}
+
+		virtual const uint8_t* borrowData() const {
+			return m_data->empty() ? 0 : &(*m_data)[0];
+		}
+
+	private:
+		std::shared_ptr<const std::vector<uint8_t> > m_data;
+	};
+
 	SoundDecoderOgg::SoundDecoderOgg(RawData* rdp) : m_file(rdp) {
 
 		ov_callbacks ocb = {
@@ -142,6 +169,22 @@ namespace FIFE {
 		return false;
 	}
 
+	SoundDecoder* SoundDecoderOgg::createStreamDecoder() {
+		if (!m_encoded) {
+			std::shared_ptr<std::vector<uint8_t> > encoded(new std::vector<uint8_t>());
+			const uint8_t* data = m_file->borrowData();
+			if (data) {
+				encoded->assign(data, data + m_file->getDataLength());
+			} else {
+				IndexSaver saver(m_file.get());
+				m_file->setIndex(0);
+				*encoded = m_file->getDataInBytes();
+			}
+			m_encoded = encoded;
+		}
+		return new SoundDecoderOgg(new RawData(new RawDataSharedSource(m_encoded)));
+	}
+
 	void SoundDecoderOgg::releaseBuffer() {
 		if (m_data != NULL) {
 			delete[] m_data;
@@ -24,6 +24,7 @@
 
 // Standard C++ library includes
 #include <memory>
+#include <vector>
 
 // Platform specific includes
 
@@ -82,8 +83,15 @@ namespace FIFE {
 		 */
 		void releaseBuffer();
 
+		/** Creates a decoder that reads from an in-memory copy of the encoded file.
+		 * The copy is made once and shared by all stream decoders of this file.
+		 */
+		SoundDecoder* createStreamDecoder();
+
 	private:
 		std::unique_ptr<RawData> m_file;
+		// encoded file, shared with the stream decoders
+		std::shared_ptr<const std::vector<uint8_t> > m_encoded;
 		uint64_t m_declength;
 		uint64_t m_datasize;
 		char* m_data;
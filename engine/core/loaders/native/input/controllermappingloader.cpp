@@ -41,9 +41,14 @@ namespace FIFE {
 
 		std::unique_ptr<RawData> data(vfs->open(filename));
 		size_t datalen = data->getDataLength();
-		std::unique_ptr<uint8_t[]> darray(new uint8_t[datalen]);
-		data->readInto(darray.get(), datalen);
-		SDL_RWops* rwops = SDL_RWFromConstMem(darray.get(), static_cast<int>(datalen));
+		const uint8_t* mapped = data->borrowData();
+		std::unique_ptr<uint8_t[]> darray;
+		if (!mapped) {
+			darray.reset(new uint8_t[datalen]);
+			data->readInto(darray.get(), datalen);
+			mapped = darray.get();
+		}
+		SDL_RWops* rwops = SDL_RWFromConstMem(mapped, static_cast<int>(datalen));
 		if (SDL_GameControllerAddMappingsFromRW(rwops, 0) == -1) {
 			throw SDLException(std::string("Error when loading gamecontroller mappings: ") + SDL_GetError());
 		}
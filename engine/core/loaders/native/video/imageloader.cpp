@@ -55,9 +55,15 @@ namespace FIFE {
 			const std::string& filename = img->getName();
 			std::unique_ptr<RawData> data(vfs->open(filename));
 			size_t datalen = data->getDataLength();
-			std::unique_ptr<uint8_t[]> darray(new uint8_t[datalen]);
-			data->readInto(darray.get(), datalen);
-			SDL_RWops* rwops = SDL_RWFromConstMem(darray.get(), static_cast<int>(datalen));
+			// decode directly from the file mapping if possible
+			const uint8_t* mapped = data->borrowData();
+			std::unique_ptr<uint8_t[]> darray;
+			if (!mapped) {
+				darray.reset(new uint8_t[datalen]);
+				data->readInto(darray.get(), datalen);
+				mapped = darray.get();
+			}
+			SDL_RWops* rwops = SDL_RWFromConstMem(mapped, static_cast<int>(datalen));
 
 			SDL_Surface* surface = IMG_Load_RW(rwops, false);
 
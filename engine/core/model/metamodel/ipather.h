@@ -108,6 +108,26 @@ namespace FIFE {
 		 */
 		virtual int32_t getMaxTicks() = 0;
 
+		/** Sets the time budget per update to solve routes. @see update()
+		 * @param time The time in microseconds, 0 means no limit. default is 0
+		 */
+		virtual void setMaxTime(uint32_t time) = 0;
+
+		/** Returns the time budget per update to solve routes. @see update()
+		 * @return The time in microseconds, 0 means no limit. default is 0
+		 */
+		virtual uint32_t getMaxTime() = 0;
+
+		/** Sets if solved paths are smoothed.
+		 * @param smoothing A boolean, if true straight parts of the paths are merged. default is false
+		 */
+		virtual void setPathSmoothing(bool smoothing) = 0;
+
+		/** Gets if solved paths are smoothed.
+		 * @return A boolean, if true straight parts of the paths are merged. default is false
+		 */
+		virtual bool isPathSmoothing() = 0;
+
 		/** Gets the name of this pather
 		 */
 		virtual std::string getName() const = 0;
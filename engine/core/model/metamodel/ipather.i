@@ -25,7 +25,7 @@
 %}
 
 %include "model/structures/instance.i"
-%include "pathfinder/route.h"
+%include "pathfinder/route.i"
 
 namespace FIFE {
 	enum PriorityType {
@@ -45,6 +45,10 @@ namespace FIFE {
 		virtual bool cancelSession(const int32_t sessionId) = 0;
 		virtual void setMaxTicks(int32_t ticks) = 0;
 		virtual int32_t getMaxTicks() = 0;
+		virtual void setMaxTime(uint32_t time) = 0;
+		virtual uint32_t getMaxTime() = 0;
+		virtual void setPathSmoothing(bool smoothing) = 0;
+		virtual bool isPathSmoothing() = 0;
 		virtual std::string getName() const = 0;
 	};
 }
@@ -29,6 +29,7 @@
 // Second block: files included from the same folder
 #include "util/structures/purge.h"
 #include "util/log/logger.h"
+#include "util/time/profiler.h"
 #include "model/metamodel/ipather.h"
 #include "model/metamodel/object.h"
 #include "model/metamodel/grids/cellgrid.h"
@@ -325,6 +326,7 @@ namespace FIFE {
 	}
 
 	void Model::update() {
+		FIFE_PROFILE_ZONE("Model::update");
 		std::list<Map*>::iterator it = m_maps.begin();
 		for(; it != m_maps.end(); ++it) {
 			(*it)->update();
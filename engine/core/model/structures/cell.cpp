@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 
 // 3rd party library includes
 
@@ -44,9 +45,11 @@ namespace FIFE {
 		m_coordinate(coordinate),
 		m_layer(layer),
 		m_zone(NULL),
+		m_zoneIndex(0),
 		m_transition(NULL),
 		m_inserted(false),
-		m_protect(false) {
+		m_protect(false),
+		m_type(CTYPE_NO_BLOCKER) {
 	}
 
 	Cell::~Cell() {
@@ -72,41 +75,42 @@ namespace FIFE {
 	}
 
 	void Cell::addInstances(const std::list<Instance*>& instances) {
-		CellCache* cache = m_layer->getCellCache();
 		for (std::list<Instance*>::const_iterator it = instances.begin(); it != instances.end(); ++it) {
-			std::pair<std::set<Instance*>::iterator, bool> ret = m_instances.insert(*it);
-			if (ret.second) {
-				if ((*it)->isSpecialCost()) {
-					cache->registerCost((*it)->getCostId(), (*it)->getCost());
-					cache->addCellToCost((*it)->getCostId(), this);
-				}
-				if ((*it)->isSpecialSpeed()) {
-					cache->setSpeedMultiplier(this, (*it)->getSpeed());
-				}
-				if ((*it)->getObject()->getArea() != "") {
-					cache->addCellToArea((*it)->getObject()->getArea(), this);
-				}
-				callOnInstanceEntered(*it);
-			}
+			insertInstance(*it);
+		}
+		updateCellBlockingInfo();
+	}
+
+	void Cell::addInstances(std::vector<Instance*>::const_iterator first, std::vector<Instance*>::const_iterator last) {
+		for (; first != last; ++first) {
+			insertInstance(*first);
 		}
 		updateCellBlockingInfo();
 	}
 
+	bool Cell::insertInstance(Instance* instance) {
+		// cells hold only a few instances, so a linear search is cheaper than a set
+		if (std::find(m_instances.begin(), m_instances.end(), instance) != m_instances.end()) {
+			return false;
+		}
+		m_instances.push_back(instance);
+		CellCache* cache = m_layer->getCellCache();
+		if (instance->isSpecialCost()) {
+			cache->registerCost(instance->getCostId(), instance->getCost());
+			cache->addCellToCost(instance->getCostId(), this);
+		}
+		if (instance->isSpecialSpeed()) {
+			cache->setSpeedMultiplier(this, instance->getSpeed());
+		}
+		if (instance->getObject()->getArea() != "") {
+			cache->addCellToArea(instance->getObject()->getArea(), this);
+		}
+		callOnInstanceEntered(instance);
+		return true;
+	}
+
 	void Cell::addInstance(Instance* instance) {
-		std::pair<std::set<Instance*>::iterator, bool> ret = m_instances.insert(instance);
-		if (ret.second) {
-			CellCache* cache = m_layer->getCellCache();
-			if (instance->isSpecialCost()) {
-				cache->registerCost(instance->getCostId(), instance->getCost());
-				cache->addCellToCost(instance->getCostId(), this);
-			}
-			if (instance->isSpecialSpeed()) {
-				cache->setSpeedMultiplier(this, instance->getSpeed());
-			}
-			if (instance->getObject()->getArea() != "") {
-				cache->addCellToArea(instance->getObject()->getArea(), this);
-			}
-			callOnInstanceEntered(instance);
+		if (insertInstance(instance)) {
 			updateCellBlockingInfo();
 		}
 	}
@@ -116,10 +120,13 @@ namespace FIFE {
 	}
 
 	void Cell::removeInstance(Instance* instance) {
-		if (m_instances.erase(instance) == 0) {
+		std::vector<Instance*>::iterator found = std::find(m_instances.begin(), m_instances.end(), instance);
+		if (found == m_instances.end()) {
 			FL_ERR(_log, "Tried to remove an instance from cell, but given instance could not be found.");
 			return;
 		}
+		*found = m_instances.back();
+		m_instances.pop_back();
 		CellCache* cache = m_layer->getCellCache();
 		if (instance->isSpecialCost()) {
 			cache->removeCellFromCost(instance->getCostId(), this);
@@ -128,7 +135,7 @@ namespace FIFE {
 			cache->resetSpeedMultiplier(this);
 			// try to find other speed value
 			if (!m_instances.empty()) {
-				std::set<Instance*>::iterator it = m_instances.begin();
+				std::vector<Instance*>::iterator it = m_instances.begin();
 				for (; it != m_instances.end(); ++it) {
 					if ((*it)->isSpecialSpeed()) {
 						cache->setSpeedMultiplier(this, (*it)->getSpeed());
@@ -160,7 +167,7 @@ namespace FIFE {
 		if (!m_instances.empty()) {
 			int32_t pos = -1;
 			bool cellblock = (m_type == CTYPE_CELL_NO_BLOCKER || m_type == CTYPE_CELL_BLOCKER);
-			for (std::set<Instance*>::iterator it = m_instances.begin(); it != m_instances.end(); ++it) {
+			for (std::vector<Instance*>::iterator it = m_instances.begin(); it != m_instances.end(); ++it) {
 				if (cellblock) {
 					continue;
 				}
@@ -207,6 +214,7 @@ namespace FIFE {
 			bool block = (m_type == CTYPE_STATIC_BLOCKER ||
 				m_type == CTYPE_DYNAMIC_BLOCKER || m_type == CTYPE_CELL_BLOCKER);
 			m_layer->getCellCache()->setBlockingUpdate(true);
+			m_layer->getCellCache()->invalidateFieldsOfView(m_coordinate);
 			callOnBlockingChanged(block);
 		}
 	}
@@ -271,6 +279,14 @@ namespace FIFE {
 		m_zone = NULL;
 	}
 
+	uint32_t Cell::getZoneIndex() const {
+		return m_zoneIndex;
+	}
+
+	void Cell::setZoneIndex(uint32_t index) {
+		m_zoneIndex = index;
+	}
+
 	bool Cell::isInserted() {
 		return m_inserted;
 	}
@@ -292,10 +308,16 @@ namespace FIFE {
 	}
 
 	void Cell::setCellType(CellTypeInfo type) {
-		m_type = type;
+		if (type != m_type) {
+			m_type = type;
+			CellCache* cache = m_layer->getCellCache();
+			if (cache) {
+				cache->invalidateFieldsOfView(m_coordinate);
+			}
+		}
 	}
 
-	const std::set<Instance*>& Cell::getInstances() {
+	const std::vector<Instance*>& Cell::getInstances() {
 		return m_instances;
 	}
 
@@ -137,6 +137,12 @@ namespace FIFE {
 			 * @param instances A const reference to list that contains instances.
 			 */
 			void addInstances(const std::list<Instance*>& instances);
+
+			/** Adds a range of instances to this cell, used by the bulk creation of the CellCache.
+			 * @param first Iterator to the first instance.
+			 * @param last Iterator behind the last instance.
+			 */
+			void addInstances(std::vector<Instance*>::const_iterator first, std::vector<Instance*>::const_iterator last);
 			
 			/** Adds a instance to this cell.
 			 * @param instance A pointer to the instance.
@@ -217,6 +223,16 @@ namespace FIFE {
 			 */
 			void resetZone();
 
+			/** Returns the position of the cell in the cell list of its zone.
+			 * @return A unsigned integer with the position.
+			 */
+			uint32_t getZoneIndex() const;
+
+			/** Sets the position of the cell in the cell list of its zone, only used by the zone.
+			 * @param index A unsigned integer with the position.
+			 */
+			void setZoneIndex(uint32_t index);
+
 			/** Returns whether the cell is part of a zone.
 			 * @return True if the cell is inserted into a zone, otherwise false.
 			 */
@@ -248,9 +264,11 @@ namespace FIFE {
 			void setCellType(CellTypeInfo type);
 
 			/** Returns all instances on this cell.
-			 * @return A const reference to a set that refer to the instances on this cell.
+			 * @note Up to 0.4.2 this returned a std::set (InstanceSet in Python), the
+			 * vector is in insertion order and removing an instance can reorder it.
+			 * @return A const reference to a vector that refer to the instances on this cell.
 			 */
-			const std::set<Instance*>& getInstances();
+			const std::vector<Instance*>& getInstances();
 
 			/** Sets the cell identifier.
 			 * @param id A unique int value that is used as identifier. Based on the cell position.
@@ -353,6 +371,9 @@ namespace FIFE {
 
 			void updateCellBlockingInfo();
 
+			//! inserts the instance and registers its cost, speed and area, returns false if it was already known
+			bool insertInstance(Instance* instance);
+
 			//! holds coordinate as a unique integer id
 			int32_t m_coordId;
 			
@@ -365,6 +386,9 @@ namespace FIFE {
 			//! parent Zone
 			Zone* m_zone;
 
+			//! position in the cell list of the zone
+			uint32_t m_zoneIndex;
+
 			//! Pointer to Transistion
 			TransitionInfo* m_transition;
 
@@ -377,8 +401,8 @@ namespace FIFE {
 			//! CellType
 			CellTypeInfo m_type;
 
-			// contained Instances
-			std::set<Instance*> m_instances;
+			// contained Instances, unordered
+			std::vector<Instance*> m_instances;
 
 			//! neighbor cells
 			std::vector<Cell*> m_neighbors;
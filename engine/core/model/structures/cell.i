@@ -79,7 +79,7 @@ namespace FIFE {
 			double getSpeedMultiplier();
 			void resetSpeedMultiplier();
 			
-			const std::set<Instance*>& getInstances();
+			const std::vector<Instance*>& getInstances();
 			void setCellType(CellTypeInfo type);
 			CellTypeInfo getCellType();
 			Layer* getLayer();
@@ -94,7 +94,6 @@ namespace FIFE {
 }
 
 namespace std {
-	%template(InstanceSet) set<FIFE::Instance*>;
 	%template(CellSet) set<FIFE::Cell*>;
 	%template(CellVector) vector<FIFE::Cell*>;
 }
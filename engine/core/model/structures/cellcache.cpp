@@ -20,6 +20,9 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <new>
+#include <thread>
+#include <unordered_map>
 
 // 3rd party library includes
 
@@ -262,7 +265,7 @@ namespace FIFE {
 	}
 
 	Zone::~Zone() {
-		for (std::set<Cell*>::iterator i = m_cells.begin(); i != m_cells.end(); ++i) {
+		for (std::vector<Cell*>::iterator i = m_cells.begin(); i != m_cells.end(); ++i) {
 			(*i)->resetZone();
 		}
 	}
@@ -270,28 +273,35 @@ namespace FIFE {
 	void Zone::addCell(Cell* cell) {
 		if (!cell->getZone()) {
 			cell->setZone(this);
-			m_cells.insert(cell);
+			cell->setZoneIndex(static_cast<uint32_t>(m_cells.size()));
+			m_cells.push_back(cell);
 		}
 	}
 
 	void Zone::removeCell(Cell* cell) {
-		std::set<Cell*>::iterator i = m_cells.find(cell);
-		if (i != m_cells.end()) {
-			(*i)->resetZone();
-			m_cells.erase(i);
+		if (cell->getZone() != this) {
+			return;
 		}
+		// move the last cell into the gap
+		Cell* last = m_cells.back();
+		m_cells[cell->getZoneIndex()] = last;
+		last->setZoneIndex(cell->getZoneIndex());
+		m_cells.pop_back();
+		cell->resetZone();
 	}
 	
 	void Zone::mergeZone(Zone* zone) {
-		const std::set<Cell*>& cells = zone->getCells();
-		m_cells.insert(cells.begin(), cells.end());
-		for (std::set<Cell*>::const_iterator it = cells.begin(); it != cells.end(); ++it) {
+		const std::vector<Cell*>& cells = zone->getCells();
+		m_cells.reserve(m_cells.size() + cells.size());
+		for (std::vector<Cell*>::const_iterator it = cells.begin(); it != cells.end(); ++it) {
 			(*it)->setZone(this);
+			(*it)->setZoneIndex(static_cast<uint32_t>(m_cells.size()));
+			m_cells.push_back(*it);
 		}
 		zone->resetCells();
 	}
 
-	const std::set<Cell*>& Zone::getCells() const {
+	const std::vector<Cell*>& Zone::getCells() const {
 		return m_cells;
 	}
 
@@ -309,7 +319,7 @@ namespace FIFE {
 
 	std::vector<Cell*> Zone::getTransitionCells(Layer* layer) {
 		std::vector<Cell*> transitions;
-		std::set<Cell*>::iterator it = m_cells.begin();
+		std::vector<Cell*>::iterator it = m_cells.begin();
 		for (; it != m_cells.end(); ++it) {
 			TransitionInfo* trans = (*it)->getTransition();
 			if (!trans) {
@@ -326,6 +336,30 @@ namespace FIFE {
 		return transitions;
 	}
 
+	class RegionCellChangeListener : public CellChangeListener {
+	public:
+		RegionCellChangeListener(CellCache* cache) {
+			m_cache = cache;
+		}
+		virtual ~RegionCellChangeListener() {
+		}
+
+		virtual void onInstanceEnteredCell(Cell* cell, Instance* instance) {
+			m_cache->callOnInstanceEntered(cell, instance);
+		}
+
+		virtual void onInstanceExitedCell(Cell* cell, Instance* instance) {
+			m_cache->callOnInstanceExited(cell, instance);
+		}
+
+		virtual void onBlockingChangedCell(Cell* cell, CellTypeInfo type, bool blocks) {
+			m_cache->callOnBlockingChanged(cell, type, blocks);
+		}
+
+	private:
+		CellCache* m_cache;
+	};
+
 	class ZoneCellChangeListener : public CellChangeListener {
 	public:
 		ZoneCellChangeListener(CellCache* cache) {
@@ -347,20 +381,19 @@ namespace FIFE {
 				cell->setZoneProtected(true);
 				m_cache->splitZone(cell);
 			} else {
-				Zone* z1 = cell->getZone();
-				Zone* z2 = NULL;
+				cell->setZoneProtected(false);
+				if (!cell->getZone()) {
+					return;
+				}
+				// merge all zones around the cell, the bigger zone survives each merge
 				const std::vector<Cell*>& neighbors = cell->getNeighbors();
 				std::vector<Cell*>::const_iterator it = neighbors.begin();
 				for (; it != neighbors.end(); ++it) {
 					Zone* z = (*it)->getZone();
-					if (z && z != z1) {
-						z2 = z;
+					if (z && z != cell->getZone() && (*it)->getLayer() == cell->getLayer()) {
+						m_cache->mergeZones(cell->getZone(), z);
 					}
 				}
-				if (z1 && z2) {
-					cell->setZoneProtected(false);
-					m_cache->mergeZones(z1, z2);
-				}
 			}
 		}
 
@@ -376,9 +409,14 @@ namespace FIFE {
 		m_blockingUpdate(false),
 		m_sizeUpdate(false),
 		m_searchNarrow(true),
-		m_staticSize(false) {
+		m_staticSize(false),
+		m_regionBucketsWidth(0),
+		m_regionCalls(0),
+		m_regionGarbage(false),
+		m_splitGeneration(0) {
 		// create cell change listener
 		m_cellZoneListener = new ZoneCellChangeListener(this);
+		m_cellRegionListener = new RegionCellChangeListener(this);
 		// set base size
 		ModelCoordinate min, max;
 		m_layer->getMinMaxCoordinates(min, max);
@@ -429,6 +467,9 @@ namespace FIFE {
 		// delete listener
 		delete m_cellListener;
 		delete m_cellZoneListener;
+		delete m_cellRegionListener;
+		// delete fields of view
+		purge(m_fieldsOfView);
 	}
 
 	void CellCache::reset() {
@@ -440,6 +481,10 @@ namespace FIFE {
 			}
 			m_zones.clear();
 		}
+		m_zoneTable.clear();
+		m_freeZoneIds = std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t> >();
+		m_splitMarks.clear();
+		m_splitGenerations.clear();
 		// clear all containers
 		m_costsToCells.clear();
 		m_costsTable.clear();
@@ -453,7 +498,7 @@ namespace FIFE {
 			for (; it != m_cells.end(); ++it) {
 				std::vector<Cell*>::iterator cit = (*it).begin();
 				for (; cit != (*it).end(); ++cit) {
-					delete *cit;
+					destroyCell(*cit);
 				}
 			}
 			m_cells.clear();
@@ -491,50 +536,42 @@ namespace FIFE {
 			for (uint32_t i = 0; i < w; ++i) {
 				cells[i].resize(h, NULL);
 			}
-			const std::vector<Layer*>& interacts = m_layer->getInteractLayers();
+			// transfer ownership of the cells which are still in range
+			uint32_t created = 0;
 			for(uint32_t y = 0; y < h; ++y) {
 				for(uint32_t x = 0; x < w; ++x) {
-					// transfer cells
-					ModelCoordinate mc(newsize.x+x, newsize.y+y);
-					Cell* cell = NULL;
-					int32_t old_x = mc.x - m_size.x;
-					int32_t old_y = mc.y - m_size.y;
-					// out of range in the old size, so we create a new cell
+					int32_t old_x = newsize.x + static_cast<int32_t>(x) - m_size.x;
+					int32_t old_y = newsize.y + static_cast<int32_t>(y) - m_size.y;
+					// out of range in the old size, so we create a new cell later
 					if (old_x < 0 || old_x >= static_cast<int32_t>(m_width) || old_y < 0 || old_y >= static_cast<int32_t>(m_height)) {
-						int32_t coordId = x + y * w;
-						cell = new Cell(coordId, mc, m_layer);
-						cells[x][y] = cell;
-
-						std::list<Instance*> cell_instances;
-						m_layer->getInstanceTree()->findInstances(mc, 0, 0, cell_instances);
-						if (!interacts.empty()) {
-							// fill interact Instances into Cell
-							std::vector<Layer*>::const_iterator it = interacts.begin();
-							std::list<Instance*> interact_instances;
-							for(; it != interacts.end(); ++it) {
-								// convert coordinates
-								ExactModelCoordinate emc(FIFE::intPt2doublePt(mc));
-								ModelCoordinate inter_mc = (*it)->getCellGrid()->toLayerCoordinates(m_layer->getCellGrid()->toMapCoordinates(emc));
-								// check interact layer for instances
-								(*it)->getInstanceTree()->findInstances(inter_mc, 0, 0, interact_instances);
-								if (!interact_instances.empty()) {
-									cell_instances.insert(cell_instances.end(), interact_instances.begin(), interact_instances.end());
-									interact_instances.clear();
-								}
-							}
-						}
-						if (!cell_instances.empty()) {
-							// add instances to cell
-							cell->addInstances(cell_instances);
+						++created;
+						continue;
+					}
+					Cell* cell = m_cells[static_cast<uint32_t>(old_x)][static_cast<uint32_t>(old_y)];
+					m_cells[static_cast<uint32_t>(old_x)][static_cast<uint32_t>(old_y)] = NULL;
+					cells[x][y] = cell;
+					cell->setCellId(x + y * w);
+					cell->resetNeighbors();
+				}
+			}
+			// create the new cells in one slab and fill them with the bucketed instances
+			if (created > 0) {
+				std::vector<uint32_t> offsets;
+				std::vector<Instance*> instances;
+				collectInstances(newsize.x, newsize.y, w, h, offsets, instances);
+				Cell* slab = allocateCellSlab(created);
+				for(uint32_t y = 0; y < h; ++y) {
+					for(uint32_t x = 0; x < w; ++x) {
+						if (cells[x][y]) {
+							continue;
 						}
-					// transfer ownership
-					} else {
-						cell = m_cells[static_cast<uint32_t>(old_x)][static_cast<uint32_t>(old_y)];
-						m_cells[static_cast<uint32_t>(old_x)][static_cast<uint32_t>(old_y)] = NULL;
+						ModelCoordinate mc(newsize.x+x, newsize.y+y);
+						uint32_t index = x + y * w;
+						Cell* cell = new (slab++) Cell(index, mc, m_layer);
 						cells[x][y] = cell;
-						int32_t coordId = x + y * w;
-						cell->setCellId(coordId);
-						cell->resetNeighbors();
+						if (offsets[index] != offsets[index+1]) {
+							cell->addInstances(instances.begin() + offsets[index], instances.begin() + offsets[index+1]);
+						}
 					}
 				}
 			}
@@ -544,106 +581,59 @@ namespace FIFE {
 				std::vector<Cell*>::iterator cit = (*it).begin();
 				for (; cit != (*it).end(); ++cit) {
 					if (*cit) {
-						delete *cit;
+						destroyCell(*cit);
 						*cit = NULL;
 					}
 				}
 			}
 			// use new values
-			m_cells = cells;
+			m_cells.swap(cells);
 			m_size = newsize;
 			m_width = w;
 			m_height = h;
 
-			bool zCheck = m_neighborZ != -1;
 			// fill neighbors into cells
-			it = m_cells.begin();
-			for (; it != m_cells.end(); ++it) {
-				std::vector<Cell*>::iterator cit = (*it).begin();
-				for (; cit != (*it).end(); ++cit) {
-					int32_t cellZ = (*cit)->getLayerCoordinates().z;
-					std::vector<ModelCoordinate> coordinates;
-					m_layer->getCellGrid()->getAccessibleCoordinates((*cit)->getLayerCoordinates(), coordinates);
-					for (std::vector<ModelCoordinate>::iterator mi = coordinates.begin(); mi != coordinates.end(); ++mi) {
-						Cell* c = getCell(*mi);
-						if (*cit == c || !c) {
-							continue;
-						}
-						if (zCheck) {
-							if (ABS(c->getLayerCoordinates().z - cellZ) > m_neighborZ) {
-								continue;
-							}
-						}
-						(*cit)->addNeighbor(c);
-					}
-				}
+			connectNeighbors(m_neighborZ != -1, false);
+			invalidateFieldsOfView();
+			if (!m_regions.empty()) {
+				rebuildRegionBuckets();
 			}
 		}
 	}
 
 	void CellCache::createCells() {
-		const std::vector<Layer*>& interacts = m_layer->getInteractLayers();
+		// count the missing cells, so they can be created in one slab
+		uint32_t missing = 0;
+		for(uint32_t x = 0; x < m_width; ++x) {
+			for(uint32_t y = 0; y < m_height; ++y) {
+				if (!m_cells[x][y]) {
+					++missing;
+				}
+			}
+		}
+		Cell* slab = missing > 0 ? allocateCellSlab(missing) : NULL;
+		// fill Instances into Cells
+		std::vector<uint32_t> offsets;
+		std::vector<Instance*> instances;
+		collectInstances(m_size.x, m_size.y, m_width, m_height, offsets, instances);
 		for(uint32_t y = 0; y < m_height; ++y) {
 			for(uint32_t x = 0; x < m_width; ++x) {
-				ModelCoordinate mc(m_size.x+x, m_size.y+y);
-				Cell* cell = getCell(mc);
+				Cell* cell = m_cells[x][y];
 				if (!cell) {
-					cell = new Cell(convertCoordToInt(mc), mc, m_layer);
+					ModelCoordinate mc(m_size.x+x, m_size.y+y);
+					cell = new (slab++) Cell(convertCoordToInt(mc), mc, m_layer);
 					m_cells[x][y] = cell;
 				}
-				// fill Instances into Cell
-				std::list<Instance*> cell_instances;
-				m_layer->getInstanceTree()->findInstances(mc, 0, 0, cell_instances);
-				if (!interacts.empty()) {
-					// fill interact Instances into Cell
-					std::vector<Layer*>::const_iterator it = interacts.begin();
-					std::list<Instance*> interact_instances;
-					for(; it != interacts.end(); ++it) {
-						// convert coordinates
-						ExactModelCoordinate emc(FIFE::intPt2doublePt(mc));
-						ModelCoordinate inter_mc = (*it)->getCellGrid()->toLayerCoordinates(m_layer->getCellGrid()->toMapCoordinates(emc));
-						// check interact layer for instances
-						(*it)->getInstanceTree()->findInstances(inter_mc, 0, 0, interact_instances);
-						if (!interact_instances.empty()) {
-							cell_instances.insert(cell_instances.end(), interact_instances.begin(), interact_instances.end());
-							interact_instances.clear();
-						}
-					}
-				}
-				if (!cell_instances.empty()) {
-					// add instances to cell
-					cell->addInstances(cell_instances);
+				uint32_t index = x + y * m_width;
+				if (offsets[index] != offsets[index+1]) {
+					cell->addInstances(instances.begin() + offsets[index], instances.begin() + offsets[index+1]);
 				}
 			}
 		}
 		// fill neighbors into cells
-		std::vector<std::vector<Cell*> >::iterator it = m_cells.begin();
-		for (; it != m_cells.end(); ++it) {
-			std::vector<Cell*>::iterator cit = (*it).begin();
-			for (; cit != (*it).end(); ++cit) {
-				uint8_t accessible = 0;
-				bool selfblocker = (*cit)->getCellType() == CTYPE_STATIC_BLOCKER || (*cit)->getCellType() == CTYPE_CELL_BLOCKER;
-				std::vector<ModelCoordinate> coordinates;
-				m_layer->getCellGrid()->getAccessibleCoordinates((*cit)->getLayerCoordinates(), coordinates);
-				for (std::vector<ModelCoordinate>::iterator mi = coordinates.begin(); mi != coordinates.end(); ++mi) {
-					Cell* c = getCell(*mi);
-					if (*cit == c || !c) {
-						continue;
-					}
-					if (!selfblocker && c->getCellType() != CTYPE_STATIC_BLOCKER &&
-						c->getCellType() != CTYPE_CELL_BLOCKER) {
-						++accessible;
-					}
-					(*cit)->addNeighbor(c);
-				}
-				// add cell to narrow cells and add listener for zone change
-				if (m_searchNarrow && !selfblocker && accessible < 3) {
-					addNarrowCell(*cit);
-				}
-			}
-		}
+		connectNeighbors(false, m_searchNarrow);
 		// create Zones
-		it = m_cells.begin();
+		std::vector<std::vector<Cell*> >::iterator it = m_cells.begin();
 		for (; it != m_cells.end(); ++it) {
 			std::vector<Cell*>::iterator cit = (*it).begin();
 			for (; cit != (*it).end(); ++cit) {
@@ -677,6 +667,163 @@ namespace FIFE {
 		}
 	}
 
+	void CellCache::collectInstances(int32_t x, int32_t y, uint32_t width, uint32_t height,
+		std::vector<uint32_t>& offsets, std::vector<Instance*>& instances) {
+		// pairs of cell index and instance, in the order they should end up in the cells
+		std::vector<std::pair<uint32_t, Instance*> > found;
+		const std::vector<Instance*>& layerInstances = m_layer->getInstances();
+		found.reserve(layerInstances.size());
+		for (std::vector<Instance*>::const_iterator it = layerInstances.begin(); it != layerInstances.end(); ++it) {
+			ModelCoordinate mc = (*it)->getLocationRef().getLayerCoordinates();
+			int32_t cx = mc.x - x;
+			int32_t cy = mc.y - y;
+			if (cx < 0 || cx >= static_cast<int32_t>(width) || cy < 0 || cy >= static_cast<int32_t>(height)) {
+				continue;
+			}
+			found.push_back(std::make_pair(cx + cy * width, *it));
+		}
+		// the interact layers use their own grids, so each cell is converted once per layer
+		// and looked up in a hash of the interact instances
+		const std::vector<Layer*>& interacts = m_layer->getInteractLayers();
+		for (std::vector<Layer*>::const_iterator lit = interacts.begin(); lit != interacts.end(); ++lit) {
+			const std::vector<Instance*>& interactInstances = (*lit)->getInstances();
+			if (interactInstances.empty()) {
+				continue;
+			}
+			std::unordered_map<uint64_t, std::vector<Instance*> > interactCells;
+			for (std::vector<Instance*>::const_iterator it = interactInstances.begin(); it != interactInstances.end(); ++it) {
+				ModelCoordinate mc = (*it)->getLocationRef().getLayerCoordinates();
+				uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(mc.x)) << 32) | static_cast<uint32_t>(mc.y);
+				interactCells[key].push_back(*it);
+			}
+			CellGrid* grid = m_layer->getCellGrid();
+			CellGrid* interactGrid = (*lit)->getCellGrid();
+			for (uint32_t cy = 0; cy < height; ++cy) {
+				for (uint32_t cx = 0; cx < width; ++cx) {
+					ExactModelCoordinate emc(x + static_cast<int32_t>(cx), y + static_cast<int32_t>(cy));
+					ModelCoordinate inter_mc = interactGrid->toLayerCoordinates(grid->toMapCoordinates(emc));
+					uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(inter_mc.x)) << 32) | static_cast<uint32_t>(inter_mc.y);
+					std::unordered_map<uint64_t, std::vector<Instance*> >::const_iterator hit = interactCells.find(key);
+					if (hit == interactCells.end()) {
+						continue;
+					}
+					for (std::vector<Instance*>::const_iterator it = hit->second.begin(); it != hit->second.end(); ++it) {
+						found.push_back(std::make_pair(cx + cy * width, *it));
+					}
+				}
+			}
+		}
+		// counting sort into the buckets, stable so the order per cell is kept
+		uint32_t cellCount = width * height;
+		offsets.assign(cellCount + 1, 0);
+		for (std::vector<std::pair<uint32_t, Instance*> >::const_iterator it = found.begin(); it != found.end(); ++it) {
+			++offsets[it->first + 1];
+		}
+		for (uint32_t i = 0; i < cellCount; ++i) {
+			offsets[i + 1] += offsets[i];
+		}
+		instances.resize(found.size());
+		std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+		for (std::vector<std::pair<uint32_t, Instance*> >::const_iterator it = found.begin(); it != found.end(); ++it) {
+			instances[cursor[it->first]++] = it->second;
+		}
+	}
+
+	void CellCache::connectNeighbors(bool zCheck, bool findNarrow) {
+		// accessible offsets for each parity of x and y, without the cell itself
+		std::vector<ModelCoordinate> pattern[2][2];
+		CellGrid* grid = m_layer->getCellGrid();
+		for (int32_t px = 0; px < 2; ++px) {
+			for (int32_t py = 0; py < 2; ++py) {
+				std::vector<ModelCoordinate> coordinates;
+				grid->getAccessibleCoordinates(ModelCoordinate(px, py), coordinates);
+				for (std::vector<ModelCoordinate>::iterator mi = coordinates.begin(); mi != coordinates.end(); ++mi) {
+					if (mi->x == px && mi->y == py) {
+						continue;
+					}
+					pattern[px][py].push_back(ModelCoordinate(mi->x - px, mi->y - py));
+				}
+			}
+		}
+		for (uint32_t x = 0; x < m_width; ++x) {
+			for (uint32_t y = 0; y < m_height; ++y) {
+				Cell* cell = m_cells[x][y];
+				const ModelCoordinate& mc = cell->getLayerCoordinates();
+				const std::vector<ModelCoordinate>& offsets = pattern[mc.x & 1][mc.y & 1];
+				bool selfblocker = cell->getCellType() == CTYPE_STATIC_BLOCKER || cell->getCellType() == CTYPE_CELL_BLOCKER;
+				uint8_t accessible = 0;
+				for (std::vector<ModelCoordinate>::const_iterator oit = offsets.begin(); oit != offsets.end(); ++oit) {
+					int32_t nx = static_cast<int32_t>(x) + oit->x;
+					int32_t ny = static_cast<int32_t>(y) + oit->y;
+					if (nx < 0 || nx >= static_cast<int32_t>(m_width) || ny < 0 || ny >= static_cast<int32_t>(m_height)) {
+						continue;
+					}
+					Cell* c = m_cells[static_cast<uint32_t>(nx)][static_cast<uint32_t>(ny)];
+					if (!c) {
+						continue;
+					}
+					if (zCheck && ABS(c->getLayerCoordinates().z - mc.z) > m_neighborZ) {
+						continue;
+					}
+					if (!selfblocker && c->getCellType() != CTYPE_STATIC_BLOCKER &&
+						c->getCellType() != CTYPE_CELL_BLOCKER) {
+						++accessible;
+					}
+					cell->addNeighbor(c);
+				}
+				// add cell to narrow cells and add listener for zone change
+				if (findNarrow && !selfblocker && accessible < 3) {
+					addNarrowCell(cell);
+				}
+			}
+		}
+	}
+
+	Cell* CellCache::allocateCellSlab(uint32_t count) {
+		CellSlab slab;
+		slab.memory = static_cast<uint8_t*>(::operator new(count * sizeof(Cell)));
+		slab.capacity = count;
+		slab.alive = count;
+		std::vector<CellSlab>::iterator it = m_cellSlabs.begin();
+		while (it != m_cellSlabs.end() && it->memory < slab.memory) {
+			++it;
+		}
+		m_cellSlabs.insert(it, slab);
+		return reinterpret_cast<Cell*>(slab.memory);
+	}
+
+	void CellCache::destroyCell(Cell* cell) {
+		uint8_t* address = reinterpret_cast<uint8_t*>(cell);
+		// find the last slab which starts at or before the cell
+		std::vector<CellSlab>::iterator it = m_cellSlabs.end();
+		uint32_t first = 0;
+		uint32_t last = m_cellSlabs.size();
+		while (first < last) {
+			uint32_t middle = first + (last - first) / 2;
+			if (m_cellSlabs[middle].memory <= address) {
+				first = middle + 1;
+			} else {
+				last = middle;
+			}
+		}
+		if (first > 0) {
+			std::vector<CellSlab>::iterator candidate = m_cellSlabs.begin() + (first - 1);
+			if (address < candidate->memory + candidate->capacity * sizeof(Cell)) {
+				it = candidate;
+			}
+		}
+		// cells which were created on their own
+		if (it == m_cellSlabs.end()) {
+			delete cell;
+			return;
+		}
+		cell->~Cell();
+		if (--it->alive == 0) {
+			::operator delete(it->memory);
+			m_cellSlabs.erase(it);
+		}
+	}
+
 	void CellCache::forceUpdate() {
 		std::vector<std::vector<Cell*> >::iterator it = m_cells.begin();
 		for (; it != m_cells.end(); ++it) {
@@ -690,6 +837,7 @@ namespace FIFE {
 	void CellCache::addCell(Cell* cell) {
 		ModelCoordinate mc = cell->getLayerCoordinates();
 		m_cells[(mc.x-m_size.x)][(mc.y-m_size.y)] = cell;
+		invalidateFieldsOfView();
 	}
 
 	Cell* CellCache::createCell(const ModelCoordinate& mc) {
@@ -697,6 +845,7 @@ namespace FIFE {
 		if (!cell) {
 			cell = new Cell(convertCoordToInt(mc), mc, m_layer);
 			m_cells[(mc.x-m_size.x)][(mc.y-m_size.y)] = cell;
+			invalidateFieldsOfView();
 		}
 		return cell;
 	}
@@ -873,18 +1022,7 @@ namespace FIFE {
 	std::vector<Cell*> CellCache::getCellsInRect(const Rect& rec) {
 		std::vector<Cell*> cells;
 		cells.reserve(rec.w * rec.h);
-
-		ModelCoordinate current(rec.x, rec.y);
-		ModelCoordinate target(rec.x+rec.w, rec.y+rec.h);
-		for (; current.y < target.y; ++current.y) {
-			current.x = rec.x;
-			for (; current.x < target.x; ++current.x) {
-				Cell* c = getCell(current);
-				if (c) {
-					cells.push_back(c);
-				}
-			}
-		}
+		addCellsInRect(rec, cells);
 		return cells;
 	}
 
@@ -908,76 +1046,407 @@ namespace FIFE {
 
 	std::vector<Cell*> CellCache::getCellsInCircle(const ModelCoordinate& center, uint16_t radius) {
 		std::vector<Cell*> cells;
-		//radius power 2
-		uint16_t radiusp2 = (radius+1) * radius;
-
-		ModelCoordinate current(center.x-radius, center.y-radius);
-		ModelCoordinate target(center.x+radius, center.y+radius);
-		for (; current.y < center.y; current.y++) {
-			current.x = center.x-radius;
-			for (; current.x < center.x; current.x++) {
-				Cell* c = getCell(current);
-				if (c) {
-					uint16_t dx = center.x - current.x;
-					uint16_t dy = center.y - current.y;
-					uint16_t distance = dx*dx + dy*dy;
-					if (distance <= radiusp2) {
-						cells.push_back(c);
+		addCellsInCircle(center, radius, cells);
+		return cells;
+	}
 
-						current.x = center.x + dx;
-						c = getCell(current);
-						if (c) cells.push_back(c);
+	std::vector<Cell*> CellCache::getCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle) {
+		std::vector<Cell*> cells;
+		addCellsInCircleSegment(center, radius, sangle, eangle, cells);
+		return cells;
+	}
 
-						current.y = center.y + dy;
-						c = getCell(current);
-						if (c) cells.push_back(c);
+	void CellCache::getCellsInRect(const Rect& rec, std::vector<Cell*>& cells) {
+		cells.clear();
+		addCellsInRect(rec, cells);
+	}
 
-						current.x = center.x-dx;
-						c = getCell(current);
-						if (c) cells.push_back(c);
+	void CellCache::getCellsInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Cell*>& cells) {
+		cells.clear();
+		addCellsInCircle(center, radius, cells);
+	}
 
-						current.y = center.y-dy;
+	void CellCache::getCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Cell*>& cells) {
+		cells.clear();
+		addCellsInCircleSegment(center, radius, sangle, eangle, cells);
+	}
+
+	void CellCache::queryCells(SpatialQueryBatch& batch, uint32_t threads) {
+		batch.answerCells(threads, [this](const SpatialQuery& query, std::vector<Cell*>& cells) {
+			switch (query.type) {
+				case SPATIAL_QUERY_RECT:
+					addCellsInRect(query.rect, cells);
+					break;
+				case SPATIAL_QUERY_CIRCLE:
+					addCellsInCircle(query.center, query.radius, cells);
+					break;
+				case SPATIAL_QUERY_CIRCLE_SEGMENT:
+					addCellsInCircleSegment(query.center, query.radius, query.sangle, query.eangle, cells);
+					break;
+			}
+		});
+	}
 
+	FieldOfView* CellCache::createFieldOfView(const ModelCoordinate& observer, uint16_t radius) {
+		FieldOfView* fov = new FieldOfView(this, observer, radius);
+		m_fieldsOfView.push_back(fov);
+		return fov;
+	}
+
+	void CellCache::removeFieldOfView(FieldOfView* fov) {
+		std::vector<FieldOfView*>::iterator it = std::find(m_fieldsOfView.begin(), m_fieldsOfView.end(), fov);
+		if (it != m_fieldsOfView.end()) {
+			delete *it;
+			m_fieldsOfView.erase(it);
+		}
+	}
+
+	const std::vector<FieldOfView*>& CellCache::getFieldsOfView() {
+		return m_fieldsOfView;
+	}
+
+	uint32_t CellCache::updateFieldsOfView(uint32_t threads) {
+		std::vector<FieldOfView*> dirty;
+		std::vector<FieldOfView*>::iterator it = m_fieldsOfView.begin();
+		for (; it != m_fieldsOfView.end(); ++it) {
+			if ((*it)->isDirty()) {
+				dirty.push_back(*it);
+			}
+		}
+		uint32_t count = static_cast<uint32_t>(dirty.size());
+		if (threads > count) {
+			threads = count;
+		}
+		if (threads <= 1) {
+			for (uint32_t i = 0; i < count; ++i) {
+				dirty[i]->update();
+			}
+		} else {
+			// the fields of view only read the cells, every thread takes a contiguous range
+			std::vector<std::thread> workers;
+			workers.reserve(threads);
+			for (uint32_t t = 0; t < threads; ++t) {
+				uint32_t begin = count * t / threads;
+				uint32_t end = count * (t + 1) / threads;
+				workers.push_back(std::thread([&dirty, begin, end]() {
+					for (uint32_t i = begin; i < end; ++i) {
+						dirty[i]->update();
+					}
+				}));
+			}
+			for (uint32_t t = 0; t < threads; ++t) {
+				workers[t].join();
+			}
+		}
+		return count;
+	}
+
+	//! cells per side of a block of the rect listener index, as shift. A block has 64 cells,
+	//! so the covered cells of a rect fit into one uint64_t.
+	static const int32_t REGION_BLOCK_SHIFT = 3;
+	static const int32_t REGION_BLOCK_MASK = (1 << REGION_BLOCK_SHIFT) - 1;
+
+	void CellCache::addCellChangeListener(const Rect& rec, CellChangeListener* listener) {
+		if (rec.w <= 0 || rec.h <= 0) {
+			return;
+		}
+		CellRegion region;
+		region.rect = rec;
+		region.listener = listener;
+		region.cells = 0;
+		if (m_regions.empty()) {
+			rebuildRegionBuckets();
+		}
+		// cells which are not covered yet get the shared listener
+		int32_t left = std::max(rec.x, m_size.x);
+		int32_t top = std::max(rec.y, m_size.y);
+		int32_t right = std::min(rec.x + rec.w, m_size.x + static_cast<int32_t>(m_width));
+		int32_t bottom = std::min(rec.y + rec.h, m_size.y + static_cast<int32_t>(m_height));
+		for (int32_t y = top; y < bottom; ++y) {
+			for (int32_t x = left; x < right; ++x) {
+				Cell* cell = m_cells[x - m_size.x][y - m_size.y];
+				if (cell && !isCellInRegion(ModelCoordinate(x, y))) {
+					cell->addChangeListener(m_cellRegionListener);
+				}
+			}
+		}
+		m_regions.push_back(region);
+		addRegionToBuckets(region);
+	}
+
+	void CellCache::removeCellChangeListener(const Rect& rec, CellChangeListener* listener) {
+		std::vector<CellRegion>::iterator it = m_regions.begin();
+		for (; it != m_regions.end(); ++it) {
+			if (it->listener == listener && it->rect == rec) {
+				break;
+			}
+		}
+		if (it == m_regions.end()) {
+			return;
+		}
+		m_regions.erase(it);
+		int32_t left = std::max(rec.x - m_size.x, 0);
+		int32_t top = std::max(rec.y - m_size.y, 0);
+		int32_t right = std::min(rec.x + rec.w - m_size.x, static_cast<int32_t>(m_width)) - 1;
+		int32_t bottom = std::min(rec.y + rec.h - m_size.y, static_cast<int32_t>(m_height)) - 1;
+		if (left > right || top > bottom) {
+			return;
+		}
+		for (int32_t by = top >> REGION_BLOCK_SHIFT; by <= (bottom >> REGION_BLOCK_SHIFT); ++by) {
+			for (int32_t bx = left >> REGION_BLOCK_SHIFT; bx <= (right >> REGION_BLOCK_SHIFT); ++bx) {
+				std::vector<CellRegion>& regions = m_regionBuckets[bx + by * m_regionBucketsWidth];
+				for (std::vector<CellRegion>::iterator rit = regions.begin(); rit != regions.end(); ++rit) {
+					if (rit->listener == listener && rit->rect == rec) {
+						if (m_regionCalls > 0) {
+							// listeners are running, the vector must stay as it is
+							rit->listener = NULL;
+							rit->cells = 0;
+							m_regionGarbage = true;
+						} else {
+							regions.erase(rit);
+						}
+						break;
 					}
 				}
 			}
 		}
-		current.x = center.x;
-		current.y = center.y-radius;
-		for (; current.y <= target.y; current.y++) {
-			Cell* c = getCell(current);
-			if (c) cells.push_back(c);
+		// cells which are not covered anymore lose the shared listener
+		for (int32_t y = top; y <= bottom; ++y) {
+			for (int32_t x = left; x <= right; ++x) {
+				Cell* cell = m_cells[x][y];
+				if (cell && !isCellInRegion(ModelCoordinate(m_size.x + x, m_size.y + y))) {
+					cell->removeChangeListener(m_cellRegionListener);
+				}
+			}
 		}
+	}
 
-		current.y = center.y;
-		current.x = center.x-radius;
-		for (; current.x <= target.x; current.x++) {
-			Cell* c = getCell(current);
-			if (c) cells.push_back(c);
+	void CellCache::addRegionToBuckets(const CellRegion& region) {
+		const Rect& rec = region.rect;
+		// only the part inside of the cache can get events
+		int32_t left = std::max(rec.x - m_size.x, 0);
+		int32_t top = std::max(rec.y - m_size.y, 0);
+		int32_t right = std::min(rec.x + rec.w - m_size.x, static_cast<int32_t>(m_width)) - 1;
+		int32_t bottom = std::min(rec.y + rec.h - m_size.y, static_cast<int32_t>(m_height)) - 1;
+		if (left > right || top > bottom) {
+			return;
+		}
+		CellRegion part = region;
+		for (int32_t by = top >> REGION_BLOCK_SHIFT; by <= (bottom >> REGION_BLOCK_SHIFT); ++by) {
+			int32_t firstRow = std::max(top - (by << REGION_BLOCK_SHIFT), 0);
+			int32_t lastRow = std::min(bottom - (by << REGION_BLOCK_SHIFT), REGION_BLOCK_MASK);
+			for (int32_t bx = left >> REGION_BLOCK_SHIFT; bx <= (right >> REGION_BLOCK_SHIFT); ++bx) {
+				int32_t firstColumn = std::max(left - (bx << REGION_BLOCK_SHIFT), 0);
+				int32_t lastColumn = std::min(right - (bx << REGION_BLOCK_SHIFT), REGION_BLOCK_MASK);
+				uint64_t row = ((uint64_t(1) << (lastColumn - firstColumn + 1)) - 1) << firstColumn;
+				part.cells = 0;
+				for (int32_t y = firstRow; y <= lastRow; ++y) {
+					part.cells |= row << (y << REGION_BLOCK_SHIFT);
+				}
+				m_regionBuckets[bx + by * m_regionBucketsWidth].push_back(part);
+			}
 		}
-		return cells;
 	}
 
-	std::vector<Cell*> CellCache::getCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle) {
-		std::vector<Cell*> cells;
+	void CellCache::rebuildRegionBuckets() {
+		uint32_t blockSize = 1 << REGION_BLOCK_SHIFT;
+		m_regionBucketsWidth = (m_width + blockSize - 1) >> REGION_BLOCK_SHIFT;
+		uint32_t height = (m_height + blockSize - 1) >> REGION_BLOCK_SHIFT;
+		m_regionBuckets.clear();
+		m_regionBuckets.resize(m_regionBucketsWidth * height);
+		m_regionGarbage = false;
+		if (m_regions.empty()) {
+			return;
+		}
+		// kept cells already have the shared listener, new cells not, so all covered cells get it again
+		std::vector<bool> covered(m_width * m_height, false);
+		std::vector<CellRegion>::iterator it = m_regions.begin();
+		for (; it != m_regions.end(); ++it) {
+			addRegionToBuckets(*it);
+			const Rect& rec = it->rect;
+			int32_t left = std::max(rec.x - m_size.x, 0);
+			int32_t top = std::max(rec.y - m_size.y, 0);
+			int32_t right = std::min(rec.x + rec.w - m_size.x, static_cast<int32_t>(m_width));
+			int32_t bottom = std::min(rec.y + rec.h - m_size.y, static_cast<int32_t>(m_height));
+			for (int32_t y = top; y < bottom; ++y) {
+				for (int32_t x = left; x < right; ++x) {
+					Cell* cell = m_cells[x][y];
+					if (cell && !covered[x + y * m_width]) {
+						covered[x + y * m_width] = true;
+						cell->removeChangeListener(m_cellRegionListener);
+						cell->addChangeListener(m_cellRegionListener);
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<CellCache::CellRegion>* CellCache::getRegionBucket(Cell* cell, uint64_t& bit) {
+		const ModelCoordinate mc = cell->getLayerCoordinates();
+		int32_t x = mc.x - m_size.x;
+		int32_t y = mc.y - m_size.y;
+		if (x < 0 || x >= static_cast<int32_t>(m_width) || y < 0 || y >= static_cast<int32_t>(m_height)) {
+			return NULL;
+		}
+		bit = uint64_t(1) << ((x & REGION_BLOCK_MASK) + ((y & REGION_BLOCK_MASK) << REGION_BLOCK_SHIFT));
+		return &m_regionBuckets[(x >> REGION_BLOCK_SHIFT) + (y >> REGION_BLOCK_SHIFT) * m_regionBucketsWidth];
+	}
+
+	bool CellCache::isCellInRegion(const ModelCoordinate& mc) {
+		int32_t x = mc.x - m_size.x;
+		int32_t y = mc.y - m_size.y;
+		uint64_t bit = uint64_t(1) << ((x & REGION_BLOCK_MASK) + ((y & REGION_BLOCK_MASK) << REGION_BLOCK_SHIFT));
+		const std::vector<CellRegion>& regions = m_regionBuckets[(x >> REGION_BLOCK_SHIFT) + (y >> REGION_BLOCK_SHIFT) * m_regionBucketsWidth];
+		std::vector<CellRegion>::const_iterator it = regions.begin();
+		for (; it != regions.end(); ++it) {
+			if (it->cells & bit) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void CellCache::callOnInstanceEntered(Cell* cell, Instance* instance) {
+		uint64_t bit = 0;
+		std::vector<CellRegion>* regions = getRegionBucket(cell, bit);
+		if (!regions) {
+			return;
+		}
+		++m_regionCalls;
+		// the listeners can add regions, so the vector is indexed instead of iterated
+		for (std::vector<CellRegion>::size_type i = 0; i < regions->size(); ++i) {
+			if ((*regions)[i].cells & bit) {
+				(*regions)[i].listener->onInstanceEnteredCell(cell, instance);
+			}
+		}
+		if (--m_regionCalls == 0 && m_regionGarbage) {
+			purgeCellRegions();
+		}
+	}
+
+	void CellCache::callOnInstanceExited(Cell* cell, Instance* instance) {
+		uint64_t bit = 0;
+		std::vector<CellRegion>* regions = getRegionBucket(cell, bit);
+		if (!regions) {
+			return;
+		}
+		++m_regionCalls;
+		for (std::vector<CellRegion>::size_type i = 0; i < regions->size(); ++i) {
+			if ((*regions)[i].cells & bit) {
+				(*regions)[i].listener->onInstanceExitedCell(cell, instance);
+			}
+		}
+		if (--m_regionCalls == 0 && m_regionGarbage) {
+			purgeCellRegions();
+		}
+	}
+
+	void CellCache::callOnBlockingChanged(Cell* cell, CellTypeInfo type, bool blocks) {
+		uint64_t bit = 0;
+		std::vector<CellRegion>* regions = getRegionBucket(cell, bit);
+		if (!regions) {
+			return;
+		}
+		++m_regionCalls;
+		for (std::vector<CellRegion>::size_type i = 0; i < regions->size(); ++i) {
+			if ((*regions)[i].cells & bit) {
+				(*regions)[i].listener->onBlockingChangedCell(cell, type, blocks);
+			}
+		}
+		if (--m_regionCalls == 0 && m_regionGarbage) {
+			purgeCellRegions();
+		}
+	}
+
+	void CellCache::purgeCellRegions() {
+		std::vector<std::vector<CellRegion> >::iterator it = m_regionBuckets.begin();
+		for (; it != m_regionBuckets.end(); ++it) {
+			std::vector<CellRegion>& regions = *it;
+			std::vector<CellRegion>::iterator out = regions.begin();
+			for (std::vector<CellRegion>::iterator rit = regions.begin(); rit != regions.end(); ++rit) {
+				if (rit->listener) {
+					*out++ = *rit;
+				}
+			}
+			regions.erase(out, regions.end());
+		}
+		m_regionGarbage = false;
+	}
+
+	void CellCache::invalidateFieldsOfView(const ModelCoordinate& mc) {
+		std::vector<FieldOfView*>::iterator it = m_fieldsOfView.begin();
+		for (; it != m_fieldsOfView.end(); ++it) {
+			(*it)->onBlockingChanged(mc);
+		}
+	}
+
+	void CellCache::invalidateFieldsOfView() {
+		std::vector<FieldOfView*>::iterator it = m_fieldsOfView.begin();
+		for (; it != m_fieldsOfView.end(); ++it) {
+			(*it)->setDirty();
+		}
+	}
+
+	void CellCache::addCellsInRect(const Rect& rec, std::vector<Cell*>& cells) {
+		// clip the rect to the cache
+		int32_t left = std::max(rec.x, m_size.x);
+		int32_t top = std::max(rec.y, m_size.y);
+		int32_t right = std::min(rec.x + rec.w, m_size.x + static_cast<int32_t>(m_width));
+		int32_t bottom = std::min(rec.y + rec.h, m_size.y + static_cast<int32_t>(m_height));
+		for (int32_t y = top; y < bottom; ++y) {
+			for (int32_t x = left; x < right; ++x) {
+				Cell* c = m_cells[x - m_size.x][y - m_size.y];
+				if (c) {
+					cells.push_back(c);
+				}
+			}
+		}
+	}
+
+	void CellCache::addCellsInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Cell*>& cells) {
+		int32_t r = radius;
+		int32_t radiusp2 = (r + 1) * r;
+		// clip the bounding box of the circle to the cache
+		int32_t left = std::max(center.x - r, m_size.x);
+		int32_t top = std::max(center.y - r, m_size.y);
+		int32_t right = std::min(center.x + r + 1, m_size.x + static_cast<int32_t>(m_width));
+		int32_t bottom = std::min(center.y + r + 1, m_size.y + static_cast<int32_t>(m_height));
+		for (int32_t y = top; y < bottom; ++y) {
+			int32_t dy = y - center.y;
+			for (int32_t x = left; x < right; ++x) {
+				int32_t dx = x - center.x;
+				if (dx*dx + dy*dy > radiusp2) {
+					continue;
+				}
+				Cell* c = m_cells[x - m_size.x][y - m_size.y];
+				if (c) {
+					cells.push_back(c);
+				}
+			}
+		}
+	}
+
+	void CellCache::addCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Cell*>& cells) {
+		std::vector<Cell*>::size_type first = cells.size();
+		addCellsInCircle(center, radius, cells);
 		ExactModelCoordinate exactCenter(center.x, center.y);
-		std::vector<Cell*> tmpCells = getCellsInCircle(center, radius);
 		int32_t s = (sangle + 360) % 360;
 		int32_t e = (eangle + 360) % 360;
 		bool greater = (s > e) ? true : false;
-		for (std::vector<Cell*>::iterator it = tmpCells.begin(); it != tmpCells.end(); ++it) {
+		std::vector<Cell*>::iterator out = cells.begin() + first;
+		for (std::vector<Cell*>::iterator it = out; it != cells.end(); ++it) {
 			int32_t angle = getAngleBetween(exactCenter, intPt2doublePt((*it)->getLayerCoordinates()));
 			if (greater) {
 				if (angle >= s || angle <= e) {
-					cells.push_back(*it);
+					*out++ = *it;
 				}
 			} else {
 				if (angle >= s && angle <= e) {
-					cells.push_back(*it);
+					*out++ = *it;
 				}
 			}
 		}
-		return cells;
+		cells.erase(out, cells.end());
 	}
 
 	void CellCache::registerCost(const std::string& costId, double cost) {
@@ -1258,22 +1727,22 @@ namespace FIFE {
 	}
 
 	Zone* CellCache::createZone() {
-		uint32_t id = 0;
-		bool search = true;
-		while (search) {
-			bool found = false;
-			if (!m_zones.empty()) {
-				for (std::vector<Zone*>::iterator i = m_zones.begin(); i != m_zones.end(); ++i) {
-					if ((*i)->getId() == id) {
-						found = true;
-						++id;
-						break;
-					}
-				}
+		// take the lowest free identifier, entries which were taken by getZone() are skipped
+		uint32_t id = static_cast<uint32_t>(m_zoneTable.size());
+		while (!m_freeZoneIds.empty()) {
+			uint32_t freeId = m_freeZoneIds.top();
+			m_freeZoneIds.pop();
+			if (!m_zoneTable[freeId]) {
+				id = freeId;
+				break;
 			}
-			search = found;
 		}
 		Zone* zi = new Zone(id);
+		if (id == m_zoneTable.size()) {
+			m_zoneTable.push_back(zi);
+		} else {
+			m_zoneTable[id] = zi;
+		}
 		m_zones.push_back(zi);
 
 		return zi;
@@ -1284,18 +1753,20 @@ namespace FIFE {
 	}
 
 	Zone* CellCache::getZone(uint32_t id) {
-		Zone* zi = 0;
-		for (std::vector<Zone*>::iterator i = m_zones.begin(); i != m_zones.end(); ++i) {
-			if ((*i)->getId() == id) {
-				zi = (*i);
-				break;
-			}
+		if (id < m_zoneTable.size() && m_zoneTable[id]) {
+			return m_zoneTable[id];
 		}
 
-		if (!zi) {
-			zi = new Zone(id);
-			m_zones.push_back(zi);
+		// the identifiers in between are free
+		for (uint32_t i = static_cast<uint32_t>(m_zoneTable.size()); i < id; ++i) {
+			m_freeZoneIds.push(i);
+		}
+		if (id >= m_zoneTable.size()) {
+			m_zoneTable.resize(id + 1, NULL);
 		}
+		Zone* zi = new Zone(id);
+		m_zoneTable[id] = zi;
+		m_zones.push_back(zi);
 
 		return zi;
 	}
@@ -1303,6 +1774,8 @@ namespace FIFE {
 	void CellCache::removeZone(Zone* zone) {
 		for (std::vector<Zone*>::iterator i = m_zones.begin(); i != m_zones.end(); ++i) {
 			if (*i == zone) {
+				m_zoneTable[zone->getId()] = NULL;
+				m_freeZoneIds.push(zone->getId());
 				delete *i;
 				m_zones.erase(i);
 				break;
@@ -1316,41 +1789,112 @@ namespace FIFE {
 			return;
 		}
 
-		Zone* newZone = createZone();
-		std::stack<Cell*> cellstack;
+		// a new generation invalidates the marks of the last split
+		uint32_t cellCount = m_width * m_height;
+		if (m_splitMarks.size() != cellCount) {
+			m_splitMarks.assign(cellCount, 0);
+			m_splitGenerations.assign(cellCount, 0);
+			m_splitGeneration = 0;
+		}
+		if (++m_splitGeneration == 0) {
+			std::fill(m_splitGenerations.begin(), m_splitGenerations.end(), 0);
+			m_splitGeneration = 1;
+		}
+
+		// start a fill from every open neighbor
+		uint32_t searches = 0;
 		const std::vector<Cell*>& neighbors = cell->getNeighbors();
 		for (std::vector<Cell*>::const_iterator nit = neighbors.begin(); nit != neighbors.end(); ++nit) {
 			Cell* nc = *nit;
-			if (nc->isInserted() && !nc->isZoneProtected() &&
-				nc->getCellType() != CTYPE_STATIC_BLOCKER && nc->getCellType() != CTYPE_CELL_BLOCKER) {
-					cellstack.push(nc);
-					break;
+			if (nc->getZone() != currentZone || nc->isZoneProtected() ||
+				nc->getCellType() == CTYPE_STATIC_BLOCKER || nc->getCellType() == CTYPE_CELL_BLOCKER) {
+				continue;
 			}
-		}
-
-		while(!cellstack.empty()) {
-			Cell* c = cellstack.top();
-			cellstack.pop();
-
-			currentZone->removeCell(c);
-			newZone->addCell(c);
-			c->setInserted(true);
-			if (c->isZoneProtected()) {
+			uint32_t id = static_cast<uint32_t>(nc->getCellId());
+			if (m_splitGenerations[id] == m_splitGeneration) {
 				continue;
 			}
-			const std::vector<Cell*>& neigh = c->getNeighbors();
-			for (std::vector<Cell*>::const_iterator nit = neigh.begin(); nit != neigh.end(); ++nit) {
-				Cell* nc = *nit;
-				if (nc->getZone() == currentZone && nc->isInserted() &&
-					nc->getCellType() != CTYPE_STATIC_BLOCKER && nc->getCellType() != CTYPE_CELL_BLOCKER) {
-					cellstack.push(nc);
-					nc->setInserted(false);
+			m_splitGenerations[id] = m_splitGeneration;
+			m_splitMarks[id] = searches;
+			if (m_splitSearches.size() <= searches) {
+				m_splitSearches.resize(searches + 1);
+			}
+			SplitSearch& search = m_splitSearches[searches];
+			search.cells.clear();
+			search.cells.push_back(nc);
+			search.head = 0;
+			search.parent = searches;
+			search.pending = 1;
+			++searches;
+		}
+
+		// advance the fills in lockstep until only one part is left
+		uint32_t active = searches;
+		while (active > 1) {
+			for (uint32_t i = 0; i < searches && active > 1; ++i) {
+				SplitSearch& search = m_splitSearches[i];
+				if (search.head >= search.cells.size()) {
+					continue;
+				}
+				Cell* c = search.cells[search.head++];
+				// protected cells belong to a part, but don't connect parts
+				if (!c->isZoneProtected()) {
+					const std::vector<Cell*>& neigh = c->getNeighbors();
+					for (std::vector<Cell*>::const_iterator nit = neigh.begin(); nit != neigh.end(); ++nit) {
+						Cell* nc = *nit;
+						if (nc->getZone() != currentZone ||
+							nc->getCellType() == CTYPE_STATIC_BLOCKER || nc->getCellType() == CTYPE_CELL_BLOCKER) {
+							continue;
+						}
+						uint32_t id = static_cast<uint32_t>(nc->getCellId());
+						if (m_splitGenerations[id] != m_splitGeneration) {
+							m_splitGenerations[id] = m_splitGeneration;
+							m_splitMarks[id] = i;
+							search.cells.push_back(nc);
+						} else if (!nc->isZoneProtected()) {
+							// met another fill, so both are connected
+							uint32_t root = findSplitSearch(i);
+							uint32_t other = findSplitSearch(m_splitMarks[id]);
+							if (root != other && m_splitSearches[other].pending > 0) {
+								m_splitSearches[other].parent = root;
+								m_splitSearches[root].pending += m_splitSearches[other].pending;
+								--active;
+							}
+						}
+					}
+				}
+				if (search.head < search.cells.size()) {
+					continue;
+				}
+				// the fill ran out, if the united fills all did then they are a separate part
+				uint32_t root = findSplitSearch(i);
+				if (--m_splitSearches[root].pending > 0) {
+					continue;
+				}
+				--active;
+				Zone* newZone = createZone();
+				for (uint32_t j = 0; j < searches; ++j) {
+					if (findSplitSearch(j) != root) {
+						continue;
+					}
+					std::vector<Cell*>& cells = m_splitSearches[j].cells;
+					for (std::vector<Cell*>::iterator cit = cells.begin(); cit != cells.end(); ++cit) {
+						currentZone->removeCell(*cit);
+						newZone->addCell(*cit);
+						(*cit)->setInserted(true);
+					}
 				}
 			}
 		}
-		if (currentZone->getCellCount() == 0) {
-			removeZone(currentZone);
+	}
+
+	uint32_t CellCache::findSplitSearch(uint32_t search) {
+		while (m_splitSearches[search].parent != search) {
+			// path halving
+			m_splitSearches[search].parent = m_splitSearches[m_splitSearches[search].parent].parent;
+			search = m_splitSearches[search].parent;
 		}
+		return search;
 	}
 
 	void CellCache::mergeZones(Zone* zone1, Zone* zone2) {
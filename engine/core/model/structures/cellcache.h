@@ -24,6 +24,8 @@
 
 // Standard C++ library includes
 #include <algorithm>
+#include <functional>
+#include <queue>
 #include <string>
 #include <vector>
 #include <set>
@@ -42,6 +44,7 @@
 
 #include "layer.h"
 #include "cell.h"
+#include "fieldofview.h"
 
 namespace FIFE {
 
@@ -63,20 +66,21 @@ namespace FIFE {
 		 */
 		void addCell(Cell* cell);
 
-		/** Removes a cell from this zone.
+		/** Removes a cell from this zone. The last cell takes the place of the removed one.
 		 * @param cell A pointer to cell which should be removed.
 		 */
 		void removeCell(Cell* cell);
 
-		/** Merge two zones to one.
+		/** Merge two zones to one. The cells of the given zone are appended,
+		 * so the smaller zone should be merged into the bigger one.
 		 * @param zone A pointer to the old zone.
 		 */
 		void mergeZone(Zone* zone);
 
 		/** Returns all cells of this zone.
-		 * @return A const reference to a set that contains all cells of this zone.
+		 * @return A const reference to a vector that contains all cells of this zone, in no particular order.
 		 */
-		const std::set<Cell*>& getCells() const;
+		const std::vector<Cell*>& getCells() const;
 
 		/** Remove all cells from zone but does not alter the cells.
 		 */
@@ -101,8 +105,8 @@ namespace FIFE {
 	private:
 		//! identifier
 		uint32_t m_id;
-		//! cells in the zone
-		std::set<Cell*> m_cells;
+		//! cells in the zone, each cell knows its position
+		std::vector<Cell*> m_cells;
 	};
 
 	/** A CellCache is an abstract depiction of one or a few layers
@@ -281,6 +285,97 @@ namespace FIFE {
 			 */
 			std::vector<Cell*> getCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle);
 
+			/** Fills a vector with all cells in the rect, the vector is cleared first.
+			 * @param rec A const reference to the Rect which specifies the size.
+			 * @param cells A reference to the vector that receives the cells.
+			 */
+			void getCellsInRect(const Rect& rec, std::vector<Cell*>& cells);
+
+			/** Fills a vector with all cells in the circle, the vector is cleared first.
+			 * @param center A const reference to the ModelCoordinate where the center of the circle is.
+			 * @param radius A unsigned integer, radius of the circle.
+			 * @param cells A reference to the vector that receives the cells.
+			 */
+			void getCellsInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Cell*>& cells);
+
+			/** Fills a vector with all cells in the circle segment, the vector is cleared first.
+			 * @param center A const reference to the ModelCoordinate where the center of the circle is.
+			 * @param radius A unsigned integer, radius of the circle.
+			 * @param sangle A interger, start angle of the segment.
+			 * @param eangle A interger, end angle of the segment.
+			 * @param cells A reference to the vector that receives the cells.
+			 */
+			void getCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Cell*>& cells);
+
+			/** Answers all queries of the batch with the cells of this cache.
+			 * @param batch A reference to the batch with the queries, it receives the results.
+			 * @param threads The number of threads which share the queries. The cache must not be changed meanwhile.
+			 */
+			void queryCells(SpatialQueryBatch& batch, uint32_t threads = 1);
+
+			/** Creates a field of view for an observer, it is owned by the cache.
+			 * @param observer A const reference to the ModelCoordinate of the observer.
+			 * @param radius A unsigned integer, the view radius.
+			 * @return A pointer to the new field of view, it is computed on the next update.
+			 */
+			FieldOfView* createFieldOfView(const ModelCoordinate& observer, uint16_t radius);
+
+			/** Removes and deletes a field of view.
+			 * @param fov A pointer to the field of view.
+			 */
+			void removeFieldOfView(FieldOfView* fov);
+
+			/** Returns all fields of view of this cache.
+			 * @return A const reference to a vector that contains the fields of view.
+			 */
+			const std::vector<FieldOfView*>& getFieldsOfView();
+
+			/** Recomputes all dirty fields of view.
+			 * @param threads The number of threads which share the work. The cache must not be changed meanwhile.
+			 * @return The number of recomputed fields of view.
+			 */
+			uint32_t updateFieldsOfView(uint32_t threads = 1);
+
+			/** Adds a change listener for all cells in the rect. Unlike Cell::addChangeListener
+			 * the listener is registered once for the whole rect, in a bucketed index of the cache.
+			 * The cells of the rect only get one shared listener of the cache, no matter
+			 * how many rects cover them. The same listener can be added for several rects.
+			 * @param rec A const reference to the rect, the right and bottom border are excluded as in getCellsInRect().
+			 * @param listener A pointer to the listener.
+			 */
+			void addCellChangeListener(const Rect& rec, CellChangeListener* listener);
+
+			/** Removes a change listener which was added for the rect.
+			 * @param rec A const reference to the rect which was used to add the listener.
+			 * @param listener A pointer to the listener.
+			 */
+			void removeCellChangeListener(const Rect& rec, CellChangeListener* listener);
+
+			/** Calls the rect listeners which contain the cell.
+			 * @see CellChangeListener
+			 */
+			void callOnInstanceEntered(Cell* cell, Instance* instance);
+
+			/** Calls the rect listeners which contain the cell.
+			 * @see CellChangeListener
+			 */
+			void callOnInstanceExited(Cell* cell, Instance* instance);
+
+			/** Calls the rect listeners which contain the cell.
+			 * @see CellChangeListener
+			 */
+			void callOnBlockingChanged(Cell* cell, CellTypeInfo type, bool blocks);
+
+			/** Informs the fields of view that the blocking of a cell changed.
+			 * Only the fields of view that see the cell become dirty.
+			 * @param mc A const reference to the ModelCoordinate of the cell.
+			 */
+			void invalidateFieldsOfView(const ModelCoordinate& mc);
+
+			/** Marks all fields of view dirty, e.g. after cells were added or removed.
+			 */
+			void invalidateFieldsOfView();
+
 			/** Adds a cost with the given id and value.
 			 * @param costId A const reference to a string that refs to the cost id.
 			 * @param cost A double that contains the cost value. Used as multiplier for default cost.
@@ -485,7 +580,10 @@ namespace FIFE {
 			 */
 			void removeZone(Zone* zone);
 
-			/** Splits zone on the cell.
+			/** Splits zone on the cell. A flood fill is started from every open neighbor
+			 * and they advance in lockstep. Fills which meet are united, a fill which runs out
+			 * first is a separate part and gets a new zone. The search stops as soon as only one
+			 * fill is left, so only the smaller parts are visited.
 			 * @param cell A pointer to the cell where the zone should be splited.
 			 */
 			void splitZone(Cell* cell);
@@ -615,7 +713,64 @@ namespace FIFE {
 			 * @return A rect that contains the min, max coordinates.
 			 */
 			Rect calculateCurrentSize();
-			
+
+			//! appends the cells in the rect
+			void addCellsInRect(const Rect& rec, std::vector<Cell*>& cells);
+
+			//! appends the cells in the circle
+			void addCellsInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Cell*>& cells);
+
+			//! appends the cells in the circle segment
+			void addCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Cell*>& cells);
+
+			/** Sorts the instances of the layer and its interact layers into buckets, one per cell
+			 * of the given area. The instances of cell (x, y) are found between
+			 * offsets[x + y * width] and offsets[x + y * width + 1].
+			 * @param x The first x coordinate of the area.
+			 * @param y The first y coordinate of the area.
+			 * @param width The width of the area in cells.
+			 * @param height The height of the area in cells.
+			 * @param offsets The bucket offsets, width * height + 1 entries.
+			 * @param instances The bucketed instances, own layer first, then the interact layers.
+			 */
+			void collectInstances(int32_t x, int32_t y, uint32_t width, uint32_t height,
+				std::vector<uint32_t>& offsets, std::vector<Instance*>& instances);
+
+			/** Wires the neighbors of all cells in one sweep. The grids only differ by the parity
+			 * of the coordinate, so the accessible offsets are taken once for each parity.
+			 * @param zCheck If true then cells with a larger z difference than the neighbor z are skipped.
+			 * @param findNarrow If true then cells with less than three accessible neighbors are added as narrow cells.
+			 */
+			void connectNeighbors(bool zCheck, bool findNarrow);
+
+			/** Allocates a slab for the given number of cells. The caller has to construct
+			 * exactly that number of cells with placement new.
+			 * @param count The number of cells.
+			 * @return Pointer to the uninitialized storage.
+			 */
+			Cell* allocateCellSlab(uint32_t count);
+
+			/** Returns the root of a split search, see splitZone.
+			 * @param search The index of the search.
+			 * @return The index of the search which represents the united searches.
+			 */
+			uint32_t findSplitSearch(uint32_t search);
+
+			/** Destroys a cell, regardless of whether it lives in a slab or was created on its own.
+			 * @param cell The cell.
+			 */
+			void destroyCell(Cell* cell);
+
+			//! memory block for bulk created cells
+			struct CellSlab {
+				//! raw memory
+				uint8_t* memory;
+				//! number of cells which fit into the slab
+				uint32_t capacity;
+				//! number of cells which are still alive
+				uint32_t alive;
+			};
+
 			//! walkable layer
 			Layer* m_layer;
 
@@ -671,6 +826,50 @@ namespace FIFE {
 			//! listener for zones
 			CellChangeListener* m_cellZoneListener;
 
+			//! fields of view of observers
+			std::vector<FieldOfView*> m_fieldsOfView;
+
+			//! change listener of a rect
+			struct CellRegion {
+				Rect rect;
+				CellChangeListener* listener;
+				//! in a block: the covered cells of the block, bit x + y * 8
+				uint64_t cells;
+			};
+
+			//! all rect listeners
+			std::vector<CellRegion> m_regions;
+
+			//! listener on the cells covered by rects, calls the rect listeners
+			CellChangeListener* m_cellRegionListener;
+
+			//! rect listeners of each block of 8x8 cells of the cache, row by row
+			std::vector<std::vector<CellRegion> > m_regionBuckets;
+
+			//! number of blocks per row
+			uint32_t m_regionBucketsWidth;
+
+			//! depth of running rect listener calls, removals only clear the listener meanwhile
+			uint32_t m_regionCalls;
+
+			//! true if cleared rect listeners wait for removal
+			bool m_regionGarbage;
+
+			//! removes the cleared rect listeners
+			void purgeCellRegions();
+
+			//! adds the rect listener to the blocks it overlaps
+			void addRegionToBuckets(const CellRegion& region);
+
+			//! fills the blocks again, after a resize
+			void rebuildRegionBuckets();
+
+			//! returns the rect listeners of the block which contains the cell and the bit of the cell
+			std::vector<CellRegion>* getRegionBucket(Cell* cell, uint64_t& bit);
+
+			//! returns true if a rect listener contains the coordinate, it must be inside of the cache
+			bool isCellInRegion(const ModelCoordinate& mc);
+
 			//! holds cost table
 			std::map<std::string, double> m_costsTable;
 
@@ -682,6 +881,39 @@ namespace FIFE {
 
 			//! holds default speed multiplier, only if it is not default(1.0)
 			std::map<Cell*, double> m_speedMultipliers;
+
+			//! cell slabs, sorted by memory address
+			std::vector<CellSlab> m_cellSlabs;
+
+			//! zones by identifier, NULL for unused identifiers
+			std::vector<Zone*> m_zoneTable;
+
+			//! unused zone identifiers, the lowest one first
+			std::priority_queue<uint32_t, std::vector<uint32_t>, std::greater<uint32_t> > m_freeZoneIds;
+
+			//! flood fill state of a split search
+			struct SplitSearch {
+				//! visited cells, the not yet expanded ones start at head
+				std::vector<Cell*> cells;
+				//! next cell to expand
+				uint32_t head;
+				//! parent search, points to itself for a root
+				uint32_t parent;
+				//! number of unfinished fills of the united searches, only valid for a root
+				uint32_t pending;
+			};
+
+			//! split searches, reused between the splits
+			std::vector<SplitSearch> m_splitSearches;
+
+			//! per cell id, the search which visited the cell, valid for the current split only
+			std::vector<uint32_t> m_splitMarks;
+
+			//! per cell id, the split in which m_splitMarks was written
+			std::vector<uint32_t> m_splitGenerations;
+
+			//! counter of the splits, used to invalidate the marks without clearing them
+			uint32_t m_splitGeneration;
 	};
 
 } // FIFE
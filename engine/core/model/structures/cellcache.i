@@ -24,6 +24,8 @@
 #include "model/structures/cellcache.h"
 %}
 
+%include "model/structures/fieldofview.i"
+
 namespace FIFE {
 
 	class Cell;
@@ -55,6 +57,16 @@ namespace FIFE {
 			std::vector<Cell*> getCellsInRect(const Rect& rec);
 			std::vector<Cell*> getCellsInCircle(const ModelCoordinate& center, uint16_t radius);
 			std::vector<Cell*> getCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle);
+			void getCellsInRect(const Rect& rec, std::vector<Cell*>& cells);
+			void getCellsInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Cell*>& cells);
+			void getCellsInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Cell*>& cells);
+			void queryCells(SpatialQueryBatch& batch, uint32_t threads = 1);
+			FieldOfView* createFieldOfView(const ModelCoordinate& observer, uint16_t radius);
+			void removeFieldOfView(FieldOfView* fov);
+			const std::vector<FieldOfView*>& getFieldsOfView();
+			uint32_t updateFieldsOfView(uint32_t threads = 1);
+			void invalidateFieldsOfView(const ModelCoordinate& mc);
+			void invalidateFieldsOfView();
 
 			void registerCost(const std::string& costId, double cost);
 			void unregisterCost(const std::string& costId);
@@ -90,3 +102,7 @@ namespace FIFE {
 			bool isStaticSize();
 	};
 }
+
+namespace std {
+	%template(FieldOfViewVector) vector<FIFE::FieldOfView*>;
+}
@@ -0,0 +1,282 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/metamodel/grids/cellgrid.h"
+
+#include "cell.h"
+#include "cellcache.h"
+#include "fieldofview.h"
+#include "layer.h"
+
+namespace FIFE {
+
+	//! transformations of the first octant into the other seven
+	static const int32_t OCTANT_TRANSFORMS[4][8] = {
+		{1,  0,  0, -1, -1,  0,  0,  1},
+		{0,  1, -1,  0,  0, -1,  1,  0},
+		{0,  1,  1,  0,  0, -1, -1,  0},
+		{1,  0,  0,  1, -1,  0,  0, -1}
+	};
+
+	FieldOfView::FieldOfView(CellCache* cache, const ModelCoordinate& observer, uint16_t radius):
+		m_cache(cache),
+		m_observer(observer),
+		m_radius(radius),
+		m_radiusSquare((static_cast<int32_t>(radius) + 1) * radius),
+		m_dynamicBlocking(true),
+		m_dirty(true),
+		m_visibleCount(0) {
+	}
+
+	FieldOfView::~FieldOfView() {
+	}
+
+	CellCache* FieldOfView::getCellCache() const {
+		return m_cache;
+	}
+
+	void FieldOfView::setObserver(const ModelCoordinate& observer) {
+		if (observer.x != m_observer.x || observer.y != m_observer.y) {
+			m_dirty = true;
+		}
+		m_observer = observer;
+	}
+
+	const ModelCoordinate& FieldOfView::getObserver() const {
+		return m_observer;
+	}
+
+	void FieldOfView::setRadius(uint16_t radius) {
+		if (radius != m_radius) {
+			m_radius = radius;
+			m_radiusSquare = (static_cast<int32_t>(radius) + 1) * radius;
+			m_dirty = true;
+		}
+	}
+
+	uint16_t FieldOfView::getRadius() const {
+		return m_radius;
+	}
+
+	void FieldOfView::setDynamicBlocking(bool blocking) {
+		if (blocking != m_dynamicBlocking) {
+			m_dynamicBlocking = blocking;
+			m_dirty = true;
+		}
+	}
+
+	bool FieldOfView::isDynamicBlocking() const {
+		return m_dynamicBlocking;
+	}
+
+	void FieldOfView::setDirty() {
+		m_dirty = true;
+	}
+
+	bool FieldOfView::isDirty() const {
+		return m_dirty;
+	}
+
+	bool FieldOfView::update() {
+		if (!m_dirty) {
+			return false;
+		}
+		compute();
+		m_dirty = false;
+		return true;
+	}
+
+	bool FieldOfView::isVisible(const ModelCoordinate& mc) const {
+		int32_t x = mc.x - m_bounds.x;
+		int32_t y = mc.y - m_bounds.y;
+		if (x < 0 || x >= m_bounds.w || y < 0 || y >= m_bounds.h) {
+			return false;
+		}
+		return m_bitmap[y * m_bounds.w + x] != 0;
+	}
+
+	const Rect& FieldOfView::getBounds() const {
+		return m_bounds;
+	}
+
+	const std::vector<uint8_t>& FieldOfView::getBitmap() const {
+		return m_bitmap;
+	}
+
+	uint32_t FieldOfView::getVisibleCount() const {
+		return m_visibleCount;
+	}
+
+	std::vector<Cell*> FieldOfView::getVisibleCells() const {
+		std::vector<Cell*> cells;
+		cells.reserve(m_visibleCount);
+		std::vector<uint8_t>::const_iterator it = m_bitmap.begin();
+		for (int32_t y = 0; y < m_bounds.h; ++y) {
+			for (int32_t x = 0; x < m_bounds.w; ++x, ++it) {
+				if (*it) {
+					cells.push_back(m_cache->getCell(ModelCoordinate(m_bounds.x + x, m_bounds.y + y)));
+				}
+			}
+		}
+		return cells;
+	}
+
+	void FieldOfView::onBlockingChanged(const ModelCoordinate& mc) {
+		// a change in the shadow is hidden by the cells in front of it
+		if (!m_dirty && isVisible(mc)) {
+			m_dirty = true;
+		}
+	}
+
+	void FieldOfView::compute() {
+		int32_t r = m_radius;
+		m_bounds = Rect(m_observer.x - r, m_observer.y - r, 2 * r + 1, 2 * r + 1);
+		m_bitmap.assign(m_bounds.w * m_bounds.h, 0);
+		m_visibleCount = 0;
+		if (!m_cache->getCell(m_observer)) {
+			return;
+		}
+		setVisible(m_observer.x, m_observer.y);
+		if (m_cache->getLayer()->getCellGrid()->getType() == "square") {
+			for (int32_t octant = 0; octant < 8; ++octant) {
+				castOctant(1, 1.0, 0.0, OCTANT_TRANSFORMS[0][octant], OCTANT_TRANSFORMS[1][octant],
+					OCTANT_TRANSFORMS[2][octant], OCTANT_TRANSFORMS[3][octant]);
+			}
+		} else {
+			castRays();
+		}
+	}
+
+	void FieldOfView::castOctant(int32_t row, double start, double end, int32_t xx, int32_t xy, int32_t yx, int32_t yy) {
+		if (start < end) {
+			return;
+		}
+		int32_t r = m_radius;
+		double newStart = 0.0;
+		for (int32_t distance = row; distance <= r; ++distance) {
+			bool blocked = false;
+			int32_t dy = -distance;
+			for (int32_t dx = -distance; dx <= 0; ++dx) {
+				// slopes of the left and right edge of the cell
+				double leftSlope = (dx - 0.5) / (dy + 0.5);
+				double rightSlope = (dx + 0.5) / (dy - 0.5);
+				if (start < rightSlope) {
+					continue;
+				} else if (end > leftSlope) {
+					break;
+				}
+
+				int32_t x = m_observer.x + dx * xx + dy * xy;
+				int32_t y = m_observer.y + dx * yx + dy * yy;
+				Cell* cell = m_cache->getCell(ModelCoordinate(x, y));
+				if (cell && dx * dx + dy * dy <= m_radiusSquare) {
+					setVisible(x, y);
+				}
+
+				bool blocker = blocks(cell);
+				if (blocked) {
+					if (blocker) {
+						newStart = rightSlope;
+						continue;
+					}
+					blocked = false;
+					start = newStart;
+				} else if (blocker && distance < r) {
+					// scan the part of the next row that is in front of the blocker
+					blocked = true;
+					castOctant(distance + 1, start, leftSlope, xx, xy, yx, yy);
+					newStart = rightSlope;
+				}
+			}
+			if (blocked) {
+				break;
+			}
+		}
+	}
+
+	void FieldOfView::castRays() {
+		CellGrid* grid = m_cache->getLayer()->getCellGrid();
+		int32_t left = m_bounds.x;
+		int32_t top = m_bounds.y;
+		int32_t right = m_bounds.x + m_bounds.w - 1;
+		int32_t bottom = m_bounds.y + m_bounds.h - 1;
+		// every cell on the border of the bounds is the target of one ray
+		std::vector<ModelCoordinate> targets;
+		targets.reserve(4 * m_bounds.w);
+		for (int32_t x = left; x <= right; ++x) {
+			targets.push_back(ModelCoordinate(x, top));
+			targets.push_back(ModelCoordinate(x, bottom));
+		}
+		for (int32_t y = top + 1; y < bottom; ++y) {
+			targets.push_back(ModelCoordinate(left, y));
+			targets.push_back(ModelCoordinate(right, y));
+		}
+
+		for (std::vector<ModelCoordinate>::iterator it = targets.begin(); it != targets.end(); ++it) {
+			std::vector<ModelCoordinate> line = grid->getCoordinatesInLine(m_observer, *it);
+			// the first coordinate is the observer
+			for (std::vector<ModelCoordinate>::size_type i = 1; i < line.size(); ++i) {
+				const ModelCoordinate& mc = line[i];
+				int32_t dx = mc.x - m_observer.x;
+				int32_t dy = mc.y - m_observer.y;
+				if (dx * dx + dy * dy > m_radiusSquare) {
+					break;
+				}
+				Cell* cell = m_cache->getCell(mc);
+				if (!cell) {
+					break;
+				}
+				setVisible(mc.x, mc.y);
+				if (blocks(cell)) {
+					break;
+				}
+			}
+		}
+	}
+
+	bool FieldOfView::blocks(Cell* cell) const {
+		if (!cell) {
+			return true;
+		}
+		CellTypeInfo type = cell->getCellType();
+		if (type == CTYPE_NO_BLOCKER) {
+			return false;
+		}
+		return m_dynamicBlocking || type != CTYPE_DYNAMIC_BLOCKER;
+	}
+
+	void FieldOfView::setVisible(int32_t x, int32_t y) {
+		uint8_t& bit = m_bitmap[(y - m_bounds.y) * m_bounds.w + (x - m_bounds.x)];
+		if (!bit) {
+			bit = 1;
+			++m_visibleCount;
+		}
+	}
+} // FIFE
@@ -0,0 +1,179 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_FIELDOFVIEW_H
+#define FIFE_FIELDOFVIEW_H
+
+// Standard C++ library includes
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/fife_stdint.h"
+#include "util/structures/rect.h"
+#include "model/metamodel/modelcoords.h"
+
+namespace FIFE {
+
+	class Cell;
+	class CellCache;
+
+	/** Visibility of the cells around one observer, created by CellCache::createFieldOfView.
+	 *
+	 * The visible cells are stored as a bitmap over the bounding square of the radius,
+	 * one byte per cell in row-major order. Square grids use recursive shadowcasting,
+	 * other grids cast rays along CellGrid::getCoordinatesInLine to the border of the square.
+	 * Cells which are blockers are visible but hide the cells behind them, cells outside
+	 * of the cache are neither visible nor transparent.
+	 *
+	 * A field of view is only recomputed after it became dirty. Moving the observer or
+	 * changing the radius makes it dirty, blocking changes only if the changed cell is visible,
+	 * as a change in the shadow can not change what the observer sees.
+	 * A recompute always covers the whole radius, also if the observer moved by one cell.
+	 */
+	class FieldOfView {
+	public:
+		/** Constructor
+		 * @param cache The cache which holds the cells.
+		 * @param observer The layer coordinates of the observer.
+		 * @param radius The view radius in cells.
+		 */
+		FieldOfView(CellCache* cache, const ModelCoordinate& observer, uint16_t radius);
+
+		/** Destructor
+		 */
+		~FieldOfView();
+
+		/** Returns the cache this field of view belongs to.
+		 */
+		CellCache* getCellCache() const;
+
+		/** Sets the position of the observer, marks the field of view dirty if it differs.
+		 * @param observer The layer coordinates of the observer.
+		 */
+		void setObserver(const ModelCoordinate& observer);
+
+		/** Returns the position of the observer.
+		 */
+		const ModelCoordinate& getObserver() const;
+
+		/** Sets the view radius, marks the field of view dirty if it differs.
+		 * @param radius The view radius in cells.
+		 */
+		void setRadius(uint16_t radius);
+
+		/** Returns the view radius.
+		 */
+		uint16_t getRadius() const;
+
+		/** Sets if dynamic blockers, e.g. other agents, block the view. Default is true,
+		 * the same as CellCache::getCellsInLine.
+		 * @param blocking A bool that indicates if dynamic blockers block the view.
+		 */
+		void setDynamicBlocking(bool blocking);
+
+		/** Returns if dynamic blockers block the view.
+		 */
+		bool isDynamicBlocking() const;
+
+		/** Marks the field of view dirty, the next update recomputes it.
+		 */
+		void setDirty();
+
+		/** Returns true if the field of view needs to be recomputed.
+		 */
+		bool isDirty() const;
+
+		/** Recomputes the field of view if it is dirty.
+		 * @return True if it was recomputed, otherwise false.
+		 */
+		bool update();
+
+		/** Returns true if the cell at the given coordinates is visible.
+		 * @param mc The layer coordinates of the cell.
+		 */
+		bool isVisible(const ModelCoordinate& mc) const;
+
+		/** Returns the bounding square of the radius, the area of the bitmap.
+		 */
+		const Rect& getBounds() const;
+
+		/** Returns the bitmap, one byte per cell of the bounds in row-major order,
+		 * 1 for visible and 0 for hidden cells.
+		 */
+		const std::vector<uint8_t>& getBitmap() const;
+
+		/** Returns the number of visible cells.
+		 */
+		uint32_t getVisibleCount() const;
+
+		/** Returns all visible cells in row-major order.
+		 */
+		std::vector<Cell*> getVisibleCells() const;
+
+		/** Called by the CellCache if the blocking of a cell changed.
+		 * @param mc The layer coordinates of the cell.
+		 */
+		void onBlockingChanged(const ModelCoordinate& mc);
+
+	private:
+		//! recomputes the bitmap
+		void compute();
+
+		//! shadowcasting of one octant, used for square grids
+		void castOctant(int32_t row, double start, double end, int32_t xx, int32_t xy, int32_t yx, int32_t yy);
+
+		//! casts rays to the border of the bounds, used for all other grids
+		void castRays();
+
+		//! returns true if the cell blocks the view, missing cells block too
+		bool blocks(Cell* cell) const;
+
+		//! marks a cell visible
+		void setVisible(int32_t x, int32_t y);
+
+		//! cache of the cells
+		CellCache* m_cache;
+		//! position of the observer
+		ModelCoordinate m_observer;
+		//! view radius
+		uint16_t m_radius;
+		//! squared radius, same border as CellCache::getCellsInCircle
+		int32_t m_radiusSquare;
+		//! dynamic blockers block the view
+		bool m_dynamicBlocking;
+		//! needs recompute
+		bool m_dirty;
+		//! area of the bitmap
+		Rect m_bounds;
+		//! one byte per cell of the bounds
+		std::vector<uint8_t> m_bitmap;
+		//! number of visible cells
+		uint32_t m_visibleCount;
+	};
+
+} // FIFE
+
+#endif
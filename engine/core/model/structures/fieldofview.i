@@ -0,0 +1,70 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+%module fife
+%{
+#include "model/structures/fieldofview.h"
+%}
+
+%include "model/metamodel/modelcoords.i"
+%include "util/structures/utilstructures.i"
+
+namespace FIFE {
+
+	class Cell;
+	class CellCache;
+
+	class FieldOfView {
+	public:
+		~FieldOfView();
+
+		CellCache* getCellCache() const;
+		void setObserver(const ModelCoordinate& observer);
+		const ModelCoordinate& getObserver() const;
+		void setRadius(uint16_t radius);
+		uint16_t getRadius() const;
+		void setDynamicBlocking(bool blocking);
+		bool isDynamicBlocking() const;
+		void setDirty();
+		bool isDirty() const;
+		bool update();
+		bool isVisible(const ModelCoordinate& mc) const;
+		const Rect& getBounds() const;
+		uint32_t getVisibleCount() const;
+		std::vector<Cell*> getVisibleCells() const;
+	private:
+		FieldOfView(CellCache* cache, const ModelCoordinate& observer, uint16_t radius);
+	};
+
+	%extend FieldOfView {
+		/** Returns the bitmap as bytes, one per cell of the bounds in row-major order,
+		 * e.g. for numpy.frombuffer(data, numpy.uint8).reshape(bounds.h, bounds.w).
+		 */
+		PyObject* getBitmapBuffer() {
+			const std::vector<uint8_t>& bitmap = $self->getBitmap();
+			if (bitmap.empty()) {
+				return PyBytes_FromStringAndSize(NULL, 0);
+			}
+			return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(&bitmap[0]),
+				static_cast<Py_ssize_t>(bitmap.size()));
+		}
+	}
+}
@@ -209,7 +209,8 @@ namespace FIFE {
 		m_specialCost(object->isSpecialCost()),
 		m_cost(object->getCost()),
 		m_costId(object->getCostId()),
-		m_mainMultiInstance(NULL) {
+		m_mainMultiInstance(NULL),
+		m_activeSlot(-1) {
 		// create multi object instances
 		if (object->isMultiObject()) {
 			m_mainMultiInstance = this;
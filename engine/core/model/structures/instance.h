@@ -441,6 +441,15 @@ namespace FIFE {
 		 */
 		Instance* getMainMultiInstance();
 
+		/** Sets the slot of the instance in the active instances of its layer, -1 if it is not active there.
+		 * Only used by Layer.
+		 */
+		void setActiveSlot(int32_t slot) { m_activeSlot = slot; }
+
+		/** Returns the slot of the instance in the active instances of its layer, -1 if it is not active there.
+		 */
+		int32_t getActiveSlot() const { return m_activeSlot; }
+
 		/** Adds new static color overlay with given angle (degrees).
 		 */
 		void addStaticColorOverlay(uint32_t angle, const OverlayColors& colors);
@@ -597,6 +606,8 @@ namespace FIFE {
 		std::vector<Instance*> m_multiInstances;
 		//! pointer to the main multi instance
 		Instance* m_mainMultiInstance;
+		//! index in the active instances of the layer
+		int32_t m_activeSlot;
 
 		Instance(const Instance&);
 		Instance& operator=(const Instance&);
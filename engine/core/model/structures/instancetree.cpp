@@ -115,4 +115,44 @@ namespace FIFE {
 		}
 	}
 
+	class InstanceVectorCollector {
+		public:
+			std::vector<Instance*>& instances;
+			Rect searchRect;
+			InstanceVectorCollector(std::vector<Instance*>& a_instances, const Rect& rect)
+			: instances(a_instances), searchRect(rect) {
+			}
+			bool visit(const InstanceTree::InstanceTreeNode* node, int32_t d);
+	};
+
+	bool InstanceVectorCollector::visit(const InstanceTree::InstanceTreeNode* node, int32_t d) {
+		const InstanceTree::InstanceList& list = node->data();
+		for(InstanceTree::InstanceList::const_iterator it(list.begin()); it != list.end(); ++it) {
+			ModelCoordinate coords = (*it)->getLocationRef().getLayerCoordinates();
+			if( searchRect.contains(Point(coords.x,coords.y)) ) {
+				instances.push_back(*it);
+			}
+		}
+		return true;
+	}
+
+	void InstanceTree::collectInstances(const ModelCoordinate& point, int32_t w, int32_t h, std::vector<Instance*>& instances) const {
+		const InstanceTreeNode* node = m_tree.find_existing_container(point.x, point.y, w, h);
+		Rect rect(point.x, point.y, w, h);
+		InstanceVectorCollector collector(instances, rect);
+
+		node->apply_visitor(collector);
+
+		node = node->parent();
+		while( node ) {
+			for(InstanceList::const_iterator it(node->data().begin()); it != node->data().end(); ++it) {
+				ModelCoordinate coords = (*it)->getLocationRef().getLayerCoordinates();
+				if( rect.contains(Point(coords.x,coords.y)) ) {
+					instances.push_back(*it);
+				}
+			}
+			node = node->parent();
+		}
+	}
+
 }
@@ -23,6 +23,7 @@
 #define FIFE_INSTANCETREE_H
 
 // Standard C++ library includes
+#include <vector>
 #include <list>
 
 // 3rd party library includes
@@ -88,6 +89,18 @@ namespace FIFE {
 		 */
 		void findInstances(const ModelCoordinate& point, int32_t w, int32_t h, InstanceList& list);
 
+		/** Appends all instances in a given area to a vector.
+		 *
+		 * Same area as findInstances, but the tree is neither extended nor is its cursor moved,
+		 * so several threads can search at once as long as nobody changes the tree.
+		 *
+		 * @param point A ModelCoordinate representing the upper left part of the search area.
+		 * @param w The width of the search area in Model Units.
+		 * @param h The height of the search area in Model Units.
+		 * @param instances vector reference the instances are appended to, it is not cleared.
+		 */
+		void collectInstances(const ModelCoordinate& point, int32_t w, int32_t h, std::vector<Instance*>& instances) const;
+
 		/** See QuadNode::apply_visitor
 		 */
 		template<typename Visitor> void applyVisitor(Visitor& visitor) {
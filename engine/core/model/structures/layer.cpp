@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 
 // 3rd party library includes
 
@@ -50,6 +51,8 @@ namespace FIFE {
 		m_map(map),
 		m_instancesVisibility(true),
 		m_transparency(0),
+		m_updatingInstances(false),
+		m_activeSlotsFreed(false),
 		m_instanceTree(new InstanceTree()),
 		m_grid(grid),
 		m_pathingStrategy(CELL_EDGES_ONLY),
@@ -179,6 +182,10 @@ namespace FIFE {
 			++i;
 		}
 		setInstanceActivityStatus(instance, false);
+		if (m_updatingInstances) {
+			// removed by a callback during update(), the listeners must not get it as changed
+			m_changedInstances.erase(std::remove(m_changedInstances.begin(), m_changedInstances.end(), instance), m_changedInstances.end());
+		}
 		std::vector<Instance*>::iterator it = m_instances.begin();
 		for(; it != m_instances.end(); ++it) {
 			if(*it == instance) {
@@ -213,6 +220,10 @@ namespace FIFE {
 			++i;
 		}
 		setInstanceActivityStatus(instance, false);
+		if (m_updatingInstances) {
+			// removed by a callback during update(), the listeners must not get it as changed
+			m_changedInstances.erase(std::remove(m_changedInstances.begin(), m_changedInstances.end(), instance), m_changedInstances.end());
+		}
 		std::vector<Instance*>::iterator it = m_instances.begin();
 		for(; it != m_instances.end(); ++it) {
 			if(*it == instance) {
@@ -231,10 +242,26 @@ namespace FIFE {
 	}
 
 	void Layer::setInstanceActivityStatus(Instance* instance, bool active) {
-		if(active) {
-			m_activeInstances.insert(instance);
-		} else {
-			m_activeInstances.erase(instance);
+		int32_t slot = instance->getActiveSlot();
+		bool contained = slot >= 0 && slot < static_cast<int32_t>(m_activeInstances.size()) &&
+			m_activeInstances[slot] == instance;
+		if (active) {
+			if (!contained) {
+				instance->setActiveSlot(static_cast<int32_t>(m_activeInstances.size()));
+				m_activeInstances.push_back(instance);
+			}
+		} else if (contained && m_updatingInstances) {
+			// update() iterates by index, so the slots must not move until it is done
+			m_activeInstances[slot] = NULL;
+			instance->setActiveSlot(-1);
+			m_activeSlotsFreed = true;
+		} else if (contained) {
+			// swap with the last one
+			Instance* last = m_activeInstances.back();
+			m_activeInstances[slot] = last;
+			last->setActiveSlot(slot);
+			m_activeInstances.pop_back();
+			instance->setActiveSlot(-1);
 		}
 	}
 
@@ -287,99 +314,100 @@ namespace FIFE {
 
 	std::vector<Instance*> Layer::getInstancesInLine(const ModelCoordinate& pt1, const ModelCoordinate& pt2) {
 		std::vector<Instance*> instances;
-		std::list<Instance*> matchingInstances;
-		std::vector<ModelCoordinate> coords = m_grid->getCoordinatesInLine(pt1, pt2);
-		for (std::vector<ModelCoordinate>::iterator it = coords.begin(); it != coords.end(); ++it) {
-			m_instanceTree->findInstances(*it, 0, 0, matchingInstances);
-			if (!matchingInstances.empty()) {
-				instances.insert(instances.end(), matchingInstances.begin(), matchingInstances.end());
-			}
-		}
+		getInstancesInLine(pt1, pt2, instances);
 		return instances;
 	}
 
 	std::vector<Instance*> Layer::getInstancesInCircle(const ModelCoordinate& center, uint16_t radius) {
 		std::vector<Instance*> instances;
-		std::list<Instance*> matchingInstances;
-		//radius power 2
-		uint16_t radiusp2 = (radius+1) * radius;
-
-		ModelCoordinate current(center.x-radius, center.y-radius);
-		ModelCoordinate target(center.x+radius, center.y+radius);
-		for (; current.y < center.y; current.y++) {
-			current.x = center.x-radius;
-			for (; current.x < center.x; current.x++) {
-				uint16_t dx = center.x - current.x;
-				uint16_t dy = center.y - current.y;
-				uint16_t distance = dx*dx + dy*dy;
-				if (distance <= radiusp2) {
-					m_instanceTree->findInstances(current, 0, 0, matchingInstances);
-					if (!matchingInstances.empty()) {
-						instances.insert(instances.end(), matchingInstances.begin(), matchingInstances.end());
-					}
-
-					current.x = center.x + dx;
-					m_instanceTree->findInstances(current, 0, 0, matchingInstances);
-					if (!matchingInstances.empty()) {
-						instances.insert(instances.end(), matchingInstances.begin(), matchingInstances.end());
-					}
+		addInstancesInCircle(center, radius, instances);
+		return instances;
+	}
 
-					current.y = center.y + dy;
-					m_instanceTree->findInstances(current, 0, 0, matchingInstances);
-					if (!matchingInstances.empty()) {
-						instances.insert(instances.end(), matchingInstances.begin(), matchingInstances.end());
-					}
+	std::vector<Instance*> Layer::getInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle) {
+		std::vector<Instance*> instances;
+		addInstancesInCircleSegment(center, radius, sangle, eangle, instances);
+		return instances;
+	}
 
-					current.x = center.x-dx;
-					m_instanceTree->findInstances(current, 0, 0, matchingInstances);
-					if (!matchingInstances.empty()) {
-						instances.insert(instances.end(), matchingInstances.begin(), matchingInstances.end());
-					}
+	void Layer::getInstancesIn(const Rect& rec, std::vector<Instance*>& instances) {
+		instances.clear();
+		m_instanceTree->collectInstances(ModelCoordinate(rec.x, rec.y), rec.w, rec.h, instances);
+	}
 
-					current.y = center.y-dy;
-				}
-			}
-		}
-		current.x = center.x;
-		current.y = center.y-radius;
-		for (; current.y <= target.y; current.y++) {
-			m_instanceTree->findInstances(current, 0, 0, matchingInstances);
-			if (!matchingInstances.empty()) {
-				instances.insert(instances.end(), matchingInstances.begin(), matchingInstances.end());
-			}
+	void Layer::getInstancesInLine(const ModelCoordinate& pt1, const ModelCoordinate& pt2, std::vector<Instance*>& instances) {
+		instances.clear();
+		std::vector<ModelCoordinate> coords = m_grid->getCoordinatesInLine(pt1, pt2);
+		for (std::vector<ModelCoordinate>::iterator it = coords.begin(); it != coords.end(); ++it) {
+			m_instanceTree->collectInstances(*it, 0, 0, instances);
 		}
+	}
+
+	void Layer::getInstancesInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Instance*>& instances) {
+		instances.clear();
+		addInstancesInCircle(center, radius, instances);
+	}
+
+	void Layer::getInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Instance*>& instances) {
+		instances.clear();
+		addInstancesInCircleSegment(center, radius, sangle, eangle, instances);
+	}
 
-		current.y = center.y;
-		current.x = center.x-radius;
-		for (; current.x <= target.x; current.x++) {
-			m_instanceTree->findInstances(current, 0, 0, matchingInstances);
-			if (!matchingInstances.empty()) {
-				instances.insert(instances.end(), matchingInstances.begin(), matchingInstances.end());
+	void Layer::queryInstances(SpatialQueryBatch& batch, uint32_t threads) {
+		batch.answerInstances(threads, [this](const SpatialQuery& query, std::vector<Instance*>& instances) {
+			switch (query.type) {
+				case SPATIAL_QUERY_RECT:
+					m_instanceTree->collectInstances(ModelCoordinate(query.rect.x, query.rect.y), query.rect.w, query.rect.h, instances);
+					break;
+				case SPATIAL_QUERY_CIRCLE:
+					addInstancesInCircle(query.center, query.radius, instances);
+					break;
+				case SPATIAL_QUERY_CIRCLE_SEGMENT:
+					addInstancesInCircleSegment(query.center, query.radius, query.sangle, query.eangle, instances);
+					break;
+			}
+		});
+	}
+
+	void Layer::addInstancesInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Instance*>& instances) {
+		std::vector<Instance*>::size_type first = instances.size();
+		int32_t size = 2 * static_cast<int32_t>(radius);
+		m_instanceTree->collectInstances(ModelCoordinate(center.x - radius, center.y - radius), size, size, instances);
+		// keep only the instances inside of the circle
+		int32_t radiusp2 = (radius + 1) * radius;
+		std::vector<Instance*>::iterator out = instances.begin() + first;
+		for (std::vector<Instance*>::iterator it = out; it != instances.end(); ++it) {
+			ModelCoordinate mc = (*it)->getLocationRef().getLayerCoordinates();
+			int32_t dx = mc.x - center.x;
+			int32_t dy = mc.y - center.y;
+			if (dx*dx + dy*dy <= radiusp2) {
+				*out++ = *it;
 			}
 		}
-		return instances;
+		instances.erase(out, instances.end());
 	}
 
-	std::vector<Instance*> Layer::getInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle) {
-		std::vector<Instance*> instances;
+	void Layer::addInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Instance*>& instances) {
+		std::vector<Instance*>::size_type first = instances.size();
+		addInstancesInCircle(center, radius, instances);
 		ExactModelCoordinate exactCenter(center.x, center.y);
-		std::vector<Instance*> tmpInstances = getInstancesInCircle(center, radius);
 		int32_t s = (sangle + 360) % 360;
 		int32_t e = (eangle + 360) % 360;
 		bool greater = (s > e) ? true : false;
-		for (std::vector<Instance*>::iterator it = tmpInstances.begin(); it != tmpInstances.end(); ++it) {
+		std::vector<Instance*>::iterator out = instances.begin() + first;
+		for (std::vector<Instance*>::iterator it = out; it != instances.end(); ++it) {
 			int32_t angle = getAngleBetween(exactCenter, intPt2doublePt((*it)->getLocationRef().getLayerCoordinates()));
 			if (greater) {
 				if (angle >= s || angle <= e) {
-					instances.push_back(*it);
+					*out++ = *it;
 				}
 			} else {
 				if (angle >= s && angle <= e) {
-					instances.push_back(*it);
+					*out++ = *it;
 				}
 			}
 		}
-		return instances;
+		instances.erase(out, instances.end());
 	}
 
 	void Layer::getMinMaxCoordinates(ModelCoordinate& min, ModelCoordinate& max, const Layer* layer) const {
@@ -484,8 +512,8 @@ namespace FIFE {
 		if (m_cellCache) {
 			Cell* cell = m_cellCache->getCell(cellCoordinate);
 			if (cell) {
-				const std::set<Instance*>& blocker = cell->getInstances();
-				for (std::set<Instance*>::const_iterator it = blocker.begin(); it != blocker.end(); ++it) {
+				const std::vector<Instance*>& blocker = cell->getInstances();
+				for (std::vector<Instance*>::const_iterator it = blocker.begin(); it != blocker.end(); ++it) {
 					if ((*it)->isBlocking()) {
 						blockingInstances.push_back(*it);
 					}
@@ -591,18 +619,40 @@ namespace FIFE {
 		}
 	}
 
+	void Layer::compactActiveInstances() {
+		std::vector<Instance*>::size_type count = 0;
+		for (std::vector<Instance*>::size_type i = 0; i < m_activeInstances.size(); ++i) {
+			Instance* instance = m_activeInstances[i];
+			if (instance) {
+				instance->setActiveSlot(static_cast<int32_t>(count));
+				m_activeInstances[count++] = instance;
+			}
+		}
+		m_activeInstances.resize(count);
+		m_activeSlotsFreed = false;
+	}
+
 	bool Layer::update() {
 		m_changedInstances.clear();
-		std::vector<Instance*> inactiveInstances;
-		std::set<Instance*>::iterator it = m_activeInstances.begin();
-		for(; it != m_activeInstances.end(); ++it) {
-			if ((*it)->update() != ICHANGE_NO_CHANGES) {
-				m_changedInstances.push_back(*it);
+		// indexed, because instance callbacks can activate, remove or delete instances,
+		// removals only clear the slot until the loop is done
+		m_updatingInstances = true;
+		for (std::vector<Instance*>::size_type i = 0; i < m_activeInstances.size(); ++i) {
+			Instance* instance = m_activeInstances[i];
+			if (!instance) {
+				continue;
+			}
+			if (instance->update() != ICHANGE_NO_CHANGES) {
+				m_changedInstances.push_back(instance);
 				m_changed = true;
-			} else if (!(*it)->isActive()) {
-				inactiveInstances.push_back(*it);
+			} else if (!instance->isActive()) {
+				setInstanceActivityStatus(instance, false);
 			}
 		}
+		m_updatingInstances = false;
+		if (m_activeSlotsFreed) {
+			compactActiveInstances();
+		}
 		if (!m_changedInstances.empty()) {
 			std::vector<LayerChangeListener*>::iterator i = m_changeListeners.begin();
 			while (i != m_changeListeners.end()) {
@@ -611,14 +661,6 @@ namespace FIFE {
 			}
 			//std::cout << "Layer named " << Id() << " changed = 1\n";
 		}
-		// remove inactive instances from m_activeInstances
-		if (!inactiveInstances.empty()) {
-			std::vector<Instance*>::iterator i = inactiveInstances.begin();
-			while (i != inactiveInstances.end()) {
-				m_activeInstances.erase(*i);
-				++i;
-			}
-		}
 		//std::cout << "Layer named " << Id() << " changed = 0\n";
 		bool retval = m_changed;
 		m_changed = false;
@@ -40,6 +40,7 @@
 #include "model/metamodel/object.h"
 
 #include "instance.h"
+#include "spatialquery.h"
 
 namespace FIFE {
 
@@ -202,6 +203,43 @@ namespace FIFE {
 			 */
 			std::vector<Instance*> getInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle);
 
+			/** Fills a vector with the instances that match given rect, the vector is cleared first.
+			 * Unlike getInstancesIn the instance tree is only read, so several threads can
+			 * search at once as long as the layer is not changed meanwhile.
+			 * @param rec rect where to fetch instances from, the borders are included.
+			 * @param instances A reference to the vector that receives the instances.
+			 */
+			void getInstancesIn(const Rect& rec, std::vector<Instance*>& instances);
+
+			/** Fills a vector with the instances that match given line between pt1 and pt2, the vector is cleared first.
+			 * @param pt1 A const reference to the ModelCoordinate where to start from.
+			 * @param pt2 A const reference to the ModelCoordinate where the end is.
+			 * @param instances A reference to the vector that receives the instances.
+			 */
+			void getInstancesInLine(const ModelCoordinate& pt1, const ModelCoordinate& pt2, std::vector<Instance*>& instances);
+
+			/** Fills a vector with the instances that match given center and radius of the circle, the vector is cleared first.
+			 * @param center A const reference to the ModelCoordinate where the center of the circle is.
+			 * @param radius A unsigned integer, radius of the circle.
+			 * @param instances A reference to the vector that receives the instances.
+			 */
+			void getInstancesInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Instance*>& instances);
+
+			/** Fills a vector with the instances in the circle segment, the vector is cleared first.
+			 * @param center A const reference to the ModelCoordinate where the center of the circle is.
+			 * @param radius A unsigned integer, radius of the circle.
+			 * @param sangle A interger, start angle of the segment.
+			 * @param eangle A interger, end angle of the segment.
+			 * @param instances A reference to the vector that receives the instances.
+			 */
+			void getInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Instance*>& instances);
+
+			/** Answers all queries of the batch with the instances of this layer.
+			 * @param batch A reference to the batch with the queries, it receives the results.
+			 * @param threads The number of threads which share the queries. The layer must not be changed meanwhile.
+			 */
+			void queryInstances(SpatialQueryBatch& batch, uint32_t threads = 1);
+
 			/** Get the first instance on this layer with the given identifier.
 			 */
 			Instance* getInstance(const std::string& identifier);
@@ -378,6 +416,18 @@ namespace FIFE {
 			bool isStatic();
 
 		protected:
+			/** Appends the instances in the circle to the vector.
+			 */
+			void addInstancesInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Instance*>& instances);
+
+			/** Appends the instances in the circle segment to the vector.
+			 */
+			void addInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Instance*>& instances);
+
+			/** Removes the NULL slots that were left by removals during update().
+			 */
+			void compactActiveInstances();
+
 			//! string identifier
 			std::string m_id;
 			//! pointer to map
@@ -388,8 +438,12 @@ namespace FIFE {
 			uint8_t m_transparency;
 			//! all the instances on this layer
 			std::vector<Instance*> m_instances;
-			//! all the active instances on this layer
-			std::set<Instance*> m_activeInstances;
+			//! all the active instances on this layer, each instance knows its slot
+			std::vector<Instance*> m_activeInstances;
+			//! true while update() iterates m_activeInstances, removals leave a NULL slot then
+			bool m_updatingInstances;
+			//! true if m_activeInstances contains NULL slots
+			bool m_activeSlotsFreed;
 			//! The instance tree
 			InstanceTree* m_instanceTree;
 			//! layer's cellgrid
@@ -28,6 +28,7 @@
 %include "model/metamodel/grids/cellgrids.i"
 %include "util/structures/utilstructures.i"
 %include "util/base/utilbase.i"
+%include "model/structures/spatialquery.i"
 
 namespace FIFE {
 
@@ -84,6 +85,11 @@ namespace FIFE {
 			std::vector<Instance*> getInstancesInLine(const ModelCoordinate& pt1, const ModelCoordinate& pt2);
 			std::vector<Instance*> getInstancesInCircle(const ModelCoordinate& center, uint16_t radius);
 			std::vector<Instance*> getInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle);
+			void getInstancesIn(const Rect& rec, std::vector<Instance*>& instances);
+			void getInstancesInLine(const ModelCoordinate& pt1, const ModelCoordinate& pt2, std::vector<Instance*>& instances);
+			void getInstancesInCircle(const ModelCoordinate& center, uint16_t radius, std::vector<Instance*>& instances);
+			void getInstancesInCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle, std::vector<Instance*>& instances);
+			void queryInstances(SpatialQueryBatch& batch, uint32_t threads = 1);
 			Instance* getInstance(const std::string& id);
 
 			void setInstancesVisible(bool vis);
@@ -30,6 +30,7 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "util/base/exception.h"
+#include "util/base/framearena.h"
 #include "util/structures/purge.h"
 #include "util/structures/rect.h"
 #include "view/camera.h"
@@ -188,7 +189,8 @@ namespace FIFE {
 			}
 			m_transferInstances.clear();
 		}
-		std::vector<CellCache*> cellCaches;
+		FrameArenaScope scratch;
+		FrameVector<CellCache*> cellCaches;
 		std::list<Layer*>::iterator it = m_layers.begin();
 		// update Layers
 		for(; it != m_layers.end(); ++it) {
@@ -201,7 +203,7 @@ namespace FIFE {
 			}
 		}
 		// loop over Caches and update
-		for (std::vector<CellCache*>::iterator cacheIt = cellCaches.begin();
+		for (FrameVector<CellCache*>::iterator cacheIt = cellCaches.begin();
 			cacheIt != cellCaches.end(); ++cacheIt) {
 			(*cacheIt)->update();
 		}
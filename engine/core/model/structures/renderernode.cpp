@@ -61,7 +61,10 @@ namespace FIFE {
 		m_location(relative_location),
 		m_layer(relative_layer),
 		m_point(relative_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 		addInstance(attached_instance);
 	}
 	RendererNode::RendererNode(Instance* attached_instance, const Location &relative_location, const Point &relative_point):
@@ -69,7 +72,10 @@ namespace FIFE {
 		m_location(relative_location),
 		m_layer(NULL),
 		m_point(relative_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 		addInstance(attached_instance);
 	}
 	RendererNode::RendererNode(Instance* attached_instance, Layer* relative_layer, const Point &relative_point):
@@ -77,7 +83,10 @@ namespace FIFE {
 		m_location(NULL),
 		m_layer(relative_layer),
 		m_point(relative_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 		addInstance(attached_instance);
 	}
 	RendererNode::RendererNode(Instance* attached_instance, const Point &relative_point):
@@ -85,7 +94,10 @@ namespace FIFE {
 		m_location(NULL),
 		m_layer(NULL),
 		m_point(relative_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 		addInstance(attached_instance);
 	}
 	RendererNode::RendererNode(const Location &attached_location, Layer* relative_layer, const Point &relative_point):
@@ -93,41 +105,57 @@ namespace FIFE {
 		m_location(attached_location),
 		m_layer(relative_layer),
 		m_point(relative_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 	}
 	RendererNode::RendererNode(const Location &attached_location, const Point &relative_point):
 		m_instance(NULL),
 		m_location(attached_location),
 		m_layer(NULL),
 		m_point(relative_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 	}
 	RendererNode::RendererNode(Layer* attached_layer, const Point &relative_point):
 		m_instance(NULL),
 		m_location(NULL),
 		m_layer(attached_layer),
 		m_point(relative_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 	}
 	RendererNode::RendererNode(const Point &attached_point):
 		m_instance(NULL),
 		m_location(NULL),
 		m_layer(NULL),
 		m_point(attached_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 	}
 	RendererNode::RendererNode(const RendererNode& old):
 		m_instance(NULL),
 		m_location(old.m_location),
 		m_layer(old.m_layer),
 		m_point(old.m_point),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_cacheCamera(NULL),
+		m_cacheRevision(0),
+		m_cacheLayer(NULL) {
 		addInstance(old.m_instance);
 	}
 	RendererNode& RendererNode::operator=(const RendererNode &source) {
 		if (this != &source) {
 			changeInstance(source.m_instance);
 			m_location = source.m_location;
+			resetCachedPoint();
 			m_layer = source.m_layer;
 			m_point = source.m_point;
 		}
@@ -141,11 +169,13 @@ namespace FIFE {
 	void RendererNode::setAttached(Instance* attached_instance, const Location &relative_location, const Point &relative_point) {
 		changeInstance(attached_instance);
 		m_location = relative_location;
+		resetCachedPoint();
 		m_point = relative_point;
 	}
 	void RendererNode::setAttached(Instance* attached_instance, const Location &relative_location) {
 		changeInstance(attached_instance);
 		m_location = relative_location;
+		resetCachedPoint();
 	}
 	void RendererNode::setAttached(Instance* attached_instance, const Point &relative_point) {
 		changeInstance(attached_instance);
@@ -157,11 +187,13 @@ namespace FIFE {
 	void RendererNode::setAttached(const Location &attached_location, const Point &relative_point) {
 		changeInstance(NULL);
 		m_location = attached_location;
+		resetCachedPoint();
 		m_point = relative_point;
 	}
 	void RendererNode::setAttached(const Location &attached_location) {
 		changeInstance(NULL);
 		m_location = attached_location;
+		resetCachedPoint();
 	}
 	void RendererNode::setAttached(Layer* attached_layer) {
 		m_layer = attached_layer;
@@ -169,6 +201,7 @@ namespace FIFE {
 	void RendererNode::setAttached(const Point &attached_point) {
 		changeInstance(NULL);
 		m_location = NULL;
+		resetCachedPoint();
 		m_point = attached_point;
 	}
 
@@ -177,12 +210,14 @@ namespace FIFE {
 			FL_WARN(_log, LMsg("RendererNode::setRelative(Location) - ") << "No instance attached.");
 		}
 		m_location = relative_location;
+		resetCachedPoint();
 	}
 	void RendererNode::setRelative(const Location &relative_location, Point relative_point) {
 		if(m_instance == NULL) {
 			FL_WARN(_log, LMsg("RendererNode::setRelative(Location, Point) - ") << "No instance attached.");
 		}
 		m_location = relative_location;
+		resetCachedPoint();
 		m_point = relative_point;
 	}
 	void RendererNode::setRelative(const Point &relative_point) {
@@ -266,6 +301,7 @@ namespace FIFE {
 			m_instance->removeDeleteListener(m_listener);
 		}
 		m_instance = instance;
+		resetCachedPoint();
 		if (m_instance) {
 			m_instance->addDeleteListener(m_listener);
 		}
@@ -277,9 +313,14 @@ namespace FIFE {
 				m_instance->removeDeleteListener(m_listener);
 			}
 			m_instance = NULL;
+			resetCachedPoint();
 		}
 	}
 
+	void RendererNode::resetCachedPoint() {
+		m_cacheCamera = NULL;
+	}
+
 	void RendererNode::checkDeleteListener() {
 		if (m_listener) {
 			return;
@@ -288,21 +329,40 @@ namespace FIFE {
 	}
 
 	Point RendererNode::getCalculatedPoint(Camera* cam, Layer* layer, const bool zoomed) {
-		ScreenPoint p;
+		Point p;
 		if(m_instance != NULL) {
+			Location& instanceLocation = m_instance->getLocationRef();
 			if(m_layer == NULL) {
-				m_layer = m_instance->getLocationRef().getLayer();
+				m_layer = instanceLocation.getLayer();
 			}
-			if(m_location != NULL) {
-				p = cam->toScreenCoordinates(m_instance->getLocationRef().getMapCoordinates() + m_location.getMapCoordinates());
-			} else {
-				p = cam->toScreenCoordinates(m_instance->getLocationRef().getMapCoordinates());
+			// the attached instance is the only part that can move without notice
+			const ExactModelCoordinate& coordinates = instanceLocation.getExactLayerCoordinatesRef();
+			if (m_cacheCamera != cam || m_cacheRevision != cam->getMatrixRevision() ||
+				m_cacheLayer != instanceLocation.getLayer() || m_cacheCoordinates != coordinates) {
+				ScreenPoint sp;
+				if(m_location != NULL) {
+					sp = cam->toScreenCoordinates(instanceLocation.getMapCoordinates() + m_location.getMapCoordinates());
+				} else {
+					sp = cam->toScreenCoordinates(instanceLocation.getMapCoordinates());
+				}
+				m_cachePoint = Point(sp.x, sp.y);
+				m_cacheCamera = cam;
+				m_cacheRevision = cam->getMatrixRevision();
+				m_cacheLayer = instanceLocation.getLayer();
+				m_cacheCoordinates = coordinates;
 			}
+			p = m_cachePoint;
 		} else if(m_location != NULL) {
 			if(m_layer == NULL) {
 				m_layer = m_location.getLayer();
 			}
-			p = cam->toScreenCoordinates(m_location.getMapCoordinates());
+			if (m_cacheCamera != cam || m_cacheRevision != cam->getMatrixRevision()) {
+				ScreenPoint sp = cam->toScreenCoordinates(m_location.getMapCoordinates());
+				m_cachePoint = Point(sp.x, sp.y);
+				m_cacheCamera = cam;
+				m_cacheRevision = cam->getMatrixRevision();
+			}
+			p = m_cachePoint;
 		} else if(m_layer == NULL) {
 			// FIXME
 			FL_WARN(_log, LMsg("RendererNode::getCalculatedPoint(Camera, Layer) - ") << "No layer attached. So we use the first active layer of the renderer.");
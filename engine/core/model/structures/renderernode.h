@@ -85,12 +85,21 @@ namespace FIFE {
 		Point getCalculatedPoint(Camera* cam, Layer* layer, const bool zoomed = false);
 	private:
 		void checkDeleteListener();
+		//! forces getCalculatedPoint to recalculate the screen point
+		void resetCachedPoint();
 
 		Instance* m_instance;
 		Location m_location;
 		Layer* m_layer;
 		Point m_point;
 		InstanceDeleteListener* m_listener;
+
+		// the last screen point, it is only recalculated if the camera or the anchor moved
+		Camera* m_cacheCamera;
+		uint32_t m_cacheRevision;
+		Layer* m_cacheLayer;
+		ExactModelCoordinate m_cacheCoordinates;
+		Point m_cachePoint;
 	};
 }
 
@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+// Standard C++ library includes
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/exception.h"
+
+#include "cell.h"
+#include "instance.h"
+#include "spatialquery.h"
+
+namespace FIFE {
+
+	SpatialQueryBatch::SpatialQueryBatch() {
+		m_offsets.push_back(0);
+	}
+
+	SpatialQueryBatch::~SpatialQueryBatch() {
+	}
+
+	uint32_t SpatialQueryBatch::addRect(const Rect& rec) {
+		SpatialQuery query;
+		query.type = SPATIAL_QUERY_RECT;
+		query.rect = rec;
+		query.radius = 0;
+		query.sangle = 0;
+		query.eangle = 0;
+		m_queries.push_back(query);
+		return static_cast<uint32_t>(m_queries.size() - 1);
+	}
+
+	uint32_t SpatialQueryBatch::addCircle(const ModelCoordinate& center, uint16_t radius) {
+		SpatialQuery query;
+		query.type = SPATIAL_QUERY_CIRCLE;
+		query.center = center;
+		query.radius = radius;
+		query.sangle = 0;
+		query.eangle = 0;
+		m_queries.push_back(query);
+		return static_cast<uint32_t>(m_queries.size() - 1);
+	}
+
+	uint32_t SpatialQueryBatch::addCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle) {
+		SpatialQuery query;
+		query.type = SPATIAL_QUERY_CIRCLE_SEGMENT;
+		query.center = center;
+		query.radius = radius;
+		query.sangle = sangle;
+		query.eangle = eangle;
+		m_queries.push_back(query);
+		return static_cast<uint32_t>(m_queries.size() - 1);
+	}
+
+	void SpatialQueryBatch::clear() {
+		m_queries.clear();
+		m_offsets.assign(1, 0);
+		m_instances.clear();
+		m_cells.clear();
+		m_coordinates.clear();
+	}
+
+	uint32_t SpatialQueryBatch::getQueryCount() const {
+		return static_cast<uint32_t>(m_queries.size());
+	}
+
+	const SpatialQuery& SpatialQueryBatch::getQuery(uint32_t query) const {
+		if (query >= m_queries.size()) {
+			throw IndexOverflow("SpatialQueryBatch: query index out of range");
+		}
+		return m_queries[query];
+	}
+
+	uint32_t SpatialQueryBatch::getResultCount() const {
+		return m_offsets.back();
+	}
+
+	uint32_t SpatialQueryBatch::getResultCount(uint32_t query) const {
+		if (query + 1 >= m_offsets.size()) {
+			return 0;
+		}
+		return m_offsets[query + 1] - m_offsets[query];
+	}
+
+	uint32_t SpatialQueryBatch::getOffset(uint32_t query) const {
+		if (query >= m_offsets.size()) {
+			throw IndexOverflow("SpatialQueryBatch: query index out of range");
+		}
+		return m_offsets[query];
+	}
+
+	const std::vector<uint32_t>& SpatialQueryBatch::getOffsets() const {
+		return m_offsets;
+	}
+
+	const std::vector<Instance*>& SpatialQueryBatch::getInstances() const {
+		return m_instances;
+	}
+
+	std::vector<Instance*> SpatialQueryBatch::getInstances(uint32_t query) const {
+		if (query + 1 >= m_offsets.size() || m_instances.empty()) {
+			return std::vector<Instance*>();
+		}
+		return std::vector<Instance*>(m_instances.begin() + m_offsets[query], m_instances.begin() + m_offsets[query + 1]);
+	}
+
+	const std::vector<Cell*>& SpatialQueryBatch::getCells() const {
+		return m_cells;
+	}
+
+	std::vector<Cell*> SpatialQueryBatch::getCells(uint32_t query) const {
+		if (query + 1 >= m_offsets.size() || m_cells.empty()) {
+			return std::vector<Cell*>();
+		}
+		return std::vector<Cell*>(m_cells.begin() + m_offsets[query], m_cells.begin() + m_offsets[query + 1]);
+	}
+
+	const std::vector<int32_t>& SpatialQueryBatch::getCoordinates() const {
+		return m_coordinates;
+	}
+
+	void SpatialQueryBatch::storeCoordinates(const std::vector<Instance*>& instances) {
+		m_coordinates.resize(instances.size() * 2);
+		std::vector<int32_t>::iterator out = m_coordinates.begin();
+		for (std::vector<Instance*>::const_iterator it = instances.begin(); it != instances.end(); ++it) {
+			ModelCoordinate mc = (*it)->getLocationRef().getLayerCoordinates();
+			*out++ = mc.x;
+			*out++ = mc.y;
+		}
+	}
+
+	void SpatialQueryBatch::storeCoordinates(const std::vector<Cell*>& cells) {
+		m_coordinates.resize(cells.size() * 2);
+		std::vector<int32_t>::iterator out = m_coordinates.begin();
+		for (std::vector<Cell*>::const_iterator it = cells.begin(); it != cells.end(); ++it) {
+			const ModelCoordinate& mc = (*it)->getLayerCoordinates();
+			*out++ = mc.x;
+			*out++ = mc.y;
+		}
+	}
+}
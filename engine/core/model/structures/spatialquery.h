@@ -0,0 +1,263 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+#ifndef FIFE_SPATIALQUERY_H
+#define FIFE_SPATIALQUERY_H
+
+// Standard C++ library includes
+#include <thread>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/fife_stdint.h"
+#include "util/structures/rect.h"
+#include "model/metamodel/modelcoords.h"
+
+namespace FIFE {
+
+	class Cell;
+	class Instance;
+
+	/** The kinds of queries a SpatialQueryBatch can hold.
+	 */
+	enum SpatialQueryType {
+		SPATIAL_QUERY_RECT = 0,
+		SPATIAL_QUERY_CIRCLE,
+		SPATIAL_QUERY_CIRCLE_SEGMENT
+	};
+
+	/** One query of a SpatialQueryBatch.
+	 */
+	struct SpatialQuery {
+		//! kind of the query
+		SpatialQueryType type;
+		//! rect of a rect query
+		Rect rect;
+		//! center of a circle or circle segment
+		ModelCoordinate center;
+		//! radius of a circle or circle segment
+		uint16_t radius;
+		//! start angle of a circle segment
+		int32_t sangle;
+		//! end angle of a circle segment
+		int32_t eangle;
+	};
+
+	/** Holds many rect, circle and circle segment queries, which are answered in one call
+	 * by Layer::queryInstances or CellCache::queryCells.
+	 *
+	 * The hits of all queries are stored in one flat vector, the hits of query i are found
+	 * between getOffset(i) and getOffset(i + 1). Beside the instances or cells the layer
+	 * coordinates of the hits are stored as flat x, y pairs, so scripts can hand them
+	 * to numpy without touching the single objects. A batch can be reused, the memory
+	 * stays allocated.
+	 */
+	class SpatialQueryBatch {
+	public:
+		/** Constructor
+		 */
+		SpatialQueryBatch();
+
+		/** Destructor
+		 */
+		~SpatialQueryBatch();
+
+		/** Adds a rect query.
+		 * @param rec The rect, uses the same borders as the single query of the layer or cache.
+		 * @return The index of the query.
+		 */
+		uint32_t addRect(const Rect& rec);
+
+		/** Adds a circle query.
+		 * @param center The center of the circle.
+		 * @param radius The radius of the circle.
+		 * @return The index of the query.
+		 */
+		uint32_t addCircle(const ModelCoordinate& center, uint16_t radius);
+
+		/** Adds a circle segment query, e.g. a cone of view.
+		 * @param center The center of the circle.
+		 * @param radius The radius of the circle.
+		 * @param sangle The start angle of the segment.
+		 * @param eangle The end angle of the segment.
+		 * @return The index of the query.
+		 */
+		uint32_t addCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle);
+
+		/** Removes all queries and results.
+		 */
+		void clear();
+
+		/** Returns the number of queries.
+		 */
+		uint32_t getQueryCount() const;
+
+		/** Returns a query.
+		 * @param query The index of the query.
+		 */
+		const SpatialQuery& getQuery(uint32_t query) const;
+
+		/** Returns the number of hits of all queries.
+		 */
+		uint32_t getResultCount() const;
+
+		/** Returns the number of hits of one query.
+		 * @param query The index of the query.
+		 */
+		uint32_t getResultCount(uint32_t query) const;
+
+		/** Returns the position of the first hit of a query in the result vectors.
+		 * @param query The index of the query, getQueryCount() returns the end of the last query.
+		 */
+		uint32_t getOffset(uint32_t query) const;
+
+		/** Returns the offsets of all queries, one more than there are queries.
+		 */
+		const std::vector<uint32_t>& getOffsets() const;
+
+		/** Returns the found instances of all queries, after Layer::queryInstances.
+		 */
+		const std::vector<Instance*>& getInstances() const;
+
+		/** Returns the found instances of one query, after Layer::queryInstances.
+		 * @param query The index of the query.
+		 */
+		std::vector<Instance*> getInstances(uint32_t query) const;
+
+		/** Returns the found cells of all queries, after CellCache::queryCells.
+		 */
+		const std::vector<Cell*>& getCells() const;
+
+		/** Returns the found cells of one query, after CellCache::queryCells.
+		 * @param query The index of the query.
+		 */
+		std::vector<Cell*> getCells(uint32_t query) const;
+
+		/** Returns the layer coordinates of all hits as x, y pairs.
+		 */
+		const std::vector<int32_t>& getCoordinates() const;
+
+		/** Answers all queries with instances. Used by Layer::queryInstances.
+		 * @param threads The number of threads, 1 answers the queries on the calling thread.
+		 * @param answer Function object which appends the instances of one query to a vector.
+		 * It must be safe to call it from several threads at once.
+		 */
+		template<typename Function>
+		void answerInstances(uint32_t threads, Function answer) {
+			m_cells.clear();
+			answerQueries(m_instances, threads, answer);
+		}
+
+		/** Answers all queries with cells. Used by CellCache::queryCells.
+		 * @param threads The number of threads, 1 answers the queries on the calling thread.
+		 * @param answer Function object which appends the cells of one query to a vector.
+		 * It must be safe to call it from several threads at once.
+		 */
+		template<typename Function>
+		void answerCells(uint32_t threads, Function answer) {
+			m_instances.clear();
+			answerQueries(m_cells, threads, answer);
+		}
+
+	private:
+		template<typename T, typename Function>
+		void answerQueries(std::vector<T>& results, uint32_t threads, Function answer);
+
+		//! fills the coordinates of the hits
+		void storeCoordinates(const std::vector<Instance*>& instances);
+		void storeCoordinates(const std::vector<Cell*>& cells);
+
+		//! queries
+		std::vector<SpatialQuery> m_queries;
+		//! start of the hits of each query, one more than queries
+		std::vector<uint32_t> m_offsets;
+		//! found instances
+		std::vector<Instance*> m_instances;
+		//! found cells
+		std::vector<Cell*> m_cells;
+		//! coordinates of the hits, x, y pairs
+		std::vector<int32_t> m_coordinates;
+		//! per thread results, kept to avoid allocations
+		std::vector<std::vector<Instance*> > m_instanceParts;
+		std::vector<std::vector<Cell*> > m_cellParts;
+
+		std::vector<std::vector<Instance*> >& getParts(Instance*) { return m_instanceParts; }
+		std::vector<std::vector<Cell*> >& getParts(Cell*) { return m_cellParts; }
+	};
+
+	template<typename T, typename Function>
+	void SpatialQueryBatch::answerQueries(std::vector<T>& results, uint32_t threads, Function answer) {
+		uint32_t count = static_cast<uint32_t>(m_queries.size());
+		m_offsets.assign(count + 1, 0);
+		results.clear();
+		if (threads > count) {
+			threads = count;
+		}
+		if (threads <= 1) {
+			for (uint32_t i = 0; i < count; ++i) {
+				m_offsets[i] = static_cast<uint32_t>(results.size());
+				answer(m_queries[i], results);
+			}
+		} else {
+			// every thread answers a contiguous range of queries into its own vector
+			std::vector<std::vector<T> >& parts = getParts(static_cast<T>(0));
+			parts.resize(threads);
+			std::vector<std::thread> workers;
+			workers.reserve(threads);
+			for (uint32_t t = 0; t < threads; ++t) {
+				uint32_t begin = count * t / threads;
+				uint32_t end = count * (t + 1) / threads;
+				std::vector<T>& part = parts[t];
+				workers.push_back(std::thread([this, &part, &answer, begin, end]() {
+					part.clear();
+					for (uint32_t i = begin; i < end; ++i) {
+						m_offsets[i] = static_cast<uint32_t>(part.size());
+						answer(m_queries[i], part);
+					}
+				}));
+			}
+			for (uint32_t t = 0; t < threads; ++t) {
+				workers[t].join();
+			}
+			// the offsets are relative to the thread results, move them behind each other
+			for (uint32_t t = 0; t < threads; ++t) {
+				uint32_t base = static_cast<uint32_t>(results.size());
+				uint32_t begin = count * t / threads;
+				uint32_t end = count * (t + 1) / threads;
+				for (uint32_t i = begin; i < end; ++i) {
+					m_offsets[i] += base;
+				}
+				results.insert(results.end(), parts[t].begin(), parts[t].end());
+			}
+		}
+		m_offsets[count] = static_cast<uint32_t>(results.size());
+		storeCoordinates(results);
+	}
+
+} // FIFE
+
+#endif
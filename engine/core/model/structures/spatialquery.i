@@ -0,0 +1,80 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+%module fife
+%{
+#include "model/structures/spatialquery.h"
+%}
+
+%include "model/metamodel/modelcoords.i"
+%include "util/structures/utilstructures.i"
+
+namespace FIFE {
+
+	class Cell;
+	class Instance;
+
+	enum SpatialQueryType {
+		SPATIAL_QUERY_RECT = 0,
+		SPATIAL_QUERY_CIRCLE,
+		SPATIAL_QUERY_CIRCLE_SEGMENT
+	};
+
+	class SpatialQueryBatch {
+	public:
+		SpatialQueryBatch();
+		~SpatialQueryBatch();
+
+		uint32_t addRect(const Rect& rec);
+		uint32_t addCircle(const ModelCoordinate& center, uint16_t radius);
+		uint32_t addCircleSegment(const ModelCoordinate& center, uint16_t radius, int32_t sangle, int32_t eangle);
+		void clear();
+		uint32_t getQueryCount() const;
+
+		uint32_t getResultCount() const;
+		uint32_t getResultCount(uint32_t query) const;
+		uint32_t getOffset(uint32_t query) const;
+		std::vector<Instance*> getInstances(uint32_t query) const;
+		std::vector<Cell*> getCells(uint32_t query) const;
+	};
+
+	%extend SpatialQueryBatch {
+		/** Returns the offsets as bytes of uint32 values, e.g. for numpy.frombuffer(data, numpy.uint32).
+		 */
+		PyObject* getOffsetsBuffer() {
+			const std::vector<uint32_t>& offsets = $self->getOffsets();
+			return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(&offsets[0]),
+				static_cast<Py_ssize_t>(offsets.size() * sizeof(uint32_t)));
+		}
+
+		/** Returns the x, y coordinates of all hits as bytes of int32 values,
+		 * e.g. for numpy.frombuffer(data, numpy.int32).reshape(-1, 2).
+		 */
+		PyObject* getCoordinatesBuffer() {
+			const std::vector<int32_t>& coordinates = $self->getCoordinates();
+			if (coordinates.empty()) {
+				return PyBytes_FromStringAndSize(NULL, 0);
+			}
+			return PyBytes_FromStringAndSize(reinterpret_cast<const char*>(&coordinates[0]),
+				static_cast<Py_ssize_t>(coordinates.size() * sizeof(int32_t)));
+		}
+	}
+}
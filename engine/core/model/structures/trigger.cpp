@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 #include <vector>
 
 // 3rd party library includes
@@ -38,6 +39,25 @@
 
 namespace FIFE {
 
+	//! trigger condition for each bit of InstanceChangeInfo
+	static const TriggerCondition INSTANCE_CHANGE_CONDITIONS[] = {
+		INSTANCE_TRIGGER_LOCATION,
+		INSTANCE_TRIGGER_ROTATION,
+		INSTANCE_TRIGGER_SPEED,
+		INSTANCE_TRIGGER_ACTION,
+		INSTANCE_TRIGGER_TIME_MULTIPLIER,
+		INSTANCE_TRIGGER_SAYTEXT,
+		INSTANCE_TRIGGER_BLOCK,
+		INSTANCE_TRIGGER_CELL,
+		INSTANCE_TRIGGER_TRANSPARENCY,
+		INSTANCE_TRIGGER_VISIBLE,
+		INSTANCE_TRIGGER_STACKPOS,
+		INSTANCE_TRIGGER_VISUAL
+	};
+
+	//! mask with the instance trigger conditions
+	static const uint32_t INSTANCE_CONDITION_MASK = ((1u << (INSTANCE_TRIGGER_VISUAL + 1)) - 1) & ~((1u << INSTANCE_TRIGGER_LOCATION) - 1);
+
 	class TriggerChangeListener : public CellChangeListener, public InstanceChangeListener, public InstanceDeleteListener {
 	public:
 		TriggerChangeListener(Trigger* trigger)	{
@@ -47,8 +67,7 @@ namespace FIFE {
 
 		// InstanceDeleteListener callback
 		virtual void onInstanceDeleted(Instance* instance) {
-			const std::vector<TriggerCondition>& types = m_trigger->getTriggerConditions();
-			if (std::find(types.begin(), types.end(), INSTANCE_TRIGGER_DELETE) != types.end()) {
+			if (m_trigger->hasTriggerCondition(INSTANCE_TRIGGER_DELETE)) {
 				m_trigger->setTriggered();
 			}
 			m_trigger->detach();
@@ -56,70 +75,44 @@ namespace FIFE {
 
 		// CellChangeListener callback
 		virtual void onInstanceEnteredCell(Cell* cell, Instance* instance) {
-			const std::vector<TriggerCondition>& types = m_trigger->getTriggerConditions();
-			if (std::find(types.begin(), types.end(), CELL_TRIGGER_ENTER) != types.end()) {
-				const std::vector<Instance*>& restrict = m_trigger->getEnabledInstances();
-				if (m_trigger->isEnabledForAllInstances() ||
-					std::find(restrict.begin(), restrict.end(), instance) != restrict.end()) {
-					m_trigger->setTriggered();
-				}
+			if (m_trigger->hasTriggerCondition(CELL_TRIGGER_ENTER) && m_trigger->isEnabledForInstance(instance)) {
+				m_trigger->setTriggered();
 			}
 		}
 
 		// CellChangeListener callback
 		virtual void onInstanceExitedCell(Cell* cell, Instance* instance) {
-			const std::vector<TriggerCondition>& types = m_trigger->getTriggerConditions();
-			if (std::find(types.begin(), types.end(), CELL_TRIGGER_EXIT) != types.end()) {
-				const std::vector<Instance*>& restrict = m_trigger->getEnabledInstances();
-				if (m_trigger->isEnabledForAllInstances() ||
-					std::find(restrict.begin(), restrict.end(), instance) != restrict.end()) {
-					m_trigger->setTriggered();
-				}
+			if (m_trigger->hasTriggerCondition(CELL_TRIGGER_EXIT) && m_trigger->isEnabledForInstance(instance)) {
+				m_trigger->setTriggered();
 			}
 		}
 
 		// CellChangeListener callback
 		virtual void onBlockingChangedCell(Cell* cell, CellTypeInfo type, bool blocks) {
-			const std::vector<TriggerCondition>& types = m_trigger->getTriggerConditions();
-			if (std::find(types.begin(), types.end(), CELL_TRIGGER_BLOCKING_CHANGE) != types.end()) {
+			if (m_trigger->hasTriggerCondition(CELL_TRIGGER_BLOCKING_CHANGE)) {
 				m_trigger->setTriggered();
 			}
 		}
 
 		// InstanceChangeListener callback
 		virtual void onInstanceChanged(Instance* instance, InstanceChangeInfo info) {
-			const std::vector<TriggerCondition>& types = m_trigger->getTriggerConditions();
 			if (m_trigger->getAttached() == instance && (info & ICHANGE_CELL) == ICHANGE_CELL) {
 				m_trigger->move();
 			}
 
-			if (types.empty()) {
+			uint32_t conditions = m_trigger->getTriggerConditionMask() & INSTANCE_CONDITION_MASK;
+			if (conditions == 0) {
 				return;
 			}
 
-			if ((info & ICHANGE_LOC) == ICHANGE_LOC && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_LOCATION) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_ROTATION) == ICHANGE_ROTATION && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_ROTATION) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_SPEED) == ICHANGE_SPEED && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_SPEED) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_ACTION) == ICHANGE_ACTION && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_ACTION) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_TIME_MULTIPLIER) == ICHANGE_TIME_MULTIPLIER && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_TIME_MULTIPLIER) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_SAYTEXT) == ICHANGE_SAYTEXT && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_SAYTEXT) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_BLOCK) == ICHANGE_BLOCK && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_BLOCK) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_CELL) == ICHANGE_CELL && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_CELL) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_TRANSPARENCY) == ICHANGE_TRANSPARENCY && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_TRANSPARENCY) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_VISIBLE) == ICHANGE_VISIBLE && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_VISIBLE) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_STACKPOS) == ICHANGE_STACKPOS && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_STACKPOS) != types.end()) {
-				m_trigger->setTriggered();
-			} else if ((info & ICHANGE_VISUAL) == ICHANGE_VISUAL && std::find(types.begin(), types.end(), INSTANCE_TRIGGER_VISUAL) != types.end()) {
+			// translate the change bits into condition bits
+			uint32_t changed = 0;
+			for (uint32_t bit = 0; info != 0 && bit < sizeof(INSTANCE_CHANGE_CONDITIONS) / sizeof(TriggerCondition); ++bit, info >>= 1) {
+				if (info & 1) {
+					changed |= 1u << INSTANCE_CHANGE_CONDITIONS[bit];
+				}
+			}
+			if ((changed & conditions) != 0) {
 				m_trigger->setTriggered();
 			}
 		}
@@ -132,6 +125,7 @@ namespace FIFE {
 		m_name(""),
 		m_triggered(false),
 		m_enabledAll(false),
+		m_conditionMask(0),
 		m_attached(NULL) {
 			m_changeListener = new TriggerChangeListener(this);
 	}
@@ -140,6 +134,7 @@ namespace FIFE {
 		m_name(name),
 		m_triggered(false),
 		m_enabledAll(false),
+		m_conditionMask(0),
 		m_attached(NULL) {
 			m_changeListener = new TriggerChangeListener(this);
 	}
@@ -150,6 +145,13 @@ namespace FIFE {
 		for (; it != m_assigned.end(); ++it) {
 			(*it)->removeChangeListener(m_changeListener);
 		}
+		std::vector<TriggerRegion>::iterator rit = m_regions.begin();
+		for (; rit != m_regions.end(); ++rit) {
+			CellCache* cache = rit->layer->getCellCache();
+			if (cache) {
+				cache->removeCellChangeListener(rit->rect, m_changeListener);
+			}
+		}
 		delete m_changeListener;
 	}
 
@@ -195,6 +197,7 @@ namespace FIFE {
 		std::vector<TriggerCondition>::iterator it = std::find(m_triggerConditions.begin(), m_triggerConditions.end(), type);
 		if (it == m_triggerConditions.end()) {
 			m_triggerConditions.push_back(type);
+			m_conditionMask |= 1u << type;
 		}
 	}
 
@@ -206,12 +209,12 @@ namespace FIFE {
 		std::vector<TriggerCondition>::iterator it = std::find(m_triggerConditions.begin(), m_triggerConditions.end(), type);
 		if (it != m_triggerConditions.end()) {
 			m_triggerConditions.erase(it);
+			m_conditionMask &= ~(1u << type);
 		}
 	}
 
 	void Trigger::enableForInstance(Instance* instance) {
-		std::vector<Instance*>::iterator it = std::find(m_enabledInstances.begin(), m_enabledInstances.end(), instance);
-		if (it == m_enabledInstances.end()) {
+		if (m_enabledInstanceSet.insert(instance).second) {
 			m_enabledInstances.push_back(instance);
 		}
 	}
@@ -220,10 +223,20 @@ namespace FIFE {
 		return m_enabledInstances;
 	}
 
+	bool Trigger::isEnabledForInstance(Instance* instance) const {
+		if (m_enabledAll) {
+			return true;
+		}
+		// a few instances are found faster without hashing
+		if (m_enabledInstances.size() <= 8) {
+			return std::find(m_enabledInstances.begin(), m_enabledInstances.end(), instance) != m_enabledInstances.end();
+		}
+		return m_enabledInstanceSet.find(instance) != m_enabledInstanceSet.end();
+	}
+
 	void Trigger::disableForInstance(Instance* instance) {
-		std::vector<Instance*>::iterator it = std::find(m_enabledInstances.begin(), m_enabledInstances.end(), instance);
-		if (it != m_enabledInstances.end()) {
-			m_enabledInstances.erase(it);
+		if (m_enabledInstanceSet.erase(instance) > 0) {
+			m_enabledInstances.erase(std::find(m_enabledInstances.begin(), m_enabledInstances.end(), instance));
 		}
 	}
 
@@ -256,14 +269,56 @@ namespace FIFE {
 		if (!cell) {
 			return;
 		}
-		std::vector<Cell*>::iterator it = std::find(m_assigned.begin(), m_assigned.end(), cell);
-		if (it != m_assigned.end()) {
-			m_assigned.erase(it);
-			cell->removeChangeListener(m_changeListener);
+		remove(cell);
+	}
+
+	void Trigger::assign(Layer* layer, const Rect& rec) {
+		CellCache* cache = layer->getCellCache();
+		if (!cache || rec.w <= 0 || rec.h <= 0) {
+			return;
+		}
+		// the cells of the rect are covered by the region, so they don't need an own listener
+		subtractRegion(layer, rec);
+		std::vector<Cell*>::iterator it = m_assigned.begin();
+		while (it != m_assigned.end()) {
+			ModelCoordinate mc = (*it)->getLayerCoordinates();
+			if ((*it)->getLayer() == layer && mc.x >= rec.x && mc.x < rec.x + rec.w && mc.y >= rec.y && mc.y < rec.y + rec.h) {
+				(*it)->removeChangeListener(m_changeListener);
+				it = m_assigned.erase(it);
+			} else {
+				++it;
+			}
+		}
+		addRegion(layer, rec);
+	}
+
+	void Trigger::remove(Layer* layer, const Rect& rec) {
+		if (rec.w <= 0 || rec.h <= 0) {
+			return;
+		}
+		subtractRegion(layer, rec);
+		std::vector<Cell*>::iterator it = m_assigned.begin();
+		while (it != m_assigned.end()) {
+			ModelCoordinate mc = (*it)->getLayerCoordinates();
+			if ((*it)->getLayer() == layer && mc.x >= rec.x && mc.x < rec.x + rec.w && mc.y >= rec.y && mc.y < rec.y + rec.h) {
+				(*it)->removeChangeListener(m_changeListener);
+				it = m_assigned.erase(it);
+			} else {
+				++it;
+			}
 		}
 	}
 
 	void Trigger::assign(Cell* cell) {
+		ModelCoordinate mc = cell->getLayerCoordinates();
+		std::vector<TriggerRegion>::iterator rit = m_regions.begin();
+		for (; rit != m_regions.end(); ++rit) {
+			const Rect& r = rit->rect;
+			if (rit->layer == cell->getLayer() && mc.x >= r.x && mc.x < r.x + r.w && mc.y >= r.y && mc.y < r.y + r.h) {
+				// already covered by a region
+				return;
+			}
+		}
 		std::vector<Cell*>::iterator it = std::find(m_assigned.begin(), m_assigned.end(), cell);
 		if (it == m_assigned.end()) {
 			m_assigned.push_back(cell);
@@ -277,10 +332,69 @@ namespace FIFE {
 			m_assigned.erase(it);
 			cell->removeChangeListener(m_changeListener);
 		}
+		if (!m_regions.empty()) {
+			ModelCoordinate mc = cell->getLayerCoordinates();
+			subtractRegion(cell->getLayer(), Rect(mc.x, mc.y, 1, 1));
+		}
 	}
 
 	const std::vector<Cell*>& Trigger::getAssignedCells() {
-		return m_assigned;
+		if (m_regions.empty()) {
+			return m_assigned;
+		}
+		m_assignedAll = m_assigned;
+		std::vector<TriggerRegion>::iterator it = m_regions.begin();
+		for (; it != m_regions.end(); ++it) {
+			CellCache* cache = it->layer->getCellCache();
+			if (cache) {
+				std::vector<Cell*> cells = cache->getCellsInRect(it->rect);
+				m_assignedAll.insert(m_assignedAll.end(), cells.begin(), cells.end());
+			}
+		}
+		return m_assignedAll;
+	}
+
+	void Trigger::addRegion(Layer* layer, const Rect& rec) {
+		TriggerRegion region;
+		region.layer = layer;
+		region.rect = rec;
+		m_regions.push_back(region);
+		layer->getCellCache()->addCellChangeListener(rec, m_changeListener);
+	}
+
+	void Trigger::subtractRegion(Layer* layer, const Rect& rec) {
+		// regions are split into up to four parts around the removed rect
+		std::vector<TriggerRegion> regions;
+		regions.swap(m_regions);
+		std::vector<TriggerRegion>::iterator it = regions.begin();
+		for (; it != regions.end(); ++it) {
+			const Rect& r = it->rect;
+			int32_t left = std::max(r.x, rec.x);
+			int32_t top = std::max(r.y, rec.y);
+			int32_t right = std::min(r.x + r.w, rec.x + rec.w);
+			int32_t bottom = std::min(r.y + r.h, rec.y + rec.h);
+			if (it->layer != layer || left >= right || top >= bottom) {
+				m_regions.push_back(*it);
+				continue;
+			}
+			CellCache* cache = layer->getCellCache();
+			if (!cache) {
+				continue;
+			}
+			cache->removeCellChangeListener(r, m_changeListener);
+			if (top > r.y) {
+				addRegion(layer, Rect(r.x, r.y, r.w, top - r.y));
+			}
+			if (bottom < r.y + r.h) {
+				addRegion(layer, Rect(r.x, bottom, r.w, r.y + r.h - bottom));
+			}
+			if (left > r.x) {
+				addRegion(layer, Rect(r.x, top, left - r.x, bottom - top));
+			}
+			if (right < r.x + r.w) {
+				addRegion(layer, Rect(right, top, r.x + r.w - right, bottom - top));
+			}
+		}
 	}
 
 	void Trigger::attach(Instance* instance) {
@@ -305,7 +419,7 @@ namespace FIFE {
 	}
 
 	void Trigger::move() {
-		if (m_assigned.empty()) {
+		if (m_assigned.empty() && m_regions.empty()) {
 			return;
 		}
 		ModelCoordinate newPos = m_attached->getLocationRef().getLayerCoordinates();
@@ -342,5 +456,18 @@ namespace FIFE {
 			(*it)->removeChangeListener(m_changeListener);
 		}
 		m_assigned = newCells;
+
+		// move the regions
+		std::vector<TriggerRegion> regions;
+		regions.swap(m_regions);
+		std::vector<TriggerRegion>::iterator rit = regions.begin();
+		for (; rit != regions.end(); ++rit) {
+			CellCache* regionCache = rit->layer->getCellCache();
+			if (!regionCache) {
+				continue;
+			}
+			regionCache->removeCellChangeListener(rit->rect, m_changeListener);
+			addRegion(rit->layer, Rect(rit->rect.x + mc.x, rit->rect.y + mc.y, rit->rect.w, rit->rect.h));
+		}
 	}
 }
@@ -25,6 +25,7 @@
 // Standard C++ library includes
 #include <vector>
 #include <string>
+#include <unordered_set>
 
 // 3rd party library includes
 
@@ -33,6 +34,8 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "util/base/fifeclass.h"
+#include "util/structures/rect.h"
+#include "model/metamodel/modelcoords.h"
 
 namespace FIFE {
 	class Cell;
@@ -161,6 +164,16 @@ namespace FIFE {
 		 */
 		const std::vector<TriggerCondition>& getTriggerConditions();
 
+		/** Returns true if the trigger has the condition.
+		 *
+		 * @param type The trigger condition.
+		 */
+		bool hasTriggerCondition(TriggerCondition type) const { return (m_conditionMask & (1u << type)) != 0; }
+
+		/** Returns the trigger conditions as bitmask, bit n is set for condition n.
+		 */
+		uint32_t getTriggerConditionMask() const { return m_conditionMask; }
+
 		/** Removes trigger condition.
 		 *
 		 * @param type The trigger condition.
@@ -177,6 +190,13 @@ namespace FIFE {
 		 */
 		const std::vector<Instance*>& getEnabledInstances();
 
+		/** Returns if the trigger is enabled for the given instance,
+		 * either explicitly or because it is enabled for all instances.
+		 *
+		 * @param instance The instance to check.
+		 */
+		bool isEnabledForInstance(Instance* instance) const;
+
 		/** Disables trigger for given instance.
 		 *
 		 * @param instance The instance which is disabled for the trigger.
@@ -209,6 +229,21 @@ namespace FIFE {
 		 */
 		void remove(Layer* layer, const ModelCoordinate& pt);
 
+		/** Assigns trigger on the cells of the given layer and rect. The trigger is registered
+		 * once for the whole rect in the CellCache, not on every single cell.
+		 *
+		 * @param layer A pointer to the layer in which to add the Trigger to.
+		 * @param rec The Rect where the Trigger should be added, the right and bottom border are excluded.
+		 */
+		void assign(Layer* layer, const Rect& rec);
+
+		/** Removes trigger from the cells of the given layer and rect.
+		 *
+		 * @param layer A pointer to the layer in which to remove the Trigger from.
+		 * @param rec The Rect where the Trigger should be removed, the right and bottom border are excluded.
+		 */
+		void remove(Layer* layer, const Rect& rec);
+
 		/** Assigns trigger on given cell.
 		 *
 		 * @param cell A pointer to the cell in which to add the Trigger to.
@@ -221,7 +256,8 @@ namespace FIFE {
 		 */
 		void remove(Cell* cell);
 
-		/** Returns vector with the cells where the trigger is assigned to.
+		/** Returns vector with the cells where the trigger is assigned to,
+		 * including the cells of assigned rects.
 		 */
 		const std::vector<Cell*>& getAssignedCells();
 
@@ -252,6 +288,18 @@ namespace FIFE {
 		void moveTo(const ModelCoordinate& newPos, const ModelCoordinate& oldPos);
 
 	private:
+		//! rect on a layer where the trigger is assigned
+		struct TriggerRegion {
+			Layer* layer;
+			Rect rect;
+		};
+
+		//! adds a rect and registers it in the cache
+		void addRegion(Layer* layer, const Rect& rec);
+
+		//! removes a rect, parts outside of the removed area stay assigned
+		void subtractRegion(Layer* layer, const Rect& rec);
+
 		//! name of the trigger.  This should be unique per Map.
 		std::string m_name;
 
@@ -270,12 +318,24 @@ namespace FIFE {
 		//! cells in which the trigger is assigned
 		std::vector<Cell*> m_assigned;
 
+		//! rects in which the trigger is assigned
+		std::vector<TriggerRegion> m_regions;
+
+		//! assigned cells and the cells of the rects, built by getAssignedCells
+		std::vector<Cell*> m_assignedAll;
+
 		//! all trigger conditions
 		std::vector<TriggerCondition> m_triggerConditions;
 
+		//! bit n is set for trigger condition n
+		uint32_t m_conditionMask;
+
 		//! all enabled instances
 		std::vector<Instance*> m_enabledInstances;
 
+		//! all enabled instances, for the lookup on every event
+		std::unordered_set<Instance*> m_enabledInstanceSet;
+
 		//! instance where the trigger is attached to
 		Instance* m_attached;
 	};
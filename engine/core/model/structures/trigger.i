@@ -70,14 +70,19 @@ namespace FIFE {
 		void addTriggerCondition(TriggerCondition type);
 		const std::vector<TriggerCondition>& getTriggerConditions();
 		void removeTriggerCondition(TriggerCondition type);
+		bool hasTriggerCondition(TriggerCondition type) const;
+		uint32_t getTriggerConditionMask() const;
 		void enableForInstance(Instance* instance);
 		const std::vector<Instance*>& getEnabledInstances();
+		bool isEnabledForInstance(Instance* instance) const;
 		void disableForInstance(Instance* instance);
 		void enableForAllInstances();
 		bool isEnabledForAllInstances();
 		void disableForAllInstances();
 		void assign(Layer* layer, const ModelCoordinate& pt);
 		void remove(Layer* layer, const ModelCoordinate& pt);
+		void assign(Layer* layer, const Rect& rec);
+		void remove(Layer* layer, const Rect& rec);
 		void assign(Cell* cell);
 		void remove(Cell* cell);
 		void attach(Instance* instance);
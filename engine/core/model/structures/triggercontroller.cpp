@@ -90,10 +90,7 @@ namespace FIFE {
 		assert(layer->getCellCache());
 
 		Trigger* trigger = createTrigger(triggerName);
-		std::vector<Cell*> cells = layer->getCellCache()->getCellsInRect(rec);
-		for (std::vector<Cell*>::iterator it = cells.begin(); it != cells.end(); ++it) {
-			trigger->assign(*it);
-		}
+		trigger->assign(layer, rec);
 		return trigger;
 	}
 
@@ -173,10 +170,7 @@ namespace FIFE {
 	void TriggerController::removeTriggerFromRect(const std::string& triggerName, Layer* layer, const Rect& rec) {
 		TriggerNameMapIterator it = m_triggerNameMap.find(triggerName);
 		if (it != m_triggerNameMap.end()) {
-			std::vector<Cell*> cells = layer->getCellCache()->getCellsInRect(rec);
-			for (std::vector<Cell*>::iterator cit = cells.begin(); cit != cells.end(); ++cit) {
-				it->second->remove(*cit);
-			}
+			it->second->remove(layer, rec);
 		}
 	}
 
@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 
 // 3rd party library includes
 
@@ -28,7 +29,11 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "util/log/logger.h"
+#include "util/math/fife_math.h"
+#include "model/metamodel/grids/cellgrid.h"
 #include "model/metamodel/object.h"
+#include "model/structures/cell.h"
+#include "model/structures/cellcache.h"
 #include "model/structures/layer.h"
 #include "model/structures/location.h"
 
@@ -38,6 +43,152 @@ namespace FIFE {
 
 	static Logger _log(LM_STRUCTURES);
 
+	CellPath::CellPath():
+		m_lastLayer(0) {
+	}
+
+	void CellPath::clear() {
+		m_layers.clear();
+		m_cells.clear();
+		m_layerIndices.clear();
+		m_lastLayer = 0;
+	}
+
+	bool CellPath::empty() const {
+		return m_cells.empty();
+	}
+
+	uint32_t CellPath::size() const {
+		return m_cells.size();
+	}
+
+	void CellPath::reserve(uint32_t size) {
+		m_cells.reserve(size);
+	}
+
+	void CellPath::resize(uint32_t size) {
+		m_cells.resize(size);
+		if (!m_layerIndices.empty()) {
+			m_layerIndices.resize(size);
+		}
+	}
+
+	uint16_t CellPath::getLayerIndex(Layer* layer, const ModelCoordinate& origin, int32_t width) {
+		if (!m_layers.empty()) {
+			const PathLayer& last = m_layers[m_lastLayer];
+			if (last.layer == layer && last.origin == origin && last.width == width) {
+				return m_lastLayer;
+			}
+		}
+		uint16_t index = 0;
+		for (; index < m_layers.size(); ++index) {
+			const PathLayer& entry = m_layers[index];
+			if (entry.layer == layer && entry.origin == origin && entry.width == width) {
+				break;
+			}
+		}
+		if (index == m_layers.size()) {
+			PathLayer entry;
+			entry.layer = layer;
+			entry.origin = origin;
+			entry.width = width;
+			m_layers.push_back(entry);
+			// the second entry makes the per step indices necessary
+			if (m_layers.size() == 2) {
+				m_layerIndices.assign(m_cells.size(), 0);
+			}
+		}
+		m_lastLayer = index;
+		return index;
+	}
+
+	void CellPath::addCell(CellCache* cache, int32_t cell) {
+		const Rect& size = cache->getSize();
+		uint16_t index = getLayerIndex(cache->getLayer(), ModelCoordinate(size.x, size.y), cache->getWidth());
+		m_cells.push_back(cell);
+		if (m_layers.size() > 1) {
+			m_layerIndices.push_back(index);
+		}
+	}
+
+	void CellPath::assign(const Path& path) {
+		clear();
+		// one id space per layer, that covers all steps on it
+		std::vector<std::pair<Layer*, Rect> > bounds;
+		Path::const_iterator it = path.begin();
+		for (; it != path.end(); ++it) {
+			Layer* layer = (*it).getLayer();
+			ModelCoordinate mc = (*it).getLayerCoordinates();
+			std::vector<std::pair<Layer*, Rect> >::iterator bit = bounds.begin();
+			for (; bit != bounds.end(); ++bit) {
+				if (bit->first == layer) {
+					break;
+				}
+			}
+			if (bit == bounds.end()) {
+				bounds.push_back(std::make_pair(layer, Rect(mc.x, mc.y, mc.x, mc.y)));
+			} else {
+				Rect& rec = bit->second;
+				rec.x = std::min(rec.x, mc.x);
+				rec.y = std::min(rec.y, mc.y);
+				rec.w = std::max(rec.w, mc.x);
+				rec.h = std::max(rec.h, mc.y);
+			}
+		}
+
+		m_cells.reserve(path.size());
+		for (it = path.begin(); it != path.end(); ++it) {
+			Layer* layer = (*it).getLayer();
+			ModelCoordinate mc = (*it).getLayerCoordinates();
+			std::vector<std::pair<Layer*, Rect> >::const_iterator bit = bounds.begin();
+			for (; bit->first != layer; ++bit);
+			const Rect& rec = bit->second;
+			const int32_t width = rec.w - rec.x + 1;
+			uint16_t index = getLayerIndex(layer, ModelCoordinate(rec.x, rec.y), width);
+			m_cells.push_back((mc.x - rec.x) + (mc.y - rec.y) * width);
+			if (m_layers.size() > 1) {
+				m_layerIndices.push_back(index);
+			}
+		}
+	}
+
+	void CellPath::compact(const std::vector<bool>& keep) {
+		uint32_t kept = 0;
+		for (uint32_t i = 0; i < m_cells.size(); ++i) {
+			if (!keep[i]) {
+				continue;
+			}
+			m_cells[kept] = m_cells[i];
+			if (!m_layerIndices.empty()) {
+				m_layerIndices[kept] = m_layerIndices[i];
+			}
+			++kept;
+		}
+		resize(kept);
+		std::vector<int32_t>(m_cells).swap(m_cells);
+		if (!m_layerIndices.empty()) {
+			std::vector<uint16_t>(m_layerIndices).swap(m_layerIndices);
+		}
+	}
+
+	Layer* CellPath::getLayer(uint32_t index) const {
+		if (m_layerIndices.empty()) {
+			return m_layers.front().layer;
+		}
+		return m_layers[m_layerIndices[index]].layer;
+	}
+
+	ModelCoordinate CellPath::getLayerCoordinates(uint32_t index) const {
+		const PathLayer& entry = m_layerIndices.empty() ? m_layers.front() : m_layers[m_layerIndices[index]];
+		const int32_t cell = m_cells[index];
+		return ModelCoordinate(cell % entry.width + entry.origin.x, cell / entry.width + entry.origin.y);
+	}
+
+	void CellPath::getLocation(uint32_t index, Location& location) const {
+		location.setLayer(getLayer(index));
+		location.setLayerCoordinates(getLayerCoordinates(index));
+	}
+
 	Route::Route(const Location& start, const Location& end):
 		m_status(ROUTE_CREATED),
 		m_startNode(start),
@@ -48,7 +199,9 @@ namespace FIFE {
 		m_replanned(false),
 		m_ignoresBlocker(false),
 		m_costId(""),
-		m_object(NULL) {
+		m_object(NULL),
+		m_searchExpansions(0),
+		m_searchLatency(0) {
 	}
 
 	Route::~Route() {
@@ -68,9 +221,7 @@ namespace FIFE {
 		m_startNode = node;
 		if (m_status != ROUTE_CREATED) {
 			m_status = ROUTE_CREATED;
-			if (!m_path.empty()) {
-				m_path.clear();
-			}
+			m_path.clear();
 			m_walked = 1;
 		}
 	}
@@ -83,7 +234,7 @@ namespace FIFE {
 		if (m_status != ROUTE_CREATED) {
 			m_status = ROUTE_CREATED;
 			if (!m_path.empty()) {
-				m_startNode = *m_current;
+				m_startNode = getCurrentNode();
 				m_path.clear();
 			}
 			m_walked = 1;
@@ -95,43 +246,41 @@ namespace FIFE {
 		return m_endNode;
 	}
 
+	const Location& Route::getNode(uint32_t index, Location& node) {
+		// the first and the last step keep the exact coordinates
+		if (index == 0) {
+			return m_startNode;
+		}
+		if (index + 1 == m_path.size()) {
+			return m_endNode;
+		}
+		m_path.getLocation(index, node);
+		return node;
+	}
+
 	const Location& Route::getCurrentNode() {
 		if (m_path.empty()) {
 			return m_startNode;
 		}
-		if (m_current == m_path.end()) {
-			return m_path.back();
-		}
-		return *m_current;
+		return getNode(std::min(m_walked - 1, m_path.size() - 1), m_currentNode);
 	}
 
 	const Location& Route::getPreviousNode() {
 		if (m_path.empty()) {
 			return m_startNode;
 		}
-		if (m_current != m_path.begin()) {
-			--m_current;
-			const Location& loc = *m_current;
-			++m_current;
-			return loc;
+		uint32_t index = m_walked - 1;
+		if (index > 0) {
+			--index;
 		}
-		return *m_current;
+		return getNode(std::min(index, m_path.size() - 1), m_previousNode);
 	}
 
 	const Location& Route::getNextNode() {
 		if (m_path.empty()) {
 			return m_startNode;
 		}
-		if (m_current != m_path.end()) {
-			++m_current;
-			if (m_current != m_path.end()) {
-				const Location& loc = *m_current;
-				--m_current;
-				return loc;
-			}
-			--m_current;
-		}
-		return *m_current;
+		return getNode(std::min(m_walked, m_path.size() - 1), m_nextNode);
 	}
 
 	bool Route::walkToNextNode(int32_t step) {
@@ -143,11 +292,6 @@ namespace FIFE {
 		if (pos > static_cast<int32_t>(m_path.size()) || pos < 0) {
 			return false;
 		}
-		if (step > 0) {
-			for (int32_t i = 0; i < step; ++i, ++m_current);
-		} else {
-			for (int32_t i = 0; i > step; --i, --m_current);
-		}
 		m_walked += step;
 
 		return true;
@@ -157,16 +301,33 @@ namespace FIFE {
 		if (m_path.empty()) {
 			return true;
 		}
-		return m_current == m_path.end();
+		return m_walked > m_path.size();
 	}
 
 	void Route::setPath(const Path& path) {
+		m_path.assign(path);
+		if (!m_path.empty()) {
+			m_status = ROUTE_SOLVED;
+			m_startNode = path.front();
+			m_endNode = path.back();
+		}
+		if (!isMultiCell()) {
+			m_replanned = false;
+		}
+		m_walked = 1;
+	}
+
+	void Route::setPath(const CellPath& path) {
 		m_path = path;
 		if (!m_path.empty()) {
 			m_status = ROUTE_SOLVED;
-			m_current = m_path.begin();
-			m_startNode = m_path.front();
-			m_endNode = m_path.back();
+			// keep the exact start coordinates if the path begins at the start cell
+			ModelCoordinate start = m_startNode.getLayerCoordinates();
+			ModelCoordinate first = m_path.getLayerCoordinates(0);
+			if (m_startNode.getLayer() != m_path.getLayer(0) || start.x != first.x || start.y != first.y) {
+				m_path.getLocation(0, m_startNode);
+			}
+			m_path.getLocation(m_path.size() - 1, m_endNode);
 		}
 		if (!isMultiCell()) {
 			m_replanned = false;
@@ -175,16 +336,24 @@ namespace FIFE {
 	}
 
 	Path Route::getPath() {
+		Path path;
+		Location node;
+		for (uint32_t i = 0; i < m_path.size(); ++i) {
+			path.push_back(getNode(i, node));
+		}
+		return path;
+	}
+
+	const CellPath& Route::getCellPath() const {
 		return m_path;
 	}
 
 	void Route::cutPath(uint32_t length) {
 		if (length == 0) {
 			if (!m_path.empty()) {
-				m_startNode = *m_current;
-				m_endNode = *m_current;
+				m_startNode = getCurrentNode();
+				m_endNode = m_startNode;
 				m_path.clear();
-				m_current = m_path.end();
 			}
 			m_status = ROUTE_CREATED;
 			m_walked = 1;
@@ -200,10 +369,53 @@ namespace FIFE {
 		}
 
 		m_path.resize(newend);
-		m_endNode = m_path.back();
+		m_path.getLocation(newend - 1, m_endNode);
 		m_replanned = true;
 	}
 
+	void Route::smoothPath() {
+		if (m_path.size() < 3 || isMultiCell()) {
+			return;
+		}
+
+		std::vector<bool> keep(m_path.size(), true);
+		uint32_t anchor = 0;
+		for (uint32_t i = 1; i + 1 < m_path.size(); ++i) {
+			Layer* layer = m_path.getLayer(i);
+			if (layer != m_path.getLayer(anchor) || layer != m_path.getLayer(i + 1)) {
+				anchor = i;
+				continue;
+			}
+			CellCache* cache = layer->getCellCache();
+			Cell* cell = cache ? cache->getCell(m_path.getLayerCoordinates(i)) : NULL;
+			Cell* anchorCell = cache ? cache->getCell(m_path.getLayerCoordinates(anchor)) : NULL;
+			Cell* nextCell = cache ? cache->getCell(m_path.getLayerCoordinates(i + 1)) : NULL;
+			if (!cell || !anchorCell || !nextCell || cell->getTransition() ||
+				cell->getLayerCoordinates().z != anchorCell->getLayerCoordinates().z ||
+				cell->getLayerCoordinates().z != nextCell->getLayerCoordinates().z) {
+				anchor = i;
+				continue;
+			}
+			// the step can be left out if it lies on the line between anchor and next step
+			CellGrid* grid = layer->getCellGrid();
+			ExactModelCoordinate a = grid->toMapCoordinates(m_path.getLayerCoordinates(anchor));
+			ExactModelCoordinate b = grid->toMapCoordinates(m_path.getLayerCoordinates(i));
+			ExactModelCoordinate c = grid->toMapCoordinates(m_path.getLayerCoordinates(i + 1));
+			double abx = b.x - a.x;
+			double aby = b.y - a.y;
+			double bcx = c.x - b.x;
+			double bcy = c.y - b.y;
+			double cross = abx * bcy - aby * bcx;
+			double dot = abx * bcx + aby * bcy;
+			if (dot > 0 && Mathd::Equal(cross, 0.0)) {
+				keep[i] = false;
+			} else {
+				anchor = i;
+			}
+		}
+		m_path.compact(keep);
+	}
+
 	void Route::setReplanned(bool replanned) {
 		m_replanned = replanned;
 	}
@@ -301,17 +513,29 @@ namespace FIFE {
 
 	Path Route::getBlockingPathLocations() {
 		Path p;
-		if (!m_path.empty()) {
-			for (PathIterator it = m_path.begin(); it != m_path.end(); ++it) {
-				Layer* layer = (*it).getLayer();
-				if (layer->cellContainsBlockingInstance((*it).getLayerCoordinates())) {
-					p.push_back(*it);
-				}
+		Location node;
+		for (uint32_t i = 0; i < m_path.size(); ++i) {
+			Layer* layer = m_path.getLayer(i);
+			if (layer->cellContainsBlockingInstance(m_path.getLayerCoordinates(i))) {
+				p.push_back(getNode(i, node));
 			}
 		}
 		return p;
 	}
 
+	void Route::setSearchStatistics(uint32_t expansions, double latency) {
+		m_searchExpansions = expansions;
+		m_searchLatency = latency;
+	}
+
+	uint32_t Route::getSearchExpansions() {
+		return m_searchExpansions;
+	}
+
+	double Route::getSearchLatency() {
+		return m_searchLatency;
+	}
+
 	void Route::setObject(Object* obj) {
 		m_object = obj;
 	}
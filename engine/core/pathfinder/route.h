@@ -24,6 +24,7 @@
 
 // Standard C++ library includes
 #include <list>
+#include <vector>
 
 // 3rd party library includes
 
@@ -31,11 +32,14 @@
 // These includes are split up in two parts, separated by one empty line
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
+#include "model/metamodel/modelcoords.h"
+#include "model/structures/location.h"
 #include "util/base/fifeclass.h"
 
 namespace FIFE {
 
-	class Location;
+	class CellCache;
+	class Layer;
 	class Object;
 
 	/** Defines different route status types for the search.
@@ -58,6 +62,113 @@ namespace FIFE {
 	//! A path is a list with locations. Each location holds the coordinate for one cell.
 	typedef std::list<Location> Path;
 
+	/** Compact storage for the steps of a path.
+	 *
+	 * Each step is stored as a cell id plus, for paths that cross layers, the index
+	 * into a small layer table. The table entry keeps the origin and width the ids were
+	 * made with, so the ids stay valid if the CellCache is resized later on.
+	 */
+	class CellPath {
+	public:
+		/** Constructor
+		 */
+		CellPath();
+
+		/** Removes all steps.
+		 */
+		void clear();
+
+		/** Gets if the path contains no steps.
+		 * @return A boolean, true if there are no steps, otherwise false.
+		 */
+		bool empty() const;
+
+		/** Returns the number of steps.
+		 * @return The number of steps.
+		 */
+		uint32_t size() const;
+
+		/** Reserves memory for the given number of steps.
+		 * @param size The number of steps.
+		 */
+		void reserve(uint32_t size);
+
+		/** Cuts the path after the given number of steps.
+		 * @param size The new number of steps, must not be larger than size().
+		 */
+		void resize(uint32_t size);
+
+		/** Adds a step at the end of the path.
+		 * @param cache A pointer to the CellCache the cell id belongs to.
+		 * @param cell The cell id, @see CellCache::convertCoordToInt()
+		 */
+		void addCell(CellCache* cache, int32_t cell);
+
+		/** Adds steps at the end of the path.
+		 * @param cache A pointer to the CellCache the cell ids belong to.
+		 * @param first Iterator to the first cell id.
+		 * @param last Iterator behind the last cell id.
+		 */
+		template<typename Iterator>
+		void addCells(CellCache* cache, Iterator first, Iterator last) {
+			for (; first != last; ++first) {
+				addCell(cache, *first);
+			}
+		}
+
+		/** Replaces the steps with the cells of the given locations.
+		 * @param path A const reference to the path.
+		 */
+		void assign(const Path& path);
+
+		/** Removes the steps that are not marked to keep.
+		 * @param keep A const reference to a vector that holds one flag per step.
+		 */
+		void compact(const std::vector<bool>& keep);
+
+		/** Returns the layer of a step.
+		 * @param index The index of the step.
+		 * @return A pointer to the layer.
+		 */
+		Layer* getLayer(uint32_t index) const;
+
+		/** Returns the layer coordinates of a step.
+		 * @param index The index of the step.
+		 * @return The coordinates of the cell.
+		 */
+		ModelCoordinate getLayerCoordinates(uint32_t index) const;
+
+		/** Sets the location to the center of the cell of a step.
+		 * @param index The index of the step.
+		 * @param location A reference to the location that should be set.
+		 */
+		void getLocation(uint32_t index, Location& location) const;
+
+	private:
+		//! cell id space of one layer
+		struct PathLayer {
+			Layer* layer;
+			ModelCoordinate origin;
+			int32_t width;
+		};
+
+		/** Returns the index of the layer table entry, adds one if needed.
+		 */
+		uint16_t getLayerIndex(Layer* layer, const ModelCoordinate& origin, int32_t width);
+
+		//! layer table
+		std::vector<PathLayer> m_layers;
+
+		//! cell ids of the steps
+		std::vector<int32_t> m_cells;
+
+		//! layer table index of the steps, empty as long as only one layer is used
+		std::vector<uint16_t> m_layerIndices;
+
+		//! last used layer table entry
+		uint16_t m_lastLayer;
+	};
+
 	/** A basic route.
 	 * Holds the path and all related infos.
 	 */
@@ -140,11 +251,29 @@ namespace FIFE {
 		 */
 		Path getPath();
 
+		/** Sets the path for the route.
+		 * @param path A const reference to the compact path.
+		 */
+		void setPath(const CellPath& path);
+
+		/** Returns the compact path.
+		 * The first and the last step are the cells of the start and end location.
+		 * @return A const reference to the compact path.
+		 */
+		const CellPath& getCellPath() const;
+
 		/** Cuts path after the given length.
 		 * @param length The new length of the path.
 		 */
 		void cutPath(uint32_t length = 1);
 
+		/** Removes the steps that lie on a straight line between their neighbors.
+		 * Only steps on the same layer and with the same cell height are merged and
+		 * transition cells are always kept. Instances do not check the merged cells for
+		 * dynamic blockers anymore, so this is optional. Multi cell routes are not changed.
+		 */
+		void smoothPath();
+
 		/** Sets the route to replanned.
 		 * @param replanned A boolean that indicates if true the route is replanned, otherwise false.
 		 */
@@ -240,6 +369,22 @@ namespace FIFE {
 		 */
 		Path getBlockingPathLocations();
 
+		/** Sets the statistics of the search that solved the route.
+		 * @param expansions The number of expanded nodes.
+		 * @param latency The time in milliseconds from the request to the solution.
+		 */
+		void setSearchStatistics(uint32_t expansions, double latency);
+
+		/** Returns the number of nodes the search expanded.
+		 * @return The number of expanded nodes.
+		 */
+		uint32_t getSearchExpansions();
+
+		/** Returns the time from the request to the solution.
+		 * @return The latency in milliseconds.
+		 */
+		double getSearchLatency();
+
 		/** Sets the object, needed for multi cell and z-step range.
 		 * @param obj A pointer to the object.
 		 */
@@ -251,8 +396,12 @@ namespace FIFE {
 		Object* getObject();
 
 	private:
-		//! path iterator
-		typedef Path::iterator PathIterator;
+		/** Sets the location to the given step of the path.
+		 * @param index The index of the step, must be lower than the path length.
+		 * @param node A reference to the location that should be set.
+		 * @return A const reference to the location of the step.
+		 */
+		const Location& getNode(uint32_t index, Location& node);
 
 		//! search status
 		RouteStatusInfo m_status;
@@ -264,12 +413,18 @@ namespace FIFE {
 		Location m_endNode;
 
 		//! path
-		Path m_path;
+		CellPath m_path;
+
+		//! returned by getCurrentNode()
+		Location m_currentNode;
 
-		//! current position on the path
-		PathIterator m_current;
+		//! returned by getPreviousNode()
+		Location m_previousNode;
 
-		//! walked steps on the path
+		//! returned by getNextNode()
+		Location m_nextNode;
+
+		//! walked steps on the path, the current step is m_walked - 1
 		uint32_t m_walked;
 
 		//! session id of the search
@@ -292,6 +447,12 @@ namespace FIFE {
 
 		//! pointer to multi object
 		Object* m_object;
+
+		//! expanded nodes of the search
+		uint32_t m_searchExpansions;
+
+		//! time from request to solution in milliseconds
+		double m_searchLatency;
 	};
 
 } // FIFE
@@ -24,5 +24,68 @@
 #include "pathfinder/route.h"
 %}
 
+%include "model/structures/location.i"
+
 %template(LocationList) std::list<FIFE::Location>;
 
+namespace FIFE {
+
+	class Object;
+
+	enum RouteStatus {
+		ROUTE_CREATED = 0,
+		ROUTE_SEARCHING,
+		ROUTE_SEARCHED,
+		ROUTE_SOLVED,
+		ROUTE_FAILED
+	};
+	typedef uint8_t RouteStatusInfo;
+	typedef std::list<Location> Path;
+
+	class Route : public FifeClass {
+	public:
+		Route(const Location& start, const Location& end);
+		~Route();
+
+		void setRouteStatus(RouteStatusInfo status);
+		RouteStatusInfo getRouteStatus();
+		void setStartNode(const Location& node);
+		const Location& getStartNode();
+		void setEndNode(const Location& node);
+		const Location& getEndNode();
+		const Location& getCurrentNode();
+		const Location& getPreviousNode();
+		const Location& getNextNode();
+		bool walkToNextNode(int32_t step = 1);
+		bool reachedEnd();
+		void setPath(const Path& path);
+		Path getPath();
+		void cutPath(uint32_t length = 1);
+		void smoothPath();
+		void setReplanned(bool replanned);
+		bool isReplanned();
+		uint32_t getPathLength();
+		uint32_t getWalkedLength();
+		void setSessionId(int32_t id);
+		int32_t getSessionId();
+		void setRotation(int32_t rotation);
+		int32_t getRotation();
+		void setCostId(const std::string& cost);
+		const std::string& getCostId();
+		bool isMultiCell();
+		void setOccupiedArea(const std::vector<ModelCoordinate>& area);
+		const std::vector<ModelCoordinate>& getOccupiedArea();
+		std::vector<ModelCoordinate> getOccupiedCells(int32_t rotation);
+		int32_t getZStepRange();
+		bool isAreaLimited();
+		const std::list<std::string> getLimitedAreas();
+		void setDynamicBlockerIgnored(bool ignore);
+		bool isDynamicBlockerIgnored();
+		Path getBlockingPathLocations();
+		uint32_t getSearchExpansions();
+		double getSearchLatency();
+		void setObject(Object* obj);
+		Object* getObject();
+	};
+}
+
@@ -297,11 +297,9 @@ namespace FIFE {
 	void MultiLayerSearch::calcPathStep() {
 		int32_t current = m_lastDestCoordInt;
 		int32_t end = m_lastStartCoordInt;
-		Location newnode(m_currentCache->getLayer());
-		Path path;
-		// This assures that the agent always steps into the center of the target cell.
-		newnode.setLayerCoordinates(m_currentCache->convertIntToCoord(current));
-		path.push_back(newnode);
+		// the shortest path tree is walked backwards from the target
+		std::vector<int32_t> cells;
+		cells.push_back(current);
 		while(current != end) {
 			if (m_spt[current] < 0 ) {
 				// This is when the size of m_spt can not handle the distance of the location
@@ -310,25 +308,17 @@ namespace FIFE {
 				break;
 			}
 			current = m_spt[current];
-			newnode.setLayerCoordinates(m_currentCache->convertIntToCoord(current));
-			path.push_front(newnode);
+			cells.push_back(current);
 		}
-		// set exact start coordinates
-		if (m_path.empty()) {
-			path.front().setExactLayerCoordinates(m_from.getExactLayerCoordinatesRef());
-		}
-		m_path.insert(m_path.end(), path.begin(), path.end());
+		// the route keeps the exact start coordinates
+		m_path.addCells(m_currentCache, cells.rbegin(), cells.rend());
 	}
 
 	void MultiLayerSearch::calcPath() {
 		int32_t current = m_lastDestCoordInt;
 		int32_t end = m_lastStartCoordInt;
-		Location newnode(m_currentCache->getLayer());
-		Path path;
-		// This assures that the agent always steps into the center of the target cell.
-		newnode.setLayerCoordinates(
-			m_currentCache->getCell(m_currentCache->convertIntToCoord(current))->getLayerCoordinates());
-		path.push_back(newnode);
+		std::vector<int32_t> cells;
+		cells.push_back(current);
 		while(current != end) {
 			if (m_spt[current] < 0 ) {
 				// This is when the size of m_spt can not handle the distance of the location
@@ -337,10 +327,9 @@ namespace FIFE {
 				break;
 			}
 			current = m_spt[current];
-			newnode.setLayerCoordinates(m_currentCache->convertIntToCoord(current));
-			path.push_front(newnode);
+			cells.push_back(current);
 		}
-		m_path.insert(m_path.end(), path.begin(), path.end());
+		m_path.addCells(m_currentCache, cells.rbegin(), cells.rend());
 		m_route->setPath(m_path);
 	}
 
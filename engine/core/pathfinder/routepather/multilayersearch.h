@@ -132,7 +132,7 @@ namespace FIFE {
 		//! Indicates if last between target could be achieved
 		bool m_foundLast;
 		//! Path to which all steps are added.
-		Path m_path;
+		CellPath m_path;
 	};
 }
 #endif
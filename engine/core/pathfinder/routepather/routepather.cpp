@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 #include <cassert>
 
 // 3rd party library includes
@@ -33,6 +34,7 @@
 #include "model/structures/layer.h"
 #include "model/structures/cellcache.h"
 #include "util/math/angles.h"
+#include "util/time/profiler.h"
 #include "pathfinder/route.h"
 
 #include "routepather.h"
@@ -42,6 +44,26 @@
 
 namespace FIFE {
 
+	RoutePather::RoutePather():
+		m_nextFreeSessionId(0),
+		m_maxTicks(1000),
+		m_pathSmoothing(false),
+		m_maxTime(0),
+		m_batchSize(100),
+		m_priorityAging(10),
+		m_turn(0),
+		m_frameExpansions(0),
+		m_frameTime(0) {
+		resetSearchStats();
+	}
+
+	RoutePather::~RoutePather() {
+		SessionQueue::iterator it = m_sessions.begin();
+		for (; it != m_sessions.end(); ++it) {
+			delete it->search;
+		}
+	}
+
 	int32_t RoutePather::makeSessionId() {
 		return m_nextFreeSessionId++;
 	}
@@ -55,35 +77,100 @@ namespace FIFE {
 	}
 
 	void RoutePather::update() {
+		FIFE_PROFILE_ZONE("RoutePather::update");
+		const Clock::time_point frameStart = Clock::now();
+		const Clock::time_point deadline = frameStart + std::chrono::microseconds(m_maxTime);
+		const uint32_t firstTurn = m_turn + 1;
+		m_frameExpansions = 0;
 		int32_t ticksleft = m_maxTicks;
-		while (ticksleft > 0) {
-			if(m_sessions.empty()) {
+		while (ticksleft > 0 && !m_sessions.empty()) {
+			if (m_maxTime > 0 && Clock::now() >= deadline) {
 				break;
 			}
-			RoutePatherSearch* prioritySession = m_sessions.getPriorityElement().first;
-			if(!sessionIdValid(prioritySession->getSessionId())) {
-				delete prioritySession;
-				m_sessions.popElement();
+			SessionQueue::iterator session = getNextSession();
+			RoutePatherSearch* search = session->search;
+			if (!sessionIdValid(search->getSessionId())) {
+				delete search;
+				m_sessions.erase(session);
+				continue;
+			}
+			session->age = 0;
+			session->lastTurn = ++m_turn;
+			// one turn, ends early if the search is done or the time is up
+			int32_t batch = std::min(m_batchSize, ticksleft);
+			while (batch > 0) {
+				search->updateSearch();
+				++session->expansions;
+				++m_frameExpansions;
+				--ticksleft;
+				--batch;
+				if (search->getSearchStatus() != RoutePatherSearch::search_status_incomplete) {
+					break;
+				}
+				if (m_maxTime > 0 && Clock::now() >= deadline) {
+					break;
+				}
+			}
+			if (search->getSearchStatus() == RoutePatherSearch::search_status_incomplete) {
 				continue;
 			}
-			prioritySession->updateSearch();
-			if (prioritySession->getSearchStatus() == RoutePatherSearch::search_status_complete) {
-				const int32_t sessionId = prioritySession->getSessionId();
-				prioritySession->calcPath();
-				Route* route = prioritySession->getRoute();
-				if (route->getRouteStatus() == ROUTE_SOLVED) {
-					invalidateSessionId(sessionId);
-					delete prioritySession;
-					m_sessions.popElement();
+			const int32_t sessionId = search->getSessionId();
+			Route* route = search->getRoute();
+			if (search->getSearchStatus() == RoutePatherSearch::search_status_complete) {
+				search->calcPath();
+				if (route->getRouteStatus() != ROUTE_SOLVED) {
+					// the session is gone, so a route without a path would wait forever
+					route->setRouteStatus(ROUTE_FAILED);
+				} else if (m_pathSmoothing) {
+					route->smoothPath();
 				}
-			} else if (prioritySession->getSearchStatus() == RoutePatherSearch::search_status_failed) {
-				const int32_t sessionId = prioritySession->getSessionId();
-				invalidateSessionId(sessionId);
-				delete prioritySession;
-				m_sessions.popElement();
 			}
-			--ticksleft;
+			addSearchStats(route, session->expansions, session->start);
+			invalidateSessionId(sessionId);
+			delete search;
+			m_sessions.erase(session);
 		}
+		// sessions without a turn get older
+		SessionQueue::iterator it = m_sessions.begin();
+		for (; it != m_sessions.end(); ++it) {
+			if (it->lastTurn < firstTurn) {
+				++it->age;
+			}
+		}
+		m_frameTime = std::chrono::duration<double, std::micro>(Clock::now() - frameStart).count();
+	}
+
+	RoutePather::SessionQueue::iterator RoutePather::getNextSession() {
+		SessionQueue::iterator next = m_sessions.end();
+		int32_t nextPriority = 0;
+		SessionQueue::iterator it = m_sessions.begin();
+		for (; it != m_sessions.end(); ++it) {
+			// lower values are more important, waiting makes a session more important
+			int32_t priority = it->priority;
+			if (m_priorityAging > 0) {
+				priority -= it->age / m_priorityAging;
+			}
+			if (next == m_sessions.end() || priority < nextPriority ||
+				(priority == nextPriority && it->lastTurn < next->lastTurn)) {
+				next = it;
+				nextPriority = priority;
+			}
+		}
+		return next;
+	}
+
+	void RoutePather::addSearchStats(Route* route, uint32_t expansions, const Clock::time_point& start) {
+		if (route->getRouteStatus() != ROUTE_SOLVED) {
+			++m_failedSearches;
+			return;
+		}
+		double latency = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		route->setSearchStatistics(expansions, latency);
+		++m_solvedSearches;
+		m_totalExpansions += expansions;
+		m_maxExpansions = std::max(m_maxExpansions, expansions);
+		m_totalLatency += latency;
+		m_maxLatency = std::max(m_maxLatency, latency);
 	}
 
 	bool RoutePather::cancelSession(const int32_t sessionId) {
@@ -241,15 +328,13 @@ namespace FIFE {
 			route->setSessionId(sessionId);
 		}
 
-		RoutePatherSearch* newSearch;
-		if (multilayer) {
-			newSearch = new MultiLayerSearch(route, sessionId);
-		} else {
-			newSearch = new SingleLayerSearch(route, sessionId);
-		}
+		RoutePatherSearch* newSearch = createSearch(route, sessionId, multilayer);
 		if (immediate) {
+			const Clock::time_point start = Clock::now();
+			uint32_t expansions = 0;
 			while (newSearch->getSearchStatus() != RoutePatherSearch::search_status_complete) {
 				newSearch->updateSearch();
+				++expansions;
 				if (newSearch->getSearchStatus() == RoutePatherSearch::search_status_failed) {
 					route->setRouteStatus(ROUTE_FAILED);
 					break;
@@ -259,18 +344,35 @@ namespace FIFE {
 			if (newSearch->getSearchStatus() == RoutePatherSearch::search_status_complete) {
 				newSearch->calcPath();
 				route->setRouteStatus(ROUTE_SOLVED);
+				if (m_pathSmoothing) {
+					route->smoothPath();
+				}
 			}
+			addSearchStats(route, expansions, start);
 			delete newSearch;
 			return true;
 		}
-		m_sessions.pushElement(SessionQueue::value_type(newSearch, priority));
+		SearchSession session;
+		session.search = newSearch;
+		session.priority = priority;
+		session.age = 0;
+		session.lastTurn = 0;
+		session.expansions = 0;
+		session.start = Clock::now();
+		m_sessions.push_back(session);
 		addSessionId(sessionId);
 		return true;
 	}
 
+	RoutePatherSearch* RoutePather::createSearch(Route* route, const int32_t sessionId, bool multilayer) {
+		if (multilayer) {
+			return new MultiLayerSearch(route, sessionId);
+		}
+		return new SingleLayerSearch(route, sessionId);
+	}
+
 	bool RoutePather::followRoute(const Location& current, Route* route, double speed, Location& nextLocation) {
-		Path path = route->getPath();
-		if (path.empty()) {
+		if (route->getPathLength() == 0) {
 			return false;
 		}
 		if (Mathd::Equal(speed, 0.0)) {
@@ -352,10 +454,10 @@ namespace FIFE {
 			pop = true;
 		}
 		if (!Mathd::Equal(distance, 0.0) && !pop) {
-			Location prevNode = route->getPreviousNode();
+			const Location& prevNode = route->getPreviousNode();
 			CellCache* prevCache = prevNode.getLayer()->getCellCache();
 			CellGrid* prevGrid = prevNode.getLayer()->getCellGrid();
-			ExactModelCoordinate prevPos = route->getPreviousNode().getMapCoordinates();
+			ExactModelCoordinate prevPos = prevNode.getMapCoordinates();
 			tmpCell = prevCache->getCell(prevNode.getLayerCoordinates());
 			if (tmpCell) {
 				prevPos.z = tmpCell->getLayerCoordinates().z + prevGrid->getZShift();
@@ -438,6 +540,89 @@ namespace FIFE {
 		return m_maxTicks;
 	}
 
+	void RoutePather::setMaxTime(uint32_t time) {
+		m_maxTime = time;
+	}
+
+	uint32_t RoutePather::getMaxTime() {
+		return m_maxTime;
+	}
+
+	void RoutePather::setSearchBatchSize(int32_t size) {
+		m_batchSize = std::max(size, 1);
+	}
+
+	int32_t RoutePather::getSearchBatchSize() {
+		return m_batchSize;
+	}
+
+	void RoutePather::setPriorityAging(int32_t frames) {
+		m_priorityAging = std::max(frames, 0);
+	}
+
+	int32_t RoutePather::getPriorityAging() {
+		return m_priorityAging;
+	}
+
+	uint32_t RoutePather::getActiveSessions() const {
+		return m_sessions.size();
+	}
+
+	uint32_t RoutePather::getFrameExpansions() const {
+		return m_frameExpansions;
+	}
+
+	double RoutePather::getFrameTime() const {
+		return m_frameTime;
+	}
+
+	uint32_t RoutePather::getSolvedSearches() const {
+		return m_solvedSearches;
+	}
+
+	uint32_t RoutePather::getFailedSearches() const {
+		return m_failedSearches;
+	}
+
+	double RoutePather::getAverageSearchExpansions() const {
+		if (m_solvedSearches == 0) {
+			return 0;
+		}
+		return static_cast<double>(m_totalExpansions) / m_solvedSearches;
+	}
+
+	uint32_t RoutePather::getMaxSearchExpansions() const {
+		return m_maxExpansions;
+	}
+
+	double RoutePather::getAverageSearchLatency() const {
+		if (m_solvedSearches == 0) {
+			return 0;
+		}
+		return m_totalLatency / m_solvedSearches;
+	}
+
+	double RoutePather::getMaxSearchLatency() const {
+		return m_maxLatency;
+	}
+
+	void RoutePather::resetSearchStats() {
+		m_solvedSearches = 0;
+		m_failedSearches = 0;
+		m_totalExpansions = 0;
+		m_maxExpansions = 0;
+		m_totalLatency = 0;
+		m_maxLatency = 0;
+	}
+
+	void RoutePather::setPathSmoothing(bool smoothing) {
+		m_pathSmoothing = smoothing;
+	}
+
+	bool RoutePather::isPathSmoothing() {
+		return m_pathSmoothing;
+	}
+
 	std::string RoutePather::getName() const {
 		return "RoutePather";
 	}
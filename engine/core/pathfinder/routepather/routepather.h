@@ -23,6 +23,7 @@
 #define FIFE_PATHFINDER_ROUTEPATHER
 
 // Standard C++ library includes
+#include <chrono>
 #include <map>
 #include <vector>
 
@@ -34,7 +35,6 @@
 // Second block: files included from the same folder
 #include "model/metamodel/ipather.h"
 #include "model/structures/location.h"
-#include "util/structures/priorityqueue.h"
 
 namespace FIFE {
 
@@ -47,8 +47,12 @@ namespace FIFE {
 		/** Constructor.
 		 *
 		 */
-		RoutePather() : m_nextFreeSessionId(0), m_maxTicks(1000) {
-		}
+		RoutePather();
+
+		/** Destructor.
+		 *
+		 */
+		virtual ~RoutePather();
 
 		/** Creates a route between the start and end location that needs be solved.
 		 *
@@ -80,10 +84,11 @@ namespace FIFE {
 		
 		/** Updates the route pather.
 		 *
-		 * Advances the active search by so many time steps. If the search
-		 * completes then this function pops it from the active session list and
-		 * continues updating the next session until it runs out of time.
-		 * @see setMaxTicks()
+		 * Gives the sessions turns of up to search batch size node expansions. The session
+		 * with the highest priority goes first, sessions with the same priority take turns.
+		 * Completed sessions are removed from the active session list. The update ends when
+		 * all sessions are done or the node or time budget is used up.
+		 * @see setMaxTicks(), setMaxTime(), setSearchBatchSize(), setPriorityAging()
 		 */
 		void update();
 
@@ -107,17 +112,134 @@ namespace FIFE {
 		 */
 		int32_t getMaxTicks();
 
+		/** Sets the time budget per update to solve routes. @see update()
+		 * @param time The time in microseconds, 0 means no limit. default is 0
+		 */
+		void setMaxTime(uint32_t time);
+
+		/** Returns the time budget per update to solve routes. @see update()
+		 * @return The time in microseconds, 0 means no limit. default is 0
+		 */
+		uint32_t getMaxTime();
+
+		/** Sets the number of node expansions a session can do in one turn. @see update()
+		 * @param size The number of expansions. default is 100
+		 */
+		void setSearchBatchSize(int32_t size);
+
+		/** Returns the number of node expansions a session can do in one turn. @see update()
+		 * @return The number of expansions. default is 100
+		 */
+		int32_t getSearchBatchSize();
+
+		/** Sets after how many updates without a turn the priority of a session is raised by one. @see update()
+		 * @param frames The number of updates, 0 disables the aging. default is 10
+		 */
+		void setPriorityAging(int32_t frames);
+
+		/** Returns after how many updates without a turn the priority of a session is raised by one. @see update()
+		 * @return The number of updates, 0 means the aging is disabled. default is 10
+		 */
+		int32_t getPriorityAging();
+
+		/** Returns the number of sessions that wait for or are in progress.
+		 * @return The number of sessions.
+		 */
+		uint32_t getActiveSessions() const;
+
+		/** Returns the node expansions of the last update.
+		 * @return The number of expansions.
+		 */
+		uint32_t getFrameExpansions() const;
+
+		/** Returns the time spent in the last update.
+		 * @return The time in microseconds.
+		 */
+		double getFrameTime() const;
+
+		/** Returns the number of solved searches since the last reset.
+		 * @return The number of searches.
+		 */
+		uint32_t getSolvedSearches() const;
+
+		/** Returns the number of failed searches since the last reset.
+		 * @return The number of searches.
+		 */
+		uint32_t getFailedSearches() const;
+
+		/** Returns the average node expansions of the solved searches.
+		 * @return The number of expansions.
+		 */
+		double getAverageSearchExpansions() const;
+
+		/** Returns the most node expansions of a solved search.
+		 * @return The number of expansions.
+		 */
+		uint32_t getMaxSearchExpansions() const;
+
+		/** Returns the average time from request to solution of the solved searches.
+		 * @return The latency in milliseconds.
+		 */
+		double getAverageSearchLatency() const;
+
+		/** Returns the longest time from request to solution of a solved search.
+		 * @return The latency in milliseconds.
+		 */
+		double getMaxSearchLatency() const;
+
+		/** Resets the search statistics.
+		 */
+		void resetSearchStats();
+
+		/** Sets if solved paths are smoothed. @see Route::smoothPath()
+		 * @param smoothing A boolean, if true straight parts of the paths are merged. default is false
+		 */
+		void setPathSmoothing(bool smoothing);
+
+		/** Gets if solved paths are smoothed. @see Route::smoothPath()
+		 * @return A boolean, if true straight parts of the paths are merged. default is false
+		 */
+		bool isPathSmoothing();
+
 		/** Returns name of the pathfinder.
 		 * @return A string that contains the name of the pathfinder.
 		 */
 		std::string getName() const;
 
+	protected:
+		/** Creates the search for a route.
+		 *
+		 * @param route A pointer to the route which should be solved.
+		 * @param sessionId The session id of the search.
+		 * @param multilayer A boolean, if true the route leaves the start CellCache or zone.
+		 * @return A pointer to the new search, the pather owns it.
+		 */
+		virtual RoutePatherSearch* createSearch(Route* route, const int32_t sessionId, bool multilayer);
+
 	private:
 		//! A path is a list with locations. Each location holds the coordinate for one cell.
 		typedef std::list<Location> Path;
 
-		//! Holds the searches and their priority.
-		typedef PriorityQueue<RoutePatherSearch*, int32_t> SessionQueue;
+		typedef std::chrono::steady_clock Clock;
+
+		//! A search and its scheduling state.
+		struct SearchSession {
+			//! the search
+			RoutePatherSearch* search;
+			//! priority the route was requested with
+			int32_t priority;
+			//! updates without a turn
+			int32_t age;
+			//! number of the last turn, the lowest one is next for equal priorities
+			uint32_t lastTurn;
+			//! expanded nodes
+			uint32_t expansions;
+			//! time of the request
+			Clock::time_point start;
+		};
+
+		//! Holds the searches in request order.
+		typedef std::vector<SearchSession> SessionQueue;
 
 		//! Holds the sessions.
 		typedef std::list<int32_t> SessionList;
@@ -160,6 +282,20 @@ namespace FIFE {
 		 */
 		bool invalidateSessionId(const int32_t sessionId);
 
+		/** Returns the session that gets the next turn.
+		 *
+		 * @return An iterator to the session, the queue must not be empty.
+		 */
+		SessionQueue::iterator getNextSession();
+
+		/** Adds a finished search to the statistics.
+		 *
+		 * @param route A pointer to the route of the search.
+		 * @param expansions The number of expanded nodes.
+		 * @param start The time the search was requested.
+		 */
+		void addSearchStats(Route* route, uint32_t expansions, const Clock::time_point& start);
+
 		//! A map of currently running sessions (searches).
 		SessionQueue m_sessions;
 
@@ -171,6 +307,45 @@ namespace FIFE {
 
 		//! The maximum number of ticks allowed.
 		int32_t m_maxTicks;
+
+		//! Are solved paths smoothed.
+		bool m_pathSmoothing;
+
+		//! The time budget per update in microseconds.
+		uint32_t m_maxTime;
+
+		//! The node expansions per turn.
+		int32_t m_batchSize;
+
+		//! The updates without a turn that raise the priority by one.
+		int32_t m_priorityAging;
+
+		//! The number of the last turn.
+		uint32_t m_turn;
+
+		//! The node expansions of the last update.
+		uint32_t m_frameExpansions;
+
+		//! The time of the last update in microseconds.
+		double m_frameTime;
+
+		//! The solved searches.
+		uint32_t m_solvedSearches;
+
+		//! The failed searches.
+		uint32_t m_failedSearches;
+
+		//! The node expansions of all solved searches.
+		uint64_t m_totalExpansions;
+
+		//! The most node expansions of a solved search.
+		uint32_t m_maxExpansions;
+
+		//! The latency of all solved searches in milliseconds.
+		double m_totalLatency;
+
+		//! The longest latency of a solved search in milliseconds.
+		double m_maxLatency;
 	};
 }
 #endif
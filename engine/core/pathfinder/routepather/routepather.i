@@ -32,6 +32,20 @@ namespace FIFE {
 	public:
 		RoutePather();
 		virtual ~RoutePather();
+		void setSearchBatchSize(int32_t size);
+		int32_t getSearchBatchSize();
+		void setPriorityAging(int32_t frames);
+		int32_t getPriorityAging();
+		uint32_t getActiveSessions() const;
+		uint32_t getFrameExpansions() const;
+		double getFrameTime() const;
+		uint32_t getSolvedSearches() const;
+		uint32_t getFailedSearches() const;
+		double getAverageSearchExpansions() const;
+		uint32_t getMaxSearchExpansions() const;
+		double getAverageSearchLatency() const;
+		double getMaxSearchLatency() const;
+		void resetSearchStats();
 		std::string getName() const;
 	};
 }
@@ -194,11 +194,9 @@ namespace FIFE {
 	void SingleLayerSearch::calcPath() {
 		int32_t current = m_destCoordInt;
 		int32_t end = m_startCoordInt;
-		Path path;
-		Location newnode(m_cellCache->getLayer());
-		// This assures that the agent always steps into the center of the cell.
-		newnode.setExactLayerCoordinates(FIFE::intPt2doublePt(m_to.getLayerCoordinates()));
-		path.push_back(newnode);
+		// the shortest path tree is walked backwards from the target
+		std::vector<int32_t> cells;
+		cells.push_back(current);
 		while(current != end) {
 			if (m_spt[current] < 0 ) {
 				// This is when the size of m_spt can not handle the distance of the location
@@ -207,11 +205,12 @@ namespace FIFE {
 				break;
 			}
 			current = m_spt[current];
-			ModelCoordinate currentCoord = m_cellCache->convertIntToCoord(current);
-			newnode.setLayerCoordinates(currentCoord);
-			path.push_front(newnode);
+			cells.push_back(current);
 		}
-		path.front().setExactLayerCoordinates(m_from.getExactLayerCoordinatesRef());
+		// The route keeps the exact start coordinates, all other steps are cell centers.
+		CellPath path;
+		path.reserve(cells.size());
+		path.addCells(m_cellCache, cells.rbegin(), cells.rend());
 		m_route->setPath(path);
 	}
 }
@@ -28,6 +28,7 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "util/base/exception.h"
+#include "vfs/vfs.h"
 
 #include "controllermappingsaver.h"
 
@@ -41,5 +42,6 @@ namespace FIFE {
 #endif
 		fputs(data.c_str(), fp);
 		fclose(fp);
+		VFS::instance()->invalidate();
 	}
 }  //FIFE
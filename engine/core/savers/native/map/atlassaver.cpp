@@ -0,0 +1,114 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+
+// 3rd party library includes
+#include <tinyxml.h>
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/exception.h"
+#include "util/log/logger.h"
+#include "video/atlaspacker.h"
+#include "vfs/fife_boost_filesystem.h"
+#include "vfs/vfs.h"
+
+#include "atlassaver.h"
+
+namespace FIFE {
+	/** Logger to use for this source file.
+	 *  @relates Logger
+	 */
+	static Logger _log(LM_NATIVE_SAVERS);
+
+	AtlasSaver::AtlasSaver(AtlasPacker* packer):
+		m_packer(packer) {
+	}
+
+	AtlasSaver::~AtlasSaver() {
+	}
+
+	void AtlasSaver::save(const std::string& filename) {
+		if (!m_packer || m_packer->getPageCount() == 0) {
+			FL_WARN(_log, LMsg("AtlasSaver::save() - ") << "Nothing to save, the atlas is not packed.");
+			return;
+		}
+
+		bfs::path atlasPath(filename);
+		bfs::path atlasPathDirectory;
+		if (HasParentPath(atlasPath)) {
+			atlasPathDirectory = GetParentPath(atlasPath);
+		}
+
+		TiXmlDocument doc;
+
+		// add xml declaration
+		TiXmlDeclaration* decl = new TiXmlDeclaration("1.0", "ascii", "");
+		doc.LinkEndChild(decl);
+
+		TiXmlElement* assetsElement = new TiXmlElement("assets");
+		doc.LinkEndChild(assetsElement);
+
+		for (uint32_t page = 0; page < m_packer->getPageCount(); ++page) {
+			ImagePtr pageImage = m_packer->getPage(page);
+			bfs::path pagePath(pageImage->getName());
+			std::string pageFilename = GetFilenameFromPath(pagePath);
+
+			// the page is stored next to the xml file, the loader resolves it relative to it
+			pageImage->saveImage((atlasPathDirectory / pageFilename).string());
+
+			TiXmlElement* atlasElement = new TiXmlElement("atlas");
+			atlasElement->SetAttribute("source", pageFilename);
+
+			for (uint32_t i = 0; i < m_packer->getImageCount(); ++i) {
+				if (m_packer->getImagePage(i) != page) {
+					continue;
+				}
+				const Rect& region = m_packer->getImageRegion(i);
+				TiXmlElement* subimageElement = new TiXmlElement("subimage");
+				subimageElement->SetAttribute("id", m_packer->getImage(i)->getName());
+				subimageElement->SetAttribute("xpos", region.x);
+				subimageElement->SetAttribute("ypos", region.y);
+				subimageElement->SetAttribute("width", region.w);
+				subimageElement->SetAttribute("height", region.h);
+				atlasElement->LinkEndChild(subimageElement);
+			}
+			assetsElement->LinkEndChild(atlasElement);
+		}
+
+		FILE* fp = 0;
+		#if defined(_MSC_VER) && (_MSC_VER >= 1400 )
+			fp = _fsopen( filename.c_str(), "w", _SH_DENYNO );
+		#else
+			fp = fopen( filename.c_str(), "w" );
+		#endif
+		if (!fp) {
+			throw CannotOpenFile(filename);
+		}
+		// save the atlas xml file
+		doc.SaveFile(fp);
+		fclose(fp);
+		VFS::instance()->invalidate();
+	}
+}
@@ -0,0 +1,66 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_ATLASSAVER_H
+#define FIFE_ATLASSAVER_H
+
+// Standard C++ library includes
+#include <string>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "iatlassaver.h"
+
+namespace FIFE {
+	class AtlasPacker;
+
+	/** default atlas saver class implementing the IAtlasSaver interface
+	 *
+	 * Writes the pages of a packed AtlasPacker as png files next to the
+	 * atlas xml file. The xml file has the format read by the AtlasLoader,
+	 * with one atlas element per page.
+	 */
+	class AtlasSaver : public IAtlasSaver {
+	public:
+		/** constructor
+		 * @param packer The packed atlas that should be saved, not owned by the saver.
+		 */
+		AtlasSaver(AtlasPacker* packer);
+
+		/** destructor
+		 */
+		~AtlasSaver();
+
+		/** saves the atlas xml file and the page images
+		 * @param filename The name of the xml file.
+		 */
+		virtual void save(const std::string& filename);
+
+	private:
+		AtlasPacker* m_packer;
+	};
+}
+
+#endif
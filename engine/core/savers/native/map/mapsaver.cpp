@@ -39,6 +39,7 @@
 #include "model/metamodel/grids/cellgrid.h"
 #include "util/structures/point.h"
 #include "util/structures/rect.h"
+#include "vfs/vfs.h"
 #include "view/visual.h"
 #include "view/camera.h"
 
@@ -265,12 +266,12 @@ namespace FIFE {
 					std::vector<std::string> cellAreaIds;
 					bool areasEmpty = areaIds.empty();
 					if (!areasEmpty) {
-						const std::set<Instance*>& cellInstances = cell->getInstances();
+						const std::vector<Instance*>& cellInstances = cell->getInstances();
 						if (!cellInstances.empty()) {
 							std::vector<std::string>::iterator area_it = areaIds.begin();
 							for (; area_it != areaIds.end(); ++area_it) {
 								bool objectArea = false;
-								std::set<Instance*>::const_iterator instance_it = cellInstances.begin();
+								std::vector<Instance*>::const_iterator instance_it = cellInstances.begin();
 								for (; instance_it != cellInstances.end(); ++instance_it) {
 									if ((*instance_it)->getObject()->getArea() == *area_it) {
 										objectArea = true;
@@ -482,5 +483,6 @@ namespace FIFE {
         // save the map xml file
         doc.SaveFile(fp);
         fclose(fp);
+        VFS::instance()->invalidate();
     }
 }
@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "framearena.h"
+
+namespace FIFE {
+
+	FrameArena::FrameArena(std::size_t blockSize):
+		m_block(0),
+		m_offset(0),
+		m_blockSize(blockSize),
+		m_peak(0),
+		m_blockAllocations(0) {
+	}
+
+	FrameArena::~FrameArena() {
+		std::vector<Block>::iterator it = m_blocks.begin();
+		for (; it != m_blocks.end(); ++it) {
+			delete[] it->data;
+		}
+	}
+
+	FrameArena& FrameArena::get() {
+		static thread_local FrameArena arena;
+		return arena;
+	}
+
+	void* FrameArena::allocate(std::size_t size, std::size_t alignment) {
+		while (true) {
+			if (m_block < m_blocks.size()) {
+				Block& block = m_blocks[m_block];
+				// operator new[] memory is aligned for every fundamental type
+				std::size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+				if (offset + size <= block.size) {
+					m_offset = offset + size;
+					m_peak = std::max(m_peak, block.base + m_offset);
+					return block.data + offset;
+				}
+				if (m_block + 1 < m_blocks.size() && m_blocks[m_block + 1].size >= size) {
+					m_blocks[m_block + 1].base = block.base + m_offset;
+					++m_block;
+					m_offset = 0;
+					continue;
+				}
+			}
+
+			// no block is large enough, the new block replaces all following ones
+			std::size_t base = 0;
+			if (m_block < m_blocks.size()) {
+				base = m_blocks[m_block].base + m_offset;
+				++m_block;
+			}
+			for (std::size_t i = m_block; i < m_blocks.size(); ++i) {
+				delete[] m_blocks[i].data;
+			}
+			m_blocks.resize(m_block);
+			Block block;
+			block.size = std::max(m_blockSize, size + alignment);
+			block.data = new char[block.size];
+			block.base = base;
+			m_blocks.push_back(block);
+			// the next block doubles, so the arena settles after a few frames
+			m_blockSize = block.size * 2;
+			m_offset = 0;
+			++m_blockAllocations;
+		}
+	}
+
+	void FrameArena::deallocate(void* ptr, std::size_t size) {
+		if (m_block < m_blocks.size() && static_cast<char*>(ptr) + size == m_blocks[m_block].data + m_offset) {
+			m_offset -= size;
+		}
+	}
+
+	FrameArena::Marker FrameArena::getMarker() const {
+		Marker marker;
+		marker.block = m_block;
+		marker.offset = m_offset;
+		return marker;
+	}
+
+	void FrameArena::rewind(const Marker& marker) {
+		assert(marker.block < m_block || (marker.block == m_block && marker.offset <= m_offset));
+		m_block = marker.block;
+		m_offset = marker.offset;
+	}
+
+	void FrameArena::reset() {
+		// a single block that holds a whole frame avoids the hops between blocks
+		if (m_blocks.size() > 1 && m_peak > m_blocks.front().size) {
+			std::vector<Block>::iterator it = m_blocks.begin();
+			for (; it != m_blocks.end(); ++it) {
+				delete[] it->data;
+			}
+			m_blocks.clear();
+			m_blockSize = std::max(m_blockSize, m_peak * 2);
+		}
+		m_block = 0;
+		m_offset = 0;
+	}
+
+	std::size_t FrameArena::getUsedBytes() const {
+		return m_block < m_blocks.size() ? m_blocks[m_block].base + m_offset : 0;
+	}
+
+	std::size_t FrameArena::getPeakBytes() const {
+		return m_peak;
+	}
+
+	std::size_t FrameArena::getCapacity() const {
+		std::size_t capacity = 0;
+		std::vector<Block>::const_iterator it = m_blocks.begin();
+		for (; it != m_blocks.end(); ++it) {
+			capacity += it->size;
+		}
+		return capacity;
+	}
+
+	uint32_t FrameArena::getBlockAllocations() const {
+		return m_blockAllocations;
+	}
+
+}//FIFE
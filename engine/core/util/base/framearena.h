@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_FRAMEARENA_H
+#define FIFE_FRAMEARENA_H
+
+// Standard C++ library includes
+#include <cstddef>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/fife_stdint.h"
+
+namespace FIFE {
+
+	/** Linear scratch allocator for data that only lives during a frame.
+	 *
+	 * Allocating is a pointer increment, freeing happens all at once, either when a
+	 * FrameArenaScope ends or when the engine resets the arena at the begin of a frame.
+	 * The memory blocks are kept, so once the arena is large enough a frame does not
+	 * touch the heap anymore. Every thread has its own arena.
+	 */
+	class FrameArena {
+	public:
+		/** Position in the arena, used to free everything allocated after it.
+		 */
+		struct Marker {
+			uint32_t block;
+			std::size_t offset;
+		};
+
+		/** Constructor.
+		 * @param blockSize The size of the first memory block in bytes.
+		 */
+		FrameArena(std::size_t blockSize = 64 * 1024);
+
+		/** Destructor.
+		 */
+		~FrameArena();
+
+		/** Returns the arena of the calling thread.
+		 */
+		static FrameArena& get();
+
+		/** Returns memory for size bytes with the given alignment.
+		 */
+		void* allocate(std::size_t size, std::size_t alignment);
+
+		/** Gives the memory back if it was the last allocation, otherwise it is freed with the next rewind.
+		 */
+		void deallocate(void* ptr, std::size_t size);
+
+		/** Returns the current position.
+		 */
+		Marker getMarker() const;
+
+		/** Frees everything allocated after the marker.
+		 */
+		void rewind(const Marker& marker);
+
+		/** Frees everything. Must not be called while a FrameArenaScope is active.
+		 */
+		void reset();
+
+		/** Returns the number of bytes currently allocated.
+		 */
+		std::size_t getUsedBytes() const;
+
+		/** Returns the highest number of bytes allocated at the same time.
+		 */
+		std::size_t getPeakBytes() const;
+
+		/** Returns the size of all memory blocks.
+		 */
+		std::size_t getCapacity() const;
+
+		/** Returns how often a new memory block was requested from the heap.
+		 */
+		uint32_t getBlockAllocations() const;
+
+	private:
+		struct Block {
+			char* data;
+			std::size_t size;
+			// bytes used in the blocks before this one
+			std::size_t base;
+		};
+
+		FrameArena(const FrameArena&);
+		FrameArena& operator=(const FrameArena&);
+
+		std::vector<Block> m_blocks;
+		uint32_t m_block;
+		std::size_t m_offset;
+		std::size_t m_blockSize;
+		std::size_t m_peak;
+		uint32_t m_blockAllocations;
+	};
+
+	/** Frees everything allocated from the arena of the calling thread while the scope was alive.
+	 * Declare it before the containers that use FrameAllocator.
+	 */
+	class FrameArenaScope {
+	public:
+		FrameArenaScope(): m_arena(FrameArena::get()), m_marker(m_arena.getMarker()) {}
+		~FrameArenaScope() { m_arena.rewind(m_marker); }
+
+	private:
+		FrameArenaScope(const FrameArenaScope&);
+		FrameArenaScope& operator=(const FrameArenaScope&);
+
+		FrameArena& m_arena;
+		FrameArena::Marker m_marker;
+	};
+
+	/** STL allocator that takes its memory from the arena of the calling thread.
+	 */
+	template <typename T> class FrameAllocator {
+	public:
+		typedef T value_type;
+
+		FrameAllocator() {}
+		template <typename U> FrameAllocator(const FrameAllocator<U>&) {}
+
+		T* allocate(std::size_t n) {
+			return static_cast<T*>(FrameArena::get().allocate(n * sizeof(T), alignof(T)));
+		}
+		void deallocate(T* ptr, std::size_t n) {
+			FrameArena::get().deallocate(ptr, n * sizeof(T));
+		}
+	};
+
+	template <typename T, typename U> bool operator==(const FrameAllocator<T>&, const FrameAllocator<U>&) { return true; }
+	template <typename T, typename U> bool operator!=(const FrameAllocator<T>&, const FrameAllocator<U>&) { return false; }
+
+	/** Vector for temporaries of a frame, see FrameArenaScope.
+	 */
+	template <typename T> using FrameVector = std::vector<T, FrameAllocator<T> >;
+
+}//FIFE
+
+#endif
@@ -31,4 +31,5 @@
 
 namespace FIFE {
 	ResourceHandle IResource::m_curhandle = 1;
+	uint64_t IResource::m_curstamp = 0;
 }//FIFE
@@ -31,6 +31,7 @@
 // These includes are split up in two parts, separated by one empty line
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
+#include "util/base/fife_stdint.h"
 #include "util/base/sharedptr.h"
 
 namespace FIFE {
@@ -59,7 +60,8 @@ namespace FIFE {
 		: m_name(name),
 		  m_loader(loader),
 		  m_state(RES_NOT_LOADED),
-		  m_handle(m_curhandle++) { }
+		  m_handle(m_curhandle++),
+		  m_lastUsed(0) { }
 
 		virtual ~IResource() { }
 
@@ -72,6 +74,16 @@ namespace FIFE {
 
 		virtual size_t getSize() = 0;
 
+		/** Marks the resource as used.
+		 * Resource managers use the stamp to find the least recently used resources.
+		 */
+		void touch() { m_lastUsed = ++m_curstamp; }
+
+		/** Returns the stamp of the last use, 0 if it was never used.
+		 * Stamps are increasing, a higher value means a more recent use.
+		 */
+		uint64_t getLastUsed() const { return m_lastUsed; }
+
 		virtual void load() = 0;
 		virtual void free() = 0;
 
@@ -83,6 +95,8 @@ namespace FIFE {
 	private:
 		ResourceHandle m_handle;
 		static ResourceHandle m_curhandle;
+		uint64_t m_lastUsed;
+		static uint64_t m_curstamp;
 	};
 
 	typedef SharedPtr<IResource> ResourcePtr;
@@ -65,6 +65,9 @@ namespace FIFE {
 
 		virtual size_t getSize() = 0;
 
+		void touch();
+		uint64_t getLastUsed() const;
+
 		virtual void load() = 0;
 		virtual void free() = 0;
 	};
@@ -80,6 +80,12 @@ class QuadNode {
 			return find_container(rect.x,rect.y,rect.w,rect.h);
 		}
 
+		/** Find the deepest existing node which contains a given rectangle.
+		 *  Unlike find_container this never extends the tree, so several readers
+		 *  can use it at the same time. Returns null if this node does not contain the rectangle.
+		 */
+		const QuadNode* find_existing_container(int32_t x, int32_t y, int32_t w, int32_t h) const;
+
 		/** Apply a visitor recursively to the QuadTree
 		 * A visitor is an object which has a @c visit method which
 		 * takes as parameters a pointer to a @c QuadNode and an integer.
@@ -99,6 +105,18 @@ class QuadNode {
 			if( m_nodes[3] ) m_nodes[3]->apply_visitor(visitor, d + 1);
 		}
 
+		/** Apply a visitor recursively to the QuadTree, without write access to the nodes.
+		 */
+		template<typename Visitor>
+		void apply_visitor(Visitor& visitor, int32_t d = 0) const {
+			if( !visitor.visit(this, d) )
+				return;
+			if( m_nodes[0] ) m_nodes[0]->apply_visitor(visitor, d + 1);
+			if( m_nodes[1] ) m_nodes[1]->apply_visitor(visitor, d + 1);
+			if( m_nodes[2] ) m_nodes[2]->apply_visitor(visitor, d + 1);
+			if( m_nodes[3] ) m_nodes[3]->apply_visitor(visitor, d + 1);
+		}
+
 		/** Return the X position of the node.
 		 */
 		int32_t x() const { return m_x; };
@@ -114,6 +132,7 @@ class QuadNode {
 		/** Return a reference to the data of the node.
 		 */
 		DataType& data() { return m_data; };
+		const DataType& data() const { return m_data; };
 		
 		/** Check whether a rectangle is contained in the node.
 		 * A rectangle is contained in a node, iff:
@@ -131,6 +150,7 @@ class QuadNode {
 		/** Return the parent node
 		 */
 		QuadNode* parent() { return m_parent; };
+		const QuadNode* parent() const { return m_parent; };
 
 		/** Create a new parent node for a rectangle
 		 *  This will create a new parent node end expand the tree so that
@@ -184,6 +204,16 @@ class QuadTree {
 			return find_container(rect.x,rect.y,rect.w,rect.h);
 		}
 
+		/** Find the deepest existing node which contains a given rectangle, without extending the tree.
+		 *  If the rectangle reaches out of the tree the root node is returned, the caller
+		 *  has to filter the data then. This does not move the cursor, so several readers
+		 *  can use it at the same time as long as nobody modifies the tree.
+		 */
+		const Node* find_existing_container(int32_t x, int32_t y, int32_t w, int32_t h) const {
+			const Node* node = m_root->find_existing_container(x,y,w,h);
+			return node ? node : m_root;
+		}
+
 		/** Apply a visitor recursively to the QuadTree
 		 */
 		template<typename Visitor>
@@ -293,6 +323,24 @@ QuadNode<DataType,MinimumSize>::find_container(int32_t x, int32_t y, int32_t w,
 	}
 }
 
+template<typename DataType,int32_t MinimumSize>
+const QuadNode<DataType,MinimumSize>*
+QuadNode<DataType,MinimumSize>::find_existing_container(int32_t x, int32_t y, int32_t w, int32_t h) const {
+	if( !contains(x,y,w,h) ) {
+		return 0L;
+	}
+
+	const QuadNode* node = this;
+	while (node->m_size > MinimumSize) {
+		int32_t r = node->subnode(x,y,w,h);
+		if (r == -1 || node->m_nodes[r] == 0) {
+			break;
+		}
+		node = node->m_nodes[r];
+	}
+	return node;
+}
+
 template<typename DataType,int32_t MinimumSize>
 QuadNode<DataType,MinimumSize>* 
 QuadNode<DataType,MinimumSize>::create_parent(int32_t x, int32_t y, int32_t w, int32_t h) {
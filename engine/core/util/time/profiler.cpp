@@ -0,0 +1,437 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <set>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/log/logger.h"
+
+#include "profiler.h"
+
+namespace FIFE {
+	static Logger _log(LM_UTIL);
+
+	// number of frames kept per zone
+	static const uint32_t HISTORY_SIZE = 120;
+
+	/** Ring buffer of one thread. Only the owning thread writes, the written counter
+	 * publishes the records to the main thread.
+	 */
+	class ProfileBuffer {
+	public:
+		ProfileBuffer(uint32_t thread, uint32_t capacity):
+			thread(thread),
+			records(capacity),
+			written(0),
+			collected(0) {
+		}
+
+		uint32_t thread;
+		std::vector<ProfileRecord> records;
+		std::atomic<uint64_t> written;
+		// only used by the main thread
+		uint64_t collected;
+	};
+
+	static std::atomic<uint32_t> s_generation(0);
+	static thread_local ProfileBuffer* t_buffer = 0;
+	static thread_local uint32_t t_generation = 0;
+	static thread_local uint32_t t_depth = 0;
+	static thread_local uint64_t t_allocations = 0;
+	static thread_local uint64_t t_allocatedBytes = 0;
+
+	std::atomic<bool> Profiler::s_recording(false);
+
+	// interned zone names, shared by all profilers and never freed
+	static std::mutex s_namesMutex;
+	static std::set<std::string> s_names;
+
+	static int64_t getNanoseconds() {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	/** Copies the record at the given index. Returns false if the owning thread has
+	 * already started to overwrite it, the slot is reused one lap after its index.
+	 */
+	static bool readRecord(const ProfileBuffer& buffer, uint64_t index, ProfileRecord& record) {
+		const uint64_t capacity = buffer.records.size();
+		record = buffer.records[index % capacity];
+		// the copy has to be finished before written is checked again
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return buffer.written.load(std::memory_order_relaxed) < index + capacity;
+	}
+
+	/** Returns the oldest index that can still be read, the slot of written - capacity
+	 * is the one the owning thread writes next.
+	 */
+	static uint64_t getFirstReadable(uint64_t written, uint64_t capacity) {
+		return written >= capacity ? written - capacity + 1 : 0;
+	}
+
+	static std::string escapeJson(const char* text) {
+		std::string escaped;
+		for (; *text; ++text) {
+			if (*text == '"' || *text == '\\') {
+				escaped += '\\';
+			}
+			escaped += *text;
+		}
+		return escaped;
+	}
+
+	Profiler::Profiler(uint32_t capacity):
+		m_capacity(std::max(capacity, 1u)),
+		m_generation(++s_generation),
+		m_startTime(getNanoseconds()),
+		m_enabled(false),
+		m_overlay(false),
+		m_frames(0) {
+	}
+
+	Profiler::~Profiler() {
+		s_recording.store(false);
+		std::vector<ProfileBuffer*>::iterator it = m_buffers.begin();
+		for (; it != m_buffers.end(); ++it) {
+			delete *it;
+		}
+		std::map<std::string, ZoneStats*>::iterator zit = m_zones.begin();
+		for (; zit != m_zones.end(); ++zit) {
+			delete zit->second;
+		}
+	}
+
+	bool Profiler::isAvailable() {
+#ifdef PROFILING_ENABLED
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void Profiler::setEnabled(bool enabled) {
+		if (enabled && !isAvailable()) {
+			FL_WARN(_log, "Profiler zones are not compiled in, build with PROFILING_ENABLED");
+			return;
+		}
+		m_enabled = enabled;
+		s_recording.store(enabled);
+	}
+
+	bool Profiler::isEnabled() const {
+		return m_enabled;
+	}
+
+	bool Profiler::isAllocationTrackingAvailable() {
+#ifdef ALLOCATION_TRACKING_ENABLED
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	uint64_t Profiler::getThreadAllocations() {
+		return t_allocations;
+	}
+
+	uint64_t Profiler::getThreadAllocatedBytes() {
+		return t_allocatedBytes;
+	}
+
+	void Profiler::endFrame() {
+		if (!m_enabled) {
+			return;
+		}
+
+		std::vector<ProfileBuffer*> buffers;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			buffers = m_buffers;
+		}
+
+		std::vector<ProfileBuffer*>::iterator it = buffers.begin();
+		for (; it != buffers.end(); ++it) {
+			ProfileBuffer* buffer = *it;
+			const uint64_t written = buffer->written.load(std::memory_order_acquire);
+			const uint64_t capacity = buffer->records.size();
+			// records that were overwritten before we got to them are lost
+			uint64_t index = std::max(buffer->collected, getFirstReadable(written, capacity));
+			for (; index < written; ++index) {
+				ProfileRecord record;
+				if (!readRecord(*buffer, index, record)) {
+					continue;
+				}
+				ZoneStats* zone = getZone(record.name, record.depth);
+				zone->frameTime += static_cast<double>(record.end - record.start) / 1000000.0;
+				zone->frameAllocations += record.allocations;
+				++zone->frameCalls;
+			}
+			buffer->collected = written;
+		}
+
+		std::map<std::string, ZoneStats*>::iterator zit = m_zones.begin();
+		for (; zit != m_zones.end(); ++zit) {
+			ZoneStats* zone = zit->second;
+			zone->time = zone->frameTime;
+			zone->calls = zone->frameCalls;
+			zone->allocations = zone->frameAllocations;
+			zone->history[m_frames % HISTORY_SIZE] = static_cast<float>(zone->frameTime);
+			zone->frameTime = 0;
+			zone->frameCalls = 0;
+			zone->frameAllocations = 0;
+		}
+		++m_frames;
+	}
+
+	void Profiler::reset() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::vector<ProfileBuffer*>::iterator it = m_buffers.begin();
+			for (; it != m_buffers.end(); ++it) {
+				(*it)->collected = (*it)->written.load(std::memory_order_acquire);
+			}
+		}
+		std::map<std::string, ZoneStats*>::iterator zit = m_zones.begin();
+		for (; zit != m_zones.end(); ++zit) {
+			delete zit->second;
+		}
+		m_zones.clear();
+		m_zonesByPointer.clear();
+		m_frames = 0;
+	}
+
+	std::vector<std::string> Profiler::getZoneNames() const {
+		std::vector<std::string> names;
+		std::map<std::string, ZoneStats*>::const_iterator it = m_zones.begin();
+		for (; it != m_zones.end(); ++it) {
+			names.push_back(it->first);
+		}
+		return names;
+	}
+
+	double Profiler::getZoneTime(const std::string& name) const {
+		const ZoneStats* zone = findZone(name);
+		return zone ? zone->time : 0.0;
+	}
+
+	double Profiler::getAverageZoneTime(const std::string& name) const {
+		std::vector<float> history = getZoneHistory(name);
+		if (history.empty()) {
+			return 0.0;
+		}
+		double sum = 0.0;
+		std::vector<float>::const_iterator it = history.begin();
+		for (; it != history.end(); ++it) {
+			sum += *it;
+		}
+		return sum / history.size();
+	}
+
+	double Profiler::getMaxZoneTime(const std::string& name) const {
+		std::vector<float> history = getZoneHistory(name);
+		if (history.empty()) {
+			return 0.0;
+		}
+		return *std::max_element(history.begin(), history.end());
+	}
+
+	uint32_t Profiler::getZoneCalls(const std::string& name) const {
+		const ZoneStats* zone = findZone(name);
+		return zone ? zone->calls : 0;
+	}
+
+	uint32_t Profiler::getZoneAllocations(const std::string& name) const {
+		const ZoneStats* zone = findZone(name);
+		return zone ? zone->allocations : 0;
+	}
+
+	uint32_t Profiler::getZoneDepth(const std::string& name) const {
+		const ZoneStats* zone = findZone(name);
+		return zone ? zone->depth : 0;
+	}
+
+	std::vector<float> Profiler::getZoneHistory(const std::string& name) const {
+		std::vector<float> history;
+		const ZoneStats* zone = findZone(name);
+		if (!zone) {
+			return history;
+		}
+		uint32_t frames = std::min(m_frames, HISTORY_SIZE);
+		uint32_t first = m_frames - frames;
+		for (uint32_t i = 0; i < frames; ++i) {
+			history.push_back(zone->history[(first + i) % HISTORY_SIZE]);
+		}
+		return history;
+	}
+
+	uint32_t Profiler::getHistorySize() const {
+		return std::min(m_frames, HISTORY_SIZE);
+	}
+
+	bool Profiler::exportChromeTrace(const std::string& filename) const {
+		std::ofstream file(filename.c_str());
+		if (!file) {
+			FL_WARN(_log, LMsg("Profiler could not write trace file ") << filename);
+			return false;
+		}
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"traceEvents\":[";
+		bool first = true;
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::vector<ProfileBuffer*>::const_iterator it = m_buffers.begin();
+		for (; it != m_buffers.end(); ++it) {
+			const ProfileBuffer* buffer = *it;
+			if (!first) {
+				file << ",";
+			}
+			first = false;
+			file << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread
+				<< ",\"args\":{\"name\":\"Thread " << buffer->thread << "\"}}";
+
+			const uint64_t written = buffer->written.load(std::memory_order_acquire);
+			const uint64_t capacity = buffer->records.size();
+			uint64_t index = getFirstReadable(written, capacity);
+			for (; index < written; ++index) {
+				ProfileRecord record;
+				if (!readRecord(*buffer, index, record)) {
+					continue;
+				}
+				file << ",\n{\"name\":\"" << escapeJson(record.name) << "\",\"cat\":\"fife\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+					<< buffer->thread << ",\"ts\":" << record.start / 1000.0
+					<< ",\"dur\":" << (record.end - record.start) / 1000.0
+					<< ",\"args\":{\"allocations\":" << record.allocations << "}}";
+			}
+		}
+		file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+		return file.good();
+	}
+
+	void Profiler::setOverlayEnabled(bool enabled) {
+		m_overlay = enabled;
+	}
+
+	bool Profiler::isOverlayEnabled() const {
+		return m_overlay;
+	}
+
+	int64_t Profiler::now() const {
+		return getNanoseconds() - m_startTime;
+	}
+
+	void Profiler::record(const char* name, int64_t start, int64_t end, uint32_t depth, uint32_t allocations) {
+		ProfileBuffer* buffer = getThreadBuffer();
+		const uint64_t index = buffer->written.load(std::memory_order_relaxed);
+		ProfileRecord& record = buffer->records[index % buffer->records.size()];
+		record.name = name;
+		record.start = start;
+		record.end = end;
+		record.depth = depth;
+		record.allocations = allocations;
+		buffer->written.store(index + 1, std::memory_order_release);
+	}
+
+	const char* Profiler::intern(const std::string& name) {
+		std::lock_guard<std::mutex> lock(s_namesMutex);
+		return s_names.insert(name).first->c_str();
+	}
+
+	ProfileBuffer* Profiler::getThreadBuffer() {
+		if (t_buffer && t_generation == m_generation) {
+			return t_buffer;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		t_buffer = new ProfileBuffer(m_buffers.size(), m_capacity);
+		t_generation = m_generation;
+		m_buffers.push_back(t_buffer);
+		return t_buffer;
+	}
+
+	const Profiler::ZoneStats* Profiler::findZone(const std::string& name) const {
+		std::map<std::string, ZoneStats*>::const_iterator it = m_zones.find(name);
+		return it != m_zones.end() ? it->second : 0;
+	}
+
+	Profiler::ZoneStats* Profiler::getZone(const char* name, uint32_t depth) {
+		std::map<const char*, ZoneStats*>::iterator it = m_zonesByPointer.find(name);
+		if (it != m_zonesByPointer.end()) {
+			it->second->depth = std::min(it->second->depth, depth);
+			return it->second;
+		}
+
+		// the same name can be stored at different addresses
+		ZoneStats*& zone = m_zones[name];
+		if (!zone) {
+			zone = new ZoneStats();
+			zone->name = name;
+			zone->depth = depth;
+			zone->history.resize(HISTORY_SIZE, 0.0f);
+		}
+		zone->depth = std::min(zone->depth, depth);
+		m_zonesByPointer[name] = zone;
+		return zone;
+	}
+
+	void ProfileZone::begin(const char* name) {
+		m_name = name;
+		m_depth = t_depth++;
+		m_allocations = t_allocations;
+		m_start = Profiler::instance()->now();
+	}
+
+	void ProfileZone::end() {
+		--t_depth;
+		if (Profiler::isRecording()) {
+			Profiler* profiler = Profiler::instance();
+			profiler->record(m_name, m_start, profiler->now(), m_depth, static_cast<uint32_t>(t_allocations - m_allocations));
+		}
+	}
+
+}//FIFE
+
+#ifdef ALLOCATION_TRACKING_ENABLED
+// counts the heap allocations of every thread, the profiler zones take the difference
+void* operator new(std::size_t size) {
+	++FIFE::t_allocations;
+	FIFE::t_allocatedBytes += size;
+	void* ptr = std::malloc(size ? size : 1);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+#endif
@@ -0,0 +1,255 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_PROFILER_H
+#define FIFE_PROFILER_H
+
+// Standard C++ library includes
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/singleton.h"
+#include "util/base/fife_stdint.h"
+
+/** Measures the time spent in the enclosing scope and records it under the given name.
+ *
+ * The name is a const char* that has to stay valid, a string literal or a name returned
+ * by Profiler::intern(). It is evaluated on every pass, also while the profiler does not
+ * record, so generated names should be interned once and cached.
+ * Without PROFILING_ENABLED the zone and its name are compiled out completely.
+ */
+#ifdef PROFILING_ENABLED
+#define FIFE_PROFILE_CONCAT_IMPL(a, b) a##b
+#define FIFE_PROFILE_CONCAT(a, b) FIFE_PROFILE_CONCAT_IMPL(a, b)
+#define FIFE_PROFILE_ZONE(name) FIFE::ProfileZone FIFE_PROFILE_CONCAT(fifeProfileZone, __LINE__)(name)
+#else
+#define FIFE_PROFILE_ZONE(name) ((void)0)
+#endif
+
+namespace FIFE {
+
+	class ProfileBuffer;
+
+	/** A finished zone, times are in nanoseconds since the profiler was created.
+	 * Allocations include the ones of nested zones.
+	 */
+	struct ProfileRecord {
+		const char* name;
+		int64_t start;
+		int64_t end;
+		uint32_t depth;
+		uint32_t allocations;
+	};
+
+	/** Frame Profiler
+	 *
+	 * Collects the zones recorded by FIFE_PROFILE_ZONE. Every thread writes into its own
+	 * ring buffer without locking, the main thread gathers the zones once a frame and
+	 * keeps a short per zone history, which can be queried, drawn as overlay or
+	 * exported as Chrome trace (chrome://tracing).
+	 */
+	class Profiler : public DynamicSingleton<Profiler> {
+	public:
+		/** Constructor.
+		 * @param capacity The number of zones each thread buffer can hold.
+		 */
+		Profiler(uint32_t capacity = 16384);
+
+		/** Destructor.
+		 */
+		virtual ~Profiler();
+
+		/** Returns true if the zones were compiled in.
+		 */
+		static bool isAvailable();
+
+		/** Starts or stops the recording of zones. Has no effect if the profiler is not available.
+		 */
+		void setEnabled(bool enabled);
+
+		/** Returns true if zones are recorded.
+		 */
+		bool isEnabled() const;
+
+		/** Returns true if heap allocations are counted.
+		 */
+		static bool isAllocationTrackingAvailable();
+
+		/** Returns the number of heap allocations made by the calling thread so far.
+		 */
+		static uint64_t getThreadAllocations();
+
+		/** Returns the number of bytes allocated on the heap by the calling thread so far.
+		 */
+		static uint64_t getThreadAllocatedBytes();
+
+		/** Gathers the zones of all threads and advances the history by one frame.
+		 * Called by the engine at the begin of each frame.
+		 */
+		void endFrame();
+
+		/** Clears the buffers and statistics.
+		 */
+		void reset();
+
+		/** Returns the names of all zones seen so far.
+		 */
+		std::vector<std::string> getZoneNames() const;
+
+		/** Returns the time in milliseconds spent in the zone during the last frame.
+		 */
+		double getZoneTime(const std::string& name) const;
+
+		/** Returns the average time per frame in milliseconds over the history.
+		 */
+		double getAverageZoneTime(const std::string& name) const;
+
+		/** Returns the highest time per frame in milliseconds over the history.
+		 */
+		double getMaxZoneTime(const std::string& name) const;
+
+		/** Returns how often the zone was entered during the last frame.
+		 */
+		uint32_t getZoneCalls(const std::string& name) const;
+
+		/** Returns the heap allocations made inside the zone during the last frame,
+		 * always 0 without ALLOCATION_TRACKING_ENABLED.
+		 */
+		uint32_t getZoneAllocations(const std::string& name) const;
+
+		/** Returns the lowest nesting depth the zone was recorded with, 0 is the outermost zone.
+		 */
+		uint32_t getZoneDepth(const std::string& name) const;
+
+		/** Returns the time per frame in milliseconds, oldest frame first.
+		 */
+		std::vector<float> getZoneHistory(const std::string& name) const;
+
+		/** Returns the number of frames kept in the history.
+		 */
+		uint32_t getHistorySize() const;
+
+		/** Writes the zones still held by the thread buffers as Chrome trace JSON.
+		 * @return True if the file could be written.
+		 */
+		bool exportChromeTrace(const std::string& filename) const;
+
+		/** Enables or disables the on screen graph drawn by the engine.
+		 */
+		void setOverlayEnabled(bool enabled);
+
+		/** Returns true if the on screen graph is drawn.
+		 */
+		bool isOverlayEnabled() const;
+
+		/** Returns true while zones should be recorded.
+		 */
+		static bool isRecording() { return s_recording.load(std::memory_order_relaxed); }
+
+		/** Returns the current time in nanoseconds since the profiler was created.
+		 */
+		int64_t now() const;
+
+		/** Adds a finished zone to the buffer of the calling thread.
+		 */
+		void record(const char* name, int64_t start, int64_t end, uint32_t depth, uint32_t allocations);
+
+		/** Returns a persistent copy of the name, used for zones with generated names.
+		 * The copy stays valid until the process ends, so it can be cached by the caller.
+		 * Takes a lock, don't call it per zone.
+		 */
+		static const char* intern(const std::string& name);
+
+	private:
+		struct ZoneStats {
+			ZoneStats(): time(0), calls(0), allocations(0), frameTime(0), frameCalls(0), frameAllocations(0), depth(0) {}
+			std::string name;
+			double time;
+			uint32_t calls;
+			uint32_t allocations;
+			double frameTime;
+			uint32_t frameCalls;
+			uint32_t frameAllocations;
+			uint32_t depth;
+			std::vector<float> history;
+		};
+
+		ProfileBuffer* getThreadBuffer();
+		const ZoneStats* findZone(const std::string& name) const;
+		ZoneStats* getZone(const char* name, uint32_t depth);
+
+		static std::atomic<bool> s_recording;
+
+		uint32_t m_capacity;
+		// distinguishes the thread buffers of this profiler from the ones of an earlier profiler
+		uint32_t m_generation;
+		int64_t m_startTime;
+		bool m_enabled;
+		bool m_overlay;
+		// number of finished frames
+		uint32_t m_frames;
+
+		// guards the buffer list
+		mutable std::mutex m_mutex;
+		std::vector<ProfileBuffer*> m_buffers;
+
+		// only used by the main thread
+		std::map<std::string, ZoneStats*> m_zones;
+		std::map<const char*, ZoneStats*> m_zonesByPointer;
+	};
+
+	/** Records the time between construction and destruction, see FIFE_PROFILE_ZONE.
+	 */
+	class ProfileZone {
+	public:
+		explicit ProfileZone(const char* name): m_name(0) {
+			if (Profiler::isRecording()) {
+				begin(name);
+			}
+		}
+		~ProfileZone() {
+			if (m_name) {
+				end();
+			}
+		}
+
+	private:
+		void begin(const char* name);
+		void end();
+
+		const char* m_name;
+		int64_t m_start;
+		uint32_t m_depth;
+		uint64_t m_allocations;
+	};
+
+}//FIFE
+
+#endif
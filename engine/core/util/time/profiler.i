@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+%module fife
+%{
+#include "util/time/profiler.h"
+%}
+
+namespace FIFE {
+	class Profiler {
+	public:
+		static bool isAvailable();
+		void setEnabled(bool enabled);
+		bool isEnabled() const;
+		static bool isAllocationTrackingAvailable();
+		void reset();
+		std::vector<std::string> getZoneNames() const;
+		double getZoneTime(const std::string& name) const;
+		double getAverageZoneTime(const std::string& name) const;
+		double getMaxZoneTime(const std::string& name) const;
+		uint32_t getZoneCalls(const std::string& name) const;
+		uint32_t getZoneAllocations(const std::string& name) const;
+		uint32_t getZoneDepth(const std::string& name) const;
+		std::vector<float> getZoneHistory(const std::string& name) const;
+		uint32_t getHistorySize() const;
+		bool exportChromeTrace(const std::string& filename) const;
+		void setOverlayEnabled(bool enabled);
+		bool isOverlayEnabled() const;
+	private:
+		Profiler();
+	};
+}
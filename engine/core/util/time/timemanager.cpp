@@ -32,6 +32,7 @@
 // Second block: files included from the same folder
 #include "util/log/logger.h"
 
+#include "profiler.h"
 #include "timeevent.h"
 #include "timemanager.h"
 
@@ -42,16 +43,21 @@ namespace FIFE {
 	TimeManager::TimeManager():
 		m_current_time (0),
 		m_time_delta(UNDEFINED_TIME_DELTA),
-		m_average_frame_time(0) {
+		m_average_frame_time(0),
+		m_fixed_time_delta(0) {
 	}
 
 	TimeManager::~TimeManager() {
 	}
 
 	void TimeManager::update() {
+		FIFE_PROFILE_ZONE("TimeManager::update");
 		// if first update...
 		double avg_multiplier = 0.985;
-		if (m_current_time == 0) {
+		if (m_fixed_time_delta != 0) {
+			m_time_delta = m_fixed_time_delta;
+			m_current_time += m_fixed_time_delta;
+		} else if (m_current_time == 0) {
 			m_current_time = SDL_GetTicks();
 			avg_multiplier = 0;
 			m_time_delta = 0;
@@ -109,6 +115,18 @@ namespace FIFE {
 		return m_average_frame_time;
 	}
 
+	void TimeManager::setFixedTimeDelta(uint32_t delta) {
+		// back on the system clock the next update starts over
+		if (delta == 0 && m_fixed_time_delta != 0) {
+			m_current_time = 0;
+		}
+		m_fixed_time_delta = delta;
+	}
+
+	uint32_t TimeManager::getFixedTimeDelta() const {
+		return m_fixed_time_delta;
+	}
+
 	void TimeManager::printStatistics() const {
 		FL_LOG(_log, LMsg("Timers: ") << m_events_list.size());
 	}
@@ -97,6 +97,19 @@ namespace FIFE {
 		 */
 		void printStatistics() const;
 
+		/** Replaces the system clock by a synthetic one that advances by the given
+		 * time every update, which makes runs reproducible. 0 restores the system clock.
+		 *
+		 * @param delta Time per frame in milliseconds.
+		 */
+		void setFixedTimeDelta(uint32_t delta);
+
+		/** Gets the time per frame of the synthetic clock.
+		 *
+		 * @return Time per frame in milliseconds, 0 if the system clock is used.
+		 */
+		uint32_t getFixedTimeDelta() const;
+
 	private:
 		/// Current time in milliseconds.
 		uint32_t m_current_time;
@@ -104,6 +117,8 @@ namespace FIFE {
 		uint32_t m_time_delta;
 		/// Average frame time in milliseconds.
 		double m_average_frame_time;
+		/// Time per frame of the synthetic clock in milliseconds, 0 if unused.
+		uint32_t m_fixed_time_delta;
 
 		/// List of active TimeEvents.
 		std::vector<TimeEvent*> m_events_list;
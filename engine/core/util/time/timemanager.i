@@ -35,6 +35,8 @@ namespace FIFE {
 		uint32_t getTimeDelta() const;
 		double getAverageFrameTime() const;
 		void printStatistics() const;
+		void setFixedTimeDelta(uint32_t delta);
+		uint32_t getFixedTimeDelta() const;
 		void registerEvent(TimeEvent* event);
 		void unregisterEvent(TimeEvent* event);
         };
@@ -36,7 +36,8 @@
 namespace FIFE {
 	static Logger _log(LM_FO_LOADERS);
 
-	DAT1::DAT1(VFS* vfs, const std::string& file) : VFSSource(vfs), m_datpath(file), m_data(vfs->open(file))  {
+	DAT1::DAT1(VFS* vfs, const std::string& file) : VFSSource(vfs), m_datpath(file),
+		m_archive(new DATArchive(vfs->open(file))), m_data(m_archive->getData()) {
 		FL_LOG(_log, LMsg("MFFalloutDAT1") 
 			<< "loading: " << file 
 			<< " filesize: " << m_data->getDataLength());
@@ -89,7 +90,7 @@ namespace FIFE {
 
 	RawData* DAT1::open(const std::string& file) const {
 		const RawDataDAT1::s_info& info = getInfo(file);
-		return new RawData(new RawDataDAT1(getVFS(), m_datpath, info));
+		return new RawData(new RawDataDAT1(m_archive, info));
 	}
 
 	bool DAT1::fileExists(const std::string& name) const {
@@ -69,7 +69,10 @@ namespace FIFE {
 
 		private:
 			std::string m_datpath;
-			std::unique_ptr<RawData> m_data;
+			//! the opened archive, shared with the opened files
+			DATArchivePtr m_archive;
+			//! the data of m_archive
+			RawData* m_data;
 			typedef std::map<std::string, RawDataDAT1::s_info> type_filelist;
 			type_filelist m_filelist;
 
@@ -40,7 +40,8 @@ namespace FIFE {
 	static Logger _log(LM_FO_LOADERS);
 
 	DAT2::DAT2(VFS* vfs, const std::string& file)
-		: VFSSource(vfs), m_datpath(file), m_data(vfs->open(file)), m_filelist() {
+		: VFSSource(vfs), m_datpath(file), m_archive(new DATArchive(vfs->open(file))),
+		m_data(m_archive->getData()), m_filelist() {
 
 		FL_LOG(_log, LMsg("MFFalloutDAT2")
 			<< "loading: " << file
@@ -80,8 +81,10 @@ namespace FIFE {
 			load_per_cycle = m_filecount;
 		m_filecount -= load_per_cycle;
 
+		// Files of the archive can be read from other threads
+		std::lock_guard<std::mutex> lock(m_archive->getMutex());
 		// Save the old index in an exception save way.
-		IndexSaver isaver(m_data.get());
+		IndexSaver isaver(m_data);
 
 		// Move index to file list and read the entries.
 		m_data->setIndex(m_currentIndex);
@@ -108,7 +111,7 @@ namespace FIFE {
 
 	RawData* DAT2::open(const std::string& file) const {
 		const RawDataDAT2::s_info& info = getInfo(file);
-		return new RawData(new RawDataDAT2(getVFS(), m_datpath, info));
+		return new RawData(new RawDataDAT2(m_archive, info));
 	}
 
 	bool DAT2::fileExists(const std::string& name) const {
@@ -80,7 +80,10 @@ namespace FIFE {
 
 		private:
 			std::string m_datpath;
-			mutable std::unique_ptr<RawData> m_data;
+			//! the opened archive, shared with the opened files
+			DATArchivePtr m_archive;
+			//! the data of m_archive, locked by its mutex after construction
+			RawData* m_data;
 			typedef std::map<std::string, RawDataDAT2::s_info> type_filelist;
 			mutable type_filelist m_filelist;
 
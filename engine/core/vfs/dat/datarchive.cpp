@@ -0,0 +1,164 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/exception.h"
+
+#include "datarchive.h"
+
+namespace FIFE {
+
+	DATArchive::DATArchive(RawData* data, uint32_t cacheSize) :
+		m_data(data),
+		m_cacheSize(cacheSize),
+		m_cachedBytes(0) {
+	}
+
+	DATArchive::~DATArchive() {
+	}
+
+	RawData* DATArchive::getData() const {
+		return m_data.get();
+	}
+
+	std::mutex& DATArchive::getMutex() {
+		return m_mutex;
+	}
+
+	void DATArchive::read(uint32_t offset, uint8_t* target, uint32_t len) {
+		const uint8_t* data = borrow(offset);
+		if (data) {
+			if (offset + len > m_data->getDataLength()) {
+				throw IndexOverflow(__FUNCTION__);
+			}
+			std::copy(data, data + len, target);
+			return;
+		}
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_data->setIndex(offset);
+		m_data->readInto(target, len);
+	}
+
+	const uint8_t* DATArchive::borrow(uint32_t offset) const {
+		const uint8_t* data = m_data->borrowData();
+		return data ? data + offset : 0;
+	}
+
+	DATEntryData DATArchive::getDecoded(uint32_t offset) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		std::unordered_map<uint32_t, type_lru::iterator>::iterator it = m_lruIndex.find(offset);
+		if (it == m_lruIndex.end()) {
+			return DATEntryData();
+		}
+		// move to the front
+		m_lru.splice(m_lru.begin(), m_lru, it->second);
+		return it->second->second;
+	}
+
+	void DATArchive::addDecoded(uint32_t offset, const DATEntryData& data) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (data->size() > m_cacheSize || m_lruIndex.find(offset) != m_lruIndex.end()) {
+			return;
+		}
+		m_lru.push_front(std::make_pair(offset, data));
+		m_lruIndex[offset] = m_lru.begin();
+		m_cachedBytes += static_cast<uint32_t>(data->size());
+		trimCache();
+	}
+
+	void DATArchive::setCacheSize(uint32_t size) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_cacheSize = size;
+		trimCache();
+	}
+
+	uint32_t DATArchive::getCacheSize() const {
+		return m_cacheSize;
+	}
+
+	uint32_t DATArchive::getCachedBytes() const {
+		return m_cachedBytes;
+	}
+
+	void DATArchive::trimCache() {
+		while (m_cachedBytes > m_cacheSize) {
+			m_cachedBytes -= static_cast<uint32_t>(m_lru.back().second->size());
+			m_lruIndex.erase(m_lru.back().first);
+			m_lru.pop_back();
+		}
+	}
+
+	RawDataDATSource::RawDataDATSource(DATArchivePtr archive, uint32_t offset, uint32_t packedLength,
+		uint32_t unpackedLength, bool compressed) :
+		m_archive(archive),
+		m_offset(offset),
+		m_packedLength(packedLength),
+		m_unpackedLength(unpackedLength),
+		m_compressed(compressed) {
+	}
+
+	RawDataDATSource::~RawDataDATSource() {
+	}
+
+	uint32_t RawDataDATSource::getSize() const {
+		return m_unpackedLength;
+	}
+
+	void RawDataDATSource::readInto(uint8_t* buffer, uint32_t start, uint32_t length) {
+		if (!m_compressed) {
+			m_archive->read(m_offset + start, buffer, length);
+			return;
+		}
+		const uint8_t* data = getDecoded();
+		std::copy(data + start, data + start + length, buffer);
+	}
+
+	const uint8_t* RawDataDATSource::borrowData() const {
+		if (!m_compressed) {
+			return m_archive->borrow(m_offset);
+		}
+		return getDecoded();
+	}
+
+	const uint8_t* RawDataDATSource::getDecoded() const {
+		if (!m_decoded) {
+			m_decoded = m_archive->getDecoded(m_offset);
+		}
+		if (!m_decoded) {
+			// two padding bytes, the decoders can read over the end on corrupt data
+			std::vector<uint8_t> packed(m_packedLength + 2, 0);
+			m_archive->read(m_offset, &packed[0], m_packedLength);
+			std::shared_ptr<std::vector<uint8_t> > data(new std::vector<uint8_t>(m_unpackedLength));
+			decode(&packed[0], data->empty() ? 0 : &(*data)[0]);
+			m_decoded = data;
+			m_archive->addDecoded(m_offset, m_decoded);
+		}
+		return m_decoded->empty() ? 0 : &(*m_decoded)[0];
+	}
+}
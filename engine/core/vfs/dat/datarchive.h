@@ -0,0 +1,166 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_VFS_DAT_DATARCHIVE_H
+#define FIFE_VFS_DAT_DATARCHIVE_H
+
+// Standard C++ library includes
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Platform specific includes
+#include "util/base/fife_stdint.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "vfs/raw/rawdata.h"
+#include "vfs/raw/rawdatasource.h"
+
+namespace FIFE {
+
+	//! decoded content of a compressed DAT file entry
+	typedef std::shared_ptr<const std::vector<uint8_t> > DATEntryData;
+
+	/** The opened .DAT file, shared by the DAT source and all files opened from it.
+	 *
+	 * Reads are locked, so files of the archive can be read from several threads.
+	 * Keeps the last decoded entries in a small LRU cache, so opening the same
+	 * compressed file again doesn't decode it again.
+	 */
+	class DATArchive {
+		public:
+			/** Constructor
+			 * @param data The opened .DAT file, the archive takes the ownership.
+			 * @param cacheSize Size of the decoded entry cache in bytes.
+			 */
+			DATArchive(RawData* data, uint32_t cacheSize = 4 * 1024 * 1024);
+			~DATArchive();
+
+			/** Returns the data of the archive, lock getMutex() while using it.
+			 */
+			RawData* getData() const;
+
+			/** Returns the mutex that guards the archive data.
+			 */
+			std::mutex& getMutex();
+
+			/** Copies len bytes at offset of the archive into target.
+			 */
+			void read(uint32_t offset, uint8_t* target, uint32_t len);
+
+			/** Returns a pointer to the data at offset, if the archive is memory mapped, otherwise NULL.
+			 */
+			const uint8_t* borrow(uint32_t offset) const;
+
+			/** Returns the decoded entry at offset from the cache, or an empty pointer.
+			 */
+			DATEntryData getDecoded(uint32_t offset);
+
+			/** Puts a decoded entry into the cache, the least recently used entries are dropped.
+			 */
+			void addDecoded(uint32_t offset, const DATEntryData& data);
+
+			/** Sets the size of the decoded entry cache in bytes, 0 disables it.
+			 */
+			void setCacheSize(uint32_t size);
+
+			/** Returns the size of the decoded entry cache in bytes.
+			 */
+			uint32_t getCacheSize() const;
+
+			/** Returns the bytes of the cached decoded entries.
+			 */
+			uint32_t getCachedBytes() const;
+
+		private:
+			//! drops entries until the cache fits into its size
+			void trimCache();
+
+			std::unique_ptr<RawData> m_data;
+			std::mutex m_mutex;
+
+			typedef std::list<std::pair<uint32_t, DATEntryData> > type_lru;
+			//! decoded entries, most recently used first
+			type_lru m_lru;
+			//! offset of the entry to its position in m_lru
+			std::unordered_map<uint32_t, type_lru::iterator> m_lruIndex;
+			uint32_t m_cacheSize;
+			uint32_t m_cachedBytes;
+
+			// Not copyable
+			DATArchive(const DATArchive&);
+			DATArchive& operator=(const DATArchive&);
+	};
+	typedef std::shared_ptr<DATArchive> DATArchivePtr;
+
+	/** A file entry of a .DAT archive.
+	 *
+	 * Nothing is read on construction. Stored entries read directly from the
+	 * archive, compressed entries are decoded completely on the first read
+	 * and shared with the cache of the archive.
+	 */
+	class RawDataDATSource : public RawDataSource {
+		public:
+			/** Constructor
+			 * @param archive The archive that contains the entry.
+			 * @param offset Position of the entry in the archive.
+			 * @param packedLength Size of the entry in the archive.
+			 * @param unpackedLength Size of the decoded entry.
+			 * @param compressed True if the entry has to be decoded.
+			 */
+			RawDataDATSource(DATArchivePtr archive, uint32_t offset, uint32_t packedLength,
+				uint32_t unpackedLength, bool compressed);
+			virtual ~RawDataDATSource();
+
+			virtual uint32_t getSize() const;
+			virtual void readInto(uint8_t* buffer, uint32_t start, uint32_t length);
+			virtual const uint8_t* borrowData() const;
+
+		protected:
+			/** Decodes the packed entry into output, which has the size of the unpacked entry.
+			 * @param input The packed entry, followed by two padding bytes.
+			 * @param output The memory location to write to.
+			 */
+			virtual void decode(const uint8_t* input, uint8_t* output) const = 0;
+
+			uint32_t getPackedLength() const { return m_packedLength; }
+
+		private:
+			//! returns the decoded entry, decodes it on first use
+			const uint8_t* getDecoded() const;
+
+			DATArchivePtr m_archive;
+			uint32_t m_offset;
+			uint32_t m_packedLength;
+			uint32_t m_unpackedLength;
+			bool m_compressed;
+			mutable DATEntryData m_decoded;
+	};
+}
+
+#endif
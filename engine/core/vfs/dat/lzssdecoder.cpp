@@ -52,16 +52,45 @@ namespace FIFE {
 			} else {
 				// Allocate +2 bytes so that on corrupt data the LZSS
 				// decoder won't crash the input buffer.
-				std::vector<uint8_t> indata(bytesToRead + 2);
-				input->readInto(&indata[0], bytesToRead);
-				LZSSDecode(&indata[0], bytesToRead, output);
+				if (m_indata.size() < static_cast<size_t>(bytesToRead) + 2) {
+					m_indata.resize(bytesToRead + 2);
+				}
+				input->readInto(&m_indata[0], bytesToRead);
+				LZSSDecode(&m_indata[0], bytesToRead, output);
 				// Note outindex is advanced inside LZSSDecode.
 			}
 
 		}
 	}
 
-	void LZSSDecoder::LZSSDecode(uint8_t* in , int64_t len, uint8_t* out) {
+	void LZSSDecoder::decode(const uint8_t* input, uint32_t inputsize, uint8_t* output, const uint32_t outputsize) {
+		m_outindex = 0;
+		m_outlen = outputsize;
+
+		uint32_t inindex = 0;
+		while (m_outindex < outputsize && inindex + 2 <= inputsize) {
+			uint16_t blockdesc = static_cast<uint16_t>((input[inindex] << 8) | input[inindex + 1]);
+			uint16_t bytesToRead = blockdesc & 0x7fff;
+			inindex += 2;
+			if (inindex + bytesToRead > inputsize) {
+				throw InvalidFormat("LZSS block exceeds the input");
+			}
+
+			if (blockdesc & 0x8000) { // uncompressed
+				if (m_outindex + bytesToRead > outputsize) {
+					throw InvalidFormat("LZSS block exceeds the output");
+				}
+				std::copy(input + inindex, input + inindex + bytesToRead, output + m_outindex);
+				m_outindex += bytesToRead;
+			} else {
+				// the padding bytes behind the input protect against corrupt data
+				LZSSDecode(input + inindex, bytesToRead, output);
+			}
+			inindex += bytesToRead;
+		}
+	}
+
+	void LZSSDecoder::LZSSDecode(const uint8_t* in , int64_t len, uint8_t* out) {
 		const int64_t c_nRingBufferSize        = 4096;
 		const int64_t c_nMatchLengthUpperLimit =   18;
 		const int64_t c_nThreshold             =    2;
@@ -23,6 +23,7 @@
 #define FIFE_LZSSDECODER_H
 
 // Standard C++ library includes
+#include <vector>
 
 // 3rd party library includes
 
@@ -53,10 +54,20 @@ namespace FIFE {
 			 */
 			void decode(RawData* input, uint8_t* output, const uint32_t outputsize);
 
+			/** Decodes from memory into a pointer.
+			 * @param input The encoded blocks, followed by two readable padding bytes
+			 * @param inputsize The size of the encoded blocks in byte
+			 * @param output The memory location to write to
+			 * @param outputsize The size of the memory location in byte
+			 */
+			void decode(const uint8_t* input, uint32_t inputsize, uint8_t* output, const uint32_t outputsize);
+
 		private:
 			uint32_t m_outlen;
 			uint32_t m_outindex;
-			void LZSSDecode(uint8_t* in, int64_t len, uint8_t* out);
+			//! input block, reused for all blocks
+			std::vector<uint8_t> m_indata;
+			void LZSSDecode(const uint8_t* in, int64_t len, uint8_t* out);
 
 	};
 
@@ -20,7 +20,6 @@
  ***************************************************************************/
 
 // Standard C++ library includes
-#include <memory>
 
 // 3rd party library includes
 
@@ -28,24 +27,18 @@
 // These includes are split up in two parts, separated by one empty line
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
-#include "vfs/raw/rawdata.h"
-#include "util/base/exception.h"
-
 #include "lzssdecoder.h"
 #include "rawdatadat1.h"
 
 namespace FIFE {
 
-	RawDataDAT1::RawDataDAT1(VFS* vfs, const std::string& datfile, const s_info& info) : 
-		RawDataMemSource(info.unpackedLength) {
-
-		std::unique_ptr<RawData> input (vfs->open(datfile));
-		input->setIndex(info.offset);
+	RawDataDAT1::RawDataDAT1(DATArchivePtr archive, const s_info& info) :
+		RawDataDATSource(archive, info.offset, info.packedLength, info.unpackedLength, info.type == 0x40),
+		m_unpackedLength(info.unpackedLength) {
+	}
 
-		if (info.type == 0x40) { // compressed
-			LZSSDecoder decoder;
-			decoder.decode(input.get(), getRawData(), getSize());
-		} else
-			input->readInto(getRawData(), getSize());
+	void RawDataDAT1::decode(const uint8_t* input, uint8_t* output) const {
+		LZSSDecoder decoder;
+		decoder.decode(input, getPackedLength(), output, m_unpackedLength);
 	}
 } // FIFE
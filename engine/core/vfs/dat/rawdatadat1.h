@@ -31,15 +31,14 @@
 // These includes are split up in two parts, separated by one empty line
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
-#include "vfs/raw/rawdatamemsource.h"
-#include "vfs/vfs.h"
+#include "datarchive.h"
 
 namespace FIFE {
 
-	/** A subclass of RawDataMemSource, that fills itself with a FALLOUT1 .DAT file entry
+	/** A FALLOUT1 .DAT file entry, LZSS compressed entries are decoded on the first read
 	 * @see MFFalloutDAT1
 	 */
-	class RawDataDAT1 : public RawDataMemSource {
+	class RawDataDAT1 : public RawDataDATSource {
 		public:
 			/** The needed information for the extraction.
 			 */
@@ -52,11 +51,16 @@ namespace FIFE {
 			};
 
 			/** Constructor
-			 * @param vfs The vfs to open with.
-			 * @param datfile The .DAT archive - e.g. master.DAT
+			 * @param archive The opened .DAT archive - e.g. master.DAT
 			 * @param info The .DAT file entry, as retrieved by MFFalloutDAT1
 			 */
-			RawDataDAT1(VFS* vfs, const std::string& datfile, const s_info& info);
+			RawDataDAT1(DATArchivePtr archive, const s_info& info);
+
+		protected:
+			virtual void decode(const uint8_t* input, uint8_t* output) const;
+
+		private:
+			uint32_t m_unpackedLength;
 	};
 
 }
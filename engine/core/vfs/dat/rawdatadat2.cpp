@@ -20,8 +20,6 @@
  ***************************************************************************/
 
 // Standard C++ library includes
-#include <algorithm>
-#include <memory>
 
 // 3rd party library includes
 #include <zlib.h>
@@ -30,30 +28,22 @@
 // These includes are split up in two parts, separated by one empty line
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
-#include "vfs/raw/rawdata.h"
-#include "vfs/vfs.h"
 #include "util/base/exception.h"
 
 #include "rawdatadat2.h"
 
 namespace FIFE {
 
-	RawDataDAT2::RawDataDAT2(VFS* vfs, const std::string& datfile, const s_info& info) :
-		RawDataMemSource(info.unpackedLength) {
-
-		std::unique_ptr<RawData> input (vfs->open(datfile));
-		input->setIndex(info.offset);
-
-		if (info.type == 1) { // compressed
-			std::unique_ptr<uint8_t[]> compressed(new uint8_t[info.packedLength]);
-			input->readInto(compressed.get(), info.packedLength);
+	RawDataDAT2::RawDataDAT2(DATArchivePtr archive, const s_info& info) :
+		RawDataDATSource(archive, info.offset, info.packedLength, info.unpackedLength, info.type == 1),
+		m_name(info.name),
+		m_unpackedLength(info.unpackedLength) {
+	}
 
-			uLongf dstlen = info.unpackedLength;
-			if (uncompress(getRawData(), &dstlen, compressed.get(), info.packedLength) != Z_OK || dstlen != info.unpackedLength) {
-				throw InvalidFormat("failed to decompress " + info.name + " (inside: " + datfile + ")");
-			}
-		} else {
-			input->readInto(getRawData(), info.unpackedLength);
+	void RawDataDAT2::decode(const uint8_t* input, uint8_t* output) const {
+		uLongf dstlen = m_unpackedLength;
+		if (uncompress(output, &dstlen, input, getPackedLength()) != Z_OK || dstlen != m_unpackedLength) {
+			throw InvalidFormat("failed to decompress " + m_name);
 		}
 	}
 
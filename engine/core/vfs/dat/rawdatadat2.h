@@ -34,16 +34,14 @@
 // These includes are split up in two parts, separated by one empty line
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
-#include "vfs/raw/rawdatamemsource.h"
-
-#include "rawdatadat2.h"
+#include "datarchive.h"
 
 namespace FIFE {
 
-	/** A subclass of RawDataMemSource, that fills itself with a FALLOUT1 .DAT file entry
+	/** A FALLOUT2 .DAT file entry, zlib compressed entries are decoded on the first read
 	 * @see MFFalloutDAT2
 	 */
-	class RawDataDAT2 : public RawDataMemSource {
+	class RawDataDAT2 : public RawDataDATSource {
 		public:
 
 			/** The needed information for the extraction.
@@ -57,11 +55,17 @@ namespace FIFE {
 			};
 
 			/** Constructor
-			 * @param vfs The vfs to open with.
-			 * @param datfile The .DAT archive - e.g. master.DAT
+			 * @param archive The opened .DAT archive - e.g. master.DAT
 			 * @param info The .DAT file entry, as retrieved by MFFalloutDAT2
 			 */
-			RawDataDAT2(VFS* vfs, const std::string& datfile, const s_info& info);
+			RawDataDAT2(DATArchivePtr archive, const s_info& info);
+
+		protected:
+			virtual void decode(const uint8_t* input, uint8_t* output) const;
+
+		private:
+			std::string m_name;
+			uint32_t m_unpackedLength;
 	};
 }
 #endif
@@ -72,6 +72,10 @@ namespace FIFE {
 		return target;
 	}
 
+	const uint8_t* RawData::borrowData() const {
+		return m_datasource->borrowData();
+	}
+
 	uint32_t RawData::getDataLength() const {
 		return m_datasource->getSize();
 	}
@@ -126,6 +130,16 @@ namespace FIFE {
 	}
 
 	std::string RawData::readString(size_t len) {
+		const uint8_t* data = borrowData();
+		if (data) {
+			if (m_index_current + len > getDataLength()) {
+				throw IndexOverflow(__FUNCTION__);
+			}
+			std::string ret(reinterpret_cast<const char*>(data + m_index_current), len);
+			m_index_current += len;
+			return ret;
+		}
+
         std::vector<uint8_t> strVector;
         strVector.resize(len);
         readInto(&strVector[0], len);
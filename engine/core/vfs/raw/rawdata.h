@@ -60,6 +60,13 @@ namespace FIFE {
 			std::vector<std::string> getDataInLines();
 
 
+			/** Borrow a read-only pointer to the complete data.
+			 * Avoids a copy if the data is already in memory, e.g. a memory mapped file.
+			 * The pointer is valid as long as this RawData exists, the current index is not used.
+			 * @return The data or 0 if the source can't provide it, use readInto() then.
+			 */
+			const uint8_t* borrowData() const;
+
 			/** get the complete datalength
 			 *
 			 * @return the complete datalength
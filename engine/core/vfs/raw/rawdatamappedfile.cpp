@@ -0,0 +1,192 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <cassert>
+#include <string.h>
+
+// Platform specific includes
+#if defined( WIN32 )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/exception.h"
+
+#include "rawdatamappedfile.h"
+
+namespace FIFE {
+
+	// smaller files are read at once, mapping them costs more than a copy
+	static const uint32_t MAPPING_THRESHOLD = 1024 * 1024;
+
+#if defined( WIN32 )
+	RawDataMappedFile::RawDataMappedFile(const std::string& file) :
+		m_file(file),
+		m_data(0),
+		m_filesize(0),
+		m_fileHandle(INVALID_HANDLE_VALUE),
+		m_mappingHandle(0) {
+
+		m_fileHandle = CreateFileA(m_file.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+			OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, 0);
+		if (m_fileHandle == INVALID_HANDLE_VALUE) {
+			throw CannotOpenFile(m_file);
+		}
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(m_fileHandle, &size) || size.HighPart != 0) {
+			close();
+			throw NotSupported(m_file + " can't be mapped");
+		}
+		m_filesize = size.LowPart;
+		// an empty file can't be mapped, but there is nothing to read anyway
+		if (m_filesize == 0) {
+			return;
+		}
+
+		if (m_filesize < MAPPING_THRESHOLD) {
+			m_buffer.resize(m_filesize);
+			DWORD count = 0;
+			if (!ReadFile(m_fileHandle, &m_buffer[0], m_filesize, &count, 0) || count != m_filesize) {
+				close();
+				throw CannotOpenFile(m_file);
+			}
+			m_data = &m_buffer[0];
+			close();
+			return;
+		}
+
+		m_mappingHandle = CreateFileMappingA(m_fileHandle, 0, PAGE_READONLY, 0, 0, 0);
+		if (m_mappingHandle) {
+			m_data = static_cast<uint8_t*>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+		}
+		if (!m_data) {
+			close();
+			throw NotSupported(m_file + " can't be mapped");
+		}
+	}
+
+	void RawDataMappedFile::close() {
+		if (m_data && m_buffer.empty()) {
+			UnmapViewOfFile(m_data);
+			m_data = 0;
+		}
+		if (m_mappingHandle) {
+			CloseHandle(m_mappingHandle);
+			m_mappingHandle = 0;
+		}
+		if (m_fileHandle != INVALID_HANDLE_VALUE) {
+			CloseHandle(m_fileHandle);
+			m_fileHandle = INVALID_HANDLE_VALUE;
+		}
+	}
+#else
+	RawDataMappedFile::RawDataMappedFile(const std::string& file) :
+		m_file(file),
+		m_data(0),
+		m_filesize(0),
+		m_fileHandle(-1) {
+
+		m_fileHandle = ::open(m_file.c_str(), O_RDONLY);
+		if (m_fileHandle == -1) {
+			throw CannotOpenFile(m_file);
+		}
+
+		struct stat info;
+		if (fstat(m_fileHandle, &info) == -1 || !S_ISREG(info.st_mode) || info.st_size > 0xFFFFFFFFLL) {
+			close();
+			throw NotSupported(m_file + " can't be mapped");
+		}
+		m_filesize = static_cast<uint32_t>(info.st_size);
+		// an empty file can't be mapped, but there is nothing to read anyway
+		if (m_filesize == 0) {
+			return;
+		}
+
+		if (m_filesize < MAPPING_THRESHOLD) {
+			m_buffer.resize(m_filesize);
+			uint32_t count = 0;
+			while (count < m_filesize) {
+				ssize_t result = ::read(m_fileHandle, &m_buffer[count], m_filesize - count);
+				if (result <= 0) {
+					close();
+					throw CannotOpenFile(m_file);
+				}
+				count += static_cast<uint32_t>(result);
+			}
+			m_data = &m_buffer[0];
+			close();
+			return;
+		}
+
+		void* data = mmap(0, m_filesize, PROT_READ, MAP_PRIVATE, m_fileHandle, 0);
+		if (data == MAP_FAILED) {
+			close();
+			throw NotSupported(m_file + " can't be mapped");
+		}
+		m_data = static_cast<uint8_t*>(data);
+		// most files are read from the front to the end
+		madvise(m_data, m_filesize, MADV_SEQUENTIAL);
+	}
+
+	void RawDataMappedFile::close() {
+		if (m_data && m_buffer.empty()) {
+			munmap(m_data, m_filesize);
+			m_data = 0;
+		}
+		if (m_fileHandle != -1) {
+			::close(m_fileHandle);
+			m_fileHandle = -1;
+		}
+	}
+#endif
+
+	RawDataMappedFile::~RawDataMappedFile() {
+		close();
+	}
+
+	uint32_t RawDataMappedFile::getSize() const {
+		return m_filesize;
+	}
+
+	void RawDataMappedFile::readInto(uint8_t* buffer, uint32_t start, uint32_t length) {
+		assert(start + length <= m_filesize);
+		if (length > 0) {
+			memcpy(buffer, m_data + start, length);
+		}
+	}
+
+	const uint8_t* RawDataMappedFile::borrowData() const {
+		return m_data;
+	}
+
+}
@@ -0,0 +1,83 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_VFS_RAW_RAWDATAMAPPEDFILE_H
+#define FIFE_VFS_RAW_RAWDATAMAPPEDFILE_H
+
+// Standard C++ library includes
+#include <string>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "rawdatasource.h"
+
+namespace FIFE {
+
+	/** A RawDataSource for a memory mapped file on the host system
+	 *
+	 * The file is mapped read-only, reads are copies from the mapping and
+	 * borrowData() gives access to the whole file without any copy.
+	 * Files smaller than 1 MiB are read into memory at once instead, for them
+	 * setting up the mapping costs more than copying the data.
+	 */
+	class RawDataMappedFile : public RawDataSource {
+
+		public:
+			/** Constructor
+			 * @param file The file to map.
+			 * @throws CannotOpenFile if the file can't be opened.
+			 * @throws NotSupported if the file can't be mapped, RawDataFile should be used then.
+			 */
+			RawDataMappedFile(const std::string& file);
+			virtual ~RawDataMappedFile();
+
+			virtual uint32_t getSize() const;
+			virtual void readInto(uint8_t* buffer, uint32_t start, uint32_t length);
+			virtual const uint8_t* borrowData() const;
+
+		private:
+			/** Unmaps the file and closes it.
+			 */
+			void close();
+
+			std::string m_file;
+			// the mapping or m_buffer
+			uint8_t* m_data;
+			// the data of small files
+			std::vector<uint8_t> m_buffer;
+			uint32_t m_filesize;
+
+#if defined( WIN32 )
+			void* m_fileHandle;
+			void* m_mappingHandle;
+#else
+			int m_fileHandle;
+#endif
+	};
+
+}
+
+#endif
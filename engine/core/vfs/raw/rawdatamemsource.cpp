@@ -51,4 +51,8 @@ namespace FIFE {
 		return m_data;
 	}
 
+	const uint8_t* RawDataMemSource::borrowData() const {
+		return m_data;
+	}
+
 }
@@ -59,6 +59,8 @@ namespace FIFE {
 			 */
 			uint8_t* getRawData() const;
 
+			virtual const uint8_t* borrowData() const;
+
 			virtual uint32_t getSize() const;
 			virtual void readInto(uint8_t* buffer, uint32_t start, uint32_t length);
 
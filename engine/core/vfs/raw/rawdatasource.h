@@ -58,6 +58,15 @@ namespace FIFE {
 			 */
 			virtual void readInto(uint8_t* buffer, uint32_t start, uint32_t length) = 0;
 
+			/** get a pointer to the complete data
+			 *
+			 * Sources that keep the data contiguous in memory (or mapped into memory)
+			 * return it here, so it can be read without a copy.
+			 * The pointer stays valid as long as the source exists.
+			 * @return The data or 0 if the source can't provide it without copying.
+			 */
+			virtual const uint8_t* borrowData() const;
+
 	};
 
 }
@@ -44,7 +44,27 @@ namespace FIFE {
 	 */
 	static Logger _log(LM_VFS);
 
-	VFS::VFS() : m_sources() {}
+	/** Returns the key of the path in the path index.
+	 */
+	static std::string normalizePath(const std::string& path) {
+		std::string result;
+		result.reserve(path.size());
+		for (std::string::size_type i = 0; i < path.size(); ++i) {
+			char c = path[i] == '\\' ? '/' : path[i];
+			// no leading and double slashes
+			if (c == '/' && (result.empty() || result[result.size() - 1] == '/')) {
+				continue;
+			}
+			result.push_back(c);
+		}
+		return result;
+	}
+
+	VFS::VFS() :
+		m_sources(),
+		m_mutableSources(0),
+		m_indexDirectories(true) {
+	}
 
 	VFS::~VFS() {
 		cleanup();
@@ -109,12 +129,15 @@ namespace FIFE {
 
 	void VFS::addSource(VFSSource* source) {
 		m_sources.push_back(source);
+		invalidate();
 	}
 
 	void VFS::removeSource(VFSSource* source) {
 		type_sources::iterator i = std::find(m_sources.begin(), m_sources.end(), source);
-		if (i != m_sources.end())
+		if (i != m_sources.end()) {
 			m_sources.erase(i);
+			invalidate();
+		}
 	}
 
 	void VFS::removeSource(const std::string& path) {
@@ -132,15 +155,30 @@ namespace FIFE {
 		}
 	}
 
+	bool VFS::isIndexUsable() const {
+		return m_indexDirectories || m_mutableSources == 0;
+	}
+
 	VFSSource* VFS::getSourceForFile(const std::string& file) const {
+		std::string key;
+		if (isIndexUsable()) {
+			key = normalizePath(file);
+			type_pathindex::const_iterator it = m_pathIndex.find(key);
+			if (it != m_pathIndex.end()) {
+				return it->second;
+			}
+		}
+
 		type_sources::const_iterator i = std::find_if(m_sources.begin(), m_sources.end(),
 										 boost::bind2nd(boost::mem_fun(&VFSSource::fileExists), file));
-		if (i == m_sources.end()) {
+		VFSSource* source = i != m_sources.end() ? *i : 0;
+		if (!source) {
 			FL_WARN(_log, LMsg("no source for ") << file << " found");
-			return 0;
 		}
-
-		return *i;
+		if (isIndexUsable()) {
+			m_pathIndex[key] = source;
+		}
+		return source;
 	}
 
 	bool VFS::exists(const std::string& file) const {
@@ -148,6 +186,15 @@ namespace FIFE {
 	}
 
 	bool VFS::isDirectory(const std::string& path) const {
+		std::string key;
+		if (isIndexUsable()) {
+			key = normalizePath(path);
+			std::unordered_map<std::string, bool>::const_iterator it = m_directoryIndex.find(key);
+			if (it != m_directoryIndex.end()) {
+				return it->second;
+			}
+		}
+
 		std::vector<std::string> tokens;
 		// Add a slash in case there isn't one in the string
 		const std::string newpath = path + "/";
@@ -157,7 +204,10 @@ namespace FIFE {
 		std::vector<std::string>::const_iterator token=tokens.begin();
 		while (token != tokens.end()) {
 			if (*token != "") {
-				if (*token != "." && *token != ".." && listDirectories(currentpath, *token).size() == 0) {
+				if (*token != "." && *token != ".." && listDirectories(currentpath).count(*token) == 0) {
+					if (isIndexUsable()) {
+						m_directoryIndex[key] = false;
+					}
 					return false;
 				} else {
 					currentpath += *token + "/";
@@ -166,6 +216,9 @@ namespace FIFE {
 			++token;
 		}
 
+		if (isIndexUsable()) {
+			m_directoryIndex[key] = true;
+		}
 		return true;
 	}
 
@@ -225,6 +278,31 @@ namespace FIFE {
 		return results;
 	}
 
+	void VFS::setPathIndexForDirectories(bool enabled) {
+		if (m_indexDirectories != enabled) {
+			m_indexDirectories = enabled;
+			invalidate();
+		}
+	}
+
+	bool VFS::isPathIndexForDirectories() const {
+		return m_indexDirectories;
+	}
+
+	void VFS::invalidate() {
+		m_pathIndex.clear();
+		m_directoryIndex.clear();
+		// counted here, sources are removed from their destructor where isMutable() can't be used
+		m_mutableSources = 0;
+		type_sources::const_iterator end = m_sources.end();
+		for (type_sources::const_iterator i = m_sources.begin(); i != end; ++i) {
+			(*i)->invalidate();
+			if ((*i)->isMutable()) {
+				++m_mutableSources;
+			}
+		}
+	}
+
 	bool VFS::hasSource(const std::string& path) const {
 		type_providers::const_iterator end = m_providers.end();
 		for (type_providers::const_iterator i = m_providers.begin(); i != end; ++i) {
@@ -26,6 +26,7 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <unordered_map>
 
 // 3rd party library includes
 #include <boost/shared_ptr.hpp>
@@ -54,6 +55,9 @@ namespace FIFE {
 	 * @note All filenames have to be @b lowercase. The VFS will convert them to lowercase
 	 * and emit a warning. This is done to avoid problems with filesystems which are not
 	 * case sensitive.
+	 *
+	 * @note The VFS caches which files and directories exist, see invalidate().
+	 * It is not thread safe, only use it from the main thread.
 	 */
 	class VFS : public DynamicSingleton<VFS>{
 		public:
@@ -158,6 +162,29 @@ namespace FIFE {
 			 */
 			bool hasSource(const std::string& path) const;
 
+			/** Enables or disables the path index for host directories.
+			 *
+			 * Lookups are cached in a path index, including paths which do not exist.
+			 * Read-only sources like archives are always indexed. Host directories are
+			 * indexed by default too, they are scanned once and all lookups are answered
+			 * from memory. Changes made to them afterwards are not noticed, see invalidate().
+			 * Disabled, every lookup in a host directory asks the file system.
+			 * @param enabled true to index host directories too
+			 */
+			void setPathIndexForDirectories(bool enabled);
+
+			/** Returns true if host directories are indexed too.
+			 */
+			bool isPathIndexForDirectories() const;
+
+			/** Drops all cached lookups and directory scans.
+			 *
+			 * The VFS does not watch the host file system. Whoever creates, renames or
+			 * deletes files in an indexed directory has to call this afterwards, otherwise
+			 * exists(), isDirectory() and the list functions keep the old answer.
+			 * The savers of the engine do this.
+			 */
+			void invalidate();
 
 		private:
 			typedef std::vector<VFSSourceProvider*> type_providers;
@@ -166,8 +193,20 @@ namespace FIFE {
 			typedef std::vector<VFSSource*> type_sources;
 			type_sources m_sources;
 
+			//! normalized path to the source of the file, NULL if no source has it
+			typedef std::unordered_map<std::string, VFSSource*> type_pathindex;
+			mutable type_pathindex m_pathIndex;
+			//! normalized path to the result of isDirectory
+			mutable std::unordered_map<std::string, bool> m_directoryIndex;
+			//! number of sources whose content can change
+			uint32_t m_mutableSources;
+			//! index host directories too
+			bool m_indexDirectories;
+
 			std::set<std::string> filterList(const std::set<std::string>& list, const std::string& fregex) const;
 			VFSSource* getSourceForFile(const std::string& file) const;
+			//! returns true if lookups can be answered from the path index
+			bool isIndexUsable() const;
 	};
 
 }
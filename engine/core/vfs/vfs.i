@@ -53,6 +53,10 @@ namespace FIFE {
 
 		std::set<std::string> listFiles(const std::string& path) const;
 		std::set<std::string> listDirectories(const std::string& path) const;
+
+		void setPathIndexForDirectories(bool enabled);
+		bool isPathIndexForDirectories() const;
+		void invalidate();
 	};
 }
 
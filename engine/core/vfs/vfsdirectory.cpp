@@ -29,6 +29,7 @@
 // Second block: files included from the same folder
 #include "vfs/raw/rawdata.h"
 #include "vfs/raw/rawdatafile.h"
+#include "vfs/raw/rawdatamappedfile.h"
 #include "util/log/logger.h"
 #include "util/base/exception.h"
 
@@ -53,19 +54,30 @@ namespace FIFE {
 
 
 	bool VFSDirectory::fileExists(const std::string& name) const {
-		std::string fullFilename = m_root + name;
-
-        bfs::path fullPath(fullFilename);
-		std::ifstream file(fullPath.string().c_str());
-
-		if (file)
-			return true;
+		if (!getVFS()->isPathIndexForDirectories()) {
+			// one stat instead of opening the file
+			boost::system::error_code error;
+			bfs::file_status status = bfs::status(bfs::path(m_root + name), error);
+			return !error && bfs::exists(status) && !bfs::is_directory(status);
+		}
 
-		return false;
+		std::string path = fixPath(name);
+		std::string::size_type pos = path.rfind('/');
+		if (pos == std::string::npos) {
+			return getEntries("").files.count(path) > 0;
+		}
+		return getEntries(path.substr(0, pos)).files.count(path.substr(pos + 1)) > 0;
 	}
 
 	RawData* VFSDirectory::open(const std::string& file) const {
-		return new RawData(new RawDataFile(m_root + file));
+		const std::string fullFilename = m_root + file;
+		try {
+			return new RawData(new RawDataMappedFile(fullFilename));
+		} catch (const NotSupported&) {
+			// e.g. special files, fall back to reading with a stream
+			FL_DBG(_log, LMsg("can't map file ") << fullFilename);
+		}
+		return new RawData(new RawDataFile(fullFilename));
 	}
 
 	std::set<std::string> VFSDirectory::listFiles(const std::string& path) const {
@@ -76,7 +88,54 @@ namespace FIFE {
 		return list(path, true);
 	}
 
+	void VFSDirectory::invalidate() {
+		m_directories.clear();
+	}
+
+	const VFSDirectory::DirectoryEntries& VFSDirectory::getEntries(const std::string& path) const {
+		std::unordered_map<std::string, DirectoryEntries>::iterator it = m_directories.find(path);
+		if (it != m_directories.end()) {
+			return it->second;
+		}
+		DirectoryEntries& entries = m_directories[path];
+		scan(path, entries);
+		return entries;
+	}
+
+	void VFSDirectory::scan(const std::string& path, DirectoryEntries& entries) const {
+		try {
+			bfs::path boost_path(m_root + path);
+			if (!bfs::exists(boost_path) || !bfs::is_directory(boost_path))
+				return;
+
+			bfs::directory_iterator end;
+			for (bfs::directory_iterator i(boost_path); i != end; ++i) {
+				std::string filename = GetFilenameFromDirectoryIterator(i);
+				if (filename.empty())
+					continue;
+
+				if (bfs::is_directory(*i)) {
+					entries.directories.insert(filename);
+				} else {
+					entries.files.insert(filename);
+				}
+			}
+		}
+		catch (const bfs::filesystem_error& ex) {
+			throw Exception(ex.what());
+		}
+	}
+
 	std::set<std::string> VFSDirectory::list(const std::string& path, bool directorys) const {
+		if (getVFS()->isPathIndexForDirectories()) {
+			std::string dir = fixPath(path);
+			while (!dir.empty() && dir[dir.size() - 1] == '/') {
+				dir.erase(dir.size() - 1);
+			}
+			const DirectoryEntries& entries = getEntries(dir);
+			return directorys ? entries.directories : entries.files;
+		}
+
 		std::set<std::string> list;
 		std::string dir = m_root;
 
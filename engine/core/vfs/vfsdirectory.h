@@ -23,6 +23,7 @@
 #define FIFE_VFS_VFSHOSTSYSTEM_H
 
 // Standard C++ library includes
+#include <unordered_map>
 
 // 3rd party library includes
 
@@ -76,10 +77,30 @@ namespace FIFE {
 			 */
 			std::set<std::string> listDirectories(const std::string& path) const;
 
+			/** Host directories can change.
+			 */
+			bool isMutable() const { return true; }
+
+			/** Drops the scanned directories.
+			 */
+			void invalidate();
+
 		private:
 			std::string m_root;
 
+			//! content of a scanned directory
+			struct DirectoryEntries {
+				std::set<std::string> files;
+				std::set<std::string> directories;
+			};
+			//! scanned directories, only used when the VFS indexes host directories
+			mutable std::unordered_map<std::string, DirectoryEntries> m_directories;
+
 			std::set<std::string> list(const std::string& path, bool directorys) const;
+			//! scans the directory once, returns the cached content afterwards
+			const DirectoryEntries& getEntries(const std::string& path) const;
+			//! reads the content of the directory from the host file system
+			void scan(const std::string& path, DirectoryEntries& entries) const;
 
 	};
 
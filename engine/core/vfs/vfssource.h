@@ -81,6 +81,15 @@ namespace FIFE {
 			 */
 			virtual std::set<std::string> listDirectories(const std::string& path) const = 0;
 
+			/** Returns true if the content of the source can change while it is used,
+			 * like a directory of the host file system. Archives can't change.
+			 */
+			virtual bool isMutable() const { return false; }
+
+			/** Drops cached information about the content of the source.
+			 */
+			virtual void invalidate() {}
+
 		protected:
 			std::string fixPath(std::string path) const;
 
@@ -21,7 +21,6 @@
 
 // Standard C++ library includes
 #include <cassert>
-#include <string.h>
 
 // 3rd party library includes
 
@@ -33,11 +32,13 @@
 
 namespace FIFE {
 
-	ZipFileSource::ZipFileSource(uint8_t* data, uint32_t datalen) : m_data(data), m_datalen(datalen) {
+	ZipFileSource::ZipFileSource(RawDataPtr archive, uint32_t offset, uint32_t datalen) :
+		m_archive(archive),
+		m_offset(offset),
+		m_datalen(datalen) {
 	}
 
 	ZipFileSource::~ZipFileSource() {
-		delete[] m_data;
 	}
 
 	uint32_t ZipFileSource::getSize() const {
@@ -46,6 +47,12 @@ namespace FIFE {
 
 	void ZipFileSource::readInto(uint8_t* target, uint32_t start, uint32_t len) {
 		assert(start + len <= m_datalen);
-		memcpy(target, m_data + start, len);
+		m_archive->setIndex(m_offset + start);
+		m_archive->readInto(target, len);
+	}
+
+	const uint8_t* ZipFileSource::borrowData() const {
+		const uint8_t* data = m_archive->borrowData();
+		return data ? data + m_offset : 0;
 	}
 }
@@ -21,21 +21,29 @@
 #ifndef FIFE_VFS_ZIP_ZIPFILESOURCE_H
 #define FIFE_VFS_ZIP_ZIPFILESOURCE_H
 
+#include "vfs/raw/rawdata.h"
 #include "vfs/raw/rawdatasource.h"
 
 namespace FIFE {
 
-	class VFS;
+	/** A RawDataSource for a stored (uncompressed) file inside of a zip archive.
+	 *
+	 * The data is not copied, it is a view on the range of the archive that
+	 * holds the file and every read goes to the archive. If the archive is
+	 * memory mapped the file is borrowed from the mapping.
+	 */
 	class ZipFileSource : public RawDataSource {
 		public:
-			ZipFileSource(uint8_t* data, uint32_t datalen);
+			ZipFileSource(RawDataPtr archive, uint32_t offset, uint32_t datalen);
 			virtual ~ZipFileSource();
 
 			virtual uint32_t getSize() const;
 			virtual void readInto(uint8_t* target, uint32_t start, uint32_t len);
+			virtual const uint8_t* borrowData() const;
 
 		private:
-			uint8_t* m_data;
+			RawDataPtr m_archive;
+			uint32_t m_offset;
 			uint32_t m_datalen;
 
 	};
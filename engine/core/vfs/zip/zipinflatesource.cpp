@@ -0,0 +1,228 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+// Standard C++ library includes
+#include <algorithm>
+#include <cassert>
+#include <string.h>
+
+// 3rd party library includes
+#include "zlib.h"
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/exception.h"
+#include "util/log/logger.h"
+
+#include "zipinflatesource.h"
+
+namespace FIFE {
+
+	static Logger _log(LM_LOADERS);
+
+	// size of the buffer for compressed data
+	static const uint32_t INPUT_SIZE = 16 * 1024;
+	// size of the window with inflated data
+	static const uint32_t WINDOW_SIZE = 64 * 1024;
+
+	struct ZipInflateStream {
+		z_stream stream;
+		std::vector<uint8_t> input;
+	};
+
+	ZipInflatePool::ZipInflatePool(uint32_t maxStreams) :
+		m_maxStreams(maxStreams) {
+	}
+
+	ZipInflatePool::~ZipInflatePool() {
+		std::vector<ZipInflateStream*>::iterator it = m_streams.begin();
+		for (; it != m_streams.end(); ++it) {
+			inflateEnd(&(*it)->stream);
+			delete *it;
+		}
+	}
+
+	ZipInflateStream* ZipInflatePool::acquire() {
+		if (!m_streams.empty()) {
+			ZipInflateStream* stream = m_streams.back();
+			m_streams.pop_back();
+			return stream;
+		}
+
+		ZipInflateStream* stream = new ZipInflateStream();
+		stream->stream.next_in = Z_NULL;
+		stream->stream.avail_in = 0;
+		stream->stream.zalloc = Z_NULL;
+		stream->stream.zfree = Z_NULL;
+		stream->stream.opaque = Z_NULL;
+		// negative window bits, zip entries have no zlib header
+		if (inflateInit2(&stream->stream, -15) != Z_OK) {
+			delete stream;
+			throw InvalidFormat("inflateInit2 failed");
+		}
+		stream->input.resize(INPUT_SIZE);
+		return stream;
+	}
+
+	void ZipInflatePool::release(ZipInflateStream* stream) {
+		if (m_streams.size() < m_maxStreams && inflateReset(&stream->stream) == Z_OK) {
+			stream->stream.next_in = Z_NULL;
+			stream->stream.avail_in = 0;
+			m_streams.push_back(stream);
+		} else {
+			inflateEnd(&stream->stream);
+			delete stream;
+		}
+	}
+
+	uint32_t ZipInflatePool::getIdleCount() const {
+		return m_streams.size();
+	}
+
+	ZipInflateSource::ZipInflateSource(RawDataPtr archive, ZipInflatePoolPtr pool, uint32_t offset, uint32_t compsize, uint32_t datalen) :
+		m_archive(archive),
+		m_pool(pool),
+		m_stream(0),
+		m_offset(offset),
+		m_compsize(compsize),
+		m_compread(0),
+		m_datalen(datalen),
+		m_inflated(0),
+		m_windowStart(0),
+		m_windowLen(0) {
+	}
+
+	ZipInflateSource::~ZipInflateSource() {
+		releaseStream();
+	}
+
+	uint32_t ZipInflateSource::getSize() const {
+		return m_datalen;
+	}
+
+	void ZipInflateSource::readInto(uint8_t* target, uint32_t start, uint32_t len) {
+		assert(start + len <= m_datalen);
+
+		while (len > 0) {
+			// the window holds the requested bytes
+			if (start >= m_windowStart && start < m_windowStart + m_windowLen) {
+				uint32_t count = std::min(len, m_windowStart + m_windowLen - start);
+				memcpy(target, &m_window[start - m_windowStart], count);
+				target += count;
+				start += count;
+				len -= count;
+				continue;
+			}
+
+			if (start < m_inflated) {
+				restart();
+			}
+
+			// skip the data in front of the requested bytes
+			// or fill the window if the request is small
+			if (start > m_inflated || len < WINDOW_SIZE) {
+				if (m_window.empty()) {
+					m_window.resize(std::min(WINDOW_SIZE, m_datalen));
+				}
+				uint32_t count = std::min(static_cast<uint32_t>(m_window.size()), m_datalen - m_inflated);
+				m_windowStart = m_inflated;
+				m_windowLen = 0;
+				inflateInto(&m_window[0], count);
+				m_windowLen = count;
+				continue;
+			}
+
+			// big sequential read, inflate directly into the target
+			inflateInto(target, len);
+			if (m_window.empty()) {
+				m_window.resize(std::min(WINDOW_SIZE, m_datalen));
+			}
+			// keep the tail for small steps back
+			m_windowLen = std::min(static_cast<uint32_t>(m_window.size()), len);
+			m_windowStart = start + len - m_windowLen;
+			memcpy(&m_window[0], target + len - m_windowLen, m_windowLen);
+			len = 0;
+		}
+	}
+
+	void ZipInflateSource::inflateInto(uint8_t* target, uint32_t len) {
+		if (!m_stream) {
+			m_stream = m_pool->acquire();
+		}
+
+		z_stream& zstream = m_stream->stream;
+		zstream.next_out = target;
+		zstream.avail_out = len;
+
+		while (zstream.avail_out > 0) {
+			if (zstream.avail_in == 0 && m_compread < m_compsize) {
+				uint32_t count = std::min(static_cast<uint32_t>(m_stream->input.size()), m_compsize - m_compread);
+				m_archive->setIndex(m_offset + m_compread);
+				m_archive->readInto(&m_stream->input[0], count);
+				m_compread += count;
+				zstream.next_in = &m_stream->input[0];
+				zstream.avail_in = count;
+			}
+
+			int32_t err = inflate(&zstream, Z_NO_FLUSH);
+			if (err == Z_STREAM_END) {
+				break;
+			}
+			if (err != Z_OK) {
+				if (zstream.msg) {
+					FL_ERR(_log, LMsg("inflate failed: ") << zstream.msg);
+				} else {
+					FL_ERR(_log, LMsg("inflate failed without msg, err: ") << err);
+				}
+				restart();
+				throw InvalidFormat("inflate failed");
+			}
+		}
+
+		if (zstream.avail_out != 0) {
+			FL_ERR(_log, LMsg("inflate ended ") << zstream.avail_out << " bytes too early");
+			restart();
+			throw InvalidFormat("inflate ended too early");
+		}
+
+		m_inflated += len;
+		// the stream isn't needed anymore, until someone reads backwards
+		if (m_inflated == m_datalen) {
+			releaseStream();
+		}
+	}
+
+	void ZipInflateSource::restart() {
+		releaseStream();
+		m_compread = 0;
+		m_inflated = 0;
+		m_windowStart = 0;
+		m_windowLen = 0;
+	}
+
+	void ZipInflateSource::releaseStream() {
+		if (m_stream) {
+			m_pool->release(m_stream);
+			m_stream = 0;
+		}
+	}
+}
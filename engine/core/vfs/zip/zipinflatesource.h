@@ -0,0 +1,124 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+#ifndef FIFE_VFS_ZIP_ZIPINFLATESOURCE_H
+#define FIFE_VFS_ZIP_ZIPINFLATESOURCE_H
+
+// Standard C++ library includes
+#include <memory>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "vfs/raw/rawdata.h"
+#include "vfs/raw/rawdatasource.h"
+
+namespace FIFE {
+
+	struct ZipInflateStream;
+
+	/** Keeps a few initialized inflate streams of a zip archive for reuse.
+	 *
+	 * Setting up a zlib stream allocates the inflate state and the sliding
+	 * window, the pool resets finished streams instead, together with their
+	 * buffer for the compressed data.
+	 */
+	class ZipInflatePool {
+		public:
+			/** Constructor
+			 * @param maxStreams The maximal number of idle streams that are kept.
+			 */
+			ZipInflatePool(uint32_t maxStreams = 4);
+			~ZipInflatePool();
+
+			/** Returns a stream that is ready to inflate raw deflate data.
+			 */
+			ZipInflateStream* acquire();
+
+			/** Gives the stream back, it is reused or deleted.
+			 */
+			void release(ZipInflateStream* stream);
+
+			/** Returns the number of idle streams.
+			 */
+			uint32_t getIdleCount() const;
+
+		private:
+			std::vector<ZipInflateStream*> m_streams;
+			uint32_t m_maxStreams;
+	};
+	typedef std::shared_ptr<ZipInflatePool> ZipInflatePoolPtr;
+
+	/** A RawDataSource for a deflated file inside of a zip archive.
+	 *
+	 * The file is inflated on demand while it is read. Only a window with the
+	 * last inflated bytes is kept, reads that start before the window inflate
+	 * the file again from the beginning. Sequential reads of a big file don't
+	 * need more memory than the window and the inflate stream.
+	 */
+	class ZipInflateSource : public RawDataSource {
+		public:
+			ZipInflateSource(RawDataPtr archive, ZipInflatePoolPtr pool, uint32_t offset, uint32_t compsize, uint32_t datalen);
+			virtual ~ZipInflateSource();
+
+			virtual uint32_t getSize() const;
+			virtual void readInto(uint8_t* target, uint32_t start, uint32_t len);
+
+		private:
+			/** Inflates the next len bytes into target.
+			 */
+			void inflateInto(uint8_t* target, uint32_t len);
+
+			/** Starts to inflate from the beginning of the file.
+			 */
+			void restart();
+
+			/** Gives the inflate stream back to the pool.
+			 */
+			void releaseStream();
+
+			RawDataPtr m_archive;
+			ZipInflatePoolPtr m_pool;
+			ZipInflateStream* m_stream;
+
+			// position and size of the compressed data in the archive
+			uint32_t m_offset;
+			uint32_t m_compsize;
+			// compressed bytes read from the archive
+			uint32_t m_compread;
+
+			// size of the inflated file
+			uint32_t m_datalen;
+			// inflated bytes so far
+			uint32_t m_inflated;
+
+			// the last inflated bytes
+			std::vector<uint8_t> m_window;
+			uint32_t m_windowStart;
+			uint32_t m_windowLen;
+	};
+
+}
+
+#endif
@@ -22,10 +22,8 @@
 // Standard C++ library includes
 #include <algorithm>
 #include <list>
-#include <memory>
 
 // 3rd party library includes
-#include "zlib.h"
 
 // FIFE includes
 // These includes are split up in two parts, separated by one empty line
@@ -48,12 +46,12 @@ namespace FIFE {
 
 	static Logger _log(LM_LOADERS);
 
-	ZipSource::ZipSource(VFS* vfs, const std::string& zip_file) : VFSSource(vfs), m_zipfile(vfs->open(zip_file)) {
+	ZipSource::ZipSource(VFS* vfs, const std::string& zip_file) : VFSSource(vfs), m_zipfile(vfs->open(zip_file)),
+		m_inflatePool(new ZipInflatePool()) {
 		readIndex();
 	}
 
 	ZipSource::~ZipSource() {
-		delete m_zipfile;
 	}
 
 	bool ZipSource::fileExists(const std::string& file) const {
@@ -70,51 +68,17 @@ namespace FIFE {
 		if (node) {
 			const ZipEntryData& entryData = node->getZipEntryData();
 
-			m_zipfile->setIndex(entryData.offset);
-			uint8_t* data = new uint8_t[entryData.size_real]; // beware of me - one day i WILL cause memory leaks
+			// nothing is read here, the data is read from the archive when it's requested
 			if (entryData.comp == 8) { // compressed using deflate
-				FL_DBG(_log, LMsg("trying to uncompress file ") <<  path << " (compressed with method " << entryData.comp << ")");
-				std::unique_ptr<uint8_t[]> compdata(new uint8_t[entryData.size_comp]);
-				m_zipfile->readInto(compdata.get(), entryData.size_comp);
-
-				z_stream zstream;
-				zstream.next_in = compdata.get();
-				zstream.avail_in = entryData.size_comp;
-				zstream.zalloc = Z_NULL;
-				zstream.zfree = Z_NULL;
-				zstream.opaque = Z_NULL;
-				zstream.next_out = data;
-				zstream.avail_out = entryData.size_real;
-
-				if (inflateInit2(&zstream, -15) != Z_OK) {
-					FL_ERR(_log, LMsg("inflateInit2 failed"));
-					delete[] data;
-					return 0;
-				}
-
-				int32_t err = inflate(&zstream, Z_FINISH);
-				if (err != Z_STREAM_END) {
-					if (zstream.msg) {
-						FL_ERR(_log, LMsg("inflate failed: ") << zstream.msg);
-					} else {
-						FL_ERR(_log, LMsg("inflate failed without msg, err: ") << err);
-					}
-
-					inflateEnd(&zstream);
-					delete[] data;
-					return 0;
-				}
-
-				inflateEnd(&zstream);
+				FL_DBG(_log, LMsg("opening compressed file ") <<  path << " (compressed with method " << entryData.comp << ")");
+				return new RawData(new ZipInflateSource(m_zipfile, m_inflatePool,
+					entryData.offset, entryData.size_comp, entryData.size_real));
 			} else if (entryData.comp == 0) { // uncompressed
-				m_zipfile->readInto(data, entryData.size_real);
+				return new RawData(new ZipFileSource(m_zipfile, entryData.offset, entryData.size_real));
 			} else {
 				FL_ERR(_log, LMsg("unsupported compression"));
-				delete[] data;
 				return 0;
 			}
-
-			return new RawData(new ZipFileSource(data, entryData.size_real));
 		}
 
 		return 0;
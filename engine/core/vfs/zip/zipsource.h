@@ -34,8 +34,10 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "util/base/fife_stdint.h"
+#include "vfs/raw/rawdata.h"
 #include "vfs/vfssource.h"
 
+#include "zipinflatesource.h"
 #include "ziptree.h"
 
 namespace FIFE {
@@ -63,7 +65,9 @@ namespace FIFE {
 
     private:
         ZipTree m_zipTree;
-		RawData* m_zipfile;
+		// shared with the files opened from the archive, they read from it
+		RawDataPtr m_zipfile;
+		ZipInflatePoolPtr m_inflatePool;
 
 	};
 
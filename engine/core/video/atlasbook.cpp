@@ -55,101 +55,107 @@ namespace FIFE {
 			return 0;
 		}
 
-		blocks.push_back(AtlasBlock(Rect(), 0));
-		AtlasBlock* newBlock = &blocks[blocks.size() - 1];
-
-		for(uint32_t v = 0; (v+1)*height <= this->height; ++v) {
-			newBlock->top = v * height;
-			newBlock->bottom = (v+1) * height;
-
-			for(uint32_t u = 0; (u+1)*width <= this->width; ++u) {
-
-				newBlock->left = u * width;
-				newBlock->right = (u+1) * width;
-
-				AtlasBlock const* intersection = intersects(newBlock);
-				if(!intersection) {
-					freePixels -= width*height*pixelSize;
-					assert(freePixels >= 0);
-
-					// try to squeeze a little bit (horizontal)
-					if(newBlock->left > 0) {
-						AtlasBlock squeezed(*newBlock);
-
-						--squeezed.left;
-						--squeezed.right;
-
-						if(!(intersection = intersects(&squeezed)))	{
-							++squeezed.left;
-							++squeezed.right;
-							int blockWidth = newBlock->getWidth();
-
-							// binary search
-							for(int i = 0, div = 2; i < 4; ++i) {
-								squeezed.left -= blockWidth / div;
-								squeezed.right -= blockWidth / div;
-
-								if((intersection = intersects(&squeezed))) {
-									squeezed.left += blockWidth / div;
-									squeezed.right += blockWidth / div;
-								}
-								div <<= 1;
-							}
-
-							// linear search
-							while(!(intersection = intersects(&squeezed)) && squeezed.left > 0) {
-								--squeezed.left;
-								--squeezed.right;
-							}
-
-							newBlock->left = squeezed.left + 1;
-							newBlock->right = squeezed.right + 1;
-						}
-					}
-
-					// try to squeeze a little bit (vertical)
-					if(newBlock->top > 0) {
-						AtlasBlock squeezed(*newBlock);
-
-						--squeezed.top;
-						--squeezed.bottom;
-
-						if(!(intersection = intersects(&squeezed)))	{
-							++squeezed.top;
-							++squeezed.bottom;
-							int blockHeight = newBlock->getHeight();
-
-							// binary search
-							for(int i = 0, div = 2; i < 4; ++i) {
-								squeezed.top -= blockHeight / div;
-								squeezed.bottom -= blockHeight / div;
-
-								if((intersection = intersects(&squeezed))) {
-									squeezed.top += blockHeight / div;
-									squeezed.bottom += blockHeight / div;
-								}
-								div <<= 1;
-							}
-
-							// linear search
-							while(!(intersection = intersects(&squeezed)) && squeezed.top > 0) {
-								--squeezed.top;
-								--squeezed.bottom;
-							}
-
-							newBlock->top = squeezed.top + 1;
-							newBlock->bottom = squeezed.bottom + 1;
-						}
-					}
-
-					newBlock->page = this->page;
-					return newBlock;
-				}
+		// look for the free block with the best short side fit
+		Blocks::const_iterator best = freeBlocks.end();
+		uint32_t bestShortSide = std::numeric_limits<uint32_t>::max();
+		uint32_t bestLongSide = std::numeric_limits<uint32_t>::max();
+		for(Blocks::const_iterator free = freeBlocks.begin(); free != freeBlocks.end(); ++free) {
+			if(free->getWidth() < width || free->getHeight() < height) {
+				continue;
+			}
+
+			uint32_t leftoverHoriz = free->getWidth() - width;
+			uint32_t leftoverVert = free->getHeight() - height;
+			uint32_t shortSide = std::min(leftoverHoriz, leftoverVert);
+			uint32_t longSide = std::max(leftoverHoriz, leftoverVert);
+
+			if(shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+				best = free;
+				bestShortSide = shortSide;
+				bestLongSide = longSide;
 			}
 		}
+
 		// couldn't find suitable place for a new block
-		blocks.pop_back();
-		return 0;
+		if(best == freeBlocks.end()) {
+			return 0;
+		}
+
+		AtlasBlock newBlock(Rect(best->left, best->top, width, height), page);
+		freePixels -= width*height*pixelSize;
+		assert(freePixels >= 0);
+
+		splitFreeBlocks(newBlock);
+		pruneFreeBlocks();
+
+		blocks.push_back(newBlock);
+		return &blocks[blocks.size() - 1];
+	}
+
+	void AtlasPage::splitFreeBlocks(AtlasBlock const& used) {
+		Blocks newBlocks;
+		Blocks::iterator free = freeBlocks.begin();
+		while(free != freeBlocks.end()) {
+			if(free->intersects(used).isTrivial()) {
+				++free;
+				continue;
+			}
+
+			// keep the maximal parts of the free block around the used one
+			AtlasBlock part(*free);
+			if(used.left > free->left) {
+				part.right = used.left;
+				newBlocks.push_back(part);
+				part = *free;
+			}
+			if(used.right < free->right) {
+				part.left = used.right;
+				newBlocks.push_back(part);
+				part = *free;
+			}
+			if(used.top > free->top) {
+				part.bottom = used.top;
+				newBlocks.push_back(part);
+				part = *free;
+			}
+			if(used.bottom < free->bottom) {
+				part.top = used.bottom;
+				newBlocks.push_back(part);
+			}
+			free = freeBlocks.erase(free);
+		}
+		freeBlocks.insert(freeBlocks.end(), newBlocks.begin(), newBlocks.end());
+	}
+
+	void AtlasPage::pruneFreeBlocks() {
+		for(size_t i = 0; i < freeBlocks.size(); ++i) {
+			for(size_t j = i + 1; j < freeBlocks.size(); ++j) {
+				if(freeBlocks[j].contains(freeBlocks[i])) {
+					freeBlocks.erase(freeBlocks.begin() + i);
+					--i;
+					break;
+				}
+				if(freeBlocks[i].contains(freeBlocks[j])) {
+					freeBlocks.erase(freeBlocks.begin() + j);
+					--j;
+				}
+			}
+		}
+	}
+
+	uint32_t AtlasPage::getUsedPixels() const {
+		uint32_t used = 0;
+		for(Blocks::const_iterator block = blocks.begin(); block != blocks.end(); ++block) {
+			used += block->getWidth() * block->getHeight();
+		}
+		return used;
+	}
+
+	float AtlasPage::getOccupancy() const {
+		if(width == 0 || height == 0) {
+			return 0.0f;
+		}
+		return static_cast<float>(getUsedPixels()) / static_cast<float>(width * height);
 	}
 
 	void AtlasPage::shrink(bool pot) {
@@ -183,15 +189,19 @@ namespace FIFE {
 			width = boundaryBox.getWidth();
 			height = boundaryBox.getHeight();
 		}
-	}	
-	
-	AtlasBlock const* AtlasPage::intersects(AtlasBlock const* block) const {
-		for(size_t b = 0; b < blocks.size() - 1; ++b) {
-			if(!blocks[b].intersects(*block).isTrivial())
-				return block;
+
+		// clip the free blocks to the new page size
+		Blocks::iterator free = freeBlocks.begin();
+		while(free != freeBlocks.end()) {
+			free->right = std::min(free->right, width);
+			free->bottom = std::min(free->bottom, height);
+			if(free->left >= free->right || free->top >= free->bottom) {
+				free = freeBlocks.erase(free);
+			} else {
+				++free;
+			}
 		}
-		// no intersection
-		return 0;
+		freePixels = static_cast<int32_t>((width * height - getUsedPixels()) * pixelSize);
 	}	
 	
 	AtlasBlock* AtlasBook::getBlock(uint32_t width, uint32_t height) {
@@ -222,4 +232,17 @@ namespace FIFE {
 			page->shrink(pot);
 		}
 	}	
+
+	float AtlasBook::getOccupancy() const {
+		uint64_t used = 0;
+		uint64_t total = 0;
+		for(Pages::const_iterator page = pages.begin(); page != pages.end(); ++page) {
+			used += page->getUsedPixels();
+			total += page->getWidth() * page->getHeight();
+		}
+		if(total == 0) {
+			return 0.0f;
+		}
+		return static_cast<float>(used) / static_cast<float>(total);
+	}
 }
\ No newline at end of file
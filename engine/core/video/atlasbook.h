@@ -27,6 +27,7 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <limits>
 
 // 3rd party library includes
 
@@ -49,7 +50,8 @@ namespace FIFE {
 			top(rect.y), bottom(rect.bottom()){
 		}
 
-		AtlasBlock() {
+		AtlasBlock()
+			: page(0), left(0), right(0), top(0), bottom(0) {
 		}
 
 		//	      (0,0) [left]   [right]
@@ -79,14 +81,27 @@ namespace FIFE {
 
 		AtlasBlock intersects(AtlasBlock const& rect) const;
 		void merge(AtlasBlock const& rect);
+
+		// true if the given block lies completely inside this block
+		bool contains(AtlasBlock const& rect) const {
+			return rect.left >= left && rect.right <= right &&
+				rect.top >= top && rect.bottom <= bottom;
+		}
 	};
 
+	/** A single atlas page.
+	 *
+	 * Blocks are placed with the MaxRects algorithm (best short side fit).
+	 * The page keeps a list of maximal free rectangles, a new block is put into
+	 * the free rectangle that leaves the smallest leftover on its shorter side.
+	 */
 	class AtlasPage {
 	public:
 		AtlasPage(uint32_t width, uint32_t height,
 			uint32_t pixelSize, uint32_t page)
 			: width(width), height(height), pixelSize(pixelSize),
 			page(page), freePixels(width*height*pixelSize){
+			freeBlocks.push_back(AtlasBlock(Rect(0, 0, width, height), page));
 		}
 
 		AtlasBlock* getBlock(uint32_t width, uint32_t height);
@@ -100,8 +115,19 @@ namespace FIFE {
 			return height;
 		}
 
+		/** Returns the number of pixels covered by blocks.
+		 */
+		uint32_t getUsedPixels() const;
+
+		/** Returns the ratio of used pixels to the page size (0.0 - 1.0).
+		 */
+		float getOccupancy() const;
+
 	private:
-		AtlasBlock const* intersects(AtlasBlock const* block) const;
+		// splits all free blocks that overlap with the used block
+		void splitFreeBlocks(AtlasBlock const& used);
+		// removes free blocks which are contained in other free blocks
+		void pruneFreeBlocks();
 
 		uint32_t width, height;
 		uint32_t pixelSize;
@@ -110,6 +136,7 @@ namespace FIFE {
 
 		typedef std::vector<AtlasBlock> Blocks;
 		Blocks blocks;
+		Blocks freeBlocks;
 	};
 
 	class AtlasBook {
@@ -130,6 +157,14 @@ namespace FIFE {
 			return pages[index];
 		}
 
+		size_t getPageCount() const {
+			return pages.size();
+		}
+
+		/** Returns the ratio of used pixels to the size of all pages (0.0 - 1.0).
+		 */
+		float getOccupancy() const;
+
 	private:
 		// add new atlas to atlas container
 		AtlasPage* extendCache(uint32_t minPageWidth, uint32_t minPageHeight);
@@ -0,0 +1,211 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/exception.h"
+#include "util/log/logger.h"
+
+#include "atlasbook.h"
+#include "atlaspacker.h"
+#include "imagemanager.h"
+
+namespace FIFE {
+	/** Logger to use for this source file.
+	 *  @relates Logger
+	 */
+	static Logger _log(LM_VIDEO);
+
+	AtlasPacker::AtlasPacker(const std::string& name, uint32_t pageWidth, uint32_t pageHeight):
+		m_name(name),
+		m_pageWidth(pageWidth),
+		m_pageHeight(pageHeight),
+		m_occupancy(0.0f),
+		m_sourceTextures(0) {
+	}
+
+	AtlasPacker::~AtlasPacker() {
+	}
+
+	bool AtlasPacker::addImage(const ImagePtr& image) {
+		if (!image || image->isSharedImage()) {
+			return false;
+		}
+
+		std::vector<PackedImage>::const_iterator it = m_images.begin();
+		for (; it != m_images.end(); ++it) {
+			if (it->image == image) {
+				return false;
+			}
+		}
+
+		if (image->getState() != IResource::RES_LOADED) {
+			image->load();
+		}
+		if (image->getWidth() > m_pageWidth || image->getHeight() > m_pageHeight) {
+			FL_WARN(_log, LMsg("AtlasPacker::addImage() - ") << "Image " << image->getName() << " is too big for the atlas pages.");
+			return false;
+		}
+
+		PackedImage packed;
+		packed.image = image;
+		packed.page = 0;
+		m_images.push_back(packed);
+		++m_sourceTextures;
+		return true;
+	}
+
+	uint32_t AtlasPacker::addAnimation(const AnimationPtr& animation) {
+		uint32_t count = 0;
+		for (uint32_t i = 0; i < animation->getFrameCount(); ++i) {
+			if (addImage(animation->getFrame(i))) {
+				++count;
+			}
+		}
+		return count;
+	}
+
+	namespace {
+		// MaxRects works best if the big images are placed first
+		struct LargerImage {
+			bool operator()(const ImagePtr& lhs, const ImagePtr& rhs) const {
+				uint32_t lhsSide = std::max(lhs->getWidth(), lhs->getHeight());
+				uint32_t rhsSide = std::max(rhs->getWidth(), rhs->getHeight());
+				if (lhsSide != rhsSide) {
+					return lhsSide > rhsSide;
+				}
+				return lhs->getWidth() * lhs->getHeight() > rhs->getWidth() * rhs->getHeight();
+			}
+		};
+	}
+
+	void AtlasPacker::pack(bool pot) {
+		if (!m_pages.empty()) {
+			FL_WARN(_log, LMsg("AtlasPacker::pack() - ") << "Atlas " << m_name << " was already packed.");
+			return;
+		}
+
+		std::vector<ImagePtr> order;
+		std::vector<PackedImage>::iterator it = m_images.begin();
+		for (; it != m_images.end(); ++it) {
+			order.push_back(it->image);
+		}
+		std::stable_sort(order.begin(), order.end(), LargerImage());
+
+		// place the images
+		AtlasBook book(m_pageWidth, m_pageHeight);
+		std::map<ResourceHandle, AtlasBlock> placement;
+		std::vector<ImagePtr>::iterator oit = order.begin();
+		for (; oit != order.end(); ++oit) {
+			AtlasBlock* block = book.getBlock((*oit)->getWidth(), (*oit)->getHeight());
+			placement[(*oit)->getHandle()] = *block;
+		}
+		book.shrink(pot);
+		m_occupancy = book.getOccupancy();
+
+		// create the pages
+		ImageManager* manager = ImageManager::instance();
+		for (uint32_t i = 0; i < book.getPageCount(); ++i) {
+			std::ostringstream pageName;
+			pageName << m_name << "_" << i << ".png";
+			AtlasPage& page = book.getPage(i);
+			m_pages.push_back(manager->loadBlank(pageName.str(), page.getWidth(), page.getHeight()));
+		}
+
+		// copy the pixel data into the pages, afterwards the images only share the page data
+		for (it = m_images.begin(); it != m_images.end(); ++it) {
+			const AtlasBlock& block = placement[it->image->getHandle()];
+			it->page = block.page;
+			it->region = Rect(block.left, block.top, block.getWidth(), block.getHeight());
+
+			ImagePtr& page = m_pages[it->page];
+			page->copySubimage(it->region.x, it->region.y, it->image);
+
+			// the offsets are not part of the pixel data
+			int32_t xshift = it->image->getXShift();
+			int32_t yshift = it->image->getYShift();
+			it->image->free();
+			it->image->useSharedImage(page, it->region);
+			it->image->setXShift(xshift);
+			it->image->setYShift(yshift);
+		}
+
+		FL_LOG(_log, LMsg("AtlasPacker::pack() - ") << "Packed " << m_images.size() << " images into "
+			<< m_pages.size() << " pages, occupancy " << static_cast<int32_t>(m_occupancy * 100.0f) << "%.");
+	}
+
+	const std::string& AtlasPacker::getName() const {
+		return m_name;
+	}
+
+	uint32_t AtlasPacker::getPageCount() const {
+		return m_pages.size();
+	}
+
+	ImagePtr AtlasPacker::getPage(uint32_t index) const {
+		if (index >= m_pages.size()) {
+			throw IndexOverflow("AtlasPacker::getPage() - page index out of range");
+		}
+		return m_pages[index];
+	}
+
+	uint32_t AtlasPacker::getImageCount() const {
+		return m_images.size();
+	}
+
+	ImagePtr AtlasPacker::getImage(uint32_t index) const {
+		if (index >= m_images.size()) {
+			throw IndexOverflow("AtlasPacker::getImage() - image index out of range");
+		}
+		return m_images[index].image;
+	}
+
+	uint32_t AtlasPacker::getImagePage(uint32_t index) const {
+		if (index >= m_images.size()) {
+			throw IndexOverflow("AtlasPacker::getImagePage() - image index out of range");
+		}
+		return m_images[index].page;
+	}
+
+	const Rect& AtlasPacker::getImageRegion(uint32_t index) const {
+		if (index >= m_images.size()) {
+			throw IndexOverflow("AtlasPacker::getImageRegion() - image index out of range");
+		}
+		return m_images[index].region;
+	}
+
+	float AtlasPacker::getOccupancy() const {
+		return m_occupancy;
+	}
+
+	uint32_t AtlasPacker::getSourceTextureCount() const {
+		return m_sourceTextures;
+	}
+}
@@ -0,0 +1,145 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_VIDEO_ATLASPACKER_H
+#define FIFE_VIDEO_ATLASPACKER_H
+
+// Standard C++ library includes
+#include <string>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/fife_stdint.h"
+#include "util/structures/rect.h"
+
+#include "animation.h"
+#include "image.h"
+
+namespace FIFE {
+
+	/** Packs loose images into atlas pages.
+	 *
+	 * Images are collected with addImage() / addAnimation() and placed with
+	 * the MaxRects heuristic of the AtlasBook when pack() is called.  Every
+	 * page becomes an Image in the ImageManager and the packed images are
+	 * turned into shared images of their page, so all images of one page
+	 * are rendered with the same texture.
+	 *
+	 * @see AtlasBook
+	 * @see AtlasSaver
+	 */
+	class AtlasPacker {
+	public:
+		/** Constructor.
+		 * @param name The base name of the atlas pages. Page n is named "<name>_<n>.png".
+		 * @param pageWidth The maximal width of a page.
+		 * @param pageHeight The maximal height of a page.
+		 */
+		AtlasPacker(const std::string& name, uint32_t pageWidth = 1024, uint32_t pageHeight = 1024);
+
+		/** Destructor.
+		 */
+		~AtlasPacker();
+
+		/** Adds an image that should be packed.
+		 * Shared images, images that were already added and images that
+		 * don't fit into a page are ignored.
+		 * @return True if the image is packed by the next pack() call.
+		 */
+		bool addImage(const ImagePtr& image);
+
+		/** Adds all frames of the animation.
+		 * @return The number of frames that are packed by the next pack() call.
+		 */
+		uint32_t addAnimation(const AnimationPtr& animation);
+
+		/** Packs all added images into pages and makes them use the pages.
+		 * @param pot If true the pages are shrinked to power of two sizes, otherwise as tight as possible.
+		 */
+		void pack(bool pot = true);
+
+		/** Returns the base name of the pages.
+		 */
+		const std::string& getName() const;
+
+		/** Returns the number of pages, only valid after pack().
+		 */
+		uint32_t getPageCount() const;
+
+		/** Returns the page image with the given index.
+		 */
+		ImagePtr getPage(uint32_t index) const;
+
+		/** Returns the number of packed images.
+		 */
+		uint32_t getImageCount() const;
+
+		/** Returns the packed image with the given index.
+		 */
+		ImagePtr getImage(uint32_t index) const;
+
+		/** Returns the page index of the packed image with the given index.
+		 */
+		uint32_t getImagePage(uint32_t index) const;
+
+		/** Returns the area of the packed image with the given index on its page.
+		 */
+		const Rect& getImageRegion(uint32_t index) const;
+
+		/** Returns the packing efficiency (0.0 - 1.0), the ratio of image pixels to page pixels.
+		 */
+		float getOccupancy() const;
+
+		/** Returns the number of textures the added images used before packing.
+		 * This is the number of texture binds that are needed in the worst case
+		 * to render all images, after packing it is the page count.
+		 */
+		uint32_t getSourceTextureCount() const;
+
+	private:
+		struct PackedImage {
+			ImagePtr image;
+			uint32_t page;
+			Rect region;
+		};
+
+		// base name of the pages
+		std::string m_name;
+		// maximal page size
+		uint32_t m_pageWidth;
+		uint32_t m_pageHeight;
+		// all images, ordered by addition
+		std::vector<PackedImage> m_images;
+		// the page images
+		std::vector<ImagePtr> m_pages;
+		// packing efficiency of the last pack() call
+		float m_occupancy;
+		// number of packed images that had an own texture
+		uint32_t m_sourceTextures;
+	};
+}
+
+#endif
@@ -59,6 +59,9 @@ namespace FIFE {
 		virtual void setColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255);
 		virtual int32_t getWidth(const std::string& text) const;
 		virtual int32_t getHeight() const;
+		void setGlyphAtlas(bool enabled);
+		bool isGlyphAtlas() const;
+		uint32_t getGlyphCount() const;
 	};
 
 	%feature("notabstract") SubImageFont;
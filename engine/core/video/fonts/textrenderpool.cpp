@@ -21,6 +21,7 @@
 
 // Standard C++ library includes
 #include <algorithm>
+#include <functional>
 
 // Platform specific includes
 
@@ -38,6 +39,25 @@
 
 namespace FIFE {
 
+	bool TextRenderPool::s_pool_key::operator==(const s_pool_key& rhs) const {
+		return antialias == rhs.antialias && glyph_spacing == rhs.glyph_spacing &&
+			row_spacing == rhs.row_spacing && style == rhs.style &&
+			color.r == rhs.color.r && color.g == rhs.color.g &&
+			color.b == rhs.color.b && color.a == rhs.color.a &&
+			text == rhs.text;
+	}
+
+	size_t TextRenderPool::s_pool_key_hash::operator()(const s_pool_key& key) const {
+		size_t seed = std::hash<std::string>()(key.text);
+		uint32_t state = (static_cast<uint32_t>(key.color.r) << 24) | (static_cast<uint32_t>(key.color.g) << 16) |
+			(static_cast<uint32_t>(key.color.b) << 8) | key.color.a;
+		seed ^= std::hash<uint32_t>()(state) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		state = (static_cast<uint32_t>(key.glyph_spacing & 0xFFF) << 20) | (static_cast<uint32_t>(key.row_spacing & 0xFFF) << 8) |
+			(static_cast<uint32_t>(key.style) << 1) | (key.antialias ? 1 : 0);
+		seed ^= std::hash<uint32_t>()(state) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+		return seed;
+	}
+
 	TextRenderPool::TextRenderPool(size_t poolSize) {
 		m_poolMaxSize = poolSize;
 		m_poolSize = 0;
@@ -53,47 +73,48 @@ namespace FIFE {
 		}
 	}
 
-	Image* TextRenderPool::getRenderedText( FontBase* fontbase, const std::string& text) {
-		SDL_Color c = fontbase->getColor();
-
-		type_pool::iterator it= m_pool.begin();
-		for(;it != m_pool.end(); ++it) {
-			if( it->antialias != fontbase->isAntiAlias() )
-				continue;
-
-			if( it->glyph_spacing != fontbase->getGlyphSpacing() )
-				continue;
-
-			if( it->row_spacing != fontbase->getRowSpacing() )
-				continue;
+	void TextRenderPool::createKey(FontBase* fontbase, const std::string& text, s_pool_key& key) {
+		key.text = text;
+		key.color = fontbase->getColor();
+		key.antialias = fontbase->isAntiAlias();
+		key.glyph_spacing = fontbase->getGlyphSpacing();
+		key.row_spacing = fontbase->getRowSpacing();
+		key.style = (fontbase->isBoldStyle() ? 1 : 0) | (fontbase->isItalicStyle() ? 2 : 0) |
+			(fontbase->isUnderlineStyle() ? 4 : 0) | (fontbase->isStrikethroughStyle() ? 8 : 0);
+	}
 
-			if( it->color.r != c.r || it->color.g != c.g || it->color.b != c.b  )
-				continue;
+	Image* TextRenderPool::getRenderedText( FontBase* fontbase, const std::string& text) {
+		s_pool_key key;
+		createKey(fontbase, text, key);
 
-			if( it->text != text )
-				continue;
+		type_index::iterator found = m_index.find(key);
+		if (found == m_index.end()) {
+			return 0;
+		}
 
-			// Stay sorted after access time
-			it->timestamp = TimeManager::instance()->getTime();
-			m_pool.push_front( *it );
-			m_pool.erase( it );
+		// Stay sorted after access time
+		type_pool::iterator it = found->second;
+		it->timestamp = TimeManager::instance()->getTime();
+		m_pool.splice(m_pool.begin(), m_pool, it);
 
-			return m_pool.front().image;
-		}
-		return 0;
+		return it->image;
 	}
 
 	void TextRenderPool::addRenderedText( FontBase* fontbase,const std::string& text, Image* image) {
 		// Construct a entry and add it.
 		s_pool_entry centry;
-		centry.antialias = fontbase->isAntiAlias();
-		centry.glyph_spacing = fontbase->getGlyphSpacing();
-		centry.row_spacing = fontbase->getRowSpacing();
-		centry.text = text;
-		centry.color = fontbase->getColor();
+		createKey(fontbase, text, centry.key);
 		centry.image = image;
 		centry.timestamp = TimeManager::instance()->getTime();
+
+		// Replace an older image of the same text
+		type_index::iterator found = m_index.find(centry.key);
+		if (found != m_index.end()) {
+			removeEntry(found->second);
+		}
+
 		m_pool.push_front( centry );
+		m_index[centry.key] = m_pool.begin();
 
 		// Some minimal amount of entries -> start collection timer
 		// Don't have a timer active if only _some_ text is pooled.
@@ -101,27 +122,30 @@ namespace FIFE {
 			m_collectTimer.start();
 
 		// Maintain max pool size
-		if( m_poolSize < m_poolMaxSize ) {
-			m_poolSize++;
-			return;
-		} else {
-			delete m_pool.back().image;
-			m_pool.pop_back();
+		m_poolSize++;
+		if( m_poolSize > m_poolMaxSize ) {
+			type_pool::iterator last = m_pool.end();
+			removeEntry(--last);
 		}
 	}
 
-	void TextRenderPool::removeOldEntries() {
+	void TextRenderPool::removeEntry(type_pool::iterator entry) {
+		m_index.erase(entry->key);
+		delete entry->image;
+		m_pool.erase(entry);
+		--m_poolSize;
+	}
 
-		type_pool::iterator it = m_pool.begin();
+	void TextRenderPool::removeOldEntries() {
 		uint32_t now = TimeManager::instance()->getTime();
-		while (it != m_pool.end()) {
+		// The list is sorted after access time, so old entries are at the back
+		while (!m_pool.empty()) {
+			type_pool::iterator it = m_pool.end();
+			--it;
 			if( (now - it->timestamp) > 1000*60 ) {
-				delete it->image;
-				it = m_pool.erase(it);
-				--m_poolSize;
-			}
-			else {
-				++it;
+				removeEntry(it);
+			} else {
+				break;
 			}
 		}
 
@@ -25,8 +25,10 @@
 // Standard C++ library includes
 #include <list>
 #include <string>
+#include <unordered_map>
 
 // Platform specific includes
+#include "util/base/fife_stdint.h"
 
 // 3rd party library includes
 #include <SDL.h>
@@ -48,7 +50,9 @@ namespace FIFE {
 	 *  Automatically removes pooled strings not used for a minute.
 	 *  Doesn't use resources (apart from a minimum) if not used after a while.
 	 *
-	 *  @todo Should probably use a @c std::map instead of a @c std::list
+	 *  The entries are kept in a list sorted by access time, the least recently
+	 *  used entry is at the back. A hash map indexes the entries by text and
+	 *  font state, so a lookup doesn't depend on the number of pooled strings.
 	 */
 	class TextRenderPool {
 		public:
@@ -79,19 +83,43 @@ namespace FIFE {
 			void removeOldEntries();
 
 		protected:
-			typedef struct {
+			/** Everything that changes the look of a rendered string.
+			 */
+			struct s_pool_key {
 				std::string text;
 				SDL_Color color;
 				bool antialias;
 				int glyph_spacing;
 				int row_spacing;
+				// bold, italic, underline and strikethrough bits
+				uint8_t style;
+
+				bool operator==(const s_pool_key& rhs) const;
+			};
+
+			struct s_pool_key_hash {
+				size_t operator()(const s_pool_key& key) const;
+			};
+
+			typedef struct {
+				s_pool_key key;
 				uint32_t timestamp;
 
 				Image* image;
 			} s_pool_entry;
 
+			/** Fills the key with the current state of the font.
+			 */
+			static void createKey(FontBase* fontbase, const std::string& text, s_pool_key& key);
+
+			/** Removes the entry from the list and the index and deletes the image.
+			 */
+			void removeEntry(std::list<s_pool_entry>::iterator entry);
+
 			typedef std::list<s_pool_entry> type_pool;
+			typedef std::unordered_map<s_pool_key, type_pool::iterator, s_pool_key_hash> type_index;
 			type_pool m_pool;
+			type_index m_index;
 			size_t m_poolSize;
 			size_t m_poolMaxSize;
 
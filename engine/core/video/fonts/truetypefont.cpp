@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 #include <cassert>
 
 // 3rd party library includes
@@ -37,10 +38,24 @@
 
 #include "truetypefont.h"
 
+// SDL_ttf defines it since 2.0.15
+#ifndef SDL_TTF_VERSION_ATLEAST
+#define SDL_TTF_VERSION_ATLEAST(X, Y, Z) \
+	((SDL_TTF_MAJOR_VERSION >= X) && \
+	 (SDL_TTF_MAJOR_VERSION > X || SDL_TTF_MINOR_VERSION >= Y) && \
+	 (SDL_TTF_MAJOR_VERSION > X || SDL_TTF_MINOR_VERSION > Y || SDL_TTF_PATCHLEVEL >= Z))
+#endif
+
 namespace FIFE {
+	// width and height of the glyph atlas
+	static const uint32_t GLYPH_ATLAS_SIZE = 512;
 
 	TrueTypeFont::TrueTypeFont(const std::string& filename, int32_t size)
-		: FIFE::FontBase() {
+		: FIFE::FontBase(),
+		m_glyphPage(GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE, 1, 0),
+		m_glyphCoverage(GLYPH_ATLAS_SIZE * GLYPH_ATLAS_SIZE, 0),
+		m_glyphGeneration(0),
+		m_glyphAtlas(true) {
 		mFilename = filename;
 		mFont = NULL;
 		mFontStyle = TTF_STYLE_NORMAL;
@@ -86,6 +101,8 @@ namespace FIFE {
 			}
 			m_boldStyle = style;
 			TTF_SetFontStyle(mFont, mFontStyle);
+			// the glyphs look different now
+			clearGlyphAtlas();
 		}
 	}
 
@@ -98,6 +115,8 @@ namespace FIFE {
 			}
 			m_italicStyle = style;
 			TTF_SetFontStyle(mFont, mFontStyle);
+			// the glyphs look different now
+			clearGlyphAtlas();
 		}
 	}
 
@@ -133,6 +152,14 @@ namespace FIFE {
 			return surface;
 		}
 
+		// SDL_ttf draws the underline along the whole string, so it can't be composed from glyphs
+		if (m_glyphAtlas && m_antiAlias && !(mFontStyle & TTF_STYLE_UNDERLINE)) {
+			SDL_Surface* glyphText = renderGlyphString(text);
+			if (glyphText) {
+				return glyphText;
+			}
+		}
+
 		SDL_Surface* renderedText = 0;
 		if (m_antiAlias) {
 			renderedText = TTF_RenderUTF8_Blended(mFont, text.c_str(), mColor);
@@ -157,4 +184,191 @@ namespace FIFE {
 		mColor.b = b;
 		mColor.a = a;
 	}
+
+	void TrueTypeFont::setGlyphAtlas(bool enabled) {
+		m_glyphAtlas = enabled;
+		if (!m_glyphAtlas) {
+			clearGlyphAtlas();
+		}
+	}
+
+	bool TrueTypeFont::isGlyphAtlas() const {
+		return m_glyphAtlas;
+	}
+
+	uint32_t TrueTypeFont::getGlyphCount() const {
+		return m_glyphs.size();
+	}
+
+	void TrueTypeFont::clearGlyphAtlas() {
+		m_glyphs.clear();
+		m_glyphPage = AtlasPage(GLYPH_ATLAS_SIZE, GLYPH_ATLAS_SIZE, 1, 0);
+		++m_glyphGeneration;
+	}
+
+	bool TrueTypeFont::getGlyph(uint32_t codepoint, s_glyph& glyph) {
+		type_glyphs::const_iterator found = m_glyphs.find(codepoint);
+		if (found != m_glyphs.end()) {
+			glyph = found->second;
+			return true;
+		}
+
+		// SDL_ttf renders only single glyphs of the basic multilingual plane
+		if (codepoint > 0xFFFF) {
+			return false;
+		}
+
+		Uint16 ch = static_cast<Uint16>(codepoint);
+		int32_t minx, advance;
+		if (TTF_GlyphMetrics(mFont, ch, &minx, NULL, NULL, NULL, &advance) != 0) {
+			return false;
+		}
+
+		// the color is applied when the string is composed
+		SDL_Color white = { 255, 255, 255, 255 };
+		SDL_Surface* rendered = TTF_RenderGlyph_Blended(mFont, ch, white);
+		if (!rendered) {
+			return false;
+		}
+		if (rendered->format->BytesPerPixel != 4) {
+			SDL_FreeSurface(rendered);
+			return false;
+		}
+
+		glyph.x = 0;
+		glyph.y = 0;
+		glyph.w = rendered->w;
+		glyph.h = rendered->h;
+		// SDL_ttf moves the pen to the right if the glyph starts left of it
+		glyph.offset = minx < 0 ? -minx : 0;
+		glyph.advance = advance;
+
+		if (glyph.w > 0 && glyph.h > 0) {
+			AtlasBlock* block = m_glyphPage.getBlock(glyph.w, glyph.h);
+			if (!block) {
+				clearGlyphAtlas();
+				block = m_glyphPage.getBlock(glyph.w, glyph.h);
+			}
+			if (!block) {
+				SDL_FreeSurface(rendered);
+				return false;
+			}
+			glyph.x = block->left;
+			glyph.y = block->top;
+
+			// only the coverage is stored
+			if (SDL_MUSTLOCK(rendered)) {
+				SDL_LockSurface(rendered);
+			}
+			const SDL_PixelFormat* format = rendered->format;
+			for (uint32_t y = 0; y < glyph.h; ++y) {
+				const Uint32* src = reinterpret_cast<const Uint32*>(static_cast<const uint8_t*>(rendered->pixels) + y * rendered->pitch);
+				uint8_t* dst = &m_glyphCoverage[(glyph.y + y) * GLYPH_ATLAS_SIZE + glyph.x];
+				for (uint32_t x = 0; x < glyph.w; ++x) {
+					dst[x] = static_cast<uint8_t>((src[x] & format->Amask) >> format->Ashift);
+				}
+			}
+			if (SDL_MUSTLOCK(rendered)) {
+				SDL_UnlockSurface(rendered);
+			}
+		}
+		SDL_FreeSurface(rendered);
+
+		m_glyphs[codepoint] = glyph;
+		return true;
+	}
+
+	SDL_Surface* TrueTypeFont::renderGlyphString(const std::string& text) {
+		std::vector<s_glyph> glyphs;
+		std::vector<int32_t> positions;
+		int32_t left = 0;
+		int32_t right = 0;
+		bool kerning = TTF_GetFontKerning(mFont) != 0;
+#if !SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+		// kerning between two glyphs needs SDL_ttf 2.0.14, SDL_ttf renders the whole string then
+		if (kerning) {
+			return 0;
+		}
+#endif
+
+		// if the atlas runs full while the glyphs are collected, it is cleared
+		// and the glyphs that were already collected are gone, so try it again
+		bool complete = false;
+		for (int32_t attempt = 0; attempt < 2 && !complete; ++attempt) {
+			uint32_t generation = m_glyphGeneration;
+			glyphs.clear();
+			positions.clear();
+			left = 0;
+			right = 0;
+
+			int32_t pen = 0;
+			uint32_t previous = 0;
+			std::string::const_iterator it = text.begin();
+			while (it != text.end()) {
+				uint32_t codepoint = utf8::next(it, text.end());
+				s_glyph glyph;
+				if (!getGlyph(codepoint, glyph)) {
+					return 0;
+				}
+				if (kerning && previous != 0) {
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+					pen += TTF_GetFontKerningSizeGlyphs(mFont, static_cast<Uint16>(previous), static_cast<Uint16>(codepoint));
+#endif
+				}
+				int32_t x = pen - glyph.offset;
+				left = std::min(left, x);
+				right = std::max(right, x + static_cast<int32_t>(glyph.w));
+				glyphs.push_back(glyph);
+				positions.push_back(x);
+
+				pen += glyph.advance;
+				previous = codepoint;
+			}
+			right = std::max(right, pen);
+			complete = generation == m_glyphGeneration;
+		}
+		if (!complete || right <= left) {
+			return 0;
+		}
+
+		// merge the coverage of all glyphs
+		int32_t width = right - left;
+		int32_t height = TTF_FontHeight(mFont);
+		std::vector<uint8_t> coverage(width * height, 0);
+		for (size_t i = 0; i < glyphs.size(); ++i) {
+			const s_glyph& glyph = glyphs[i];
+			int32_t xpos = positions[i] - left;
+			int32_t rows = std::min(static_cast<int32_t>(glyph.h), height);
+			for (int32_t y = 0; y < rows; ++y) {
+				const uint8_t* src = &m_glyphCoverage[(glyph.y + y) * GLYPH_ATLAS_SIZE + glyph.x];
+				uint8_t* dst = &coverage[y * width + xpos];
+				for (uint32_t x = 0; x < glyph.w; ++x) {
+					dst[x] = std::max(dst[x], src[x]);
+				}
+			}
+		}
+
+		SDL_Surface* surface = SDL_CreateRGBSurface(0, width, height, 32,
+			RMASK, GMASK, BMASK, AMASK);
+		if (!surface) {
+			throw SDLException(std::string("CreateRGBSurface failed: ") + SDL_GetError());
+		}
+		if (SDL_MUSTLOCK(surface)) {
+			SDL_LockSurface(surface);
+		}
+		const Uint32 color = SDL_MapRGBA(surface->format, mColor.r, mColor.g, mColor.b, 0);
+		const Uint8 ashift = surface->format->Ashift;
+		for (int32_t y = 0; y < height; ++y) {
+			Uint32* dst = reinterpret_cast<Uint32*>(static_cast<uint8_t*>(surface->pixels) + y * surface->pitch);
+			const uint8_t* src = &coverage[y * width];
+			for (int32_t x = 0; x < width; ++x) {
+				Uint32 alpha = (static_cast<Uint32>(src[x]) * mColor.a) / 255;
+				dst[x] = color | (alpha << ashift);
+			}
+		}
+		if (SDL_MUSTLOCK(surface)) {
+			SDL_UnlockSurface(surface);
+		}
+		return surface;
+	}
 }
@@ -25,6 +25,8 @@
 // Standard C++ library includes
 #include <map>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 // 3rd party library includes
 #include <SDL_ttf.h>
@@ -33,6 +35,8 @@
 // These includes are split up in two parts, separated by one empty line
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
+#include "video/atlasbook.h"
+
 #include "fontbase.h"
 
 namespace FIFE {
@@ -47,6 +51,11 @@ namespace FIFE {
 	 *
 	 * Original author of this class is Walluce Pinkham. Some modifications
 	 * made by the Guichan team, and additonal modifications by the FIFE team.
+	 *
+	 * Antialiased strings are composed from a glyph atlas. Every glyph is
+	 * rendered only once by SDL_ttf, its coverage is stored in the atlas and
+	 * strings are built by copying the glyphs, so a new string doesn't have
+	 * to be rasterized by FreeType again.
 	 */
 	class TrueTypeFont: public FontBase {
 		public:
@@ -80,10 +89,66 @@ namespace FIFE {
 
 			virtual void setColor(uint8_t r,uint8_t g,uint8_t b, uint8_t a = 255);
 
+			/**
+			 * Enables or disables the glyph atlas. If disabled every string
+			 * is rendered by SDL_ttf. Underlined text is always rendered by
+			 * SDL_ttf. Enabled by default.
+			 */
+			void setGlyphAtlas(bool enabled);
+
+			/**
+			 * Returns true if strings are composed from the glyph atlas.
+			 */
+			bool isGlyphAtlas() const;
+
+			/**
+			 * Returns the number of glyphs in the glyph atlas.
+			 */
+			uint32_t getGlyphCount() const;
+
 		protected:
+			/** Position of a glyph in the atlas.
+			 */
+			struct s_glyph {
+				uint32_t x;
+				uint32_t y;
+				uint32_t w;
+				uint32_t h;
+				// distance from the left border to the pen position
+				int32_t offset;
+				int32_t advance;
+			};
+
+			/**
+			 * Composes the string from the glyph atlas.
+			 * @return The rendered string or 0 if the string can't be composed from glyphs.
+			 */
+			SDL_Surface* renderGlyphString(const std::string& text);
+
+			/**
+			 * Looks up the glyph, renders it into the atlas if it's not cached.
+			 * @return False if the glyph can't be put into the atlas.
+			 */
+			bool getGlyph(uint32_t codepoint, s_glyph& glyph);
+
+			/**
+			 * Removes all glyphs from the atlas.
+			 */
+			void clearGlyphAtlas();
+
 			TTF_Font* mFont;
 
 			int32_t mFontStyle;
+
+			typedef std::unordered_map<uint32_t, s_glyph> type_glyphs;
+			type_glyphs m_glyphs;
+			// places the glyphs in the atlas
+			AtlasPage m_glyphPage;
+			// coverage of the glyphs, one byte per pixel
+			std::vector<uint8_t> m_glyphCoverage;
+			// incremented every time the atlas is cleared
+			uint32_t m_glyphGeneration;
+			bool m_glyphAtlas;
 	};
 }
 
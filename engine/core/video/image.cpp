@@ -228,7 +228,7 @@ namespace FIFE {
 		saveAsPng(filename, *m_surface);
 	}
 
-	void Image::saveAsPng(const std::string& filename, const SDL_Surface& surface) {
+	bool Image::saveAsPng(const std::string& filename, const SDL_Surface& surface) {
 		FILE *fp;
 		png_structp pngptr;
 		png_infop infoptr;
@@ -238,7 +238,7 @@ namespace FIFE {
 		fp = fopen(filename.c_str(), "wb");
 
 		if (fp == NULL) {
-			return;
+			return false;
 		}
 
 		//create the png file
@@ -246,7 +246,7 @@ namespace FIFE {
 		NULL, NULL, NULL);
 		if (pngptr == NULL) {
 			fclose(fp);
-			return;
+			return false;
 		}
 
 		//create information struct
@@ -254,13 +254,13 @@ namespace FIFE {
 		if (infoptr == NULL) {
 			fclose(fp);
 			png_destroy_write_struct(&pngptr, (png_infopp)NULL);
-			return;
+			return false;
 		}
 
 		if (setjmp(png_jmpbuf(pngptr))) {
 			png_destroy_write_struct(&pngptr, &infoptr);
 			fclose(fp);
-			return;
+			return false;
 		}
 
 		//initialize io
@@ -296,6 +296,7 @@ namespace FIFE {
 		delete [] rowpointers;
 		png_destroy_write_struct(&pngptr, &infoptr);
 		fclose(fp);
+		return true;
 	}
 
 	std::string Image::createUniqueImageName() {
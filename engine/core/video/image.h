@@ -108,8 +108,9 @@ namespace FIFE {
 		void saveImage(const std::string& filename);
 
 		/** Saves the SDL_Surface to png format
+		 * @return False if the file could not be written.
 		 */
-		static void saveAsPng(const std::string& filename, const SDL_Surface& surface);
+		static bool saveAsPng(const std::string& filename, const SDL_Surface& surface);
 		static bool putPixel(SDL_Surface* surface, int32_t x, int32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a = 255);
 
 		uint32_t getWidth() const;
@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 #include <map>
 
 // 3rd party library includes
@@ -43,6 +44,12 @@ namespace FIFE {
 	 */
 	static Logger _log(LM_RESMGR);
 
+	/** Orders resources from the least to the most recently used one.
+	 */
+	static bool lessRecentlyUsed(IResource* lhs, IResource* rhs) {
+		return lhs->getLastUsed() < rhs->getLastUsed();
+	}
+
 	ImageManager::~ImageManager() {
 
 	}
@@ -162,6 +169,10 @@ namespace FIFE {
 		returnValue = m_imgHandleMap.insert ( ImageHandleMapPair(res->getHandle(), resptr));
 
 		if (returnValue.second) {
+			// resources added in a loaded state have no source to be reloaded from
+			if (res->getState() == IResource::RES_LOADED) {
+				m_pinned.insert(res->getHandle());
+			}
 			m_imgNameMap.insert ( ImageNameMapPair(returnValue.first->second->getName(), returnValue.first->second) );
 		}
 		else {
@@ -305,6 +316,7 @@ namespace FIFE {
 		ImageNameMapIterator nit = m_imgNameMap.find(resource->getName());
 
 		if (it != m_imgHandleMap.end()) {
+			m_pinned.erase(it->first);
 			m_imgHandleMap.erase(it);
 
 			if (nit != m_imgNameMap.end()) {
@@ -323,6 +335,7 @@ namespace FIFE {
 		ImageNameMapIterator nit = m_imgNameMap.find(name);
 		if (nit != m_imgNameMap.end()) {
 			handle = nit->second->getHandle();
+			m_pinned.erase(handle);
 			m_imgNameMap.erase(nit);
 		}
 		else {
@@ -346,6 +359,7 @@ namespace FIFE {
 
 		if (it != m_imgHandleMap.end()) {
 			name = it->second->getName();
+			m_pinned.erase(handle);
 			m_imgHandleMap.erase(it);
 		}
 		else {
@@ -370,6 +384,7 @@ namespace FIFE {
 
 		m_imgHandleMap.clear();
 		m_imgNameMap.clear();
+		m_pinned.clear();
 
 		FL_DBG(_log, LMsg("ImageManager::removeAll() - ") << "Removed all " << count << " resources.");
 	}
@@ -490,4 +505,77 @@ namespace FIFE {
 
 	}
 
+	void ImageManager::setMemoryBudget(size_t budget) {
+		m_memoryBudget = budget;
+	}
+
+	size_t ImageManager::getMemoryBudget() const {
+		return m_memoryBudget;
+	}
+
+	void ImageManager::enforceMemoryBudget() {
+		m_lastEvictionCount = 0;
+		if (m_memoryBudget == 0) {
+			return;
+		}
+
+		size_t used = getMemoryUsed();
+		if (used <= m_memoryBudget) {
+			return;
+		}
+
+		// collect all loaded resources which are only referenced by the manager
+		std::vector<Image*> candidates;
+		ImageHandleMapIterator it = m_imgHandleMap.begin(),
+			itend = m_imgHandleMap.end();
+
+		for ( ; it != itend; ++it) {
+			if (it->second.useCount() != 2 || it->second->getState() != IResource::RES_LOADED) {
+				continue;
+			}
+			// shared images only reference an atlas, their data is owned by the atlas image
+			if (it->second->isSharedImage()) {
+				continue;
+			}
+			if (m_pinned.find(it->first) != m_pinned.end()) {
+				continue;
+			}
+			candidates.push_back(it->second.get());
+		}
+		std::sort(candidates.begin(), candidates.end(), lessRecentlyUsed);
+
+		std::vector<Image*>::iterator cit = candidates.begin();
+		for ( ; cit != candidates.end() && used > m_memoryBudget; ++cit) {
+			size_t size = (*cit)->getSize();
+			(*cit)->free();
+			used -= std::min(used, size);
+			m_evictedBytes += size;
+			++m_lastEvictionCount;
+		}
+		m_evictionCount += m_lastEvictionCount;
+
+		if (used > m_memoryBudget) {
+			FL_DBG(_log, LMsg("ImageManager::enforceMemoryBudget() - ") << "Budget of " << m_memoryBudget << " bytes exceeded by referenced resources, " << used << " bytes in use.");
+		}
+		FL_DBG(_log, LMsg("ImageManager::enforceMemoryBudget() - ") << "Evicted " << m_lastEvictionCount << " resources.");
+	}
+
+	size_t ImageManager::getEvictionCount() const {
+		return m_evictionCount;
+	}
+
+	size_t ImageManager::getEvictedBytes() const {
+		return m_evictedBytes;
+	}
+
+	size_t ImageManager::getLastEvictionCount() const {
+		return m_lastEvictionCount;
+	}
+
+	void ImageManager::resetEvictionStatistics() {
+		m_evictionCount = 0;
+		m_evictedBytes = 0;
+		m_lastEvictionCount = 0;
+	}
+
 } //FIFE
@@ -24,6 +24,7 @@
 
 // Standard C++ library includes
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -56,7 +57,12 @@ namespace FIFE {
 
 		/** Default constructor.
 		 */
-		ImageManager() : IResourceManager() { }
+		ImageManager() :
+			IResourceManager(),
+			m_memoryBudget(0),
+			m_evictionCount(0),
+			m_evictedBytes(0),
+			m_lastEvictionCount(0) { }
 
 		/** Destructor.
 		 */
@@ -376,6 +382,49 @@ namespace FIFE {
 		virtual void invalidate(ResourceHandle handle);
 		virtual void invalidateAll();
 
+		/** Sets the memory budget of the manager
+		 *
+		 * If the memory used by loaded Images exceeds the budget the
+		 * least recently used Images are freed by enforceMemoryBudget().
+		 * Only Images without external references are freed and they are
+		 * reloaded on the next access.  Images that were added to the
+		 * manager in a loaded state (e.g. blank images) are never freed
+		 * because they can not be reloaded.
+		 *
+		 * @param budget The budget in bytes, 0 disables the budget (default).
+		 *
+		 */
+		void setMemoryBudget(size_t budget);
+
+		/** Returns the memory budget in bytes, 0 if disabled.
+		 */
+		size_t getMemoryBudget() const;
+
+		/** Frees least recently used Images until the memory budget is met
+		 *
+		 * This is called once per frame by the Engine.
+		 *
+		 * @see setMemoryBudget()
+		 *
+		 */
+		void enforceMemoryBudget();
+
+		/** Returns the number of Images freed by the budget since the last reset.
+		 */
+		size_t getEvictionCount() const;
+
+		/** Returns the number of bytes freed by the budget since the last reset.
+		 */
+		size_t getEvictedBytes() const;
+
+		/** Returns the number of Images freed by the last enforceMemoryBudget() call.
+		 */
+		size_t getLastEvictionCount() const;
+
+		/** Resets the eviction statistics.
+		 */
+		void resetEvictionStatistics();
+
 	private:
 		typedef std::map< ResourceHandle, ImagePtr > ImageHandleMap;
 		typedef std::map< ResourceHandle, ImagePtr >::iterator ImageHandleMapIterator;
@@ -390,6 +439,15 @@ namespace FIFE {
 		ImageHandleMap m_imgHandleMap;
 
 		ImageNameMap m_imgNameMap;
+
+		// handles of resources which can not be reloaded and are never evicted
+		std::set<ResourceHandle> m_pinned;
+		// memory budget in bytes, 0 if disabled
+		size_t m_memoryBudget;
+		// eviction statistics
+		size_t m_evictionCount;
+		size_t m_evictedBytes;
+		size_t m_lastEvictionCount;
 	};
 
 } //FIFE
@@ -37,9 +37,33 @@
 #include "glimage.h"
 
 namespace FIFE {
+	/** Returns true if the region has texels that are neither transparent nor opaque.
+	 */
+	static bool hasPartialAlpha(const SDL_Surface* surface, const Rect& region) {
+		const SDL_PixelFormat* format = surface->format;
+		if (format->Amask == 0) {
+			return false;
+		}
+		if (format->BytesPerPixel != 4) {
+			return true;
+		}
+		const Uint32 opaque = format->Amask;
+		for (int32_t y = region.y; y < region.y + region.h; ++y) {
+			const Uint32* row = reinterpret_cast<const Uint32*>(static_cast<const uint8_t*>(surface->pixels) + y * surface->pitch);
+			for (int32_t x = region.x; x < region.x + region.w; ++x) {
+				const Uint32 alpha = row[x] & format->Amask;
+				if (alpha != 0 && alpha != opaque) {
+					return true;
+				}
+			}
+		}
+		return false;
+	}
+
 	GLImage::GLImage(IResourceLoader* loader):
 		Image(loader),
 		m_compressed(false),
+		m_partialAlpha(true),
 		m_texId(0) {
 
 		resetGlimage();
@@ -48,6 +72,7 @@ namespace FIFE {
 	GLImage::GLImage(const std::string& name, IResourceLoader* loader):
 		Image(name, loader),
 		m_compressed(false),
+		m_partialAlpha(true),
 		m_texId(0) {
 
 		resetGlimage();
@@ -56,6 +81,7 @@ namespace FIFE {
 	GLImage::GLImage(SDL_Surface* surface):
 		Image(surface),
 		m_compressed(false),
+		m_partialAlpha(true),
 		m_texId(0) {
 
 		resetGlimage();
@@ -64,6 +90,7 @@ namespace FIFE {
 	GLImage::GLImage(const std::string& name, SDL_Surface* surface):
 		Image(name, surface),
 		m_compressed(false),
+		m_partialAlpha(true),
 		m_texId(0) {
 
 		resetGlimage();
@@ -72,6 +99,7 @@ namespace FIFE {
 	GLImage::GLImage(const uint8_t* data, uint32_t width, uint32_t height):
 		Image(data, width, height),
 		m_compressed(false),
+		m_partialAlpha(true),
 		m_texId(0) {
 
 		assert(m_surface);
@@ -81,6 +109,7 @@ namespace FIFE {
 	GLImage::GLImage(const std::string& name, const uint8_t* data, uint32_t width, uint32_t height):
 		Image(name, data, width, height),
 		m_compressed(false),
+		m_partialAlpha(true),
 		m_texId(0) {
 
 		assert(m_surface);
@@ -136,6 +165,7 @@ namespace FIFE {
 			rect.bottom() < 0 || rect.y > static_cast<int32_t>(target->h)) {
 			return;
 		}
+		touch();
 		if (!m_texId) {
 			generateGLTexture();
 		} else if (m_shared) {
@@ -159,6 +189,7 @@ namespace FIFE {
 			rect.bottom() < 0 || rect.y > static_cast<int32_t>(target->h)) {
 			return;
 		}
+		touch();
 		if (!m_texId) {
 			generateGLTexture();
 		} else if (m_shared) {
@@ -186,12 +217,13 @@ namespace FIFE {
 			rect.bottom() < 0 || rect.y > static_cast<int32_t>(target->h)) {
 			return;
 		}
+		touch();
 		if (!m_texId) {
 			generateGLTexture();
 		} else if (m_shared) {
 			validateShared();
 		}
-		static_cast<RenderBackendOpenGL*>(rb)->addImageToArrayZ(m_texId, rect, vertexZ, m_tex_coords, alpha, rgb);
+		static_cast<RenderBackendOpenGL*>(rb)->addImageToArrayZ(m_texId, rect, vertexZ, m_tex_coords, alpha, rgb, m_partialAlpha);
 		//rb->addImageToArray(m_texId, rect, m_tex_coords, alpha, rgb);
 	}
 
@@ -209,6 +241,7 @@ namespace FIFE {
 			rect.bottom() < 0 || rect.y > static_cast<int32_t>(target->h)) {
 			return;
 		}
+		touch();
 		
 		if (!m_texId) {
 			generateGLTexture();
@@ -266,6 +299,7 @@ namespace FIFE {
 
 		uint8_t* data = static_cast<uint8_t*>(m_surface->pixels);
 		int32_t pitch = m_surface->pitch;
+		m_partialAlpha = hasPartialAlpha(m_surface, Rect(0, 0, width, height));
 
 		assert(!m_texId);
 
@@ -527,6 +561,7 @@ namespace FIFE {
 		m_texId = m_shared_img->m_texId;
 		m_surface = m_shared_img->m_surface;
 		m_compressed = m_shared_img->m_compressed;
+		m_partialAlpha = hasPartialAlpha(m_surface, m_subimagerect);
 		generateGLSharedTexture(m_shared_img, m_subimagerect);
 	}
 
@@ -87,6 +87,9 @@ namespace FIFE {
 		// Was this image compressed by OpenGL driver during loading ?
 		bool m_compressed;
 
+		// Has the image texels that are neither transparent nor opaque ?
+		bool m_partialAlpha;
+
 		//     [0]    [2]    ->(x)
 		// [1]  +------+
 		//      |      |
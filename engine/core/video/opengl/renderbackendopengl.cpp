@@ -20,6 +20,9 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 
 // Platform specific includes
 
@@ -29,7 +32,9 @@
 // FIFE includes
 #include "util/base/exception.h"
 #include "util/log/logger.h"
+#include "util/time/profiler.h"
 #include "video/devicecaps.h"
+#include "video/screencapturer.h"
 
 #include "glimage.h"
 #include "renderbackendopengl.h"
@@ -42,6 +47,9 @@ namespace FIFE {
 	 */
 	static Logger _log(LM_VIDEO);
 
+	//! pointer value that never matches a real array, used to invalidate the pointer states
+	static const void* const INVALID_POINTER = reinterpret_cast<const void*>(~static_cast<uintptr_t>(0));
+
 	class RenderBackendOpenGL::RenderObject {
 	public:
 		RenderObject(GLenum m, uint16_t s, uint32_t t1=0, uint32_t t2=0):
@@ -115,6 +123,17 @@ namespace FIFE {
 		m_state.scissor_test = true;
 		m_state.depth_enabled = true;
 		m_state.color_enabled = true;
+
+		m_vertexStream.id = 0;
+		m_vertexStream.target = GL_ARRAY_BUFFER;
+		m_vertexStream.size = 0;
+		m_vertexStream.offset = 0;
+		m_indexStream.id = 0;
+		m_indexStream.target = GL_ELEMENT_ARRAY_BUFFER;
+		m_indexStream.size = 0;
+		m_indexStream.offset = 0;
+		m_indicebufferId = 0;
+		m_frameNumber = 0;
 	}
 
 	RenderBackendOpenGL::~RenderBackendOpenGL() {
@@ -122,6 +141,11 @@ namespace FIFE {
 		if(GLEW_EXT_framebuffer_object && m_useframebuffer) {
 			glDeleteFramebuffers(1, &m_fbo_id);
 		}
+		deleteBufferObjects();
+		collectReadbacks(true);
+		if (!m_readbackBuffers.empty()) {
+			glDeleteBuffers(m_readbackBuffers.size(), &m_readbackBuffers[0]);
+		}
 		SDL_GL_DeleteContext(m_context);
 		SDL_DestroyWindow(m_window);
 		deinit();
@@ -334,11 +358,9 @@ namespace FIFE {
 			index += 4;
 		}
 
-		// currently unused, create buffer and send data
-		//glGenBuffers(1, &m_indicebufferId);
-		//glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indicebufferId);
-		//glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), &indices[0], GL_STATIC_DRAW);
-		//glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		if (m_usevbo) {
+			initBufferObjects();
+		}
 	}
 
 	void RenderBackendOpenGL::startFrame() {
@@ -347,6 +369,9 @@ namespace FIFE {
 
 	void RenderBackendOpenGL::endFrame() {
 		if (m_window) {
+			processCaptures();
+			collectReadbacks(false);
+			++m_frameNumber;
 			SDL_GL_SwapWindow(m_window);
 		}
 		RenderBackend::endFrame();
@@ -502,6 +527,7 @@ namespace FIFE {
 				glClientActiveTexture(GL_TEXTURE0 + texUnit);
 			}
 			m_state.texture[texUnit] = texId;
+			++m_textureBinds;
 			glBindTexture(GL_TEXTURE_2D, texId);
 		}
 	}
@@ -509,6 +535,7 @@ namespace FIFE {
 	void RenderBackendOpenGL::bindTexture(GLuint texId) {
 		if(m_state.texture[m_state.active_tex] != texId) {
 			m_state.texture[m_state.active_tex] = texId;
+			++m_textureBinds;
 			glBindTexture(GL_TEXTURE_2D, texId);
 		}
 	}
@@ -684,6 +711,134 @@ namespace FIFE {
 		}
 	}
 
+	void RenderBackendOpenGL::initBufferObjects() {
+		if (m_vertexStream.id != 0) {
+			// the context is reused, so the buffers are still valid
+			return;
+		}
+		// the core entry points are used, an ARB_vertex_buffer_object only context is not enough
+		if (!GLEW_VERSION_1_5) {
+			// if not available use client side vertex arrays
+			FL_WARN(_log, LMsg("RenderBackendOpenGL") << "Vertex buffer objects need OpenGL 1.5, using vertex arrays.");
+			m_usevbo = false;
+			return;
+		}
+		glGenBuffers(1, &m_vertexStream.id);
+		glGenBuffers(1, &m_indexStream.id);
+
+		// the quad indices never change, so they are uploaded once
+		glGenBuffers(1, &m_indicebufferId);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indicebufferId);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(uint32_t), &m_indices[0], GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+
+	void RenderBackendOpenGL::deleteBufferObjects() {
+		if (m_vertexStream.id == 0) {
+			return;
+		}
+		glDeleteBuffers(1, &m_vertexStream.id);
+		glDeleteBuffers(1, &m_indexStream.id);
+		glDeleteBuffers(1, &m_indicebufferId);
+		m_vertexStream.id = 0;
+		m_vertexStream.size = 0;
+		m_vertexStream.offset = 0;
+		m_indexStream.id = 0;
+		m_indexStream.size = 0;
+		m_indexStream.offset = 0;
+		m_indicebufferId = 0;
+	}
+
+	void RenderBackendOpenGL::streamArrays(StreamBuffer& buffer, const StreamArray* arrays, uint32_t count, const uint8_t** pointers) {
+		if (!m_usevbo) {
+			for (uint32_t i = 0; i < count; ++i) {
+				pointers[i] = static_cast<const uint8_t*>(arrays[i].data);
+			}
+			return;
+		}
+
+		// every array starts 16 byte aligned
+		uint32_t total = 0;
+		for (uint32_t i = 0; i < count; ++i) {
+			total += (arrays[i].size + 15) & ~15u;
+		}
+
+		glBindBuffer(buffer.target, buffer.id);
+		if (buffer.offset + total > buffer.size) {
+			// orphan the storage, the driver keeps the old one alive until the pending draw calls are done
+			if (total > buffer.size) {
+				buffer.size = std::max(total, buffer.size * 2);
+			}
+			glBufferData(buffer.target, buffer.size, NULL, GL_STREAM_DRAW);
+			buffer.offset = 0;
+		}
+
+		// the range behind the offset was never used since the last orphaning,
+		// so it can be written without waiting for the gpu
+		uint8_t* mapped = NULL;
+		if (total > 0 && GLEW_ARB_map_buffer_range) {
+			mapped = static_cast<uint8_t*>(glMapBufferRange(buffer.target, buffer.offset, total,
+				GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+		}
+
+		uint32_t offset = buffer.offset;
+		for (uint32_t i = 0; i < count; ++i) {
+			pointers[i] = reinterpret_cast<const uint8_t*>(static_cast<uintptr_t>(offset));
+			if (arrays[i].size > 0) {
+				if (mapped) {
+					std::memcpy(mapped + (offset - buffer.offset), arrays[i].data, arrays[i].size);
+				} else {
+					glBufferSubData(buffer.target, offset, arrays[i].size, arrays[i].data);
+				}
+			}
+			offset += (arrays[i].size + 15) & ~15u;
+		}
+		if (mapped) {
+			glUnmapBuffer(buffer.target);
+		}
+		buffer.offset = offset;
+		m_uploadedBytes += total;
+	}
+
+	void RenderBackendOpenGL::streamVertexData() {
+		StreamArray vertices[VERTEX_STREAM_COUNT] = {
+			makeStreamArray(m_renderPrimitiveDatas),
+			makeStreamArray(m_renderTextureDatas),
+			makeStreamArray(m_renderTextureColorDatas),
+			makeStreamArray(m_renderMultitextureDatas),
+			makeStreamArray(m_renderTextureDatasZ),
+			makeStreamArray(m_renderTextureColorDatasZ),
+			makeStreamArray(m_renderMultitextureDatasZ)
+		};
+		streamArrays(m_vertexStream, vertices, VERTEX_STREAM_COUNT, m_vertexPointers);
+
+		StreamArray indices[INDEX_STREAM_COUNT] = {
+			makeStreamArray(m_pIndices),
+			makeStreamArray(m_tIndices),
+			makeStreamArray(m_tcIndices),
+			makeStreamArray(m_tc2Indices)
+		};
+		streamArrays(m_indexStream, indices, INDEX_STREAM_COUNT, m_indexPointers);
+
+		if (m_usevbo) {
+			// offsets can repeat after the buffer was orphaned, so the cached pointers are not reliable
+			m_state.vertex_pointer = INVALID_POINTER;
+			m_state.color_pointer = INVALID_POINTER;
+			m_state.tex_pointer[0] = INVALID_POINTER;
+			m_state.tex_pointer[1] = INVALID_POINTER;
+			m_state.tex_pointer[2] = INVALID_POINTER;
+			m_state.tex_pointer[3] = INVALID_POINTER;
+		}
+	}
+
+	const uint32_t* RenderBackendOpenGL::getQuadIndices() {
+		if (m_usevbo) {
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indicebufferId);
+			return 0;
+		}
+		return &m_indices[0];
+	}
+
 	void RenderBackendOpenGL::enableScissorTest() {
 		if(m_state.scissor_test == false) {
 			m_state.scissor_test = true;
@@ -827,8 +982,21 @@ namespace FIFE {
 		int32_t* currentIndex = 0;
 		uint32_t* currentElements = 0;
 
+		// vertex and index data
+		const uint8_t* dataP = m_vertexPointers[VERTEX_STREAM_P];
+		const uint8_t* dataT = m_vertexPointers[VERTEX_STREAM_T];
+		const uint8_t* dataTC = m_vertexPointers[VERTEX_STREAM_TC];
+		const uint8_t* data2TC = m_vertexPointers[VERTEX_STREAM_2TC];
+		const uint32_t* indicesP = reinterpret_cast<const uint32_t*>(m_indexPointers[INDEX_STREAM_P]);
+		const uint32_t* indicesT = reinterpret_cast<const uint32_t*>(m_indexPointers[INDEX_STREAM_T]);
+		const uint32_t* indicesTC = reinterpret_cast<const uint32_t*>(m_indexPointers[INDEX_STREAM_TC]);
+		const uint32_t* indices2TC = reinterpret_cast<const uint32_t*>(m_indexPointers[INDEX_STREAM_2TC]);
+		if (m_usevbo) {
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexStream.id);
+		}
+
 		// index buffer pointer
-		uint32_t* indexBuffer = 0;
+		const uint32_t* indexBuffer = 0;
 
 		//stride
 		const uint32_t strideP = sizeof(renderDataP);
@@ -845,38 +1013,38 @@ namespace FIFE {
 			if (!m_renderObjects[0].color) {
 				// set pointer
 				disableColorArray();
-				setVertexPointer(2, strideT, &m_renderTextureDatas[0].vertex);
-				setTexCoordPointer(0, strideT, &m_renderTextureDatas[0].texel);
-				indexBuffer = &m_tIndices[0];
+				setVertexPointer(2, strideT, dataT + offsetof(renderDataT, vertex));
+				setTexCoordPointer(0, strideT, dataT + offsetof(renderDataT, texel));
+				indexBuffer = indicesT;
 				currentIndex = &indexT;
 				currentElements = &elementsT;
 			// texture with color/alpha
 			} else if (m_renderObjects[0].texture_id != 0){
 				// set pointer
 				enableColorArray();
-				setVertexPointer(2, strideTC, &m_renderTextureColorDatas[0].vertex);
-				setTexCoordPointer(0, strideTC, &m_renderTextureColorDatas[0].texel);
-				setColorPointer(strideTC, &m_renderTextureColorDatas[0].color);
-				indexBuffer = &m_tcIndices[0];
+				setVertexPointer(2, strideTC, dataTC + offsetof(renderDataTC, vertex));
+				setTexCoordPointer(0, strideTC, dataTC + offsetof(renderDataTC, texel));
+				setColorPointer(strideTC, dataTC + offsetof(renderDataTC, color));
+				indexBuffer = indicesTC;
 				currentIndex = &indexTC;
 				currentElements = &elementsTC;
 			// primitive
 			} else {
 				// set pointer
 				enableColorArray();
-				setVertexPointer(2, strideP, &m_renderPrimitiveDatas[0].vertex);
-				setColorPointer(strideP, &m_renderPrimitiveDatas[0].color);
-				indexBuffer = &m_pIndices[0];
+				setVertexPointer(2, strideP, dataP + offsetof(renderDataP, vertex));
+				setColorPointer(strideP, dataP + offsetof(renderDataP, color));
+				indexBuffer = indicesP;
 				currentIndex = &indexP;
 				currentElements = &elementsP;
 			}
 		// multitexture overlay
 		} else {
 			// set pointer
-			setVertexPointer(2, stride2TC, &m_renderMultitextureDatas[0].vertex);
-			setColorPointer(stride2TC, &m_renderMultitextureDatas[0].color);
-			setTexCoordPointer(0, stride2TC, &m_renderMultitextureDatas[0].texel);
-			indexBuffer = &m_tc2Indices[0];
+			setVertexPointer(2, stride2TC, data2TC + offsetof(renderData2TC, vertex));
+			setColorPointer(stride2TC, data2TC + offsetof(renderData2TC, color));
+			setTexCoordPointer(0, stride2TC, data2TC + offsetof(renderData2TC, texel));
+			indexBuffer = indices2TC;
 			currentIndex = &index2TC;
 			currentElements = &elements2TC;
 		}
@@ -931,6 +1099,7 @@ namespace FIFE {
 			if (render) {
 				if (*currentElements > 0) {
 					//render
+					++m_drawCalls;
 					glDrawElements(mode, *currentElements, GL_UNSIGNED_INT, indexBuffer + *currentIndex);
 					*currentIndex += *currentElements;
 				}
@@ -945,16 +1114,16 @@ namespace FIFE {
 						enableColorArray();
 						if (ro.overlay_type == OVERLAY_TYPE_NONE) {
 							if (ro.texture_id != 0) {
-								setVertexPointer(2, strideTC, &m_renderTextureColorDatas[0].vertex);
-								setTexCoordPointer(0, strideTC, &m_renderTextureColorDatas[0].texel);
-								setColorPointer(strideTC, &m_renderTextureColorDatas[0].color);
-								indexBuffer = &m_tcIndices[0];
+								setVertexPointer(2, strideTC, dataTC + offsetof(renderDataTC, vertex));
+								setTexCoordPointer(0, strideTC, dataTC + offsetof(renderDataTC, texel));
+								setColorPointer(strideTC, dataTC + offsetof(renderDataTC, color));
+								indexBuffer = indicesTC;
 								currentElements = &elementsTC;
 								currentIndex = &indexTC;
 							} else {
-								setVertexPointer(2, strideP, &m_renderPrimitiveDatas[0].vertex);
-								setColorPointer(strideP, &m_renderPrimitiveDatas[0].color);
-								indexBuffer = &m_pIndices[0];
+								setVertexPointer(2, strideP, dataP + offsetof(renderDataP, vertex));
+								setColorPointer(strideP, dataP + offsetof(renderDataP, color));
+								indexBuffer = indicesP;
 								currentElements = &elementsP;
 								currentIndex = &indexP;
 							}
@@ -962,9 +1131,9 @@ namespace FIFE {
 					} else if (!ro.color && m_state.color_enabled) {
 						disableColorArray();
 						if (ro.overlay_type == OVERLAY_TYPE_NONE) {
-							setVertexPointer(2, strideT, &m_renderTextureDatas[0].vertex);
-							setTexCoordPointer(0, strideT, &m_renderTextureDatas[0].texel);
-							indexBuffer = &m_tIndices[0];
+							setVertexPointer(2, strideT, dataT + offsetof(renderDataT, vertex));
+							setTexCoordPointer(0, strideT, dataT + offsetof(renderDataT, texel));
+							indexBuffer = indicesT;
 							currentElements = &elementsT;
 							currentIndex = &indexT;
 						}
@@ -982,23 +1151,23 @@ namespace FIFE {
 						if (ro.texture_id != 0) {
 							enableTextures(0);
 							if (m_state.color_enabled) {
-								setVertexPointer(2, strideTC, &m_renderTextureColorDatas[0].vertex);
-								setTexCoordPointer(0, strideTC, &m_renderTextureColorDatas[0].texel);
-								setColorPointer(strideTC, &m_renderTextureColorDatas[0].color);
-								indexBuffer = &m_tcIndices[0];
+								setVertexPointer(2, strideTC, dataTC + offsetof(renderDataTC, vertex));
+								setTexCoordPointer(0, strideTC, dataTC + offsetof(renderDataTC, texel));
+								setColorPointer(strideTC, dataTC + offsetof(renderDataTC, color));
+								indexBuffer = indicesTC;
 								currentElements = &elementsTC;
 								currentIndex = &indexTC;
 							} else {
-								setVertexPointer(2, strideT, &m_renderTextureDatas[0].vertex);
-								setTexCoordPointer(0, strideT, &m_renderTextureDatas[0].texel);
-								indexBuffer = &m_tIndices[0];
+								setVertexPointer(2, strideT, dataT + offsetof(renderDataT, vertex));
+								setTexCoordPointer(0, strideT, dataT + offsetof(renderDataT, texel));
+								indexBuffer = indicesT;
 								currentIndex = &indexT;
 								currentElements = &elementsT;
 							}
 						} else {
-							setVertexPointer(2, strideP, &m_renderPrimitiveDatas[0].vertex);
-							setColorPointer(strideP, &m_renderPrimitiveDatas[0].color);
-							indexBuffer = &m_pIndices[0];
+							setVertexPointer(2, strideP, dataP + offsetof(renderDataP, vertex));
+							setColorPointer(strideP, dataP + offsetof(renderDataP, color));
+							indexBuffer = indicesP;
 							currentElements = &elementsP;
 							currentIndex = &indexP;
 						}
@@ -1012,11 +1181,11 @@ namespace FIFE {
 						enableTextures(0);
 
 						// set pointer
-						setVertexPointer(2, stride2TC, &m_renderMultitextureDatas[0].vertex);
-						setColorPointer(stride2TC, &m_renderMultitextureDatas[0].color);
-						setTexCoordPointer(1, stride2TC, &m_renderMultitextureDatas[0].texel2);
-						setTexCoordPointer(0, stride2TC, &m_renderMultitextureDatas[0].texel);
-						indexBuffer = &m_tc2Indices[0];
+						setVertexPointer(2, stride2TC, data2TC + offsetof(renderData2TC, vertex));
+						setColorPointer(stride2TC, data2TC + offsetof(renderData2TC, color));
+						setTexCoordPointer(1, stride2TC, data2TC + offsetof(renderData2TC, texel2));
+						setTexCoordPointer(0, stride2TC, data2TC + offsetof(renderData2TC, texel));
+						indexBuffer = indices2TC;
 
 						texture_id2 = m_maskOverlay;
 						currentElements = &elements2TC;
@@ -1030,11 +1199,11 @@ namespace FIFE {
 						enableTextures(0);
 
 						// set pointer
-						setVertexPointer(2, stride2TC, &m_renderMultitextureDatas[0].vertex);
-						setColorPointer(stride2TC, &m_renderMultitextureDatas[0].color);
-						setTexCoordPointer(2, stride2TC, &m_renderMultitextureDatas[0].texel2);
-						setTexCoordPointer(0, stride2TC, &m_renderMultitextureDatas[0].texel);
-						indexBuffer = &m_tc2Indices[0];
+						setVertexPointer(2, stride2TC, data2TC + offsetof(renderData2TC, vertex));
+						setColorPointer(stride2TC, data2TC + offsetof(renderData2TC, color));
+						setTexCoordPointer(2, stride2TC, data2TC + offsetof(renderData2TC, texel2));
+						setTexCoordPointer(0, stride2TC, data2TC + offsetof(renderData2TC, texel));
+						indexBuffer = indices2TC;
 
 						texture_id2 = ro.overlay_id;
 						currentElements = &elements2TC;
@@ -1048,11 +1217,11 @@ namespace FIFE {
 						enableTextures(0);
 
 						// set pointer
-						setVertexPointer(2, stride2TC, &m_renderMultitextureDatas[0].vertex);
-						setColorPointer(stride2TC, &m_renderMultitextureDatas[0].color);
-						setTexCoordPointer(3, stride2TC, &m_renderMultitextureDatas[0].texel2);
-						setTexCoordPointer(0, stride2TC, &m_renderMultitextureDatas[0].texel);
-						indexBuffer = &m_tc2Indices[0];
+						setVertexPointer(2, stride2TC, data2TC + offsetof(renderData2TC, vertex));
+						setColorPointer(stride2TC, data2TC + offsetof(renderData2TC, color));
+						setTexCoordPointer(3, stride2TC, data2TC + offsetof(renderData2TC, texel2));
+						setTexCoordPointer(0, stride2TC, data2TC + offsetof(renderData2TC, texel));
+						indexBuffer = indices2TC;
 
 						texture_id2 = ro.overlay_id;
 						currentElements = &elements2TC;
@@ -1070,16 +1239,16 @@ namespace FIFE {
 						texture_id = ro.texture_id;
 						if (ro.overlay_type == OVERLAY_TYPE_NONE) {
 							if (m_state.color_enabled) {
-								setVertexPointer(2, strideTC, &m_renderTextureColorDatas[0].vertex);
-								setTexCoordPointer(0, strideTC, &m_renderTextureColorDatas[0].texel);
-								setColorPointer(strideTC, &m_renderTextureColorDatas[0].color);
-								indexBuffer = &m_tcIndices[0];
+								setVertexPointer(2, strideTC, dataTC + offsetof(renderDataTC, vertex));
+								setTexCoordPointer(0, strideTC, dataTC + offsetof(renderDataTC, texel));
+								setColorPointer(strideTC, dataTC + offsetof(renderDataTC, color));
+								indexBuffer = indicesTC;
 								currentElements = &elementsTC;
 								currentIndex = &indexTC;
 							} else {
-								setVertexPointer(2, strideT, &m_renderTextureDatas[0].vertex);
-								setTexCoordPointer(0, strideT, &m_renderTextureDatas[0].texel);
-								indexBuffer = &m_tIndices[0];
+								setVertexPointer(2, strideT, dataT + offsetof(renderDataT, vertex));
+								setTexCoordPointer(0, strideT, dataT + offsetof(renderDataT, texel));
+								indexBuffer = indicesT;
 								currentElements = &elementsT;
 								currentIndex = &indexT;
 							}
@@ -1088,9 +1257,9 @@ namespace FIFE {
 						disableTextures(0);
 						texture_id = 0;
 						if (ro.overlay_type == OVERLAY_TYPE_NONE) {
-							setVertexPointer(2, strideP, &m_renderPrimitiveDatas[0].vertex);
-							setColorPointer(strideP, &m_renderPrimitiveDatas[0].color);
-							indexBuffer = &m_pIndices[0];
+							setVertexPointer(2, strideP, dataP + offsetof(renderDataP, vertex));
+							setColorPointer(strideP, dataP + offsetof(renderDataP, color));
+							indexBuffer = indicesP;
 							currentElements = &elementsP;
 							currentIndex = &indexP;
 						}
@@ -1139,6 +1308,7 @@ namespace FIFE {
 			}
 		}
 		// render
+		++m_drawCalls;
 		glDrawElements(mode, *currentElements, GL_UNSIGNED_INT, indexBuffer + *currentIndex);
 
 		// reset all states
@@ -1172,10 +1342,13 @@ namespace FIFE {
 	void RenderBackendOpenGL::renderWithZ() {
 		// stride
 		const uint32_t stride = sizeof(renderDataZ);
+		// vertex data and static quad indices
+		const uint8_t* data = m_vertexPointers[VERTEX_STREAM_Z];
+		const uint32_t* quadIndices = getQuadIndices();
 
 		// set pointer
-		setVertexPointer(3, stride, &m_renderTextureDatasZ[0].vertex);
-		setTexCoordPointer(0, stride, &m_renderTextureDatasZ[0].texel);
+		setVertexPointer(3, stride, data + offsetof(renderDataZ, vertex));
+		setTexCoordPointer(0, stride, data + offsetof(renderDataZ, texel));
 
 		// array index
 		int32_t index = 0;
@@ -1199,7 +1372,8 @@ namespace FIFE {
 			if (ro.texture_id != texture_id) {
 				if (*currentElements > 0) {
 					//render
-					glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, &m_indices[*currentIndex]);
+					++m_drawCalls;
+					glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, quadIndices + *currentIndex);
 					*currentIndex += *currentElements;
 				}
 
@@ -1220,7 +1394,8 @@ namespace FIFE {
 		}
 
 		// render
-		glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, &m_indices[*currentIndex]);
+		++m_drawCalls;
+		glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, quadIndices + *currentIndex);
 
 		//reset all states
 		disableLighting();
@@ -1233,6 +1408,70 @@ namespace FIFE {
 		m_renderTextureObjectsZ.clear();
 	}
 
+	void RenderBackendOpenGL::sortRenderObjectsZ() {
+		// Quads with partial alpha are blended with what is already drawn, so they keep
+		// their submission order behind the quads that are grouped by texture.
+		const uint64_t blendedKey = static_cast<uint64_t>(1) << 32;
+		const uint32_t quads = m_renderTextureObjectsZ.size();
+		m_sortKeysZ.clear();
+		m_sortKeysZ.reserve(quads);
+		for (uint32_t i = 0; i < quads; ++i) {
+			const RenderZObject& ro = m_renderTextureObjectsZ[i];
+			m_sortKeysZ.push_back(std::make_pair(ro.partial_alpha ? blendedKey : ro.texture_id, i));
+		}
+
+		// Quads with equal depth are resolved by the draw order (GL_LEQUAL), so they
+		// are grouped under the key of the first one and keep their order. If one
+		// of them is blended, all of them are.
+		m_depthKeysZ.clear();
+		m_depthKeysZ.reserve(quads);
+		for (uint32_t i = 0; i < quads; ++i) {
+			m_depthKeysZ.push_back(std::make_pair(m_renderTextureDatasZ[i * 4].vertex[2], i));
+		}
+		std::sort(m_depthKeysZ.begin(), m_depthKeysZ.end());
+		for (uint32_t first = 0; first < quads;) {
+			uint32_t last = first + 1;
+			while (last < quads && m_depthKeysZ[last].first == m_depthKeysZ[first].first) {
+				++last;
+			}
+			// the first one has the lowest index
+			uint64_t group = m_sortKeysZ[m_depthKeysZ[first].second].first;
+			for (uint32_t i = first + 1; i < last; ++i) {
+				if (m_sortKeysZ[m_depthKeysZ[i].second].first == blendedKey) {
+					group = blendedKey;
+				}
+			}
+			for (uint32_t i = first; i < last; ++i) {
+				m_sortKeysZ[m_depthKeysZ[i].second].first = group;
+			}
+			first = last;
+		}
+
+		bool sorted = true;
+		for (uint32_t i = 1; i < quads; ++i) {
+			if (m_sortKeysZ[i].first < m_sortKeysZ[i - 1].first) {
+				sorted = false;
+				break;
+			}
+		}
+		if (sorted) {
+			return;
+		}
+		// the quad index makes the keys unique, so the result is the same every frame
+		std::sort(m_sortKeysZ.begin(), m_sortKeysZ.end());
+
+		// reorder the vertex data, so the static quad indices can still be used
+		m_sortedTextureDatasZ.resize(m_renderTextureDatasZ.size());
+		m_sortedTextureObjectsZ.resize(quads);
+		for (uint32_t i = 0; i < quads; ++i) {
+			const uint32_t source = m_sortKeysZ[i].second;
+			std::copy(&m_renderTextureDatasZ[source * 4], &m_renderTextureDatasZ[source * 4] + 4, &m_sortedTextureDatasZ[i * 4]);
+			m_sortedTextureObjectsZ[i] = m_renderTextureObjectsZ[source];
+		}
+		m_renderTextureDatasZ.swap(m_sortedTextureDatasZ);
+		m_renderTextureObjectsZ.swap(m_sortedTextureObjectsZ);
+	}
+
 	void RenderBackendOpenGL::renderWithZTest() {
 		// stride
 		const uint32_t stride = sizeof(renderDataZ);
@@ -1250,6 +1489,7 @@ namespace FIFE {
 		std::vector<RenderZObjectTest>::iterator iter = m_renderZ_objects.begin();
 		for ( ; iter != m_renderZ_objects.end(); ++iter) {
 			bindTexture(iter->texture_id);
+			++m_drawCalls;
 			glDrawArrays(GL_QUADS, iter->index, iter->elements);
 		}
 		m_renderZ_objects.clear();
@@ -1265,11 +1505,14 @@ namespace FIFE {
 	void RenderBackendOpenGL::renderWithColorAndZ() {
 		// stride
 		const uint32_t stride = sizeof(renderDataColorZ);
+		// vertex data and static quad indices
+		const uint8_t* data = m_vertexPointers[VERTEX_STREAM_COLOR_Z];
+		const uint32_t* quadIndices = getQuadIndices();
 
 		// set pointer
-		setVertexPointer(3, stride, &m_renderTextureColorDatasZ[0].vertex);
-		setTexCoordPointer(0, stride, &m_renderTextureColorDatasZ[0].texel);
-		setColorPointer(stride, &m_renderTextureColorDatasZ[0].color);
+		setVertexPointer(3, stride, data + offsetof(renderDataColorZ, vertex));
+		setTexCoordPointer(0, stride, data + offsetof(renderDataColorZ, texel));
+		setColorPointer(stride, data + offsetof(renderDataColorZ, color));
 
 		// array index
 		int32_t index = 0;
@@ -1293,7 +1536,8 @@ namespace FIFE {
 			if (ro.texture_id != texture_id) {
 				if (*currentElements > 0) {
 					//render
-					glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, &m_indices[*currentIndex]);
+					++m_drawCalls;
+					glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, quadIndices + *currentIndex);
 					*currentIndex += *currentElements;
 				}
 
@@ -1314,7 +1558,8 @@ namespace FIFE {
 		}
 
 		// render
-		glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, &m_indices[*currentIndex]);
+		++m_drawCalls;
+		glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, quadIndices + *currentIndex);
 
 		//reset all states
 		disableLighting();
@@ -1335,14 +1580,17 @@ namespace FIFE {
 
 		// stride
 		const uint32_t stride = sizeof(renderData2TCZ);
+		// vertex data and static quad indices
+		const uint8_t* data = m_vertexPointers[VERTEX_STREAM_2TC_Z];
+		const uint32_t* quadIndices = getQuadIndices();
 
 		// set pointer
-		setVertexPointer(3, stride, &m_renderMultitextureDatasZ[0].vertex);
-		setTexCoordPointer(0, stride, &m_renderMultitextureDatasZ[0].texel);
-		setTexCoordPointer(1, stride, &m_renderMultitextureDatasZ[0].texel2);
-		setTexCoordPointer(2, stride, &m_renderMultitextureDatasZ[0].texel2);
-		setTexCoordPointer(3, stride, &m_renderMultitextureDatasZ[0].texel2);
-		setColorPointer(stride, &m_renderMultitextureDatasZ[0].color);
+		setVertexPointer(3, stride, data + offsetof(renderData2TCZ, vertex));
+		setTexCoordPointer(0, stride, data + offsetof(renderData2TCZ, texel));
+		setTexCoordPointer(1, stride, data + offsetof(renderData2TCZ, texel2));
+		setTexCoordPointer(2, stride, data + offsetof(renderData2TCZ, texel2));
+		setTexCoordPointer(3, stride, data + offsetof(renderData2TCZ, texel2));
+		setColorPointer(stride, data + offsetof(renderData2TCZ, color));
 
 		// array index
 		int32_t index = 0;
@@ -1382,7 +1630,8 @@ namespace FIFE {
 			if (render) {
 				if (*currentElements > 0) {
 					//render
-					glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, &m_indices[*currentIndex]);
+					++m_drawCalls;
+					glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, quadIndices + *currentIndex);
 					*currentIndex += *currentElements;
 				}
 				// multitexturing
@@ -1450,7 +1699,8 @@ namespace FIFE {
 			}
 		}
 		// render
-		glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, &m_indices[*currentIndex]);
+		++m_drawCalls;
+		glDrawElements(GL_TRIANGLES, *currentElements, GL_UNSIGNED_INT, quadIndices + *currentIndex);
 
 		//reset all states
 		if (overlay_type != OVERLAY_TYPE_NONE) {
@@ -1468,10 +1718,16 @@ namespace FIFE {
 	}
 
 	void RenderBackendOpenGL::renderVertexArrays() {
+		FIFE_PROFILE_ZONE("RenderBackend::renderVertexArrays");
 		// z stuff
 		if (!m_renderZ_objects.empty()) {
 			renderWithZTest();
 		}
+		if (!m_renderTextureObjectsZ.empty()) {
+			sortRenderObjectsZ();
+		}
+		// one upload for the remaining passes
+		streamVertexData();
 		if (!m_renderTextureObjectsZ.empty()) {
 			renderWithZ();
 		}
@@ -1486,6 +1742,12 @@ namespace FIFE {
 		if (!m_renderObjects.empty()) {
 			renderWithoutZ();
 		}
+
+		if (m_usevbo) {
+			// the other draw functions use client memory
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		}
 	}
 
 	bool RenderBackendOpenGL::putPixel(int32_t x, int32_t y, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
@@ -1787,19 +2049,17 @@ namespace FIFE {
 		if (subdivisions < 12) {
 			subdivisions = 12;
 		}
-		const float step = Mathf::twoPi()/subdivisions;
-		float angle = 0;
+		const float* circle = getUnitCircle(subdivisions);
 
 		renderDataP rd;
 		rd.color[0] = r;
 		rd.color[1] = g;
 		rd.color[2] = b;
 		rd.color[3] = a;
-		for (uint16_t i = 0; i < subdivisions-1; ++i) {
-			rd.vertex[0] = radius * Mathf::Cos(angle) + p.x;
-			rd.vertex[1] = radius * Mathf::Sin(angle) + p.y;
+		for (int32_t i = 0; i < subdivisions-1; ++i) {
+			rd.vertex[0] = radius * circle[2*i] + p.x;
+			rd.vertex[1] = radius * circle[2*i+1] + p.y;
 			m_renderPrimitiveDatas.push_back(rd);
-			angle += step;
 			m_pIndices.push_back(m_pIndices.empty() ? 0 : m_pIndices.back() + 1);
 		}
 
@@ -1813,8 +2073,7 @@ namespace FIFE {
 		if (subdivisions < 12) {
 			subdivisions = 12;
 		}
-		const float step = Mathf::twoPi()/subdivisions;
-		float angle = Mathf::twoPi();
+		const float* circle = getUnitCircle(subdivisions);
 		uint32_t index = m_pIndices.empty() ? 0 : m_pIndices.back() + 1;
 		uint32_t lastIndex = index;
 
@@ -1828,11 +2087,10 @@ namespace FIFE {
 		rd.color[3] = a;
 		m_renderPrimitiveDatas.push_back(rd);
 		// reversed because of culling faces
-		for (uint16_t i = 0; i <= subdivisions; ++i) {
-			rd.vertex[0] = radius * Mathf::Cos(angle) + p.x;
-			rd.vertex[1] = radius * Mathf::Sin(angle) + p.y;
+		for (int32_t i = subdivisions; i >= 0; --i) {
+			rd.vertex[0] = radius * circle[2*i] + p.x;
+			rd.vertex[1] = radius * circle[2*i+1] + p.y;
 			m_renderPrimitiveDatas.push_back(rd);
-			angle -= step;
 			// forms triangle with start index, the last and a new one
 			uint32_t indices[] = { index, lastIndex, ++lastIndex };
 			m_pIndices.insert(m_pIndices.end(), indices, indices + 3);
@@ -1842,7 +2100,8 @@ namespace FIFE {
 	}
 
 	void RenderBackendOpenGL::drawCircleSegment(const Point& p, uint32_t radius, int32_t sangle, int32_t eangle, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-		const float step = Mathf::twoPi()/360;
+		// one segment per degree
+		const float* circle = getUnitCircle(360);
 		int32_t elements = 0;
 		int32_t s = (sangle + 360) % 360;
 		int32_t e = (eangle + 360) % 360;
@@ -1858,10 +2117,9 @@ namespace FIFE {
 		rd.color[1] = g;
 		rd.color[2] = b;
 		rd.color[3] = a;
-		float angle = static_cast<float>(s) * step;
-		for (;s <= e; ++s, angle += step, ++elements) {
-			rd.vertex[0] = radius * Mathf::Cos(angle) + p.x;
-			rd.vertex[1] = radius * Mathf::Sin(angle) + p.y;
+		for (;s <= e; ++s, ++elements) {
+			rd.vertex[0] = radius * circle[2*s] + p.x;
+			rd.vertex[1] = radius * circle[2*s+1] + p.y;
 			m_renderPrimitiveDatas.push_back(rd);
 			m_pIndices.push_back(m_pIndices.empty() ? 0 : m_pIndices.back() + 1);
 		}
@@ -1871,7 +2129,8 @@ namespace FIFE {
 	}
 
 	void RenderBackendOpenGL::drawFillCircleSegment(const Point& p, uint32_t radius, int32_t sangle, int32_t eangle, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-		const float step = Mathf::twoPi() / 360;
+		// one segment per degree
+		const float* circle = getUnitCircle(360);
 		int32_t s = (sangle + 360) % 360;
 		int32_t e = (eangle + 360) % 360;
 		if (e == 0) {
@@ -1894,10 +2153,9 @@ namespace FIFE {
 		m_renderPrimitiveDatas.push_back(rd);
 		int32_t elements = 0;
 		// reversed because of culling faces
-		float angle = static_cast<float>(e) * step;
-		for (;s <= e; ++s, angle -= step, ++elements) {
-			rd.vertex[0] = radius * Mathf::Cos(angle) + p.x;
-			rd.vertex[1] = radius * Mathf::Sin(angle) + p.y;
+		for (int32_t i = e; i >= s; --i, ++elements) {
+			rd.vertex[0] = radius * circle[2*i] + p.x;
+			rd.vertex[1] = radius * circle[2*i+1] + p.y;
 
 			m_renderPrimitiveDatas.push_back(rd);
 			// forms triangle with start index, the last and a new one
@@ -1910,10 +2168,13 @@ namespace FIFE {
 	}
 
 	void RenderBackendOpenGL::drawLightPrimitive(const Point& p, uint8_t intensity, float radius, int32_t subdivisions, float xstretch, float ystretch, uint8_t red, uint8_t green, uint8_t blue) {
-		const float step = Mathf::twoPi()/subdivisions;
-		uint32_t elements = 0;
+		if (subdivisions < 3) {
+			return;
+		}
+		const float* circle = getUnitCircle(subdivisions);
+		const float xradius = radius * xstretch;
+		const float yradius = radius * ystretch;
 		uint32_t index = m_pIndices.empty() ? 0 : m_pIndices.back() + 1;
-		uint32_t lastIndex = index;
 		// center vertex
 		renderDataP rd;
 		rd.vertex[0] = static_cast<float>(p.x);
@@ -1923,23 +2184,22 @@ namespace FIFE {
 		rd.color[2] = blue;
 		rd.color[3] = intensity;
 		m_renderPrimitiveDatas.push_back(rd);
-		for (float angle = 0; angle <= Mathf::twoPi(); angle += step, elements += 3) {
-			rd.vertex[0] = radius*Mathf::Cos(angle+step)*xstretch + p.x;
-			rd.vertex[1] = radius*Mathf::Sin(angle+step)*ystretch + p.y;
-			rd.color[0] = 0;
-			rd.color[1] = 0;
-			rd.color[2] = 0;
-			rd.color[3] = 255;
-			m_renderPrimitiveDatas.push_back(rd);
-
-			rd.vertex[0] = radius*Mathf::Cos(angle)*xstretch + p.x;
-			rd.vertex[1] = radius*Mathf::Sin(angle)*ystretch + p.y;
+		// the rim vertices are shared by neighbouring triangles
+		rd.color[0] = 0;
+		rd.color[1] = 0;
+		rd.color[2] = 0;
+		rd.color[3] = 255;
+		for (int32_t i = 0; i <= subdivisions; ++i) {
+			rd.vertex[0] = xradius * circle[2*i] + p.x;
+			rd.vertex[1] = yradius * circle[2*i+1] + p.y;
 			m_renderPrimitiveDatas.push_back(rd);
-			// forms triangle with start index and two new ones
-			uint32_t indices[] = { index, ++lastIndex, ++lastIndex };
+		}
+		for (int32_t i = 1; i <= subdivisions; ++i) {
+			// forms triangle with the center and two rim vertices, the last index is always the highest
+			uint32_t indices[] = { index + i, index, index + i + 1 };
 			m_pIndices.insert(m_pIndices.end(), indices, indices + 3);
 		}
-		RenderObject ro(GL_TRIANGLES, elements);
+		RenderObject ro(GL_TRIANGLES, subdivisions * 3);
 		m_renderObjects.push_back(ro);
 	}
 
@@ -2127,7 +2387,7 @@ namespace FIFE {
 		return &m_renderZ_objects.back();
 	}
 
-	void RenderBackendOpenGL::addImageToArrayZ(uint32_t id, const Rect& rect, float vertexZ, float const* st, uint8_t alpha, uint8_t const* rgba) {
+	void RenderBackendOpenGL::addImageToArrayZ(uint32_t id, const Rect& rect, float vertexZ, float const* st, uint8_t alpha, uint8_t const* rgba, bool partialAlpha) {
 		// texture quad without alpha and coloring
 		if (alpha == 255 && !rgba) {
 			// ToDo: Consider if this is better.
@@ -2188,6 +2448,7 @@ namespace FIFE {
 
 			RenderZObject ro;
 			ro.texture_id = id;
+			ro.partial_alpha = partialAlpha;
 			m_renderTextureObjectsZ.push_back(ro);
 		} else {
 			// multitexture with color, second texel is used for m_maskOverlay
@@ -2263,6 +2524,7 @@ namespace FIFE {
 
 				RenderZObject ro;
 				ro.texture_id = id;
+				ro.partial_alpha = true;
 				m_renderTextureColorObjectsZ.push_back(ro);
 			}
 		}
@@ -2463,6 +2725,74 @@ namespace FIFE {
 		delete[] pixels;
 	}
 
+	void RenderBackendOpenGL::readbackFrame(const std::string& filename, bool force) {
+		const uint32_t width = getWidth();
+		const uint32_t height = getHeight();
+
+		// the pixel buffer object path uses the buffer object calls of OpenGL 1.5
+		if (!GLEW_VERSION_1_5 || !GLEW_ARB_pixel_buffer_object) {
+			// the read back blocks, but flipping and saving is still done by the capturer
+			CaptureFrame* frame = new CaptureFrame();
+			frame->filename = filename;
+			frame->width = width;
+			frame->height = height;
+			frame->flipped = true;
+			frame->pixels.resize(width * height * 3);
+			glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, reinterpret_cast<GLvoid*>(&frame->pixels[0]));
+			m_capturer->push(frame, force);
+			return;
+		}
+
+		PixelReadback readback;
+		if (m_readbackBuffers.empty()) {
+			glGenBuffers(1, &readback.buffer);
+		} else {
+			readback.buffer = m_readbackBuffers.back();
+			m_readbackBuffers.pop_back();
+		}
+		readback.frame = m_frameNumber;
+		readback.width = width;
+		readback.height = height;
+		readback.force = force;
+		readback.filename = filename;
+
+		// the copy into the buffer object is done asynchronously by the driver
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+		glBufferData(GL_PIXEL_PACK_BUFFER, width * height * 3, NULL, GL_STREAM_READ);
+		glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		m_readbacks.push_back(readback);
+	}
+
+	void RenderBackendOpenGL::collectReadbacks(bool all) {
+		while (!m_readbacks.empty()) {
+			PixelReadback& readback = m_readbacks.front();
+			// the gpu finishes the copy within two frames
+			if (!all && readback.frame + 2 > m_frameNumber) {
+				break;
+			}
+
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+			const uint8_t* data = static_cast<const uint8_t*>(glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY));
+			if (data) {
+				CaptureFrame* frame = new CaptureFrame();
+				frame->filename = readback.filename;
+				frame->width = readback.width;
+				frame->height = readback.height;
+				frame->flipped = true;
+				frame->pixels.assign(data, data + readback.width * readback.height * 3);
+				glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+				m_capturer->push(frame, readback.force);
+			} else {
+				FL_WARN(_log, LMsg("RenderBackendOpenGL") << "Could not map the read back of " << readback.filename);
+			}
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+			m_readbackBuffers.push_back(readback.buffer);
+			m_readbacks.pop_front();
+		}
+	}
+
 	void RenderBackendOpenGL::captureScreen(const std::string& filename, uint32_t width, uint32_t height) {
 		const uint32_t swidth = getWidth();
 		const uint32_t sheight = getHeight();
@@ -2691,11 +3021,13 @@ namespace FIFE {
 			glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 		} else {
 			glEnable(GL_TEXTURE_2D);
+			++m_textureBinds;
 			glBindTexture(GL_TEXTURE_2D, texId);
 			glEnableClientState(GL_TEXTURE_COORD_ARRAY);
 			glTexCoordPointer(2, GL_DOUBLE, sizeof(GuiVertex), &vertices[0].texCoords);
 		}
 		
+		++m_drawCalls;
 		glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, &indices[0]);
 		
 		glPopMatrix();
@@ -23,6 +23,7 @@
 #define FIFE_VIDEO_RENDERBACKENSD_OPENGL_RENDERBACKENDOPENGL_H
 
 // Standard C++ library includes
+#include <deque>
 
 // 3rd party library includes
 
@@ -70,7 +71,7 @@ namespace FIFE {
 		virtual void addImageToArray(uint32_t id, const Rect& rec, float const* st, uint8_t alpha, uint8_t const* rgba);
 		virtual void addImageToArray(const Rect& rect, uint32_t id1, float const* st1, uint32_t id2, float const* st2, uint8_t alpha, uint8_t const* rgba);
 
-		virtual void addImageToArrayZ(uint32_t id, const Rect& rect, float vertexZ, float const* st, uint8_t alpha, uint8_t const* rgba);
+		virtual void addImageToArrayZ(uint32_t id, const Rect& rect, float vertexZ, float const* st, uint8_t alpha, uint8_t const* rgba, bool partialAlpha = true);
 		virtual void addImageToArrayZ(const Rect& rect, float vertexZ, uint32_t id1, float const* st1, uint32_t id2, float const* st2, uint8_t alpha, uint8_t const* rgba);
 
 		virtual void changeRenderInfos(RenderDataType type, uint16_t elements, int32_t src, int32_t dst, bool light, bool stentest, uint8_t stenref, GLConstants stenop, GLConstants stenfunc, OverlayType otype = OVERLAY_TYPE_NONE);
@@ -109,6 +110,12 @@ namespace FIFE {
 
 	protected:
 		virtual void setClipArea(const Rect& cliparea, bool clear);
+		virtual void readbackFrame(const std::string& filename, bool force);
+
+		/** Hands the finished read backs to the capturer.
+		 * @param all If false the read backs of the last frames are left alone, because mapping them would stall.
+		 */
+		void collectReadbacks(bool all);
 
 		void enableLighting();
 		void disableLighting();
@@ -137,11 +144,30 @@ namespace FIFE {
 		void renderWithZTest();
 		void renderWithColorAndZ();
 		void renderWithMultitextureAndZ();
+		/** Groups the opaque quads with z by texture. The depth buffer resolves their order,
+		 * so this saves texture binds and draw calls.
+		 */
+		void sortRenderObjectsZ();
+
+		/** Creates the buffer objects for the streamed vertex and index data and the static quad indices.
+		 * Disables the usage of buffer objects if the driver does not support them.
+		 */
+		void initBufferObjects();
+		void deleteBufferObjects();
+		/** Uploads the vertex and index data of the current flush into the stream buffers
+		 * and stores the pointers the render methods have to use.
+		 */
+		void streamVertexData();
+		/** Returns the pointer to the static quad indices and binds their buffer object if needed.
+		 */
+		const uint32_t* getQuadIndices();
 
 		class RenderObject;
 
 		struct RenderZObject {
 			GLuint texture_id;
+			// true if the texture has soft edges, these quads are blended in submission order
+			bool partial_alpha;
 			//uint32_t elements;
 		};
 
@@ -224,6 +250,12 @@ namespace FIFE {
 		// vertex data source for textured quads that do use depth buffer but no color/alpha - described by m_renderTextureObjectsZ
 		std::vector<renderDataZ> m_renderTextureDatasZ;
 		std::vector<RenderZObject> m_renderTextureObjectsZ;
+		// group texture id and quad index, used to group the quads above by texture
+		std::vector<std::pair<uint64_t, uint32_t> > m_sortKeysZ;
+		// depth and quad index, used to find quads with equal depth
+		std::vector<std::pair<float, uint32_t> > m_depthKeysZ;
+		std::vector<renderDataZ> m_sortedTextureDatasZ;
+		std::vector<RenderZObject> m_sortedTextureObjectsZ;
 
 		// vertex data source for textured quads that do use depth buffer and color/alpha - described by m_renderTextureColorObjectsZ
 		std::vector<renderDataColorZ> m_renderTextureColorDatasZ;
@@ -272,6 +304,69 @@ namespace FIFE {
 			bool color_enabled;
 		} m_state;
 
+		// part of the data that is streamed into a buffer object
+		struct StreamArray {
+			const void* data;
+			uint32_t size;
+		};
+
+		// buffer object that is filled like a ring and orphaned when it is full
+		struct StreamBuffer {
+			GLuint id;
+			GLenum target;
+			uint32_t size;
+			uint32_t offset;
+		};
+
+		template<typename T>
+		static StreamArray makeStreamArray(const std::vector<T>& data) {
+			StreamArray array = { data.empty() ? 0 : &data[0], static_cast<uint32_t>(data.size() * sizeof(T)) };
+			return array;
+		}
+
+		/** Copies the arrays with one mapping into the buffer and writes the pointers that
+		 * have to be used for them. Without buffer objects the client memory is used.
+		 */
+		void streamArrays(StreamBuffer& buffer, const StreamArray* arrays, uint32_t count, const uint8_t** pointers);
+
+		enum VertexStream {
+			VERTEX_STREAM_P,
+			VERTEX_STREAM_T,
+			VERTEX_STREAM_TC,
+			VERTEX_STREAM_2TC,
+			VERTEX_STREAM_Z,
+			VERTEX_STREAM_COLOR_Z,
+			VERTEX_STREAM_2TC_Z,
+			VERTEX_STREAM_COUNT
+		};
+
+		enum IndexStream {
+			INDEX_STREAM_P,
+			INDEX_STREAM_T,
+			INDEX_STREAM_TC,
+			INDEX_STREAM_2TC,
+			INDEX_STREAM_COUNT
+		};
+
+		StreamBuffer m_vertexStream;
+		StreamBuffer m_indexStream;
+		const uint8_t* m_vertexPointers[VERTEX_STREAM_COUNT];
+		const uint8_t* m_indexPointers[INDEX_STREAM_COUNT];
+
+		// frame read back into a pixel buffer object
+		struct PixelReadback {
+			GLuint buffer;
+			uint32_t frame;
+			uint32_t width;
+			uint32_t height;
+			bool force;
+			std::string filename;
+		};
+		std::deque<PixelReadback> m_readbacks;
+		// pixel buffer objects that are not in use
+		std::vector<GLuint> m_readbackBuffers;
+		uint32_t m_frameNumber;
+
 		GLuint m_fbo_id;
 		GLuint m_indicebufferId;
 		//! static indices for vertex data with z
@@ -20,6 +20,8 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <iomanip>
+#include <sstream>
 
 // 3rd party library includes
 
@@ -28,16 +30,20 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "renderbackend.h"
+#include "screencapturer.h"
 #include "video/devicecaps.h"
+#include "util/math/fife_math.h"
 
 namespace FIFE {
 	RenderBackend::RenderBackend(const SDL_Color& colorkey):
+		m_capturer(NULL),
 		m_window(NULL),
 		m_screen(NULL),
 		m_target(NULL),
 		m_compressimages(false),
 		m_useframebuffer(false),
 		m_usenpot(false),
+		m_usevbo(false),
 		m_isalphaoptimized(false),
 		m_iscolorkeyenabled(false),
 		m_colorkey(colorkey),
@@ -48,9 +54,17 @@ namespace FIFE {
 		m_isDepthBuffer(false),
 		m_alphaValue(0.3),
 		m_vSync(false),
+		m_drawCalls(0),
+		m_uploadedBytes(0),
+		m_textureBinds(0),
 		m_isframelimit(false),
 		m_frame_start(0),
-		m_framelimit(60) {
+		m_framelimit(60),
+		m_lastDrawCalls(0),
+		m_lastUploadedBytes(0),
+		m_lastTextureBinds(0),
+		m_captureFrames(false),
+		m_captureFrameNumber(0) {
 
 		m_isbackgroundcolor = false;
 		m_backgroundcolor.r = 0;
@@ -59,6 +73,7 @@ namespace FIFE {
 	}
 
 	RenderBackend::~RenderBackend() {
+		delete m_capturer;
 	}
 
 	void RenderBackend::deinit() {
@@ -73,6 +88,12 @@ namespace FIFE {
 	}
 
 	void RenderBackend::endFrame () {
+		m_lastDrawCalls = m_drawCalls;
+		m_lastUploadedBytes = m_uploadedBytes;
+		m_lastTextureBinds = m_textureBinds;
+		m_drawCalls = 0;
+		m_uploadedBytes = 0;
+		m_textureBinds = 0;
 		if (m_isframelimit) {
 			uint16_t frame_time = SDL_GetTicks() - m_frame_start;
 			const float frame_limit = 1000.0f/m_framelimit;
@@ -82,6 +103,95 @@ namespace FIFE {
 		}
 	}
 
+	uint32_t RenderBackend::getDrawCalls() const {
+		return m_lastDrawCalls;
+	}
+
+	uint32_t RenderBackend::getUploadedBytes() const {
+		return m_lastUploadedBytes;
+	}
+
+	uint32_t RenderBackend::getTextureBinds() const {
+		return m_lastTextureBinds;
+	}
+
+	void RenderBackend::captureScreenAsync(const std::string& filename) {
+		if (!m_capturer) {
+			m_capturer = new ScreenCapturer();
+		}
+		m_captureRequests.push_back(filename);
+	}
+
+	void RenderBackend::startFrameCapture(const std::string& prefix, uint32_t maxQueued) {
+		if (!m_capturer) {
+			m_capturer = new ScreenCapturer(maxQueued);
+		} else {
+			m_capturer->setMaxQueuedFrames(maxQueued);
+		}
+		m_capturePrefix = prefix;
+		m_captureFrames = true;
+		m_captureFrameNumber = 0;
+	}
+
+	void RenderBackend::stopFrameCapture() {
+		m_captureFrames = false;
+	}
+
+	bool RenderBackend::isCapturingFrames() const {
+		return m_captureFrames;
+	}
+
+	uint32_t RenderBackend::getCapturedFrames() const {
+		return m_capturer ? m_capturer->getSavedFrames() : 0;
+	}
+
+	uint32_t RenderBackend::getDroppedFrames() const {
+		return m_capturer ? m_capturer->getDroppedFrames() : 0;
+	}
+
+	uint32_t RenderBackend::getFailedFrames() const {
+		return m_capturer ? m_capturer->getFailedFrames() : 0;
+	}
+
+	void RenderBackend::processCaptures() {
+		std::vector<std::string>::iterator it = m_captureRequests.begin();
+		for (; it != m_captureRequests.end(); ++it) {
+			readbackFrame(*it, true);
+		}
+		m_captureRequests.clear();
+
+		if (m_captureFrames) {
+			std::ostringstream filename;
+			filename << m_capturePrefix << std::setw(6) << std::setfill('0') << m_captureFrameNumber << ".png";
+			++m_captureFrameNumber;
+			// a frame that can not be queued is not worth the read back
+			if (m_capturer->isFull()) {
+				m_capturer->addDroppedFrame();
+			} else {
+				readbackFrame(filename.str(), false);
+			}
+		}
+	}
+
+	const float* RenderBackend::getUnitCircle(int32_t subdivisions) {
+		std::map<int32_t, std::vector<float> >::iterator it = m_unitCircles.find(subdivisions);
+		if (it != m_unitCircles.end()) {
+			return &it->second[0];
+		}
+
+		std::vector<float>& circle = m_unitCircles[subdivisions];
+		circle.resize(2 * (subdivisions + 1));
+		const float step = Mathf::twoPi() / subdivisions;
+		for (int32_t i = 0; i < subdivisions; ++i) {
+			circle[2 * i] = Mathf::Cos(static_cast<float>(i) * step);
+			circle[2 * i + 1] = Mathf::Sin(static_cast<float>(i) * step);
+		}
+		// closes the circle without rounding errors
+		circle[2 * subdivisions] = circle[0];
+		circle[2 * subdivisions + 1] = circle[1];
+		return &circle[0];
+	}
+
 	const ScreenMode& RenderBackend::getCurrentScreenMode() const{
 		return m_screenMode;
 	}
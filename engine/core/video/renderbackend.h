@@ -23,6 +23,7 @@
 #define FIFE_VIDEO_RENDERBACKEND_H
 
 // Standard C++ library includes
+#include <map>
 #include <string>
 #include <vector>
 
@@ -52,6 +53,7 @@
 namespace FIFE {
 
 	class Image;
+	class ScreenCapturer;
 
 #ifdef HAVE_OPENGL
 	enum GLConstants {
@@ -230,6 +232,37 @@ namespace FIFE {
 		 */
 		virtual void captureScreen(const std::string& filename, uint32_t width, uint32_t height) = 0;
 
+		/** Creates a Screenshot without stalling the game. The pixels are read back at the
+		 * end of the frame and a worker thread saves them to the file.
+		 */
+		void captureScreenAsync(const std::string& filename);
+
+		/** Captures every frame into numbered files, prefix000000.png, prefix000001.png and so on.
+		 * The frames are saved by worker threads, if more than maxQueued frames wait
+		 * for saving further frames are dropped.
+		 */
+		void startFrameCapture(const std::string& prefix, uint32_t maxQueued = 8);
+
+		/** Stops the frame capture, the frames already captured are still saved.
+		 */
+		void stopFrameCapture();
+
+		/** Returns true if every frame is captured.
+		 */
+		bool isCapturingFrames() const;
+
+		/** Returns the number of captured frames that were saved.
+		 */
+		uint32_t getCapturedFrames() const;
+
+		/** Returns the number of frames that were dropped, because saving could not keep up.
+		 */
+		uint32_t getDroppedFrames() const;
+
+		/** Returns the number of captured frames that could not be saved.
+		 */
+		uint32_t getFailedFrames() const;
+
 		SDL_Window* getWindow() {return m_window; }
 
 		/** Get current screen mode
@@ -365,6 +398,28 @@ namespace FIFE {
 		 */
 		bool isNPOTEnabled() const { return m_usenpot; }
 
+		/** Enables or disable the usage of vertex and index buffer objects, if available.
+		 * The vertex data is then uploaded once per flush instead of being read from client memory by every draw call.
+		 * Note! Works only for OpenGL backend.
+		 */
+		void setVertexBufferObjectsEnabled(bool enabled) { m_usevbo = enabled; }
+
+		/** @see setVertexBufferObjectsEnabled
+		 */
+		bool isVertexBufferObjectsEnabled() const { return m_usevbo; }
+
+		/** Returns the number of draw calls of the last frame.
+		 */
+		uint32_t getDrawCalls() const;
+
+		/** Returns the number of bytes of vertex and index data, that were uploaded into buffer objects in the last frame.
+		 */
+		uint32_t getUploadedBytes() const;
+
+		/** Returns the number of texture binds of the last frame.
+		 */
+		uint32_t getTextureBinds() const;
+
 		/** Sets the texture filtering method.
 		 * Supports none, bilinear, trilinear and anisotropic filtering.
 		 * Note! Works only for OpenGL backends.
@@ -504,12 +559,33 @@ namespace FIFE {
 		 */
 		virtual void setClipArea(const Rect& cliparea, bool clear) = 0;
 
+		/** Reads back the requested captures, called by the backends before the frame is presented.
+		 */
+		void processCaptures();
+
+		/** Reads the pixels of the current frame back and hands them to the capturer.
+		 * @param filename The file the frame is saved to.
+		 * @param force If true the frame is not dropped, even if the capturer queue is full.
+		 */
+		virtual void readbackFrame(const std::string& filename, bool force) = 0;
+
+		/** Returns a unit circle divided into the given number of segments.
+		 * The array holds subdivisions + 1 interleaved cosine and sine pairs,
+		 * the pair at index i belongs to the angle i * 2pi / subdivisions.
+		 * The table is calculated once and reused by all primitives with the same subdivisions.
+		 */
+		const float* getUnitCircle(int32_t subdivisions);
+
+		// saves the captured frames, created with the first capture
+		ScreenCapturer* m_capturer;
+
 		SDL_Window* m_window;
 		SDL_Surface* m_screen;
 		SDL_Surface* m_target;
 		bool m_compressimages;
 		bool m_useframebuffer;
 		bool m_usenpot;
+		bool m_usevbo;
 		bool m_isalphaoptimized;
 		bool m_iscolorkeyenabled;
 		SDL_Color m_colorkey;
@@ -533,6 +609,12 @@ namespace FIFE {
 		float m_alphaValue;
 		// vsync value
 		bool m_vSync;
+		// draw calls of the current frame
+		uint32_t m_drawCalls;
+		// uploaded bytes of the current frame
+		uint32_t m_uploadedBytes;
+		// texture binds of the current frame
+		uint32_t m_textureBinds;
 
 		/** Clears any possible clip areas
 		 *  @see pushClipArea
@@ -551,6 +633,16 @@ namespace FIFE {
 		bool m_isframelimit;
 		uint32_t m_frame_start;
 		uint16_t m_framelimit;
+		uint32_t m_lastDrawCalls;
+		uint32_t m_lastUploadedBytes;
+		uint32_t m_lastTextureBinds;
+		// screenshots requested for the current frame
+		std::vector<std::string> m_captureRequests;
+		std::string m_capturePrefix;
+		bool m_captureFrames;
+		uint32_t m_captureFrameNumber;
+		// unit circles, key is the number of subdivisions
+		std::map<int32_t, std::vector<float> > m_unitCircles;
 		
 	};
 }
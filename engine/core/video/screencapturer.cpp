@@ -0,0 +1,203 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+
+// Platform specific includes
+
+// 3rd party library includes
+#include <SDL.h>
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/log/logger.h"
+
+#include "image.h"
+#include "screencapturer.h"
+
+namespace FIFE {
+	static Logger _log(LM_VIDEO);
+
+	ScreenCapturer::ScreenCapturer(uint32_t maxQueued, int32_t workers) :
+		m_maxQueued(std::max(maxQueued, 1u)),
+		m_busy(0),
+		m_quit(false),
+		m_saved(0),
+		m_failed(0),
+		m_dropped(0) {
+		if (workers < 0) {
+			// encoding is much slower than reading back, but leave a core for the game
+			uint32_t cores = std::thread::hardware_concurrency();
+			workers = std::min(std::max(cores, 2u) - 1, 2u);
+		}
+		for (int32_t i = 0; i < workers; ++i) {
+			m_workers.push_back(std::thread(&ScreenCapturer::run, this));
+		}
+	}
+
+	ScreenCapturer::~ScreenCapturer() {
+		if (m_workers.empty()) {
+			flush();
+			return;
+		}
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_condition.notify_all();
+		std::vector<std::thread>::iterator it = m_workers.begin();
+		for (; it != m_workers.end(); ++it) {
+			it->join();
+		}
+	}
+
+	bool ScreenCapturer::push(CaptureFrame* frame, bool force) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!force && m_queue.size() >= m_maxQueued) {
+				++m_dropped;
+				delete frame;
+				return false;
+			}
+			m_queue.push_back(frame);
+		}
+		m_condition.notify_one();
+		return true;
+	}
+
+	bool ScreenCapturer::isFull() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_queue.size() >= m_maxQueued;
+	}
+
+	void ScreenCapturer::addDroppedFrame() {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		++m_dropped;
+	}
+
+	void ScreenCapturer::setMaxQueuedFrames(uint32_t maxQueued) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_maxQueued = std::max(maxQueued, 1u);
+	}
+
+	void ScreenCapturer::flush() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_workers.empty()) {
+			while (!m_queue.empty()) {
+				saveNext(lock);
+			}
+			return;
+		}
+		while (!m_queue.empty() || m_busy > 0) {
+			m_idle.wait(lock);
+		}
+	}
+
+	uint32_t ScreenCapturer::getSavedFrames() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_saved;
+	}
+
+	uint32_t ScreenCapturer::getFailedFrames() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_failed;
+	}
+
+	uint32_t ScreenCapturer::getDroppedFrames() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_dropped;
+	}
+
+	uint32_t ScreenCapturer::getQueuedFrames() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_queue.size();
+	}
+
+	void ScreenCapturer::run() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true) {
+			if (m_queue.empty()) {
+				// queued frames are saved before quitting
+				if (m_quit) {
+					break;
+				}
+				m_condition.wait(lock);
+				continue;
+			}
+			saveNext(lock);
+		}
+	}
+
+	void ScreenCapturer::saveNext(std::unique_lock<std::mutex>& lock) {
+		CaptureFrame* frame = m_queue.front();
+		m_queue.pop_front();
+		++m_busy;
+
+		lock.unlock();
+		bool saved = save(*frame);
+		delete frame;
+		lock.lock();
+
+		--m_busy;
+		if (saved) {
+			++m_saved;
+		} else {
+			++m_failed;
+		}
+		if (m_queue.empty() && m_busy == 0) {
+			m_idle.notify_all();
+		}
+	}
+
+	bool ScreenCapturer::save(const CaptureFrame& frame) {
+		SDL_Surface* surface = SDL_CreateRGBSurface(0, frame.width, frame.height, 24,
+			RMASK, GMASK, BMASK, NULLMASK);
+
+		if (!surface) {
+			FL_WARN(_log, LMsg("ScreenCapturer") << "Could not create surface for " << frame.filename);
+			return false;
+		}
+
+		SDL_LockSurface(surface);
+		const uint32_t rowSize = frame.width * 3;
+		uint8_t* imagepixels = reinterpret_cast<uint8_t*>(surface->pixels);
+		for (uint32_t y = 0; y < frame.height; ++y) {
+			// OpenGL reads the rows bottom up
+			const uint32_t row = frame.flipped ? frame.height - 1 - y : y;
+			const uint8_t* rowbegin = &frame.pixels[row * rowSize];
+			std::copy(rowbegin, rowbegin + rowSize, imagepixels);
+
+			// Advance a row in the output surface.
+			imagepixels += surface->pitch;
+		}
+		SDL_UnlockSurface(surface);
+
+		bool saved = Image::saveAsPng(frame.filename, *surface);
+		SDL_FreeSurface(surface);
+		if (!saved) {
+			FL_WARN(_log, LMsg("ScreenCapturer") << "Could not save " << frame.filename);
+		}
+		return saved;
+	}
+}
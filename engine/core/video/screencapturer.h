@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+#ifndef FIFE_VIDEO_SCREENCAPTURER_H
+#define FIFE_VIDEO_SCREENCAPTURER_H
+
+// Standard C++ library includes
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Platform specific includes
+#include "util/base/fife_stdint.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+
+namespace FIFE {
+
+	/** Pixels of a captured frame, waiting to be saved.
+	 */
+	struct CaptureFrame {
+		//! file the frame is saved to
+		std::string filename;
+		//! tightly packed RGB pixels
+		std::vector<uint8_t> pixels;
+		uint32_t width;
+		uint32_t height;
+		//! true if the rows are stored bottom up, like OpenGL reads them
+		bool flipped;
+	};
+
+	/** Saves captured frames as PNG files on worker threads.
+	 *
+	 * The render backends only read the pixels back, flipping and encoding
+	 * is done by the workers. The queue is bounded, frames of a sequence
+	 * are dropped and counted if the workers can not keep up. Without workers
+	 * the frames wait until flush() or the destructor saves them.
+	 */
+	class ScreenCapturer {
+	public:
+		/** Constructor
+		 * @param maxQueued Number of frames that can wait for encoding.
+		 * @param workers Number of worker threads, -1 uses up to two cores but leaves one for the game.
+		 */
+		ScreenCapturer(uint32_t maxQueued = 8, int32_t workers = -1);
+
+		/** Destructor, saves the frames that are still queued.
+		 */
+		~ScreenCapturer();
+
+		/** Queues the frame for saving, the capturer takes the ownership.
+		 * @param frame The frame to save.
+		 * @param force If true the frame is queued even if the queue is full.
+		 * @return False if the frame was dropped.
+		 */
+		bool push(CaptureFrame* frame, bool force = false);
+
+		/** Returns true if a frame pushed without force would be dropped.
+		 * Allows to skip the read back of frames that can not be queued.
+		 */
+		bool isFull() const;
+
+		/** Counts a frame that was dropped before it was read back.
+		 */
+		void addDroppedFrame();
+
+		/** Sets the number of frames that can wait for encoding.
+		 */
+		void setMaxQueuedFrames(uint32_t maxQueued);
+
+		/** Blocks until all queued frames are saved.
+		 * Without workers the frames are saved on the calling thread.
+		 */
+		void flush();
+
+		/** Returns the number of saved frames.
+		 */
+		uint32_t getSavedFrames() const;
+
+		/** Returns the number of frames that could not be saved.
+		 */
+		uint32_t getFailedFrames() const;
+
+		/** Returns the number of dropped frames.
+		 */
+		uint32_t getDroppedFrames() const;
+
+		/** Returns the number of frames waiting for encoding.
+		 */
+		uint32_t getQueuedFrames() const;
+
+	private:
+		void run();
+		//! saves the first queued frame, the lock is released while saving
+		void saveNext(std::unique_lock<std::mutex>& lock);
+		bool save(const CaptureFrame& frame);
+
+		std::vector<std::thread> m_workers;
+		mutable std::mutex m_mutex;
+		std::condition_variable m_condition;
+		std::condition_variable m_idle;
+		std::deque<CaptureFrame*> m_queue;
+		uint32_t m_maxQueued;
+		//! frames currently encoded by the workers
+		uint32_t m_busy;
+		bool m_quit;
+
+		uint32_t m_saved;
+		uint32_t m_failed;
+		uint32_t m_dropped;
+	};
+}
+
+#endif
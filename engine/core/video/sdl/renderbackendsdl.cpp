@@ -32,6 +32,7 @@
 #include "util/math/fife_math.h"
 #include "util/log/logger.h"
 #include "video/devicecaps.h"
+#include "video/screencapturer.h"
 
 #include "renderbackendsdl.h"
 #include "sdlimage.h"
@@ -176,6 +177,7 @@ namespace FIFE {
 	}
 
 	void RenderBackendSDL::endFrame() {
+		processCaptures();
 		SDL_RenderPresent(m_renderer);
 		RenderBackend::endFrame();
 	}
@@ -448,7 +450,8 @@ namespace FIFE {
 	}
 
 	void RenderBackendSDL::drawCircleSegment(const Point& p, uint32_t radius, int32_t sangle, int32_t eangle, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-		const float step = Mathf::twoPi() / 360;
+		// one segment per degree
+		const float* circle = getUnitCircle(360);
 		int32_t s = (sangle + 360) % 360;
 		int32_t e = (eangle + 360) % 360;
 		if (e == 0) {
@@ -458,17 +461,17 @@ namespace FIFE {
 			return;
 		}
 
-		float angle = static_cast<float>(s) * step;
-		Point oldPoint(radius * Mathf::Cos(angle) + p.x, radius * Mathf::Sin(angle) + p.y);
-		for (;s <= e; ++s, angle += step) {
-			Point newPoint(radius * Mathf::Cos(angle) + p.x, radius * Mathf::Sin(angle) + p.y);
+		Point oldPoint(radius * circle[2*s] + p.x, radius * circle[2*s+1] + p.y);
+		for (;s <= e; ++s) {
+			Point newPoint(radius * circle[2*s] + p.x, radius * circle[2*s+1] + p.y);
 			drawLine(oldPoint, newPoint, r, g, b, a);
 			oldPoint = newPoint;
 		}
 	}
 
 	void RenderBackendSDL::drawFillCircleSegment(const Point& p, uint32_t radius, int32_t sangle, int32_t eangle, uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
-		const float step = Mathf::twoPi() / 360;
+		// one segment per degree
+		const float* circle = getUnitCircle(360);
 		int32_t s = (sangle + 360) % 360;
 		int32_t e = (eangle + 360) % 360;
 		if (e == 0) {
@@ -482,16 +485,14 @@ namespace FIFE {
 		points.push_back(p);
 		int32_t yMax = p.y;
 		int32_t yMin = p.y;
-		float angle = static_cast<float>(s) * step;
-		for (;s <= e; ++s, angle += step) {
-			Point newPoint(radius * Mathf::Cos(angle) + p.x, radius * Mathf::Sin(angle) + p.y);
+		for (;s <= e; ++s) {
+			Point newPoint(radius * circle[2*s] + p.x, radius * circle[2*s+1] + p.y);
 			yMax = std::max(yMax, newPoint.y);
 			yMin = std::min(yMin, newPoint.y);
 			points.push_back(newPoint);
 		}
 		// add end point (again)
-		angle = static_cast<float>(e) * step;
-		Point newPoint(radius * Mathf::Cos(angle) + p.x, radius * Mathf::Sin(angle) + p.y);
+		Point newPoint(radius * circle[2*e] + p.x, radius * circle[2*e+1] + p.y);
 		points.push_back(newPoint);
 		yMax = std::max(yMax, newPoint.y);
 		yMin = std::min(yMin, newPoint.y);
@@ -552,6 +553,21 @@ namespace FIFE {
 		}
 	}
 
+	void RenderBackendSDL::readbackFrame(const std::string& filename, bool force) {
+		CaptureFrame* frame = new CaptureFrame();
+		frame->filename = filename;
+		frame->width = getWidth();
+		frame->height = getHeight();
+		frame->flipped = false;
+		frame->pixels.resize(frame->width * frame->height * 3);
+		if (SDL_RenderReadPixels(m_renderer, NULL, SDL_PIXELFORMAT_RGB24, &frame->pixels[0], frame->width * 3) != 0) {
+			FL_WARN(_log, LMsg("RenderBackendSDL") << "Could not read back the frame: " << SDL_GetError());
+			delete frame;
+			return;
+		}
+		m_capturer->push(frame, force);
+	}
+
 	void RenderBackendSDL::captureScreen(const std::string& filename, uint32_t width, uint32_t height) {
 		if(m_screen) {
 			const uint32_t swidth = getWidth();
@@ -100,6 +100,7 @@ namespace FIFE {
 		
 	protected:
 		virtual void setClipArea(const Rect& cliparea, bool clear);
+		virtual void readbackFrame(const std::string& filename, bool force);
 
 		SDL_Renderer* m_renderer;
 	};
@@ -108,6 +108,7 @@ namespace FIFE {
 			rect.bottom() < 0 || rect.y > static_cast<int32_t>(target->h)) {
 			return;
 		}
+		touch();
 
 		SDL_Rect tarRect;
 		tarRect.x = rect.x;
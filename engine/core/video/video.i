@@ -29,6 +29,7 @@
 #include "video/renderbackend.h"
 #include "video/devicecaps.h"
 #include "video/atlasbook.h"
+#include "video/atlaspacker.h"
 #include "video/color.h"
 #include "util/base/sharedptr.h"
 #include "util/base/exception.h"
@@ -129,6 +130,14 @@ namespace FIFE {
 		virtual void invalidate(const std::string& name);
 		virtual void invalidate(ResourceHandle handle);
 		virtual void invalidateAll();
+
+		void setMemoryBudget(size_t budget);
+		size_t getMemoryBudget() const;
+		void enforceMemoryBudget();
+		size_t getEvictionCount() const;
+		size_t getEvictedBytes() const;
+		size_t getLastEvictionCount() const;
+		void resetEvictionStatistics();
 	};
 	
 	class Animation: public IResource {
@@ -208,6 +217,13 @@ namespace FIFE {
 		
 		void captureScreen(const std::string& filename);
 		void captureScreen(const std::string& filename, uint32_t width, uint32_t height);
+		void captureScreenAsync(const std::string& filename);
+		void startFrameCapture(const std::string& prefix, uint32_t maxQueued = 8);
+		void stopFrameCapture();
+		bool isCapturingFrames() const;
+		uint32_t getCapturedFrames() const;
+		uint32_t getDroppedFrames() const;
+		uint32_t getFailedFrames() const;
 		const ScreenMode& getCurrentScreenMode() const;
 		uint32_t getWidth() const;
 		uint32_t getHeight() const;
@@ -223,6 +239,8 @@ namespace FIFE {
 		bool isFramebufferEnabled() const;
 		void setNPOTEnabled(bool enabled);
 		bool isNPOTEnabled() const;
+		void setVertexBufferObjectsEnabled(bool enabled);
+		bool isVertexBufferObjectsEnabled() const;
 		void setTextureFiltering(TextureFiltering filter);
 		TextureFiltering getTextureFiltering() const;
 		void setMipmappingEnabled(bool enabled);
@@ -242,6 +260,9 @@ namespace FIFE {
 		bool isFrameLimitEnabled() const;
 		void setFrameLimit(uint16_t framelimit);
 		uint16_t getFrameLimit() const;
+		uint32_t getDrawCalls() const;
+		uint32_t getUploadedBytes() const;
+		uint32_t getTextureBinds() const;
 	};
 	
 	enum MouseCursorType {
@@ -357,6 +378,7 @@ namespace FIFE {
 
 		AtlasBlock intersects(AtlasBlock const& rect) const;
 		void merge(AtlasBlock const& rect);
+		bool contains(AtlasBlock const& rect) const;
 	};	
 	
 	class AtlasBook {
@@ -365,6 +387,8 @@ namespace FIFE {
 
 		AtlasBlock* getBlock(uint32_t width, uint32_t height);
 		void shrink(bool pot);
+		size_t getPageCount() const;
+		float getOccupancy() const;
 	};
 	
 	%extend AtlasBook {
@@ -375,6 +399,26 @@ namespace FIFE {
 			return $self->getPage(index).getHeight();
 		}
 	}
+
+	class AtlasPacker {
+	public:
+		AtlasPacker(const std::string& name, uint32_t pageWidth = 1024, uint32_t pageHeight = 1024);
+		~AtlasPacker();
+
+		bool addImage(const ImagePtr& image);
+		uint32_t addAnimation(const AnimationPtr& animation);
+		void pack(bool pot = true);
+
+		const std::string& getName() const;
+		uint32_t getPageCount() const;
+		ImagePtr getPage(uint32_t index) const;
+		uint32_t getImageCount() const;
+		ImagePtr getImage(uint32_t index) const;
+		uint32_t getImagePage(uint32_t index) const;
+		const Rect& getImageRegion(uint32_t index) const;
+		float getOccupancy() const;
+		uint32_t getSourceTextureCount() const;
+	};
 	
 	class Color {
 	public:
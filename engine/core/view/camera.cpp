@@ -39,6 +39,7 @@
 #include "util/log/logger.h"
 #include "util/math/fife_math.h"
 #include "util/math/angles.h"
+#include "util/time/profiler.h"
 #include "util/time/timemanager.h"
 #include "video/renderbackend.h"
 #include "video/image.h"
@@ -104,6 +105,7 @@ namespace FIFE {
 		m_renderers(),
 		m_pipeline(),
 		m_updated(false),
+		m_matrixRevision(0),
 		m_layerToInstances(),
 		m_lighting(false),
 		m_light_colors(),
@@ -366,6 +368,7 @@ namespace FIFE {
 	}
 
 	void Camera::updateMatrices() {
+		++m_matrixRevision;
 		m_matrix.loadScale(m_referenceScaleX, m_referenceScaleY, m_referenceScaleX);
 		m_vs_matrix.loadScale(m_referenceScaleX, m_referenceScaleY, m_referenceScaleX);
 
@@ -931,11 +934,11 @@ namespace FIFE {
 				for (uint8_t i = 0; i < batches; ++i) {
 					uint32_t start = i*MAX_BATCH_SIZE;
 					uint32_t end = start + ((i+1 == batches) ? residual : MAX_BATCH_SIZE);
-					RenderList tempList(instancesToRender.begin() + start, instancesToRender.begin() + end);
+					m_batchList.assign(instancesToRender.begin() + start, instancesToRender.begin() + end);
 					std::list<RendererBase*>::iterator r_it = m_pipeline.begin();
 					for (; r_it != m_pipeline.end(); ++r_it) {
 						if ((*r_it)->isActivedLayer(layer)) {
-							(*r_it)->render(this, layer, tempList);
+							(*r_it)->render(this, layer, m_batchList);
 							m_renderbackend->renderVertexArrays();
 						}
 					}
@@ -955,6 +958,7 @@ namespace FIFE {
 	}
 
 	void Camera::updateRenderLists() {
+		FIFE_PROFILE_ZONE("Camera::updateRenderLists");
 		if (!m_map) {
 			FL_ERR(_log, "No map for camera found");
 			return;
@@ -979,6 +983,7 @@ namespace FIFE {
 	}
 
 	void Camera::render() {
+		FIFE_PROFILE_ZONE("Camera::render");
 		updateRenderLists();
 
 		if (!m_map) {
@@ -1021,11 +1026,12 @@ namespace FIFE {
 				for (uint8_t i = 0; i < batches; ++i) {
 					uint32_t start = i*MAX_BATCH_SIZE;
 					uint32_t end = start + ((i+1 == batches) ? residual : MAX_BATCH_SIZE);
-					RenderList tempList(instancesToRender.begin() + start, instancesToRender.begin() + end);
+					m_batchList.assign(instancesToRender.begin() + start, instancesToRender.begin() + end);
 					std::list<RendererBase*>::iterator r_it = m_pipeline.begin();
 					for (; r_it != m_pipeline.end(); ++r_it) {
 						if ((*r_it)->isActivedLayer(*layer_it)) {
-							(*r_it)->render(this, *layer_it, tempList);
+							FIFE_PROFILE_ZONE((*r_it)->getProfileName());
+							(*r_it)->render(this, *layer_it, m_batchList);
 							m_renderbackend->renderVertexArrays();
 						}
 					}
@@ -1034,6 +1040,7 @@ namespace FIFE {
 				std::list<RendererBase*>::iterator r_it = m_pipeline.begin();
 				for (; r_it != m_pipeline.end(); ++r_it) {
 					if ((*r_it)->isActivedLayer(*layer_it)) {
+						FIFE_PROFILE_ZONE((*r_it)->getProfileName());
 						(*r_it)->render(this, *layer_it, instancesToRender);
 						m_renderbackend->renderVertexArrays();
 					}
@@ -333,6 +333,11 @@ namespace FIFE {
 		 */
 		bool isUpdated() { return m_updated; }
 
+		/** Returns a number that changes whenever the transformation from map to screen coordinates changes.
+		 * Allows renderers to keep screen coordinates between frames.
+		 */
+		uint32_t getMatrixRevision() const { return m_matrixRevision; }
+
 		/** Adds new renderer on the view. Ownership is transferred to the camera.
 		 */
 		void addRenderer(RendererBase* renderer);
@@ -488,9 +493,13 @@ namespace FIFE {
 		std::list<RendererBase*> m_pipeline;
 		// false, if view has not been updated
 		bool m_updated;
+		// incremented by updateMatrices
+		uint32_t m_matrixRevision;
 
 		// caches layer -> instances structure between renders e.g. to fast query of mouse picking order
 		t_layer_to_instances m_layerToInstances;
+		// part of a layer's instances handed to the renderers, kept to reuse the memory
+		RenderList m_batchList;
 
 		std::map<Layer*,LayerCache*> m_cache;
 		MapObserver* m_map_observer;
@@ -38,6 +38,7 @@
 #include "util/log/logger.h"
 #include "util/math/fife_math.h"
 #include "util/math/angles.h"
+#include "util/time/profiler.h"
 #include "video/renderbackend.h"
 #include "video/image.h"
 #include "video/animation.h"
@@ -256,6 +257,7 @@ namespace FIFE {
 			m_entries.push_back(entry);
 			entry->instanceIndex = m_renderItems.size() - 1;
 			entry->entryIndex = m_entries.size() - 1;
+			entry->updateIndex = -1;
 		} else {
 			// uses free/unused RenderItem
 			int32_t index = m_freeEntries.front();
@@ -274,7 +276,7 @@ namespace FIFE {
 		entry->visible = true;
 		entry->updateInfo = EntryFullUpdate;
 
-		m_entriesToUpdate.insert(entry->entryIndex);
+		queueEntry(entry);
 	}
 
 	void LayerCache::removeInstance(Instance* instance) {
@@ -284,10 +286,7 @@ namespace FIFE {
 		assert(entry->instanceIndex == m_instance_map[instance]);
 		RenderItem* item = m_renderItems[entry->instanceIndex];
 		// removes entry from updates
-		std::set<int32_t>::iterator it = m_entriesToUpdate.find(entry->entryIndex);
-		if (it != m_entriesToUpdate.end()) {
-			m_entriesToUpdate.erase(it);
-		}
+		unqueueEntry(entry);
 		// removes entry from CacheTree
 		if (entry->node) {
 			entry->node->data().erase(entry->entryIndex);
@@ -333,15 +332,34 @@ namespace FIFE {
 		// if entry is not already inserted
 		if (!entry->forceUpdate && entry->updateInfo != EntryNoneUpdate) {
 			entry->forceUpdate = true;
-			m_entriesToUpdate.insert(entry->entryIndex);
+			queueEntry(entry);
+		}
+	}
+
+	void LayerCache::queueEntry(Entry* entry) {
+		if (entry->updateIndex == -1) {
+			entry->updateIndex = m_entriesToUpdate.size();
+			m_entriesToUpdate.push_back(entry->entryIndex);
+		}
+	}
+
+	void LayerCache::unqueueEntry(Entry* entry) {
+		if (entry->updateIndex == -1) {
+			return;
 		}
+		// moves the last queued entry into the free slot
+		int32_t last = m_entriesToUpdate.back();
+		m_entriesToUpdate[entry->updateIndex] = last;
+		m_entries[last]->updateIndex = entry->updateIndex;
+		m_entriesToUpdate.pop_back();
+		entry->updateIndex = -1;
 	}
 
 	class CacheTreeCollector {
-			std::vector<int32_t>& m_indices;
+			FrameVector<int32_t>& m_indices;
 			Rect m_viewport;
 		public:
-			CacheTreeCollector(std::vector<int32_t>& indices, const Rect& viewport)
+			CacheTreeCollector(FrameVector<int32_t>& indices, const Rect& viewport)
 			: m_indices(indices), m_viewport(viewport) {
 			}
 			bool visit(LayerCache::CacheTree::Node* node, int32_t d = -1);
@@ -355,7 +373,7 @@ namespace FIFE {
 		return true;
 	}
 
-	void LayerCache::collect(const Rect& viewport, std::vector<int32_t>& index_list) {
+	void LayerCache::collect(const Rect& viewport, FrameVector<int32_t>& index_list) {
 		CacheTree::Node * node = m_tree->find_container(viewport);
 		CacheTreeCollector collector(index_list, viewport);
 		node->apply_visitor(collector);
@@ -367,14 +385,17 @@ namespace FIFE {
 	}
 
 	void LayerCache::update(Camera::Transform transform, RenderList& renderlist) {
+		FIFE_PROFILE_ZONE("LayerCache::update");
+		FrameArenaScope scratch;
 		// this is only a bit faster, but works without this block too.
 		if(!m_layer->areInstancesVisible()) {
 			FL_DBG(_log, "Layer instances hidden");
-			std::set<int32_t>::const_iterator entry_it = m_entriesToUpdate.begin();
+			std::vector<int32_t>::const_iterator entry_it = m_entriesToUpdate.begin();
 			for (; entry_it != m_entriesToUpdate.end(); ++entry_it) {
 				Entry* entry = m_entries[*entry_it];
 				entry->forceUpdate = false;
 				entry->visible = false;
+				entry->updateIndex = -1;
 			}
 			m_entriesToUpdate.clear();
 			renderlist.clear();
@@ -383,13 +404,13 @@ namespace FIFE {
 		// if transform is none then we have only to update the instances with an update info.
 		if (transform == Camera::NoneTransform) {
 			if (!m_entriesToUpdate.empty()) {
-				std::set<int32_t> entryToRemove;
+				FrameVector<int32_t> entryToRemove;
 				updateEntries(entryToRemove, renderlist);
 				//std::cout << "update entries: " << int32_t(m_entriesToUpdate.size()) << " remove entries: " << int32_t(entryToRemove.size()) <<"\n";
 				if (!entryToRemove.empty()) {
-					std::set<int32_t>::iterator entry_it = entryToRemove.begin();
+					FrameVector<int32_t>::iterator entry_it = entryToRemove.begin();
 					for (; entry_it != entryToRemove.end(); ++entry_it) {
-						m_entriesToUpdate.erase(*entry_it);
+						unqueueEntry(m_entries[*entry_it]);
 					}
 				}
 			}
@@ -421,7 +442,7 @@ namespace FIFE {
 			m_zMax = 0.0;
 
 			// FL_LOG(_log, LMsg("camera-update viewport") << viewport);
-			std::vector<int32_t> index_list;
+			FrameVector<int32_t> index_list;
 			collect(viewport, index_list);
 			// fill renderlist
 			for (uint32_t i = 0; i != index_list.size(); ++i) {
@@ -441,11 +462,12 @@ namespace FIFE {
 			} else {
 				// calculates zmin and zmax of the current viewport
 				Rect r = m_camera->getMapViewPort();
-				std::vector<ExactModelCoordinate> coords;
-				coords.push_back(ExactModelCoordinate(r.x, r.y));
-				coords.push_back(ExactModelCoordinate(r.x, r.y+r.h));
-				coords.push_back(ExactModelCoordinate(r.x+r.w, r.y));
-				coords.push_back(ExactModelCoordinate(r.x+r.w, r.y+r.h));
+				const ExactModelCoordinate coords[] = {
+					ExactModelCoordinate(r.x, r.y),
+					ExactModelCoordinate(r.x, r.y+r.h),
+					ExactModelCoordinate(r.x+r.w, r.y),
+					ExactModelCoordinate(r.x+r.w, r.y+r.h)
+				};
 				for (uint8_t i = 0; i < 4; ++i) {
 					double z = m_camera->toVirtualScreenCoordinates(coords[i]).z;
 					m_zMin = std::min(z, m_zMin);
@@ -468,11 +490,11 @@ namespace FIFE {
 					if (force && !entry->forceUpdate) {
 						// no action
 						entry->updateInfo = EntryNoneUpdate;
-						m_entriesToUpdate.erase(entry->entryIndex);
+						unqueueEntry(entry);
 					} else if (!force && entry->forceUpdate) {
 						// new action
 						entry->updateInfo |= EntryVisualUpdate;
-						m_entriesToUpdate.insert(entry->entryIndex);
+						queueEntry(entry);
 					}
 				}
 				updatePosition(entry);
@@ -491,7 +513,7 @@ namespace FIFE {
 					if (!entry->forceUpdate) {
 						// no action
 						entry->updateInfo = EntryNoneUpdate;
-						m_entriesToUpdate.erase(entry->entryIndex);
+						unqueueEntry(entry);
 					}
 					continue;
 				}
@@ -500,16 +522,17 @@ namespace FIFE {
 		}
 	}
 
-	void LayerCache::updateEntries(std::set<int32_t>& removes, RenderList& renderlist) {
-		RenderList needSorting;
+	void LayerCache::updateEntries(FrameVector<int32_t>& removes, RenderList& renderlist) {
+		RenderList& needSorting = m_sortItems;
+		needSorting.clear();
 		Rect viewport = m_camera->getViewPort();
-		std::set<int32_t>::const_iterator entry_it = m_entriesToUpdate.begin();
+		std::vector<int32_t>::const_iterator entry_it = m_entriesToUpdate.begin();
 		for (; entry_it != m_entriesToUpdate.end(); ++entry_it) {
 			Entry* entry = m_entries[*entry_it];
 			entry->forceUpdate = false;
 			if (entry->instanceIndex == -1) {
 				entry->updateInfo = EntryNoneUpdate;
-				removes.insert(*entry_it);
+				removes.push_back(*entry_it);
 				continue;
 			}
 			RenderItem* item = m_renderItems[entry->instanceIndex];
@@ -544,7 +567,7 @@ namespace FIFE {
 			if (!entry->forceUpdate) {
 				entry->forceUpdate = false;
 				entry->updateInfo = EntryNoneUpdate;
-				removes.insert(*entry_it);
+				removes.push_back(*entry_it);
 			} else {
 				entry->updateInfo = EntryVisualUpdate;
 			}
@@ -750,6 +773,7 @@ namespace FIFE {
 	}
 
 	void LayerCache::sortRenderList(RenderList& renderlist) {
+		FIFE_PROFILE_ZONE("LayerCache::sortRenderList");
 		if (renderlist.empty()) {
 			return;
 		}
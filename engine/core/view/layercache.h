@@ -34,6 +34,7 @@
 // First block: files included from the FIFE root src directory
 // Second block: files included from the same folder
 #include "model/structures/location.h"
+#include "util/base/framearena.h"
 #include "util/math/matrix.h"
 #include "util/structures/rect.h"
 #include "util/structures/quadtree.h"
@@ -80,6 +81,8 @@ namespace FIFE {
 			int32_t instanceIndex;
 			// Index in m_entries;
 			int32_t entryIndex;
+			// Index in m_entriesToUpdate, -1 if the entry is not queued
+			int32_t updateIndex;
 			// Force update for entries with animation
 			bool forceUpdate;
 			// Is visible
@@ -88,11 +91,13 @@ namespace FIFE {
 			RenderEntryUpdate updateInfo;
 		};
 
-		void collect(const Rect& viewport, std::vector<int32_t>& indices);
+		void collect(const Rect& viewport, FrameVector<int32_t>& indices);
 		void reset();
 		void fullUpdate(Camera::Transform transform);
 		void fullCoordinateUpdate(Camera::Transform transform);
-		void updateEntries(std::set<int32_t>& removes, RenderList& renderlist);
+		void updateEntries(FrameVector<int32_t>& removes, RenderList& renderlist);
+		void queueEntry(Entry* entry);
+		void unqueueEntry(Entry* entry);
 		bool updateVisual(Entry* entry);
 		void updatePosition(Entry* entry);
 		void updateScreenCoordinate(RenderItem* item, bool changedZoom = true);
@@ -107,7 +112,10 @@ namespace FIFE {
 		std::map<Instance*, int32_t> m_instance_map;
 		std::vector<Entry*> m_entries;
 		std::vector<RenderItem*> m_renderItems;
-		std::set<int32_t> m_entriesToUpdate;
+		// entries that need an update, unordered, see Entry::updateIndex
+		std::vector<int32_t> m_entriesToUpdate;
+		// items of updateEntries that need sorting, kept to reuse the memory
+		RenderList m_sortItems;
 		std::deque<int32_t> m_freeEntries;
 
 		bool m_needSorting;
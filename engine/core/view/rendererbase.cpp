@@ -30,6 +30,7 @@
 #include "model/structures/layer.h"
 #include "model/structures/map.h"
 #include "util/log/logger.h"
+#include "util/time/profiler.h"
 #include "rendererbase.h"
 
 namespace FIFE {
@@ -42,7 +43,8 @@ namespace FIFE {
 		m_renderbackend(renderbackend),
 		m_enabled(false),
 		m_pipeline_position(DEFAULT_RENDERER_POSITION),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_profileName(NULL) {
 		setPipelinePosition(position);
 	}
 	
@@ -50,7 +52,8 @@ namespace FIFE {
 		m_renderbackend(old.m_renderbackend),
 		m_enabled(old.m_enabled),
 		m_pipeline_position(old.m_pipeline_position),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_profileName(NULL) {
 		setPipelinePosition(old.m_pipeline_position);
 	}
 	
@@ -58,7 +61,15 @@ namespace FIFE {
 		m_renderbackend(NULL),
 		m_enabled(false),
 		m_pipeline_position(DEFAULT_RENDERER_POSITION),
-		m_listener(NULL) {
+		m_listener(NULL),
+		m_profileName(NULL) {
+	}
+	
+	const char* RendererBase::getProfileName() {
+		if (!m_profileName) {
+			m_profileName = Profiler::intern(getName());
+		}
+		return m_profileName;
 	}
 	
 	void RendererBase::setPipelinePosition(int32_t position) { 
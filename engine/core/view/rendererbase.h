@@ -111,6 +111,10 @@ namespace FIFE {
 		/** Name of the renderer
 		 */
 		virtual std::string getName() = 0;
+
+		/** Name of the renderer for profiler zones, stays valid until the process ends.
+		 */
+		const char* getProfileName();
 		
 		/** Gets renderer position in the rendering pipeline
 		 */
@@ -174,6 +178,8 @@ namespace FIFE {
 		bool m_enabled;
 		int32_t m_pipeline_position;
 		IRendererListener* m_listener;
+		// interned getName(), set on the first getProfileName() call
+		const char* m_profileName;
 	};
 }
 
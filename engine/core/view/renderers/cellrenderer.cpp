@@ -184,15 +184,14 @@ namespace FIFE {
 			for (; it != m_visualPaths.end(); ++it) {
 				Route* route = (*it)->getRoute();
 				if (route) {
-					Path path = route->getPath();
+					const CellPath& path = route->getCellPath();
 					if (!path.empty()) {
-						Path::iterator pit = path.begin();
-						for (; pit != path.end(); ++pit) {
-							if ((*pit).getLayer() != layer) {
+						for (uint32_t i = 0; i < path.size(); ++i) {
+							if (path.getLayer(i) != layer) {
 								continue;
 							}
 							std::vector<ExactModelCoordinate> vertices;
-							cg->getVertices(vertices, (*pit).getLayerCoordinates());
+							cg->getVertices(vertices, path.getLayerCoordinates(i));
 							std::vector<ExactModelCoordinate>::const_iterator it = vertices.begin();
 							int32_t halfind = vertices.size() / 2;
 							ScreenPoint firstpt = cam->toScreenCoordinates(cg->toMapCoordinates(*it));
@@ -20,6 +20,7 @@
  ***************************************************************************/
 
 // Standard C++ library includes
+#include <algorithm>
 
 // 3rd party library includes
 
@@ -51,6 +52,23 @@ namespace FIFE {
 	 */
 	static Logger _log(LM_VIEWVIEW);
 
+	/** Returns true if the bounding box of the points, enlarged by border, intersects the viewport.
+	 */
+	static bool isVisible(const Rect& viewport, const Point* points, uint32_t count, int32_t border = 0) {
+		int32_t minX = points[0].x;
+		int32_t maxX = points[0].x;
+		int32_t minY = points[0].y;
+		int32_t maxY = points[0].y;
+		for (uint32_t i = 1; i < count; ++i) {
+			minX = std::min(minX, points[i].x);
+			maxX = std::max(maxX, points[i].x);
+			minY = std::min(minY, points[i].y);
+			maxY = std::max(maxY, points[i].y);
+		}
+		Rect bounds(minX - border, minY - border, maxX - minX + 2 * border + 1, maxY - minY + 2 * border + 1);
+		return bounds.intersects(viewport);
+	}
+
 	GenericRendererLineInfo::GenericRendererLineInfo(RendererNode n1, RendererNode n2, uint8_t r, uint8_t g, uint8_t b, uint8_t a):
 		GenericRendererElementInfo(),
 		m_edge1(n1),
@@ -61,10 +79,11 @@ namespace FIFE {
 		m_alpha(a) {
 	}
 	void GenericRendererLineInfo::render(Camera* cam, Layer* layer, RenderList& instances, RenderBackend* renderbackend) {
-		Point p1 = m_edge1.getCalculatedPoint(cam, layer);
-		Point p2 = m_edge2.getCalculatedPoint(cam, layer);
-		if(m_edge1.getLayer() == layer) {
-			renderbackend->drawLine(p1, p2, m_red, m_green, m_blue, m_alpha);
+		Point p[2];
+		p[0] = m_edge1.getCalculatedPoint(cam, layer);
+		p[1] = m_edge2.getCalculatedPoint(cam, layer);
+		if(m_edge1.getLayer() == layer && isVisible(cam->getViewPort(), p, 2)) {
+			renderbackend->drawLine(p[0], p[1], m_red, m_green, m_blue, m_alpha);
 			if (renderbackend->getLightingModel() > 0) {
 				renderbackend->changeRenderInfos(RENDER_DATA_WITHOUT_Z, 1, 4, 5, false, false, 0, KEEP, ALWAYS);
 			}
@@ -81,7 +100,7 @@ namespace FIFE {
 	}
 	void GenericRendererPointInfo::render(Camera* cam, Layer* layer, RenderList& instances, RenderBackend* renderbackend) {
 		Point p = m_anchor.getCalculatedPoint(cam, layer);
-		if(m_anchor.getLayer() == layer) {
+		if(m_anchor.getLayer() == layer && isVisible(cam->getViewPort(), &p, 1)) {
 			renderbackend->putPixel(p.x, p.y, m_red, m_green, m_blue, m_alpha);
 			if (renderbackend->getLightingModel() > 0) {
 				renderbackend->changeRenderInfos(RENDER_DATA_WITHOUT_Z, 1, 4, 5, false, false, 0, KEEP, ALWAYS);
@@ -100,11 +119,12 @@ namespace FIFE {
 		m_alpha(a) {
 	}
 	void GenericRendererTriangleInfo::render(Camera* cam, Layer* layer, RenderList& instances, RenderBackend* renderbackend) {
-		Point p1 = m_edge1.getCalculatedPoint(cam, layer);
-		Point p2 = m_edge2.getCalculatedPoint(cam, layer);
-		Point p3 = m_edge3.getCalculatedPoint(cam, layer);
-		if(m_edge1.getLayer() == layer) {
-			renderbackend->drawTriangle(p1, p2, p3, m_red, m_green, m_blue, m_alpha);
+		Point p[3];
+		p[0] = m_edge1.getCalculatedPoint(cam, layer);
+		p[1] = m_edge2.getCalculatedPoint(cam, layer);
+		p[2] = m_edge3.getCalculatedPoint(cam, layer);
+		if(m_edge1.getLayer() == layer && isVisible(cam->getViewPort(), p, 3)) {
+			renderbackend->drawTriangle(p[0], p[1], p[2], m_red, m_green, m_blue, m_alpha);
 			if (renderbackend->getLightingModel() > 0) {
 				renderbackend->changeRenderInfos(RENDER_DATA_WITHOUT_Z, 1, 4, 5, false, false, 0, KEEP, ALWAYS);
 			}
@@ -123,12 +143,13 @@ namespace FIFE {
 		m_alpha(a) {
 	}
 	void GenericRendererQuadInfo::render(Camera* cam, Layer* layer, RenderList& instances, RenderBackend* renderbackend) {
-		Point p1 = m_edge1.getCalculatedPoint(cam, layer);
-		Point p2 = m_edge2.getCalculatedPoint(cam, layer);
-		Point p3 = m_edge3.getCalculatedPoint(cam, layer);
-		Point p4 = m_edge4.getCalculatedPoint(cam, layer);
-		if(m_edge1.getLayer() == layer) {
-			renderbackend->drawQuad(p1, p2, p3, p4, m_red, m_green, m_blue, m_alpha);
+		Point p[4];
+		p[0] = m_edge1.getCalculatedPoint(cam, layer);
+		p[1] = m_edge2.getCalculatedPoint(cam, layer);
+		p[2] = m_edge3.getCalculatedPoint(cam, layer);
+		p[3] = m_edge4.getCalculatedPoint(cam, layer);
+		if(m_edge1.getLayer() == layer && isVisible(cam->getViewPort(), p, 4)) {
+			renderbackend->drawQuad(p[0], p[1], p[2], p[3], m_red, m_green, m_blue, m_alpha);
 			if (renderbackend->getLightingModel() > 0) {
 				renderbackend->changeRenderInfos(RENDER_DATA_WITHOUT_Z, 1, 4, 5, false, false, 0, KEEP, ALWAYS);
 			}
@@ -146,7 +167,7 @@ namespace FIFE {
 	}
 	void GenericRendererVertexInfo::render(Camera* cam, Layer* layer, RenderList& instances, RenderBackend* renderbackend) {
 		Point p = m_center.getCalculatedPoint(cam, layer);
-		if(m_center.getLayer() == layer) {
+		if(m_center.getLayer() == layer && isVisible(cam->getViewPort(), &p, 1, m_size)) {
 			renderbackend->drawVertex(p, m_size, m_red, m_green, m_blue, m_alpha);
 			if (renderbackend->getLightingModel() > 0) {
 				renderbackend->changeRenderInfos(RENDER_DATA_WITHOUT_Z, 1, 4, 5, false, false, 0, KEEP, ALWAYS);
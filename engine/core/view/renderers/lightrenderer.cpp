@@ -177,6 +177,12 @@ namespace FIFE {
 		Point p = m_anchor.getCalculatedPoint(cam, layer, true);
 		if(m_anchor.getLayer() == layer) {
 			double zoom = cam->getZoom();
+			// skip lights whose fan lies completely outside of the viewport
+			int32_t w = static_cast<int32_t>(ceil(m_radius * m_xstretch * zoom));
+			int32_t h = static_cast<int32_t>(ceil(m_radius * m_ystretch * zoom));
+			if (!Rect(p.x - w, p.y - h, 2 * w + 1, 2 * h + 1).intersects(cam->getViewPort())) {
+				return;
+			}
 
 			uint8_t lm = renderbackend->getLightingModel();
 			renderbackend->drawLightPrimitive(p, m_intensity, m_radius, m_subdivisions,
@@ -121,6 +121,7 @@ class ApplicationBase(object):
 		engineSetting.setGLUseMonochrome(self._finalSetting['GLUseMonochrome'])
 		engineSetting.setGLUseDepthBuffer(self._finalSetting['GLUseDepthBuffer'])
 		engineSetting.setGLAlphaTestValue(self._finalSetting['GLAlphaTestValue'])
+		engineSetting.setGLUseVertexBufferObjects(self._finalSetting['GLUseVertexBufferObjects'])
 		if self._finalSetting['GLTextureFiltering'] == 'None':
 			engineSetting.setGLTextureFiltering(fife.TEXTURE_FILTER_NONE)
 		elif self._finalSetting['GLTextureFiltering'] == 'Bilinear':
@@ -101,7 +101,7 @@ class Setting(object):
 			'FullScreen':[True,False], 'RefreshRate':[0,200], 'Display':[0,9], 'VSync':[True,False], 'PychanDebug':[True,False]
 			, 'ProfilingOn':[True,False], 'SDLRemoveFakeAlpha':[True,False], 'GLCompressImages':[False,True], 'GLUseFramebuffer':[False,True], 'GLUseNPOT':[False,True],
 			'GLUseMipmapping':[False,True], 'GLTextureFiltering':['None', 'Bilinear', 'Trilinear', 'Anisotropic'], 'GLUseMonochrome':[False,True],
-			'GLUseDepthBuffer':[False,True], 'GLAlphaTestValue':[0.0,1.0],
+			'GLUseDepthBuffer':[False,True], 'GLAlphaTestValue':[0.0,1.0], 'GLUseVertexBufferObjects':[False,True],
 			'RenderBackend':['OpenGL', 'SDL'],
 			'ScreenResolution':['640x480', '800x600', '1024x600', '1024x768', '1280x768',
 								'1280x800', '1280x960', '1280x1024', '1366x768', '1440x900',
@@ -124,7 +124,7 @@ class Setting(object):
 		self._defaultSetting['FIFE'] = {
 			'FullScreen':False, 'RefreshRate':60, 'Display':0, 'VSync':False, 'PychanDebug':False,
 			'ProfilingOn':False, 'SDLRemoveFakeAlpha':False, 'GLCompressImages':False, 'GLUseFramebuffer':True, 'GLUseNPOT':True,
-			'GLUseMipmapping':False, 'GLTextureFiltering':'None', 'GLUseMonochrome':False, 'GLUseDepthBuffer':False, 'GLAlphaTestValue':0.3,
+			'GLUseMipmapping':False, 'GLTextureFiltering':'None', 'GLUseMonochrome':False, 'GLUseDepthBuffer':False, 'GLAlphaTestValue':0.3, 'GLUseVertexBufferObjects':False,
 			'RenderBackend':'OpenGL', 'ScreenResolution':"1024x768", 'BitsPerPixel':0,
 			'InitialVolume':5.0, 'WindowTitle':"", 'WindowIcon':"", 'Font':"",
 			'FontGlyphs':glyphDft, 'DefaultFontSize':12, 'Lighting':0,
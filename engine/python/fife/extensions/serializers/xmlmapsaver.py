@@ -386,6 +386,8 @@ class XMLMapSaver(object):
 	def flush(self):
 		self.xmlout.endDocument()
 		self.file.close()
+		# the vfs caches which files exist, make the new file visible
+		self.engine.getVFS().invalidate()
 
 	def saveResource(self):
 		self.write_map()
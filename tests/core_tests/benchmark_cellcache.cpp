@@ -0,0 +1,106 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/hexgrid.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/cellcache.h"
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+// Measures the creation of the cell caches for square and hex maps of several sizes.
+// Every map has a walkable ground layer with one tile per cell and an interact layer
+// with a wall on every seventh cell, like a typical loaded map.
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static double buildCellCache(Model& model, const std::string& gridtype, int32_t size, uint32_t& cells) {
+	Map* map = model.createMap("benchmark");
+	Layer* ground = map->createLayer("ground", model.getCellGrid(gridtype));
+	ground->setWalkable(true);
+	Layer* walls = map->createLayer("walls", model.getCellGrid(gridtype));
+	walls->setInteract(true, "ground");
+
+	Object* tile = model.getObject("tile", "benchmark");
+	Object* wall = model.getObject("wall", "benchmark");
+	for (int32_t y = 0; y < size; ++y) {
+		for (int32_t x = 0; x < size; ++x) {
+			ground->createInstance(tile, ModelCoordinate(x, y));
+			if ((x + y * size) % 7 == 0) {
+				walls->createInstance(wall, ModelCoordinate(x, y));
+			}
+		}
+	}
+
+	Clock::time_point start = Clock::now();
+	map->initializeCellCaches();
+	map->finalizeCellCaches();
+	double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+	CellCache* cache = ground->getCellCache();
+	cells = cache->getWidth() * cache->getHeight();
+	model.deleteMap(map);
+	return elapsed;
+}
+
+int main() {
+	const int32_t sizes[] = { 64, 128, 256, 512, 1024 };
+	// the layers need a time manager, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model(NULL, renderers);
+	model.adoptCellGrid(new SquareGrid());
+	model.adoptCellGrid(new HexGrid());
+
+	Object* tile = model.createObject("tile", "benchmark");
+	tile->setStatic(true);
+	Object* wall = model.createObject("wall", "benchmark");
+	wall->setStatic(true);
+	wall->setBlocking(true);
+
+	std::cout << std::setw(12) << "size" << std::setw(12) << "cells"
+		<< std::setw(16) << "square (ms)" << std::setw(16) << "hex (ms)" << std::endl;
+	for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+		uint32_t cells = 0;
+		double square = buildCellCache(model, "square", sizes[i], cells);
+		double hex = buildCellCache(model, "hexagonal", sizes[i], cells);
+
+		std::cout << std::setw(12) << sizes[i] << std::setw(12) << cells << std::fixed << std::setprecision(1)
+			<< std::setw(16) << square << std::setw(16) << hex << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,193 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// 3rd party library includes
+#include <zlib.h>
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "vfs/dat/datarchive.h"
+#include "vfs/dat/lzssdecoder.h"
+#include "vfs/dat/rawdatadat1.h"
+#include "vfs/dat/rawdatadat2.h"
+#include "vfs/raw/rawdata.h"
+#include "vfs/raw/rawdatamemsource.h"
+
+using namespace FIFE;
+
+// Measures the decoding of LZSS (DAT1) and zlib (DAT2) compressed entries of an
+// archive in memory, with and without the decoded entry cache of the archive.
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static const uint32_t ENTRY_COUNT = 64;
+static const uint32_t ENTRY_SIZE = 256 * 1024;
+
+// Appends LZSS blocks to the archive and returns the decoded size.
+static uint32_t encodeLZSSEntry(std::vector<uint8_t>& archive, uint32_t size) {
+	uint32_t decoded = 0;
+	while (decoded < size) {
+		std::vector<uint8_t> block;
+		while (block.size() < 0x7000 && decoded < size) {
+			uint8_t flags = static_cast<uint8_t>(std::rand());
+			block.push_back(flags);
+			for (int32_t bit = 0; bit < 8; ++bit) {
+				if (flags & (1 << bit)) {
+					// literal of a small alphabet, like text or sprite data
+					block.push_back(static_cast<uint8_t>('a' + std::rand() % 16));
+					decoded += 1;
+				} else {
+					// reference into the ring buffer
+					uint32_t offset = std::rand() % 4096;
+					uint32_t length = std::rand() % 16;
+					block.push_back(static_cast<uint8_t>(offset & 0xff));
+					block.push_back(static_cast<uint8_t>(((offset >> 4) & 0xf0) | length));
+					decoded += length + 3;
+				}
+			}
+		}
+		archive.push_back(static_cast<uint8_t>(block.size() >> 8));
+		archive.push_back(static_cast<uint8_t>(block.size() & 0xff));
+		archive.insert(archive.end(), block.begin(), block.end());
+	}
+	return decoded;
+}
+
+// Appends a zlib stream to the archive and returns the compressed size.
+static uint32_t encodeZlibEntry(std::vector<uint8_t>& archive, uint32_t size) {
+	std::vector<uint8_t> data(size);
+	for (uint32_t i = 0; i < size; ++i) {
+		data[i] = static_cast<uint8_t>((i % 97 < 60) ? 'a' + (i % 7) : std::rand() % 256);
+	}
+	uLongf packed = compressBound(size);
+	std::vector<uint8_t> buffer(packed);
+	compress(&buffer[0], &packed, &data[0], size);
+	archive.insert(archive.end(), buffer.begin(), buffer.begin() + packed);
+	return static_cast<uint32_t>(packed);
+}
+
+static RawData* createArchive(const std::vector<uint8_t>& data) {
+	RawDataMemSource* source = new RawDataMemSource(static_cast<uint32_t>(data.size()));
+	std::copy(data.begin(), data.end(), source->getRawData());
+	return new RawData(source);
+}
+
+template <typename T>
+static double readEntries(DATArchivePtr archive, const std::vector<typename T::s_info>& entries) {
+	std::vector<uint8_t> buffer(ENTRY_SIZE * 2);
+	Clock::time_point start = Clock::now();
+	for (uint32_t i = 0; i < entries.size(); ++i) {
+		RawData data(new T(archive, entries[i]));
+		data.readInto(&buffer[0], data.getDataLength());
+	}
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+template <typename T>
+static double readHeaders(DATArchivePtr archive, const std::vector<typename T::s_info>& entries) {
+	uint8_t header[16];
+	Clock::time_point start = Clock::now();
+	for (uint32_t i = 0; i < entries.size(); ++i) {
+		RawData data(new T(archive, entries[i]));
+		data.readInto(header, sizeof(header));
+	}
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void printResult(const std::string& name, double ms, uint64_t bytes) {
+	std::cout << std::setw(28) << name << std::fixed << std::setprecision(2)
+		<< std::setw(12) << ms << std::setw(12) << (bytes / (1024.0 * 1024.0)) / (ms / 1000.0) << std::endl;
+}
+
+int main() {
+	std::srand(1);
+	std::vector<uint8_t> lzssData;
+	std::vector<RawDataDAT1::s_info> lzssEntries;
+	for (uint32_t i = 0; i < ENTRY_COUNT; ++i) {
+		RawDataDAT1::s_info info;
+		info.offset = static_cast<uint32_t>(lzssData.size());
+		info.unpackedLength = encodeLZSSEntry(lzssData, ENTRY_SIZE);
+		info.packedLength = static_cast<uint32_t>(lzssData.size()) - info.offset;
+		info.type = 0x40;
+		lzssEntries.push_back(info);
+	}
+	std::vector<uint8_t> zlibData;
+	std::vector<RawDataDAT2::s_info> zlibEntries;
+	for (uint32_t i = 0; i < ENTRY_COUNT; ++i) {
+		RawDataDAT2::s_info info;
+		info.offset = static_cast<uint32_t>(zlibData.size());
+		info.packedLength = encodeZlibEntry(zlibData, ENTRY_SIZE);
+		info.unpackedLength = ENTRY_SIZE;
+		info.type = 1;
+		zlibEntries.push_back(info);
+	}
+	uint64_t lzssBytes = 0;
+	for (uint32_t i = 0; i < ENTRY_COUNT; ++i) {
+		lzssBytes += lzssEntries[i].unpackedLength;
+	}
+	uint64_t zlibBytes = static_cast<uint64_t>(ENTRY_COUNT) * ENTRY_SIZE;
+
+	// the stream decoder reads every block from the archive
+	RawData* lzssStream = createArchive(lzssData);
+	std::vector<uint8_t> buffer(ENTRY_SIZE * 2);
+	Clock::time_point start = Clock::now();
+	for (uint32_t i = 0; i < ENTRY_COUNT; ++i) {
+		lzssStream->setIndex(lzssEntries[i].offset);
+		LZSSDecoder decoder;
+		decoder.decode(lzssStream, &buffer[0], lzssEntries[i].unpackedLength);
+	}
+	double streamed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	delete lzssStream;
+
+	DATArchivePtr lzssArchive(new DATArchive(createArchive(lzssData), 0));
+	DATArchivePtr zlibArchive(new DATArchive(createArchive(zlibData), 0));
+
+	std::cout << std::setw(28) << "" << std::setw(12) << "ms" << std::setw(12) << "MiB/s" << std::endl;
+	printResult("LZSS from RawData", streamed, lzssBytes);
+	printResult("LZSS DAT1 entries", readEntries<RawDataDAT1>(lzssArchive, lzssEntries), lzssBytes);
+	printResult("zlib DAT2 entries", readEntries<RawDataDAT2>(zlibArchive, zlibEntries), zlibBytes);
+
+	// everything fits into the cache, the second round doesn't decode
+	lzssArchive->setCacheSize(64 * 1024 * 1024);
+	zlibArchive->setCacheSize(64 * 1024 * 1024);
+	readEntries<RawDataDAT1>(lzssArchive, lzssEntries);
+	readEntries<RawDataDAT2>(zlibArchive, zlibEntries);
+	printResult("LZSS DAT1 entries, cached", readEntries<RawDataDAT1>(lzssArchive, lzssEntries), lzssBytes);
+	printResult("zlib DAT2 entries, cached", readEntries<RawDataDAT2>(zlibArchive, zlibEntries), zlibBytes);
+
+	// stored entries only read what is asked for
+	for (uint32_t i = 0; i < ENTRY_COUNT; ++i) {
+		zlibEntries[i].type = 0;
+		zlibEntries[i].unpackedLength = zlibEntries[i].packedLength;
+	}
+	std::cout << std::setw(28) << "stored DAT2 headers" << std::fixed << std::setprecision(3)
+		<< std::setw(12) << readHeaders<RawDataDAT2>(zlibArchive, zlibEntries) << std::endl;
+	return 0;
+}
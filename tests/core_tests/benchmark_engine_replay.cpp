@@ -0,0 +1,479 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 3rd party library includes
+#include <SDL.h>
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "controller/engine.h"
+#include "eventchannel/eventmanager.h"
+#include "eventchannel/sdl/isdleventlistener.h"
+#include "loaders/native/map/maploader.h"
+#include "model/model.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+#include "model/structures/map.h"
+#include "util/time/profiler.h"
+#include "util/time/timemanager.h"
+#include "view/camera.h"
+#include "view/visual.h"
+
+using namespace FIFE;
+
+// Replays a script of SDL events and game commands against a map for a fixed number of
+// frames, with a synthetic clock and without a visible window, and prints the frame
+// times, the profiler zones and the heap allocations as JSON.
+//
+// Usage (from tests/fife_test, the default map is data/maps/benchmark.xml):
+//   benchmark_engine_replay [--map file] [--script file] [--frames n] [--delta ms]
+//                           [--backend SDL|OpenGL] [--output file] [--record file]
+//
+// Every script line is "<frame> <command> <arguments>", lines starting with # are skipped:
+//   spawn <count>                  adds skeletons on random cells of the item layer
+//   wander <count>                 sends that many skeletons to random cells
+//   move <x> <y>                   sends the player to the layer coordinates
+//   pan <dx> <dy>                  moves the camera by map coordinates
+//   zoom <zoom>                    sets the camera zoom
+//   key <down|up> <keycode>        SDL key event
+//   mouse <down|up> <button> <x> <y>  SDL mouse button event
+//   motion <x> <y>                 SDL mouse motion event
+//   wheel <y>                      SDL mouse wheel event
+// --record opens a normal window and writes the SDL events of the session in this format.
+
+typedef std::chrono::high_resolution_clock Clock;
+
+#ifdef ALLOCATION_TRACKING_ENABLED
+// the engine already counts the allocations of the calling thread
+static uint64_t heapAllocations() {
+	return Profiler::getThreadAllocations();
+}
+
+static uint64_t heapAllocatedBytes() {
+	return Profiler::getThreadAllocatedBytes();
+}
+#else
+static std::atomic<uint64_t> s_allocations(0);
+static std::atomic<uint64_t> s_allocatedBytes(0);
+
+static uint64_t heapAllocations() {
+	return s_allocations;
+}
+
+static uint64_t heapAllocatedBytes() {
+	return s_allocatedBytes;
+}
+
+void* operator new(std::size_t size) {
+	++s_allocations;
+	s_allocatedBytes += size;
+	void* ptr = std::malloc(size ? size : 1);
+	if (!ptr) {
+		throw std::bad_alloc();
+	}
+	return ptr;
+}
+
+void operator delete(void* ptr) noexcept {
+	std::free(ptr);
+}
+#endif
+
+struct ReplayCommand {
+	uint32_t frame;
+	std::string name;
+	std::vector<std::string> args;
+};
+
+struct ZoneTotal {
+	ZoneTotal(): time(0), max(0), calls(0), allocations(0) {}
+	double time;
+	double max;
+	uint64_t calls;
+	uint64_t allocations;
+};
+
+// deterministic random numbers, independent of the platform
+class Random {
+public:
+	Random(): m_state(12345) {}
+	int32_t range(int32_t min, int32_t max) {
+		m_state = m_state * 1103515245u + 12345u;
+		return min + static_cast<int32_t>((m_state >> 16) % static_cast<uint32_t>(max - min + 1));
+	}
+private:
+	uint32_t m_state;
+};
+
+class EventRecorder : public ISdlEventListener {
+public:
+	EventRecorder(std::ostream& out, const uint32_t& frame): m_out(out), m_frame(frame) {}
+
+	virtual bool onSdlEvent(SDL_Event& evt) {
+		switch (evt.type) {
+			case SDL_KEYDOWN:
+			case SDL_KEYUP:
+				m_out << m_frame << " key " << (evt.type == SDL_KEYDOWN ? "down " : "up ") << evt.key.keysym.sym << "\n";
+				break;
+			case SDL_MOUSEBUTTONDOWN:
+			case SDL_MOUSEBUTTONUP:
+				m_out << m_frame << " mouse " << (evt.type == SDL_MOUSEBUTTONDOWN ? "down " : "up ")
+					<< static_cast<int32_t>(evt.button.button) << " " << evt.button.x << " " << evt.button.y << "\n";
+				break;
+			case SDL_MOUSEMOTION:
+				m_out << m_frame << " motion " << evt.motion.x << " " << evt.motion.y << "\n";
+				break;
+			case SDL_MOUSEWHEEL:
+				m_out << m_frame << " wheel " << evt.wheel.y << "\n";
+				break;
+			default:
+				break;
+		}
+		return false;
+	}
+
+private:
+	std::ostream& m_out;
+	const uint32_t& m_frame;
+};
+
+class Replay {
+public:
+	Replay(Map* map):
+		m_camera(map->getCameras().front()),
+		m_layer(map->getLayer("item_layer")),
+		m_player(m_layer->getInstance("player")),
+		m_mouseX(0),
+		m_mouseY(0) {
+		m_layer->getMinMaxCoordinates(m_min, m_max);
+	}
+
+	void execute(const ReplayCommand& cmd) {
+		if (cmd.name == "spawn") {
+			int32_t count = argument(cmd, 0);
+			for (int32_t i = 0; i < count; ++i) {
+				std::ostringstream id;
+				id << "skel" << m_spawned.size();
+				Instance* instance = m_layer->createInstance(m_player->getObject(), randomCell(), id.str());
+				InstanceVisual::create(instance);
+				instance->actOnce("stand");
+				m_spawned.push_back(instance);
+			}
+		} else if (cmd.name == "wander") {
+			int32_t count = std::min(argument(cmd, 0), static_cast<int32_t>(m_spawned.size()));
+			for (int32_t i = 0; i < count; ++i) {
+				Instance* instance = m_spawned[m_random.range(0, m_spawned.size() - 1)];
+				Location target(m_layer);
+				target.setLayerCoordinates(randomCell());
+				instance->move("walk", target, 4.0);
+			}
+		} else if (cmd.name == "move") {
+			Location target(m_layer);
+			target.setLayerCoordinates(ModelCoordinate(argument(cmd, 0), argument(cmd, 1)));
+			m_player->move("walk", target, 4.0);
+		} else if (cmd.name == "pan") {
+			Location location = m_camera->getLocation();
+			ExactModelCoordinate coords = location.getMapCoordinates();
+			coords.x += argumentf(cmd, 0);
+			coords.y += argumentf(cmd, 1);
+			location.setMapCoordinates(coords);
+			m_camera->setLocation(location);
+		} else if (cmd.name == "zoom") {
+			m_camera->setZoom(argumentf(cmd, 0));
+		} else if (cmd.name == "key") {
+			SDL_Event evt;
+			SDL_zero(evt);
+			bool down = cmd.args.size() > 0 && cmd.args[0] == "down";
+			evt.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+			evt.key.state = down ? SDL_PRESSED : SDL_RELEASED;
+			evt.key.keysym.sym = argument(cmd, 1);
+			evt.key.keysym.scancode = SDL_GetScancodeFromKey(evt.key.keysym.sym);
+			SDL_PushEvent(&evt);
+		} else if (cmd.name == "mouse") {
+			SDL_Event evt;
+			SDL_zero(evt);
+			bool down = cmd.args.size() > 0 && cmd.args[0] == "down";
+			evt.type = down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+			evt.button.state = down ? SDL_PRESSED : SDL_RELEASED;
+			evt.button.button = argument(cmd, 1);
+			evt.button.clicks = 1;
+			evt.button.x = argument(cmd, 2);
+			evt.button.y = argument(cmd, 3);
+			SDL_PushEvent(&evt);
+		} else if (cmd.name == "motion") {
+			SDL_Event evt;
+			SDL_zero(evt);
+			evt.type = SDL_MOUSEMOTION;
+			evt.motion.x = argument(cmd, 0);
+			evt.motion.y = argument(cmd, 1);
+			evt.motion.xrel = evt.motion.x - m_mouseX;
+			evt.motion.yrel = evt.motion.y - m_mouseY;
+			m_mouseX = evt.motion.x;
+			m_mouseY = evt.motion.y;
+			SDL_PushEvent(&evt);
+		} else if (cmd.name == "wheel") {
+			SDL_Event evt;
+			SDL_zero(evt);
+			evt.type = SDL_MOUSEWHEEL;
+			evt.wheel.y = argument(cmd, 0);
+			SDL_PushEvent(&evt);
+		} else {
+			std::cerr << "unknown command '" << cmd.name << "' in frame " << cmd.frame << std::endl;
+		}
+	}
+
+private:
+	static int32_t argument(const ReplayCommand& cmd, uint32_t index) {
+		return index < cmd.args.size() ? std::atoi(cmd.args[index].c_str()) : 0;
+	}
+
+	static double argumentf(const ReplayCommand& cmd, uint32_t index) {
+		return index < cmd.args.size() ? std::atof(cmd.args[index].c_str()) : 0.0;
+	}
+
+	ModelCoordinate randomCell() {
+		return ModelCoordinate(m_random.range(m_min.x, m_max.x), m_random.range(m_min.y, m_max.y));
+	}
+
+	Camera* m_camera;
+	Layer* m_layer;
+	Instance* m_player;
+	ModelCoordinate m_min;
+	ModelCoordinate m_max;
+	std::vector<Instance*> m_spawned;
+	Random m_random;
+	int32_t m_mouseX;
+	int32_t m_mouseY;
+};
+
+static bool parseScript(std::istream& in, std::vector<ReplayCommand>& commands) {
+	std::string line;
+	while (std::getline(in, line)) {
+		std::istringstream tokens(line);
+		ReplayCommand cmd;
+		if (line.empty() || line[0] == '#' || !(tokens >> cmd.frame >> cmd.name)) {
+			continue;
+		}
+		std::string arg;
+		while (tokens >> arg) {
+			cmd.args.push_back(arg);
+		}
+		commands.push_back(cmd);
+	}
+	return !commands.empty();
+}
+
+// skeletons keep walking, the camera pans and zooms in a fixed rhythm
+static std::string defaultScript(uint32_t frames) {
+	std::ostringstream script;
+	script << "0 spawn 1000\n0 move 5 5\n";
+	for (uint32_t frame = 30; frame < frames; frame += 60) {
+		script << frame << " wander 100\n";
+		script << frame << " pan " << ((frame / 60) % 2 == 0 ? "2 1" : "-2 -1") << "\n";
+		script << frame + 30 << " zoom " << ((frame / 60) % 2 == 0 ? "1.5" : "1.125") << "\n";
+	}
+	return script.str();
+}
+
+static void writeJson(std::ostream& out, const std::string& mapfile, uint32_t delta, const std::vector<double>& frameTimes,
+	const std::vector<uint64_t>& frameAllocations, uint64_t allocatedBytes, const std::map<std::string, ZoneTotal>& zones) {
+	std::vector<double> sorted(frameTimes);
+	std::sort(sorted.begin(), sorted.end());
+	double total = 0;
+	for (uint32_t i = 0; i < frameTimes.size(); ++i) {
+		total += frameTimes[i];
+	}
+	uint64_t allocations = 0;
+	uint64_t maxAllocations = 0;
+	for (uint32_t i = 0; i < frameAllocations.size(); ++i) {
+		allocations += frameAllocations[i];
+		maxAllocations = std::max(maxAllocations, frameAllocations[i]);
+	}
+	const uint32_t frames = frameTimes.size();
+
+	out << std::fixed << std::setprecision(4);
+	out << "{\n";
+	out << "  \"map\": \"" << mapfile << "\",\n";
+	out << "  \"frames\": " << frames << ",\n";
+	out << "  \"time_delta\": " << delta << ",\n";
+	out << "  \"profiling\": " << (Profiler::isAvailable() ? "true" : "false") << ",\n";
+	out << "  \"frame\": { \"total_ms\": " << total << ", \"avg_ms\": " << total / frames
+		<< ", \"median_ms\": " << sorted[frames / 2] << ", \"p95_ms\": " << sorted[(frames * 95) / 100]
+		<< ", \"max_ms\": " << sorted.back() << " },\n";
+	out << "  \"allocations\": { \"total\": " << allocations << ", \"per_frame\": " << static_cast<double>(allocations) / frames
+		<< ", \"max_per_frame\": " << maxAllocations << ", \"bytes\": " << allocatedBytes << " },\n";
+	out << "  \"zones\": {";
+	std::map<std::string, ZoneTotal>::const_iterator it = zones.begin();
+	for (; it != zones.end(); ++it) {
+		out << (it == zones.begin() ? "\n" : ",\n");
+		out << "    \"" << it->first << "\": { \"total_ms\": " << it->second.time << ", \"avg_ms\": " << it->second.time / frames
+			<< ", \"max_ms\": " << it->second.max << ", \"calls\": " << it->second.calls
+			<< ", \"allocations\": " << it->second.allocations << " }";
+	}
+	out << "\n  }\n}\n";
+}
+
+static void addZones(Profiler* profiler, std::map<std::string, ZoneTotal>& zones) {
+	std::vector<std::string> names = profiler->getZoneNames();
+	std::vector<std::string>::iterator it = names.begin();
+	for (; it != names.end(); ++it) {
+		ZoneTotal& zone = zones[*it];
+		double time = profiler->getZoneTime(*it);
+		zone.time += time;
+		zone.max = std::max(zone.max, time);
+		zone.calls += profiler->getZoneCalls(*it);
+		zone.allocations += profiler->getZoneAllocations(*it);
+	}
+}
+
+int main(int argc, char** argv) {
+	std::string mapfile = "data/maps/benchmark.xml";
+	std::string scriptfile;
+	std::string outputfile;
+	std::string recordfile;
+	std::string backend = "SDL";
+	uint32_t frames = 600;
+	uint32_t delta = 16;
+	for (int32_t i = 1; i + 1 < argc; i += 2) {
+		std::string option = argv[i];
+		if (option == "--map") {
+			mapfile = argv[i + 1];
+		} else if (option == "--script") {
+			scriptfile = argv[i + 1];
+		} else if (option == "--frames") {
+			frames = std::max(std::atoi(argv[i + 1]), 1);
+		} else if (option == "--delta") {
+			delta = std::atoi(argv[i + 1]);
+		} else if (option == "--backend") {
+			backend = argv[i + 1];
+		} else if (option == "--output") {
+			outputfile = argv[i + 1];
+		} else if (option == "--record") {
+			recordfile = argv[i + 1];
+		} else {
+			std::cerr << "unknown option " << option << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<ReplayCommand> commands;
+	if (recordfile.empty()) {
+		if (scriptfile.empty()) {
+			std::istringstream script(defaultScript(frames));
+			parseScript(script, commands);
+		} else {
+			std::ifstream script(scriptfile.c_str());
+			if (!parseScript(script, commands)) {
+				std::cerr << "could not read script " << scriptfile << std::endl;
+				return 1;
+			}
+		}
+		// headless, unless the environment asks for a real video driver
+		SDL_setenv("SDL_VIDEODRIVER", "dummy", 0);
+	}
+
+	Engine engine;
+	EngineSettings& settings = engine.getSettings();
+	settings.setRenderBackend(backend);
+	settings.setScreenWidth(1024);
+	settings.setScreenHeight(768);
+	settings.setFrameLimitEnabled(false);
+	settings.setVSync(false);
+	engine.init();
+	engine.getTimeManager()->setFixedTimeDelta(delta);
+
+	MapLoader loader(engine.getModel(), engine.getVFS(), engine.getImageManager(), engine.getRenderBackend());
+	Map* map = loader.isLoadable(mapfile) ? loader.load(mapfile) : 0;
+	if (!map || map->getCameras().empty() || !map->getLayer("item_layer") || !map->getLayer("item_layer")->getInstance("player")) {
+		std::cerr << "could not load " << mapfile << ", it needs a camera and a player instance on item_layer" << std::endl;
+		return 1;
+	}
+	Replay replay(map);
+
+	uint32_t frame = 0;
+	std::ofstream record;
+	EventRecorder recorder(record, frame);
+	if (!recordfile.empty()) {
+		record.open(recordfile.c_str());
+		engine.getEventManager()->addSdlEventListener(&recorder);
+	}
+
+	Profiler* profiler = engine.getProfiler();
+	profiler->setEnabled(true);
+	std::map<std::string, ZoneTotal> zones;
+	std::vector<double> frameTimes;
+	std::vector<uint64_t> frameAllocations;
+	uint64_t allocatedBytes = 0;
+
+	engine.initializePumping();
+	std::vector<ReplayCommand>::const_iterator cmd = commands.begin();
+	for (; frame < frames; ++frame) {
+		for (; cmd != commands.end() && cmd->frame <= frame; ++cmd) {
+			replay.execute(*cmd);
+		}
+
+		const uint64_t allocations = heapAllocations();
+		const uint64_t bytes = heapAllocatedBytes();
+		Clock::time_point start = Clock::now();
+		engine.pump();
+		frameTimes.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+		frameAllocations.push_back(heapAllocations() - allocations);
+		allocatedBytes += heapAllocatedBytes() - bytes;
+
+		// the zones of a frame are gathered when the next one starts
+		if (frame > 0) {
+			addZones(profiler, zones);
+		}
+	}
+	profiler->endFrame();
+	addZones(profiler, zones);
+	engine.finalizePumping();
+
+	if (!recordfile.empty()) {
+		engine.getEventManager()->removeSdlEventListener(&recorder);
+		return 0;
+	}
+
+	if (outputfile.empty()) {
+		writeJson(std::cout, mapfile, delta, frameTimes, frameAllocations, allocatedBytes, zones);
+	} else {
+		std::ofstream out(outputfile.c_str());
+		writeJson(out, mapfile, delta, frameTimes, frameAllocations, allocatedBytes, zones);
+	}
+	return 0;
+}
@@ -0,0 +1,143 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/cell.h"
+#include "model/structures/cellcache.h"
+#include "model/structures/fieldofview.h"
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+// Measures CellCache::updateFieldsOfView on a 256x256 square map with 8% wall cells
+// and 1000 observers with a view radius of 12:
+// - the first update of all observers, on one and on all cores
+// - random wall edits, each followed by an update, and how many observers recompute
+// - moving every observer by one cell, which recomputes each of them in full
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static const int32_t MAP_SIZE = 256;
+static const uint32_t WALL_PERCENT = 8;
+static const uint32_t OBSERVERS = 1000;
+static const uint16_t RADIUS = 12;
+static const uint32_t EDITS = 200;
+
+static double elapsedMs(const Clock::time_point& start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+int main() {
+	// the layers need a time manager, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model(NULL, renderers);
+	model.adoptCellGrid(new SquareGrid());
+	Object* tile = model.createObject("tile", "benchmark");
+	tile->setStatic(true);
+
+	Map* map = model.createMap("benchmark");
+	Layer* ground = map->createLayer("ground", model.getCellGrid("square"));
+	ground->setWalkable(true);
+	for (int32_t y = 0; y < MAP_SIZE; ++y) {
+		for (int32_t x = 0; x < MAP_SIZE; ++x) {
+			ground->createInstance(tile, ModelCoordinate(x, y));
+		}
+	}
+	map->initializeCellCaches();
+	map->finalizeCellCaches();
+	CellCache* cache = ground->getCellCache();
+
+	// fixed seed, every run sees the same map
+	std::mt19937 random(4711);
+	std::uniform_int_distribution<int32_t> coordinate(0, MAP_SIZE - 1);
+	std::uniform_int_distribution<uint32_t> percent(0, 99);
+	for (int32_t y = 0; y < MAP_SIZE; ++y) {
+		for (int32_t x = 0; x < MAP_SIZE; ++x) {
+			if (percent(random) < WALL_PERCENT) {
+				cache->getCell(ModelCoordinate(x, y))->setCellType(CTYPE_CELL_BLOCKER);
+			}
+		}
+	}
+	for (uint32_t i = 0; i < OBSERVERS; ++i) {
+		cache->createFieldOfView(ModelCoordinate(coordinate(random), coordinate(random)), RADIUS);
+	}
+
+	std::cout << std::fixed << std::setprecision(2);
+
+	Clock::time_point start = Clock::now();
+	uint32_t updated = cache->updateFieldsOfView(1);
+	std::cout << "full update, 1 thread:       " << std::setw(10) << elapsedMs(start) << " ms (" << updated << " observers)" << std::endl;
+
+	uint32_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+	const std::vector<FieldOfView*>& fovs = cache->getFieldsOfView();
+	for (std::vector<FieldOfView*>::const_iterator it = fovs.begin(); it != fovs.end(); ++it) {
+		(*it)->setDirty();
+	}
+	start = Clock::now();
+	updated = cache->updateFieldsOfView(threads);
+	std::cout << "full update, " << std::setw(2) << threads << " threads:     " << std::setw(10) << elapsedMs(start) << " ms (" << updated << " observers)" << std::endl;
+
+	// toggles random cells, only the observers that see a cell recompute
+	uint64_t recomputed = 0;
+	start = Clock::now();
+	for (uint32_t i = 0; i < EDITS; ++i) {
+		Cell* cell = cache->getCell(ModelCoordinate(coordinate(random), coordinate(random)));
+		cell->setCellType(cell->getCellType() == CTYPE_NO_BLOCKER ? CTYPE_CELL_BLOCKER : CTYPE_NO_BLOCKER);
+		recomputed += cache->updateFieldsOfView(1);
+	}
+	double editTime = elapsedMs(start);
+	std::cout << "wall edit + update:          " << std::setw(10) << editTime / EDITS << " ms per edit, "
+		<< std::setprecision(3) << 100.0 * recomputed / (static_cast<double>(EDITS) * OBSERVERS)
+		<< "% of the observers recomputed" << std::setprecision(2) << std::endl;
+
+	// a one cell move is a full recompute of the observer
+	for (std::vector<FieldOfView*>::const_iterator it = fovs.begin(); it != fovs.end(); ++it) {
+		ModelCoordinate observer = (*it)->getObserver();
+		observer.x = observer.x + 1 < MAP_SIZE ? observer.x + 1 : observer.x - 1;
+		(*it)->setObserver(observer);
+	}
+	start = Clock::now();
+	updated = cache->updateFieldsOfView(1);
+	std::cout << "one cell move, 1 thread:     " << std::setw(10) << elapsedMs(start) << " ms (" << updated << " observers)" << std::endl;
+
+	model.deleteMap(map);
+	return 0;
+}
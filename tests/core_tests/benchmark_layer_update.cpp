@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+#include "model/structures/map.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+// Measures Layer::update with many active instances of which only a few change per frame.
+// Instances stay active after their first change, so a long running map collects mostly
+// idle active instances that are visited every frame.
+
+typedef std::chrono::high_resolution_clock Clock;
+
+int main() {
+	const int32_t counts[] = { 5000, 20000, 50000 };
+	const int32_t frames = 200;
+	// the layers need a time manager, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model(NULL, renderers);
+	model.adoptCellGrid(new SquareGrid());
+
+	Object* object = model.createObject("critter", "benchmark");
+
+	std::cout << std::setw(12) << "instances" << std::setw(12) << "moving"
+		<< std::setw(20) << "update (ms/frame)" << std::endl;
+	for (uint32_t i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i) {
+		Map* map = model.createMap("benchmark");
+		Layer* layer = map->createLayer("critters", model.getCellGrid("square"));
+		int32_t side = 256;
+		std::vector<Instance*> instances;
+		for (int32_t n = 0; n < counts[i]; ++n) {
+			Instance* instance = layer->createInstance(object, ModelCoordinate(n % side, n / side));
+			// activates the instance
+			instance->setRotation(90);
+			instances.push_back(instance);
+		}
+		layer->update();
+
+		// one percent of the instances move every frame
+		int32_t moving = counts[i] / 100;
+		Clock::time_point start = Clock::now();
+		for (int32_t frame = 0; frame < frames; ++frame) {
+			for (int32_t n = 0; n < moving; ++n) {
+				Instance* instance = instances[(frame * moving + n) % counts[i]];
+				Location loc = instance->getLocation();
+				ExactModelCoordinate emc = loc.getExactLayerCoordinates();
+				emc.z = (frame % 2 == 0) ? 1.0 : 0.0;
+				loc.setExactLayerCoordinates(emc);
+				instance->setLocation(loc);
+			}
+			layer->update();
+		}
+		double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		std::cout << std::setw(12) << counts[i] << std::setw(12) << moving << std::fixed << std::setprecision(3)
+			<< std::setw(20) << elapsed / frames << std::endl;
+		model.deleteMap(map);
+	}
+	return 0;
+}
@@ -0,0 +1,130 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Platform specific includes
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "vfs/raw/rawdata.h"
+#include "vfs/raw/rawdatafile.h"
+#include "vfs/raw/rawdatamappedfile.h"
+
+using namespace FIFE;
+
+// Compares reading whole files with a stream, copying them out of a mapping
+// and borrowing the mapping, for several file sizes. Every file is opened,
+// read completely and closed again, like the loaders do it.
+
+static const std::string BENCHMARK_FILE = "fife_benchmark_vfs_io.tmp";
+
+typedef std::chrono::high_resolution_clock Clock;
+
+static void writeFile(uint32_t size) {
+	std::vector<uint8_t> data(size);
+	for (uint32_t i = 0; i < size; ++i) {
+		data[i] = static_cast<uint8_t>(i * 31 + (i >> 8));
+	}
+	FILE* fp = fopen(BENCHMARK_FILE.c_str(), "wb");
+	fwrite(&data[0], 1, size, fp);
+	fclose(fp);
+}
+
+// sums the data, so the compiler can't drop the reads
+static uint32_t checksum(const uint8_t* data, uint32_t size) {
+	uint32_t sum = 0;
+	for (uint32_t i = 0; i < size; i += 64) {
+		sum += data[i];
+	}
+	return sum;
+}
+
+static double readStream(uint32_t rounds, uint32_t& sum) {
+	Clock::time_point start = Clock::now();
+	for (uint32_t i = 0; i < rounds; ++i) {
+		RawData data(new RawDataFile(BENCHMARK_FILE));
+		std::unique_ptr<uint8_t[]> buffer(new uint8_t[data.getDataLength()]);
+		data.readInto(buffer.get(), data.getDataLength());
+		sum += checksum(buffer.get(), data.getDataLength());
+	}
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / rounds;
+}
+
+static double readMapped(uint32_t rounds, uint32_t& sum) {
+	Clock::time_point start = Clock::now();
+	for (uint32_t i = 0; i < rounds; ++i) {
+		RawData data(new RawDataMappedFile(BENCHMARK_FILE));
+		std::unique_ptr<uint8_t[]> buffer(new uint8_t[data.getDataLength()]);
+		data.readInto(buffer.get(), data.getDataLength());
+		sum += checksum(buffer.get(), data.getDataLength());
+	}
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / rounds;
+}
+
+static double borrowMapped(uint32_t rounds, uint32_t& sum) {
+	Clock::time_point start = Clock::now();
+	for (uint32_t i = 0; i < rounds; ++i) {
+		RawData data(new RawDataMappedFile(BENCHMARK_FILE));
+		sum += checksum(data.borrowData(), data.getDataLength());
+	}
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / rounds;
+}
+
+int main() {
+	const uint32_t sizes[] = { 1024, 16 * 1024, 256 * 1024, 4 * 1024 * 1024, 32 * 1024 * 1024 };
+	uint32_t sum = 0;
+
+	std::cout << std::setw(12) << "size" << std::setw(16) << "stream (us)"
+		<< std::setw(16) << "mapped (us)" << std::setw(16) << "borrowed (us)" << std::endl;
+	for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+		writeFile(sizes[i]);
+		// less rounds for big files, about 256 MiB per method
+		uint32_t rounds = std::max(8u, (256u * 1024 * 1024) / sizes[i]);
+		rounds = std::min(rounds, 2000u);
+
+		// warm up the page cache
+		readStream(1, sum);
+		double stream = readStream(rounds, sum);
+		double mapped = readMapped(rounds, sum);
+		double borrowed = borrowMapped(rounds, sum);
+
+		std::cout << std::setw(12) << sizes[i] << std::fixed << std::setprecision(1)
+			<< std::setw(16) << stream << std::setw(16) << mapped << std::setw(16) << borrowed << std::endl;
+	}
+	remove(BENCHMARK_FILE.c_str());
+
+	// print the checksum, so the reads are not optimized away
+	std::cout << "checksum: " << sum << std::endl;
+	return 0;
+}
@@ -0,0 +1,232 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <vector>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/cell.h"
+#include "model/structures/cellcache.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "util/structures/rect.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+// Records the cells it is called for, optionally removes itself on the first call.
+class RectListener : public CellChangeListener {
+public:
+	RectListener(CellCache* cache = NULL, const Rect& rect = Rect()):
+		m_cache(cache),
+		m_rect(rect) {
+	}
+
+	virtual void onInstanceEnteredCell(Cell* cell, Instance* instance) {
+		entered.push_back(cell->getLayerCoordinates());
+		removeSelf();
+	}
+
+	virtual void onInstanceExitedCell(Cell* cell, Instance* instance) {
+		exited.push_back(cell->getLayerCoordinates());
+		removeSelf();
+	}
+
+	virtual void onBlockingChangedCell(Cell* cell, CellTypeInfo type, bool blocks) {
+		blocking.push_back(cell->getLayerCoordinates());
+		removeSelf();
+	}
+
+	std::vector<ModelCoordinate> entered;
+	std::vector<ModelCoordinate> exited;
+	std::vector<ModelCoordinate> blocking;
+
+private:
+	void removeSelf() {
+		if (m_cache) {
+			m_cache->removeCellChangeListener(m_rect, this);
+			m_cache = NULL;
+		}
+	}
+
+	CellCache* m_cache;
+	Rect m_rect;
+};
+
+// A walkable layer with 16x16 cells, that are 2x2 blocks of the rect listener index.
+struct CellCacheEnvironment {
+	CellCacheEnvironment():
+		model(NULL, renderers) {
+		model.adoptCellGrid(new SquareGrid());
+		Object* tile = model.createObject("tile", "test");
+		tile->setStatic(true);
+		critter = model.createObject("critter", "test");
+		map = model.createMap("cellcachemap");
+		layer = map->createLayer("ground", model.getCellGrid("square"));
+		layer->setWalkable(true);
+		for (int32_t y = 0; y < 16; ++y) {
+			for (int32_t x = 0; x < 16; ++x) {
+				layer->createInstance(tile, ModelCoordinate(x, y));
+			}
+		}
+		map->initializeCellCaches();
+		map->finalizeCellCaches();
+		cache = layer->getCellCache();
+		instance = layer->createInstance(critter, ModelCoordinate(15, 15));
+	}
+
+	~CellCacheEnvironment() {
+		model.deleteMap(map);
+	}
+
+	// the instance enters and leaves the cell
+	void visit(int32_t x, int32_t y) {
+		Cell* cell = cache->getCell(ModelCoordinate(x, y));
+		cell->addInstance(instance);
+		cell->removeInstance(instance);
+	}
+
+	// the TimeManager is needed by the layers, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model;
+	Object* critter;
+	Map* map;
+	Layer* layer;
+	CellCache* cache;
+	Instance* instance;
+};
+
+TEST(cellcache_rect_listener_only_fires_inside_rect)
+{
+	CellCacheEnvironment env;
+	RectListener listener;
+	// covers the cells 2-4, all in the first 8x8 block
+	Rect rect(2, 2, 3, 3);
+	env.cache->addCellChangeListener(rect, &listener);
+
+	env.visit(2, 2);
+	env.visit(4, 4);
+	CHECK_EQUAL(2u, listener.entered.size());
+	CHECK_EQUAL(2u, listener.exited.size());
+	CHECK(ModelCoordinate(2, 2) == listener.entered[0]);
+	CHECK(ModelCoordinate(4, 4) == listener.entered[1]);
+	CHECK(ModelCoordinate(4, 4) == listener.exited[1]);
+
+	// same block, but outside of the rect, the right and bottom border are excluded
+	env.visit(5, 2);
+	env.visit(2, 5);
+	env.visit(1, 3);
+	env.visit(7, 7);
+	env.visit(0, 0);
+	// another block
+	env.visit(8, 3);
+	CHECK_EQUAL(2u, listener.entered.size());
+	CHECK_EQUAL(2u, listener.exited.size());
+	CHECK(listener.blocking.empty());
+
+	// blocking changes are reported for the rect too
+	env.instance->setOverrideBlocking(true);
+	env.instance->setBlocking(true);
+	env.visit(3, 3);
+	env.visit(6, 6);
+	CHECK_EQUAL(2u, listener.blocking.size());
+	CHECK(ModelCoordinate(3, 3) == listener.blocking[0]);
+	CHECK(ModelCoordinate(3, 3) == listener.blocking[1]);
+	CHECK_EQUAL(3u, listener.entered.size());
+	env.instance->setBlocking(false);
+
+	// a rect in the same block does not get the calls of the other rect
+	RectListener neighbor;
+	Rect neighborRect(5, 5, 2, 2);
+	env.cache->addCellChangeListener(neighborRect, &neighbor);
+	env.visit(3, 3);
+	env.visit(5, 6);
+	CHECK_EQUAL(4u, listener.entered.size());
+	CHECK_EQUAL(1u, neighbor.entered.size());
+	CHECK(ModelCoordinate(5, 6) == neighbor.entered[0]);
+
+	// removed rects are not called anymore, the other rect of the block still is
+	env.cache->removeCellChangeListener(rect, &listener);
+	env.visit(3, 3);
+	env.visit(6, 5);
+	CHECK_EQUAL(4u, listener.entered.size());
+	CHECK_EQUAL(2u, neighbor.entered.size());
+	env.cache->removeCellChangeListener(neighborRect, &neighbor);
+	env.visit(6, 5);
+	CHECK_EQUAL(2u, neighbor.entered.size());
+}
+
+TEST(cellcache_rect_listener_removes_itself)
+{
+	CellCacheEnvironment env;
+	Rect rect(2, 2, 3, 3);
+	RectListener remover(env.cache, rect);
+	RectListener other;
+	env.cache->addCellChangeListener(rect, &remover);
+	env.cache->addCellChangeListener(Rect(3, 3, 2, 2), &other);
+
+	// the listener after the removed one is still called
+	env.visit(3, 3);
+	CHECK_EQUAL(1u, remover.entered.size());
+	CHECK(remover.exited.empty());
+	CHECK_EQUAL(1u, other.entered.size());
+	CHECK_EQUAL(1u, other.exited.size());
+
+	env.visit(4, 4);
+	env.visit(2, 2);
+	CHECK_EQUAL(1u, remover.entered.size());
+	CHECK_EQUAL(2u, other.entered.size());
+
+	// the only rect of a cell removes itself, the cell loses the shared listener during the call
+	Rect single(10, 10, 1, 1);
+	RectListener lonely(env.cache, single);
+	env.cache->addCellChangeListener(single, &lonely);
+	env.visit(10, 10);
+	env.visit(10, 10);
+	CHECK_EQUAL(1u, lonely.entered.size());
+	CHECK(lonely.exited.empty());
+
+	// the rect can be added again
+	RectListener again;
+	env.cache->addCellChangeListener(single, &again);
+	env.visit(10, 10);
+	CHECK_EQUAL(1u, again.entered.size());
+	CHECK_EQUAL(1u, again.exited.size());
+	env.cache->removeCellChangeListener(single, &again);
+	env.cache->removeCellChangeListener(Rect(3, 3, 2, 2), &other);
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
@@ -0,0 +1,225 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <vector>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/cell.h"
+#include "model/structures/cellcache.h"
+#include "model/structures/fieldofview.h"
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+// A square map of 21x21 walkable cells, walls are cells with the type CTYPE_CELL_BLOCKER.
+struct FieldOfViewEnvironment {
+	FieldOfViewEnvironment():
+		model(NULL, renderers) {
+		model.adoptCellGrid(new SquareGrid());
+		Object* tile = model.createObject("tile", "test");
+		tile->setStatic(true);
+		map = model.createMap("fovmap");
+		layer = map->createLayer("ground", model.getCellGrid("square"));
+		layer->setWalkable(true);
+		for (int32_t y = 0; y < SIZE; ++y) {
+			for (int32_t x = 0; x < SIZE; ++x) {
+				layer->createInstance(tile, ModelCoordinate(x, y));
+			}
+		}
+		map->initializeCellCaches();
+		map->finalizeCellCaches();
+		cache = layer->getCellCache();
+	}
+
+	~FieldOfViewEnvironment() {
+		model.deleteMap(map);
+	}
+
+	void setWall(int32_t x, int32_t y, bool wall) {
+		cache->getCell(ModelCoordinate(x, y))->setCellType(wall ? CTYPE_CELL_BLOCKER : CTYPE_NO_BLOCKER);
+	}
+
+	// number of cells of the map inside the radius, the same border as CellCache::getCellsInCircle
+	static uint32_t countCellsInRadius(const ModelCoordinate& center, int32_t radius) {
+		uint32_t count = 0;
+		for (int32_t y = 0; y < SIZE; ++y) {
+			for (int32_t x = 0; x < SIZE; ++x) {
+				int32_t dx = x - center.x;
+				int32_t dy = y - center.y;
+				if (dx * dx + dy * dy <= (radius + 1) * radius) {
+					++count;
+				}
+			}
+		}
+		return count;
+	}
+
+	static const int32_t SIZE = 21;
+
+	// the layers need a time manager, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model;
+	Map* map;
+	Layer* layer;
+	CellCache* cache;
+};
+
+TEST(fieldofview_open_room)
+{
+	FieldOfViewEnvironment env;
+	CHECK_EQUAL(static_cast<uint32_t>(FieldOfViewEnvironment::SIZE), env.cache->getWidth());
+
+	ModelCoordinate observer(10, 10);
+	FieldOfView* fov = env.cache->createFieldOfView(observer, 5);
+	CHECK(fov->isDirty());
+	CHECK(fov->update());
+	CHECK(!fov->isDirty());
+	CHECK(!fov->update());
+
+	// without walls every cell in the radius is visible
+	CHECK_EQUAL(FieldOfViewEnvironment::countCellsInRadius(observer, 5), fov->getVisibleCount());
+	CHECK_EQUAL(fov->getVisibleCount(), fov->getVisibleCells().size());
+	CHECK(fov->isVisible(observer));
+	CHECK(fov->isVisible(ModelCoordinate(10, 15)));
+	CHECK(fov->isVisible(ModelCoordinate(14, 13)));
+	CHECK(!fov->isVisible(ModelCoordinate(10, 16)));
+	CHECK(!fov->isVisible(ModelCoordinate(15, 15)));
+
+	const Rect& bounds = fov->getBounds();
+	CHECK_EQUAL(5, bounds.x);
+	CHECK_EQUAL(5, bounds.y);
+	CHECK_EQUAL(11, bounds.w);
+	CHECK_EQUAL(11, bounds.h);
+	CHECK_EQUAL(121u, fov->getBitmap().size());
+}
+
+TEST(fieldofview_pillar_shadow)
+{
+	FieldOfViewEnvironment env;
+	env.setWall(12, 10, true);
+	FieldOfView* fov = env.cache->createFieldOfView(ModelCoordinate(10, 10), 6);
+	env.cache->updateFieldsOfView();
+
+	// the pillar itself is visible, the cells right behind it are not
+	CHECK(fov->isVisible(ModelCoordinate(11, 10)));
+	CHECK(fov->isVisible(ModelCoordinate(12, 10)));
+	CHECK(!fov->isVisible(ModelCoordinate(13, 10)));
+	CHECK(!fov->isVisible(ModelCoordinate(14, 10)));
+	CHECK(!fov->isVisible(ModelCoordinate(16, 10)));
+	// the other directions are open
+	CHECK(fov->isVisible(ModelCoordinate(8, 10)));
+	CHECK(fov->isVisible(ModelCoordinate(10, 14)));
+
+	// dynamic blockers can be made transparent, cell blockers stay opaque
+	fov->setDynamicBlocking(false);
+	CHECK(fov->isDirty());
+	fov->update();
+	CHECK(!fov->isVisible(ModelCoordinate(13, 10)));
+}
+
+TEST(fieldofview_observer_at_grid_edge)
+{
+	FieldOfViewEnvironment env;
+	ModelCoordinate corner(0, 0);
+	FieldOfView* fov = env.cache->createFieldOfView(corner, 4);
+	fov->update();
+
+	// the part of the radius inside the map is visible, nothing outside of it
+	CHECK_EQUAL(-4, fov->getBounds().x);
+	CHECK_EQUAL(FieldOfViewEnvironment::countCellsInRadius(corner, 4), fov->getVisibleCount());
+	CHECK(fov->isVisible(ModelCoordinate(4, 0)));
+	CHECK(fov->isVisible(ModelCoordinate(0, 4)));
+	CHECK(!fov->isVisible(ModelCoordinate(-1, 0)));
+	CHECK(!fov->isVisible(ModelCoordinate(0, -1)));
+
+	ModelCoordinate border(20, 10);
+	fov->setObserver(border);
+	CHECK(fov->isDirty());
+	fov->update();
+	CHECK_EQUAL(FieldOfViewEnvironment::countCellsInRadius(border, 4), fov->getVisibleCount());
+	CHECK(!fov->isVisible(ModelCoordinate(21, 10)));
+
+	// an observer outside of the cache sees nothing
+	fov->setObserver(ModelCoordinate(-3, -3));
+	fov->update();
+	CHECK_EQUAL(0u, fov->getVisibleCount());
+}
+
+TEST(fieldofview_blocking_change_dirties_only_observers_that_see_it)
+{
+	FieldOfViewEnvironment env;
+	// a wall splits the map into two rooms
+	for (int32_t y = 0; y < FieldOfViewEnvironment::SIZE; ++y) {
+		env.setWall(10, y, true);
+	}
+	FieldOfView* left = env.cache->createFieldOfView(ModelCoordinate(7, 10), 6);
+	FieldOfView* right = env.cache->createFieldOfView(ModelCoordinate(16, 10), 3);
+	CHECK_EQUAL(2u, env.cache->updateFieldsOfView());
+	CHECK(left->isVisible(ModelCoordinate(10, 10)));
+	CHECK(!left->isVisible(ModelCoordinate(12, 10)));
+	CHECK_EQUAL(0u, env.cache->updateFieldsOfView());
+
+	// only seen by the left observer
+	env.setWall(5, 10, true);
+	CHECK(left->isDirty());
+	CHECK(!right->isDirty());
+	CHECK_EQUAL(1u, env.cache->updateFieldsOfView());
+
+	// only seen by the right observer
+	env.setWall(17, 10, true);
+	CHECK(!left->isDirty());
+	CHECK(right->isDirty());
+	CHECK_EQUAL(1u, env.cache->updateFieldsOfView());
+
+	// behind the wall of the left one and out of the radius of the right one
+	env.setWall(12, 10, true);
+	CHECK(!left->isDirty());
+	CHECK(!right->isDirty());
+	CHECK_EQUAL(0u, env.cache->updateFieldsOfView());
+
+	// opening the wall makes the cells behind it visible
+	env.setWall(10, 10, false);
+	CHECK(left->isDirty());
+	CHECK_EQUAL(1u, env.cache->updateFieldsOfView());
+	CHECK(left->isVisible(ModelCoordinate(11, 10)));
+
+	env.cache->removeFieldOfView(right);
+	CHECK_EQUAL(1u, env.cache->getFieldsOfView().size());
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
@@ -0,0 +1,133 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <cstring>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/framearena.h"
+
+using namespace FIFE;
+
+TEST(framearena_nested_scopes)
+{
+	FrameArena& arena = FrameArena::get();
+	const std::size_t before = arena.getUsedBytes();
+	{
+		FrameArenaScope outer;
+		FrameVector<int32_t> first(16, 1);
+		const std::size_t afterOuter = arena.getUsedBytes();
+		CHECK(afterOuter >= before + 16 * sizeof(int32_t));
+		{
+			FrameArenaScope inner;
+			FrameVector<int32_t> second(100, 2);
+			CHECK(arena.getUsedBytes() >= afterOuter + 100 * sizeof(int32_t));
+		}
+		// the inner scope only frees its own allocations
+		CHECK_EQUAL(afterOuter, arena.getUsedBytes());
+		CHECK_EQUAL(16u, first.size());
+		CHECK_EQUAL(1, first[15]);
+	}
+	CHECK_EQUAL(before, arena.getUsedBytes());
+}
+
+TEST(framearena_growth_across_blocks)
+{
+	FrameArena arena(256);
+	char* first = static_cast<char*>(arena.allocate(200, 8));
+	std::memset(first, 1, 200);
+	// does not fit into the first block anymore
+	char* second = static_cast<char*>(arena.allocate(200, 8));
+	std::memset(second, 2, 200);
+	CHECK_EQUAL(2u, arena.getBlockAllocations());
+	CHECK_EQUAL(400u, arena.getUsedBytes());
+	CHECK_EQUAL(400u, arena.getPeakBytes());
+	// the second block doubles the size of the first one
+	CHECK_EQUAL(256u + 512u, arena.getCapacity());
+	CHECK_EQUAL(1, first[199]);
+	CHECK_EQUAL(2, second[0]);
+
+	char* unaligned = static_cast<char*>(arena.allocate(1, 1));
+	void* aligned = arena.allocate(8, 8);
+	CHECK(unaligned != 0);
+	CHECK_EQUAL(0u, reinterpret_cast<std::size_t>(aligned) % 8);
+
+	// rewinding keeps the blocks, so the same allocations don't touch the heap again
+	FrameArena::Marker start = { 0, 0 };
+	arena.rewind(start);
+	CHECK_EQUAL(0u, arena.getUsedBytes());
+	CHECK(arena.allocate(200, 8) == first);
+	CHECK(arena.allocate(200, 8) == second);
+	CHECK_EQUAL(2u, arena.getBlockAllocations());
+}
+
+TEST(framearena_reset_consolidation)
+{
+	FrameArena arena(256);
+	arena.allocate(200, 8);
+	arena.allocate(200, 8);
+	CHECK_EQUAL(2u, arena.getBlockAllocations());
+
+	// the peak did not fit into the first block, so reset replaces the blocks by one
+	arena.reset();
+	CHECK_EQUAL(0u, arena.getUsedBytes());
+	CHECK_EQUAL(0u, arena.getCapacity());
+	arena.allocate(400, 8);
+	arena.allocate(400, 8);
+	CHECK_EQUAL(3u, arena.getBlockAllocations());
+	const std::size_t capacity = arena.getCapacity();
+	CHECK(capacity >= 800u);
+
+	// a single block is kept
+	arena.reset();
+	CHECK_EQUAL(capacity, arena.getCapacity());
+	arena.allocate(800, 8);
+	CHECK_EQUAL(3u, arena.getBlockAllocations());
+}
+
+TEST(framearena_lifo_deallocate)
+{
+	FrameArena arena(1024);
+	void* first = arena.allocate(64, 8);
+	void* second = arena.allocate(32, 8);
+	CHECK_EQUAL(96u, arena.getUsedBytes());
+
+	// only the last allocation is given back
+	arena.deallocate(first, 64);
+	CHECK_EQUAL(96u, arena.getUsedBytes());
+	arena.deallocate(second, 32);
+	CHECK_EQUAL(64u, arena.getUsedBytes());
+	arena.deallocate(first, 64);
+	CHECK_EQUAL(0u, arena.getUsedBytes());
+	CHECK(arena.allocate(64, 8) == first);
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
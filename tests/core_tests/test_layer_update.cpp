@@ -0,0 +1,155 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+// Standard C++ library includes
+#include <algorithm>
+#include <vector>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/instance.h"
+#include "model/structures/layer.h"
+#include "model/structures/map.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+// Layer::update visits the active instances by index. Instance callbacks that remove
+// or delete a peer must not make it skip an instance or report a deleted one as changed.
+
+class PeerRemover : public InstanceChangeListener {
+public:
+	PeerRemover(Layer* layer, Instance* peer, bool destroy) : m_layer(layer), m_peer(peer), m_destroy(destroy) {}
+
+	virtual void onInstanceChanged(Instance* instance, InstanceChangeInfo info) {
+		if (!m_peer) {
+			return;
+		}
+		if (m_destroy) {
+			m_layer->deleteInstance(m_peer);
+		} else {
+			m_layer->removeInstance(m_peer);
+		}
+		m_peer = NULL;
+	}
+
+private:
+	Layer* m_layer;
+	Instance* m_peer;
+	bool m_destroy;
+};
+
+struct LayerUpdateEnvironment {
+	LayerUpdateEnvironment():
+		model(NULL, renderers) {
+		model.adoptCellGrid(new SquareGrid());
+		object = model.createObject("critter", "test");
+		map = model.createMap("updatemap");
+		layer = map->createLayer("layer", model.getCellGrid("square"));
+		peer = layer->createInstance(object, ModelCoordinate(0, 0));
+		remover = layer->createInstance(object, ModelCoordinate(1, 0));
+		last = layer->createInstance(object, ModelCoordinate(2, 0));
+		layer->update();
+	}
+
+	~LayerUpdateEnvironment() {
+		model.deleteMap(map);
+	}
+
+	// lets the remover take the peer out during the next update, the peer is activated
+	// first, so it is in front of the remover
+	void updateRemovingPeer(bool destroy) {
+		PeerRemover listener(layer, peer, destroy);
+		remover->addChangeListener(&listener);
+		peer->setRotation(90);
+		remover->setRotation(90);
+		last->setRotation(90);
+		layer->update();
+		remover->removeChangeListener(&listener);
+	}
+
+	bool isChanged(Instance* instance) const {
+		const std::vector<Instance*>& changed = layer->getChangedInstances();
+		return std::find(changed.begin(), changed.end(), instance) != changed.end();
+	}
+
+	// the layers need a time manager, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model;
+	Object* object;
+	Map* map;
+	Layer* layer;
+	Instance* peer;
+	Instance* remover;
+	Instance* last;
+};
+
+TEST(layer_update_remove_peer_from_callback)
+{
+	LayerUpdateEnvironment env;
+	env.updateRemovingPeer(false);
+
+	CHECK(env.isChanged(env.last));
+	CHECK(!env.isChanged(env.peer));
+	CHECK_EQUAL(2u, env.layer->getInstances().size());
+
+	// the active instances are still consistent in the next frame
+	env.remover->setRotation(180);
+	env.last->setRotation(180);
+	env.layer->update();
+	CHECK(env.isChanged(env.remover));
+	CHECK(env.isChanged(env.last));
+
+	// removeInstance leaves the instance to the caller
+	delete env.peer;
+}
+
+TEST(layer_update_delete_peer_from_callback)
+{
+	LayerUpdateEnvironment env;
+	env.updateRemovingPeer(true);
+
+	CHECK(env.isChanged(env.last));
+	CHECK(!env.isChanged(env.peer));
+	CHECK_EQUAL(2u, env.layer->getInstances().size());
+
+	env.remover->setRotation(180);
+	env.last->setRotation(180);
+	env.layer->update();
+	CHECK(env.isChanged(env.remover));
+	CHECK(env.isChanged(env.last));
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+
+// Standard C++ library includes
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 3rd party library includes
+#include <SDL.h>
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/base/exception.h"
+#include "util/structures/rect.h"
+#include "video/devicecaps.h"
+#include "video/opengl/fife_opengl.h"
+#include "video/opengl/renderbackendopengl.h"
+
+using namespace FIFE;
+
+// Renders the same primitives and texture quads once with client side vertex arrays
+// and once with the streamed vertex buffer objects and compares the read back pixels.
+// It needs a real OpenGL context, in CI that is Mesa's software renderer, either under
+// Xvfb or with "--driver offscreen" (EGL, SDL 2.0.10 and later).
+
+static const uint16_t WIDTH = 256;
+static const uint16_t HEIGHT = 256;
+static const int32_t FRAMES = 4;
+
+static GLuint createCheckerTexture() {
+	std::vector<uint8_t> pixels(16 * 16 * 4);
+	for (uint32_t y = 0; y < 16; ++y) {
+		for (uint32_t x = 0; x < 16; ++x) {
+			uint8_t* pixel = &pixels[(y * 16 + x) * 4];
+			bool odd = ((x / 4) + (y / 4)) % 2 != 0;
+			pixel[0] = odd ? 255 : 40;
+			pixel[1] = odd ? 200 : 80;
+			pixel[2] = odd ? 20 : 160;
+			pixel[3] = 255;
+		}
+	}
+	GLuint id = 0;
+	glGenTextures(1, &id);
+	glBindTexture(GL_TEXTURE_2D, id);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 16, 16, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return id;
+}
+
+// every frame adds more quads, so the stream buffers grow and get orphaned
+static void renderScene(RenderBackendOpenGL& backend, GLuint texture, int32_t frame) {
+	const float st[] = { 0.0f, 0.0f, 1.0f, 1.0f };
+	const int32_t quads = 16 << (frame * 2);
+	for (int32_t i = 0; i < quads; ++i) {
+		int32_t x = (i * 7) % (WIDTH - 16);
+		int32_t y = (i * 13) % (HEIGHT - 16);
+		backend.addImageToArray(texture, Rect(x, y, 16, 16), st, 255, 0);
+	}
+	for (int32_t i = 0; i < 32; ++i) {
+		backend.fillRectangle(Point(i * 8, 200), 6, 40, static_cast<uint8_t>(i * 8), 100, 200);
+	}
+	backend.drawTriangle(Point(10, 10), Point(120, 60), Point(40, 150), 250, 20, 20);
+	backend.drawLine(Point(0, 255), Point(255, 0), 255, 255, 255);
+	backend.addImageToArray(texture, Rect(140, 20, 100, 100), st, 128, 0);
+	backend.renderVertexArrays();
+}
+
+static bool renderFrames(const std::string& driver, bool vbo, std::vector<std::vector<uint8_t> >& frames) {
+	SDL_Color colorkey = { 255, 0, 255, 0 };
+	RenderBackendOpenGL backend(colorkey);
+	backend.setVertexBufferObjectsEnabled(vbo);
+	backend.init(driver);
+	backend.createMainScreen(ScreenMode(WIDTH, HEIGHT, 32, SDL_WINDOW_OPENGL), "FIFE", "");
+	if (backend.isVertexBufferObjectsEnabled() != vbo) {
+		std::cerr << "vertex buffer objects are not supported by " << glGetString(GL_RENDERER) << std::endl;
+		return false;
+	}
+
+	GLuint texture = createCheckerTexture();
+	for (int32_t frame = 0; frame < FRAMES; ++frame) {
+		backend.startFrame();
+		backend.pushClipArea(Rect(0, 0, WIDTH, HEIGHT), true);
+		renderScene(backend, texture, frame);
+		std::vector<uint8_t> pixels(WIDTH * HEIGHT * 3);
+		glReadPixels(0, 0, WIDTH, HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, &pixels[0]);
+		frames.push_back(pixels);
+		backend.popClipArea();
+		backend.endFrame();
+	}
+	glDeleteTextures(1, &texture);
+	return true;
+}
+
+int main(int argc, char** argv) {
+	std::string driver;
+	for (int32_t i = 1; i + 1 < argc; i += 2) {
+		std::string option = argv[i];
+		if (option == "--driver") {
+			driver = argv[i + 1];
+		} else {
+			std::cerr << "unknown option " << option << std::endl;
+			return 1;
+		}
+	}
+
+	std::vector<std::vector<uint8_t> > arrays;
+	std::vector<std::vector<uint8_t> > buffers;
+	try {
+		if (!renderFrames(driver, false, arrays) || !renderFrames(driver, true, buffers)) {
+			return 1;
+		}
+	} catch (const Exception& e) {
+		std::cerr << "could not create an OpenGL context: " << e.what() << std::endl;
+		return 1;
+	}
+
+	int32_t failed = 0;
+	for (int32_t frame = 0; frame < FRAMES; ++frame) {
+		uint32_t lit = 0;
+		uint32_t different = 0;
+		for (uint32_t i = 0; i < arrays[frame].size(); ++i) {
+			lit += arrays[frame][i] != 0;
+			different += arrays[frame][i] != buffers[frame][i];
+		}
+		if (lit == 0) {
+			std::cerr << "frame " << frame << ": nothing was rendered" << std::endl;
+			++failed;
+		} else if (different != 0) {
+			std::cerr << "frame " << frame << ": " << different << " color values differ between vertex arrays and buffer objects" << std::endl;
+			++failed;
+		}
+	}
+	if (failed == 0) {
+		std::cout << "vertex buffer objects match vertex arrays in " << FRAMES << " frames" << std::endl;
+	}
+	return failed == 0 ? 0 : 1;
+}
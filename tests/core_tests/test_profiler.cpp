@@ -0,0 +1,147 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "util/time/profiler.h"
+
+using namespace FIFE;
+
+static uint32_t countOccurrences(const std::string& text, const std::string& pattern) {
+	uint32_t count = 0;
+	std::string::size_type pos = text.find(pattern);
+	while (pos != std::string::npos) {
+		++count;
+		pos = text.find(pattern, pos + pattern.size());
+	}
+	return count;
+}
+
+TEST(profiler_nesting_depth)
+{
+	if (!Profiler::isAvailable()) {
+		return;
+	}
+	Profiler profiler(64);
+	profiler.setEnabled(true);
+	{
+		ProfileZone outer("outer");
+		{
+			ProfileZone inner("inner");
+			ProfileZone innermost("innermost");
+		}
+		ProfileZone second("inner");
+	}
+	profiler.endFrame();
+
+	CHECK_EQUAL(0u, profiler.getZoneDepth("outer"));
+	CHECK_EQUAL(1u, profiler.getZoneDepth("inner"));
+	CHECK_EQUAL(2u, profiler.getZoneDepth("innermost"));
+	CHECK_EQUAL(1u, profiler.getZoneCalls("outer"));
+	CHECK_EQUAL(2u, profiler.getZoneCalls("inner"));
+	CHECK_EQUAL(1u, profiler.getZoneCalls("innermost"));
+	CHECK(profiler.getZoneTime("outer") >= profiler.getZoneTime("innermost"));
+	CHECK_EQUAL(1u, profiler.getHistorySize());
+
+	// nothing is recorded while disabled
+	profiler.setEnabled(false);
+	{
+		ProfileZone outer("outer");
+	}
+	profiler.setEnabled(true);
+	profiler.endFrame();
+	CHECK_EQUAL(0u, profiler.getZoneCalls("outer"));
+	CHECK_EQUAL(2u, profiler.getHistorySize());
+}
+
+TEST(profiler_ring_wrap)
+{
+	if (!Profiler::isAvailable()) {
+		return;
+	}
+	Profiler profiler(8);
+	profiler.setEnabled(true);
+	const char* name = Profiler::intern("wrap");
+	CHECK(name == Profiler::intern(std::string("wrap")));
+
+	// 20 records in a ring of 8, the slot written next is not read
+	for (int64_t i = 0; i < 20; ++i) {
+		profiler.record(name, i * 1000, i * 1000 + 500, 0, 0);
+	}
+	profiler.endFrame();
+	CHECK_EQUAL(7u, profiler.getZoneCalls("wrap"));
+	CHECK_CLOSE(0.0035, profiler.getZoneTime("wrap"), 0.0000001);
+
+	// records already gathered are not counted again
+	for (int64_t i = 0; i < 3; ++i) {
+		profiler.record(name, i * 1000, i * 1000 + 500, 0, 0);
+	}
+	profiler.endFrame();
+	CHECK_EQUAL(3u, profiler.getZoneCalls("wrap"));
+
+	profiler.endFrame();
+	CHECK_EQUAL(0u, profiler.getZoneCalls("wrap"));
+	CHECK_EQUAL(3u, profiler.getZoneHistory("wrap").size());
+}
+
+TEST(profiler_chrome_trace)
+{
+	Profiler profiler(16);
+	profiler.record("first", 1000, 1500, 0, 0);
+	profiler.record(Profiler::intern("quoted \"name\""), 2000, 4000, 1, 3);
+
+	const std::string filename = "test_profiler_trace.json";
+	CHECK(profiler.exportChromeTrace(filename));
+
+	std::ifstream file(filename.c_str());
+	std::stringstream stream;
+	stream << file.rdbuf();
+	file.close();
+	std::remove(filename.c_str());
+	const std::string trace = stream.str();
+
+	CHECK_EQUAL(0u, trace.find("{\"traceEvents\":["));
+	CHECK(trace.find("],\"displayTimeUnit\":\"ms\"}") != std::string::npos);
+	CHECK_EQUAL(1u, countOccurrences(trace, "\"ph\":\"M\""));
+	CHECK_EQUAL(2u, countOccurrences(trace, "\"ph\":\"X\""));
+	CHECK(trace.find("\"name\":\"first\",\"cat\":\"fife\",\"ph\":\"X\",\"pid\":1,\"tid\":0,\"ts\":1.000,\"dur\":0.500") != std::string::npos);
+	CHECK(trace.find("\"name\":\"quoted \\\"name\\\"\"") != std::string::npos);
+	CHECK(trace.find("\"args\":{\"allocations\":3}") != std::string::npos);
+	// every opened brace is closed
+	CHECK_EQUAL(countOccurrences(trace, "{"), countOccurrences(trace, "}"));
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
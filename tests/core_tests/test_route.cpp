@@ -0,0 +1,294 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <vector>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/cell.h"
+#include "model/structures/cellcache.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+#include "model/structures/map.h"
+#include "pathfinder/route.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+// Two walkable layers with 10x10 cells. The ground cell (5,5) is raised to z 1 and the
+// ground cell (5,2) has a transition to the upper layer.
+struct RouteEnvironment {
+	RouteEnvironment():
+		model(NULL, renderers) {
+		model.adoptCellGrid(new SquareGrid());
+		Object* tile = model.createObject("tile", "test");
+		tile->setStatic(true);
+		map = model.createMap("routemap");
+		ground = map->createLayer("ground", model.getCellGrid("square"));
+		ground->setWalkable(true);
+		upper = map->createLayer("upper", model.getCellGrid("square"));
+		upper->setWalkable(true);
+		for (int32_t y = 0; y < 10; ++y) {
+			for (int32_t x = 0; x < 10; ++x) {
+				ground->createInstance(tile, ModelCoordinate(x, y));
+				upper->createInstance(tile, ModelCoordinate(x, y));
+			}
+		}
+		ground->createInstance(tile, ModelCoordinate(5, 5, 1));
+		map->initializeCellCaches();
+		map->finalizeCellCaches();
+		ground->getCellCache()->getCell(ModelCoordinate(5, 2))->createTransition(upper, ModelCoordinate(5, 2));
+	}
+
+	~RouteEnvironment() {
+		model.deleteMap(map);
+	}
+
+	Location location(Layer* layer, int32_t x, int32_t y) const {
+		Location loc(layer);
+		loc.setLayerCoordinates(ModelCoordinate(x, y));
+		return loc;
+	}
+
+	// the TimeManager is needed by the layers, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model;
+	Map* map;
+	Layer* ground;
+	Layer* upper;
+};
+
+static bool sameCell(const Location& a, const Location& b) {
+	ModelCoordinate ac = a.getLayerCoordinates();
+	ModelCoordinate bc = b.getLayerCoordinates();
+	return a.getLayer() == b.getLayer() && ac.x == bc.x && ac.y == bc.y;
+}
+
+static bool samePath(const Path& a, const Path& b) {
+	if (a.size() != b.size()) {
+		return false;
+	}
+	Path::const_iterator ait = a.begin();
+	Path::const_iterator bit = b.begin();
+	for (; ait != a.end(); ++ait, ++bit) {
+		if (!sameCell(*ait, *bit)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST(route_cellpath_single_layer_roundtrip)
+{
+	RouteEnvironment env;
+	Path path;
+	path.push_back(env.location(env.ground, 0, 0));
+	path.push_back(env.location(env.ground, 1, 0));
+	path.push_back(env.location(env.ground, 2, 1));
+	// steps outside of the cache use their own id space
+	path.push_back(env.location(env.ground, -3, 12));
+	path.push_back(env.location(env.ground, 9, 9));
+
+	CellPath cells;
+	cells.assign(path);
+	CHECK_EQUAL(5u, cells.size());
+	uint32_t index = 0;
+	for (Path::const_iterator it = path.begin(); it != path.end(); ++it, ++index) {
+		CHECK(cells.getLayer(index) == env.ground);
+		CHECK((*it).getLayerCoordinates() == cells.getLayerCoordinates(index));
+	}
+
+	Route route(path.front(), path.back());
+	route.setPath(path);
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_SOLVED), route.getRouteStatus());
+	CHECK_EQUAL(5u, route.getPathLength());
+	CHECK(samePath(path, route.getPath()));
+
+	// ids made from a cache are read back the same
+	CellCache* cache = env.ground->getCellCache();
+	CellPath added;
+	added.addCell(cache, cache->convertCoordToInt(ModelCoordinate(3, 4)));
+	added.addCell(cache, cache->convertCoordToInt(ModelCoordinate(4, 4)));
+	CHECK_EQUAL(2u, added.size());
+	CHECK(ModelCoordinate(3, 4) == added.getLayerCoordinates(0));
+	CHECK(ModelCoordinate(4, 4) == added.getLayerCoordinates(1));
+	added.clear();
+	CHECK(added.empty());
+}
+
+TEST(route_cellpath_multi_layer_roundtrip)
+{
+	RouteEnvironment env;
+	Path path;
+	path.push_back(env.location(env.ground, 3, 2));
+	path.push_back(env.location(env.ground, 4, 2));
+	path.push_back(env.location(env.ground, 5, 2));
+	path.push_back(env.location(env.upper, 5, 2));
+	path.push_back(env.location(env.upper, 6, 2));
+	path.push_back(env.location(env.ground, 7, 7));
+
+	CellPath cells;
+	cells.assign(path);
+	CHECK_EQUAL(6u, cells.size());
+	CHECK(cells.getLayer(2) == env.ground);
+	CHECK(cells.getLayer(3) == env.upper);
+	CHECK(cells.getLayer(4) == env.upper);
+	CHECK(cells.getLayer(5) == env.ground);
+	CHECK(ModelCoordinate(6, 2) == cells.getLayerCoordinates(4));
+	CHECK(ModelCoordinate(7, 7) == cells.getLayerCoordinates(5));
+
+	// steps added from different caches get their own layer entries
+	CellPath added;
+	CellCache* groundCache = env.ground->getCellCache();
+	CellCache* upperCache = env.upper->getCellCache();
+	added.addCell(groundCache, groundCache->convertCoordToInt(ModelCoordinate(5, 2)));
+	added.addCell(upperCache, upperCache->convertCoordToInt(ModelCoordinate(5, 2)));
+	added.addCell(upperCache, upperCache->convertCoordToInt(ModelCoordinate(5, 3)));
+	CHECK(added.getLayer(0) == env.ground);
+	CHECK(added.getLayer(1) == env.upper);
+	CHECK(ModelCoordinate(5, 3) == added.getLayerCoordinates(2));
+
+	Route route(path.front(), path.back());
+	route.setPath(path);
+	CHECK(samePath(path, route.getPath()));
+	route.setPath(added);
+	CHECK(sameCell(route.getEndNode(), env.location(env.upper, 5, 3)));
+}
+
+TEST(route_cut_path_then_walk)
+{
+	RouteEnvironment env;
+	Path path;
+	for (int32_t x = 0; x < 6; ++x) {
+		path.push_back(env.location(env.ground, x, 0));
+	}
+	Route route(path.front(), path.back());
+	route.setPath(path);
+	CHECK(route.walkToNextNode());
+	CHECK(sameCell(route.getCurrentNode(), env.location(env.ground, 1, 0)));
+
+	// keeps the current and the next step
+	route.cutPath(2);
+	CHECK(route.isReplanned());
+	CHECK_EQUAL(3u, route.getPathLength());
+	CHECK(sameCell(route.getEndNode(), env.location(env.ground, 2, 0)));
+	CHECK(sameCell(route.getNextNode(), env.location(env.ground, 2, 0)));
+
+	CHECK(route.walkToNextNode());
+	CHECK(sameCell(route.getCurrentNode(), env.location(env.ground, 2, 0)));
+	CHECK(sameCell(route.getPreviousNode(), env.location(env.ground, 1, 0)));
+	// no step behind the new end
+	CHECK(!route.walkToNextNode());
+	CHECK(sameCell(route.getCurrentNode(), env.location(env.ground, 2, 0)));
+
+	// cutting everything leaves the route at the current step
+	route.cutPath(0);
+	CHECK_EQUAL(0u, route.getPathLength());
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_CREATED), route.getRouteStatus());
+	CHECK(sameCell(route.getStartNode(), env.location(env.ground, 2, 0)));
+	CHECK(sameCell(route.getEndNode(), env.location(env.ground, 2, 0)));
+}
+
+TEST(route_smooth_path_keeps_corner_transition_and_height_change)
+{
+	RouteEnvironment env;
+	Path path;
+	for (int32_t x = 0; x < 5; ++x) {
+		path.push_back(env.location(env.ground, x, 0));
+	}
+	for (int32_t y = 0; y < 7; ++y) {
+		path.push_back(env.location(env.ground, 5, y));
+	}
+	Route route(path.front(), path.back());
+	route.setPath(path);
+	CHECK_EQUAL(12u, route.getPathLength());
+	route.smoothPath();
+
+	// start, the corner, the transition, both sides of the height step and the end
+	Path expected;
+	expected.push_back(env.location(env.ground, 0, 0));
+	expected.push_back(env.location(env.ground, 5, 0));
+	expected.push_back(env.location(env.ground, 5, 2));
+	expected.push_back(env.location(env.ground, 5, 4));
+	expected.push_back(env.location(env.ground, 5, 5));
+	expected.push_back(env.location(env.ground, 5, 6));
+	CHECK(samePath(expected, route.getPath()));
+
+	// the last step before and the first step after a layer change are kept
+	Path layers;
+	layers.push_back(env.location(env.ground, 0, 3));
+	layers.push_back(env.location(env.ground, 1, 3));
+	layers.push_back(env.location(env.ground, 2, 3));
+	layers.push_back(env.location(env.upper, 3, 3));
+	layers.push_back(env.location(env.upper, 4, 3));
+	layers.push_back(env.location(env.upper, 5, 3));
+	route.setPath(layers);
+	route.smoothPath();
+	CHECK_EQUAL(4u, route.getPathLength());
+	CHECK(sameCell(route.getPath().back(), env.location(env.upper, 5, 3)));
+	CHECK(route.getCellPath().getLayer(1) == env.ground);
+	CHECK(route.getCellPath().getLayer(2) == env.upper);
+}
+
+TEST(route_set_cell_path_keeps_exact_start)
+{
+	RouteEnvironment env;
+	CellCache* cache = env.ground->getCellCache();
+	CellPath cells;
+	cells.addCell(cache, cache->convertCoordToInt(ModelCoordinate(0, 0)));
+	cells.addCell(cache, cache->convertCoordToInt(ModelCoordinate(1, 0)));
+	cells.addCell(cache, cache->convertCoordToInt(ModelCoordinate(2, 0)));
+
+	Location start(env.ground);
+	start.setExactLayerCoordinates(ExactModelCoordinate(0.25, -0.3));
+	Route route(start, env.location(env.ground, 2, 0));
+	route.setPath(cells);
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_SOLVED), route.getRouteStatus());
+	CHECK_CLOSE(0.25, route.getStartNode().getExactLayerCoordinates().x, 0.00001);
+	CHECK_CLOSE(-0.3, route.getStartNode().getExactLayerCoordinates().y, 0.00001);
+	CHECK_CLOSE(0.25, route.getCurrentNode().getExactLayerCoordinates().x, 0.00001);
+	CHECK_CLOSE(-0.3, route.getPath().front().getExactLayerCoordinates().y, 0.00001);
+	CHECK(sameCell(route.getEndNode(), env.location(env.ground, 2, 0)));
+
+	// a path that begins elsewhere moves the start to the center of its first cell
+	Location elsewhere(env.ground);
+	elsewhere.setExactLayerCoordinates(ExactModelCoordinate(4.25, 4.25));
+	Route moved(elsewhere, env.location(env.ground, 2, 0));
+	moved.setPath(cells);
+	CHECK_CLOSE(0.0, moved.getStartNode().getExactLayerCoordinates().x, 0.00001);
+	CHECK_CLOSE(0.0, moved.getStartNode().getExactLayerCoordinates().y, 0.00001);
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
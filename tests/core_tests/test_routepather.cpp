@@ -0,0 +1,341 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <chrono>
+#include <vector>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "model/model.h"
+#include "model/metamodel/ipather.h"
+#include "model/metamodel/object.h"
+#include "model/metamodel/grids/squaregrid.h"
+#include "model/structures/layer.h"
+#include "model/structures/location.h"
+#include "model/structures/map.h"
+#include "pathfinder/route.h"
+#include "pathfinder/routepather/routepather.h"
+#include "pathfinder/routepather/routepathersearch.h"
+#include "util/time/timemanager.h"
+
+using namespace FIFE;
+
+typedef std::vector<int32_t> Turns;
+
+// Search that needs a fixed number of expansions and logs every expansion with its session id.
+class ScriptedSearch : public RoutePatherSearch {
+public:
+	ScriptedSearch(Route* route, const int32_t sessionId, Turns* turns, int32_t expansions, bool solve, int32_t delay):
+		RoutePatherSearch(route, sessionId),
+		m_turns(turns),
+		m_expansions(expansions),
+		m_solve(solve),
+		m_delay(delay) {
+	}
+
+	virtual void updateSearch() {
+		m_turns->push_back(getSessionId());
+		if (m_delay > 0) {
+			std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() +
+				std::chrono::microseconds(m_delay);
+			while (std::chrono::steady_clock::now() < end) {
+			}
+		}
+		if (--m_expansions == 0) {
+			setSearchStatus(search_status_complete);
+			m_route->setRouteStatus(ROUTE_SEARCHED);
+		}
+	}
+
+	// without a path the route stays searched, like a path that could not be built
+	virtual void calcPath() {
+		if (m_solve) {
+			m_route->setRouteStatus(ROUTE_SOLVED);
+		}
+	}
+
+private:
+	Turns* m_turns;
+	int32_t m_expansions;
+	bool m_solve;
+	int32_t m_delay;
+};
+
+// RoutePather that hands out scripted searches, the members apply to the next solveRoute().
+class ScriptedPather : public RoutePather {
+public:
+	ScriptedPather():
+		expansions(1),
+		solve(true),
+		delay(0) {
+		setMaxTime(0);
+	}
+
+	Turns turns;
+	int32_t expansions;
+	bool solve;
+	//! busy wait per expansion in microseconds
+	int32_t delay;
+
+protected:
+	virtual RoutePatherSearch* createSearch(Route* route, const int32_t sessionId, bool multilayer) {
+		return new ScriptedSearch(route, sessionId, &turns, expansions, solve, delay);
+	}
+};
+
+// A walkable layer with 4x1 cells, all routes go from (0,0) to (3,0).
+struct RoutePatherEnvironment {
+	RoutePatherEnvironment():
+		model(NULL, renderers) {
+		model.adoptCellGrid(new SquareGrid());
+		Object* tile = model.createObject("tile", "test");
+		tile->setStatic(true);
+		map = model.createMap("routepathermap");
+		layer = map->createLayer("ground", model.getCellGrid("square"));
+		layer->setWalkable(true);
+		for (int32_t x = 0; x < 4; ++x) {
+			layer->createInstance(tile, ModelCoordinate(x, 0));
+		}
+		map->initializeCellCaches();
+		map->finalizeCellCaches();
+	}
+
+	~RoutePatherEnvironment() {
+		for (std::vector<Route*>::iterator it = routes.begin(); it != routes.end(); ++it) {
+			delete *it;
+		}
+		model.deleteMap(map);
+	}
+
+	// requests a route that needs the given expansions and returns it, the session ids count up from 0
+	Route* request(int32_t priority, int32_t expansions, bool solve = true) {
+		Location start(layer);
+		start.setLayerCoordinates(ModelCoordinate(0, 0));
+		Location end(layer);
+		end.setLayerCoordinates(ModelCoordinate(3, 0));
+		Route* route = new Route(start, end);
+		routes.push_back(route);
+		pather.expansions = expansions;
+		pather.solve = solve;
+		pather.solveRoute(route, priority);
+		return route;
+	}
+
+	// the TimeManager is needed by the layers, the engine creates it otherwise
+	TimeManager timemanager;
+	std::vector<RendererBase*> renderers;
+	Model model;
+	Map* map;
+	Layer* layer;
+	ScriptedPather pather;
+	std::vector<Route*> routes;
+};
+
+TEST(routepather_batching)
+{
+	RoutePatherEnvironment env;
+	env.pather.setSearchBatchSize(3);
+	Route* a = env.request(MEDIUM_PRIORITY, 5);
+	Route* b = env.request(MEDIUM_PRIORITY, 5);
+	CHECK_EQUAL(0, a->getSessionId());
+	CHECK_EQUAL(1, b->getSessionId());
+	CHECK_EQUAL(2u, env.pather.getActiveSessions());
+
+	// turns of up to 3 expansions, a finished search ends its turn early
+	env.pather.update();
+	Turns expected = {0, 0, 0, 1, 1, 1, 0, 0, 1, 1};
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(10u, env.pather.getFrameExpansions());
+	CHECK_EQUAL(0u, env.pather.getActiveSessions());
+	CHECK_EQUAL(2u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(0u, env.pather.getFailedSearches());
+	CHECK_EQUAL(5u, env.pather.getMaxSearchExpansions());
+	CHECK_CLOSE(5.0, env.pather.getAverageSearchExpansions(), 0.001);
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_SOLVED), a->getRouteStatus());
+	CHECK_EQUAL(5u, a->getSearchExpansions());
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_SOLVED), b->getRouteStatus());
+	CHECK_EQUAL(5u, b->getSearchExpansions());
+}
+
+TEST(routepather_round_robin)
+{
+	RoutePatherEnvironment env;
+	env.pather.setSearchBatchSize(1);
+	env.pather.setMaxTicks(1);
+	env.pather.setPriorityAging(0);
+	env.request(MEDIUM_PRIORITY, 2);
+	env.request(MEDIUM_PRIORITY, 2);
+	env.request(MEDIUM_PRIORITY, 2);
+
+	// one expansion per update, equal priorities take turns in request order
+	for (int32_t i = 0; i < 3; ++i) {
+		env.pather.update();
+		CHECK_EQUAL(1u, env.pather.getFrameExpansions());
+	}
+	CHECK_EQUAL(0u, env.pather.getSolvedSearches());
+	env.pather.update();
+	CHECK_EQUAL(1u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(2u, env.pather.getActiveSessions());
+	env.pather.update();
+	env.pather.update();
+	Turns expected = {0, 1, 2, 0, 1, 2};
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(3u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(0u, env.pather.getFailedSearches());
+	CHECK_EQUAL(0u, env.pather.getActiveSessions());
+
+	// without sessions an update does nothing
+	env.pather.update();
+	CHECK_EQUAL(0u, env.pather.getFrameExpansions());
+	CHECK_EQUAL(6u, env.pather.turns.size());
+}
+
+TEST(routepather_aging_past_high_priority)
+{
+	RoutePatherEnvironment env;
+	env.pather.setSearchBatchSize(1);
+	env.pather.setMaxTicks(1);
+	env.pather.setPriorityAging(2);
+	Route* low = env.request(LOW_PRIORITY, 1);
+
+	// a new high priority search every update, the low one gains one level per two updates
+	// and wins the tie with a fresh high priority search after four updates
+	for (int32_t i = 0; i < 5; ++i) {
+		env.request(HIGH_PRIORITY, 1);
+		env.pather.update();
+	}
+	Turns expected = {1, 2, 3, 4, 0};
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_SOLVED), low->getRouteStatus());
+	CHECK_EQUAL(5u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(1u, env.pather.getActiveSessions());
+
+	env.pather.update();
+	expected.push_back(5);
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(6u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(0u, env.pather.getActiveSessions());
+}
+
+TEST(routepather_without_aging_high_priority_goes_first)
+{
+	RoutePatherEnvironment env;
+	env.pather.setSearchBatchSize(1);
+	env.pather.setMaxTicks(1);
+	env.pather.setPriorityAging(0);
+	Route* low = env.request(LOW_PRIORITY, 1);
+	for (int32_t i = 0; i < 5; ++i) {
+		env.request(HIGH_PRIORITY, 1);
+		env.pather.update();
+	}
+	Turns expected = {1, 2, 3, 4, 5};
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_SEARCHING), low->getRouteStatus());
+	CHECK_EQUAL(1u, env.pather.getActiveSessions());
+}
+
+TEST(routepather_ticks_budget)
+{
+	RoutePatherEnvironment env;
+	env.pather.setSearchBatchSize(100);
+	env.pather.setMaxTicks(4);
+	env.request(MEDIUM_PRIORITY, 6);
+	env.request(MEDIUM_PRIORITY, 6);
+
+	// the batch is cut to the ticks that are left
+	env.pather.update();
+	CHECK_EQUAL(4u, env.pather.getFrameExpansions());
+	env.pather.update();
+	CHECK_EQUAL(4u, env.pather.getFrameExpansions());
+	CHECK_EQUAL(0u, env.pather.getSolvedSearches());
+	env.pather.update();
+	CHECK_EQUAL(4u, env.pather.getFrameExpansions());
+	Turns expected = {0, 0, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1};
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(2u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(6u, env.pather.getMaxSearchExpansions());
+	CHECK_EQUAL(0u, env.pather.getActiveSessions());
+}
+
+TEST(routepather_time_budget)
+{
+	RoutePatherEnvironment env;
+	env.pather.setSearchBatchSize(100);
+	env.pather.delay = 2000;
+	env.request(MEDIUM_PRIORITY, 3);
+	env.request(MEDIUM_PRIORITY, 3);
+
+	// every expansion takes 2ms, so a budget of 1ms ends the update after the first one
+	env.pather.setMaxTime(1000);
+	env.pather.update();
+	Turns expected = {0};
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(1u, env.pather.getFrameExpansions());
+	CHECK(env.pather.getFrameTime() >= 1000.0);
+	env.pather.update();
+	expected.push_back(1);
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(0u, env.pather.getSolvedSearches());
+
+	// no limit, the remaining expansions run in one update
+	env.pather.setMaxTime(0);
+	env.pather.update();
+	expected = {0, 1, 0, 0, 1, 1};
+	CHECK(expected == env.pather.turns);
+	CHECK_EQUAL(4u, env.pather.getFrameExpansions());
+	CHECK_EQUAL(2u, env.pather.getSolvedSearches());
+}
+
+TEST(routepather_complete_without_path_fails)
+{
+	RoutePatherEnvironment env;
+	Route* unsolved = env.request(MEDIUM_PRIORITY, 2, false);
+	Route* solved = env.request(MEDIUM_PRIORITY, 3);
+
+	env.pather.update();
+	Turns expected = {0, 0, 1, 1, 1};
+	CHECK(expected == env.pather.turns);
+	// the session is gone, so the route must not stay searched
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_FAILED), unsolved->getRouteStatus());
+	CHECK_EQUAL(0u, unsolved->getSearchExpansions());
+	CHECK_EQUAL(static_cast<uint8_t>(ROUTE_SOLVED), solved->getRouteStatus());
+	CHECK_EQUAL(3u, solved->getSearchExpansions());
+	CHECK_EQUAL(1u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(1u, env.pather.getFailedSearches());
+	CHECK_EQUAL(3u, env.pather.getMaxSearchExpansions());
+	CHECK_EQUAL(0u, env.pather.getActiveSessions());
+
+	env.pather.resetSearchStats();
+	CHECK_EQUAL(0u, env.pather.getSolvedSearches());
+	CHECK_EQUAL(0u, env.pather.getFailedSearches());
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
@@ -0,0 +1,145 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2019 by the FIFE team                              *
+ *   http://www.fifengine.net                                              *
+ *   This file is part of FIFE.                                            *
+ *                                                                         *
+ *   FIFE is free software; you can redistribute it and/or                 *
+ *   modify it under the terms of the GNU Lesser General Public            *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2.1 of the License, or (at your option) any later version.    *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the                 *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA          *
+ ***************************************************************************/
+
+// Standard C++ library includes
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+// Platform specific includes
+#include "fife_unittest.h"
+
+// 3rd party library includes
+
+// FIFE includes
+// These includes are split up in two parts, separated by one empty line
+// First block: files included from the FIFE root src directory
+// Second block: files included from the same folder
+#include "video/screencapturer.h"
+
+using namespace FIFE;
+
+static std::string frameName(int32_t index) {
+	std::ostringstream name;
+	name << "test_screencapturer_" << index << ".png";
+	return name.str();
+}
+
+static CaptureFrame* createFrame(const std::string& filename) {
+	CaptureFrame* frame = new CaptureFrame();
+	frame->filename = filename;
+	frame->width = 4;
+	frame->height = 2;
+	frame->flipped = true;
+	frame->pixels.assign(frame->width * frame->height * 3, 128);
+	return frame;
+}
+
+// removes the file and returns true if it was there
+static bool removeFrame(const std::string& filename) {
+	return std::remove(filename.c_str()) == 0;
+}
+
+TEST(screencapturer_drops_when_full)
+{
+	// without workers the frames stay queued until flush
+	ScreenCapturer capturer(2, 0);
+	CHECK(capturer.push(createFrame(frameName(0))));
+	CHECK(!capturer.isFull());
+	CHECK(capturer.push(createFrame(frameName(1))));
+	CHECK(capturer.isFull());
+	CHECK(!capturer.push(createFrame(frameName(2))));
+	CHECK_EQUAL(1u, capturer.getDroppedFrames());
+	CHECK_EQUAL(2u, capturer.getQueuedFrames());
+
+	// forced frames are queued anyway, frames skipped before the read back count as dropped
+	CHECK(capturer.push(createFrame(frameName(3)), true));
+	CHECK_EQUAL(3u, capturer.getQueuedFrames());
+	capturer.addDroppedFrame();
+	CHECK_EQUAL(2u, capturer.getDroppedFrames());
+	CHECK_EQUAL(0u, capturer.getSavedFrames());
+
+	capturer.flush();
+	CHECK_EQUAL(0u, capturer.getQueuedFrames());
+	CHECK_EQUAL(3u, capturer.getSavedFrames());
+	CHECK_EQUAL(0u, capturer.getFailedFrames());
+	CHECK_EQUAL(2u, capturer.getDroppedFrames());
+	CHECK(removeFrame(frameName(0)));
+	CHECK(removeFrame(frameName(1)));
+	CHECK(!removeFrame(frameName(2)));
+	CHECK(removeFrame(frameName(3)));
+
+	// a smaller queue drops earlier, the queue holds at least one frame
+	capturer.setMaxQueuedFrames(0);
+	CHECK(capturer.push(createFrame(frameName(4))));
+	CHECK(!capturer.push(createFrame(frameName(5))));
+	CHECK_EQUAL(3u, capturer.getDroppedFrames());
+	capturer.flush();
+	CHECK_EQUAL(4u, capturer.getSavedFrames());
+	CHECK(removeFrame(frameName(4)));
+}
+
+TEST(screencapturer_counts_failed_saves)
+{
+	ScreenCapturer capturer(8, 0);
+	capturer.push(createFrame("test_screencapturer_missing/frame.png"));
+	capturer.push(createFrame(frameName(0)));
+	capturer.flush();
+	CHECK_EQUAL(1u, capturer.getSavedFrames());
+	CHECK_EQUAL(1u, capturer.getFailedFrames());
+	CHECK_EQUAL(0u, capturer.getDroppedFrames());
+	CHECK(removeFrame(frameName(0)));
+}
+
+TEST(screencapturer_flush_drains_workers)
+{
+	ScreenCapturer capturer(2, 2);
+	for (int32_t i = 0; i < 6; ++i) {
+		CHECK(capturer.push(createFrame(frameName(i)), true));
+	}
+	capturer.flush();
+	CHECK_EQUAL(0u, capturer.getQueuedFrames());
+	CHECK_EQUAL(6u, capturer.getSavedFrames());
+	CHECK_EQUAL(0u, capturer.getFailedFrames());
+	for (int32_t i = 0; i < 6; ++i) {
+		CHECK(removeFrame(frameName(i)));
+	}
+}
+
+TEST(screencapturer_stop_drains_queue)
+{
+	// stopping a frame capture only stops the read backs, queued frames are saved
+	// before the capturer goes away, with and without workers
+	for (int32_t workers = 0; workers < 3; ++workers) {
+		ScreenCapturer* capturer = new ScreenCapturer(8, workers);
+		for (int32_t i = 0; i < 4; ++i) {
+			capturer->push(createFrame(frameName(i)));
+		}
+		delete capturer;
+		for (int32_t i = 0; i < 4; ++i) {
+			CHECK(removeFrame(frameName(i)));
+		}
+	}
+}
+
+int main() {
+	return UnitTest::RunAllTests();
+}
@@ -60,6 +60,27 @@ class TestAudio(unittest.TestCase):
 		sound.play()
 		time.sleep(3);
 
+	def testVirtualPlaybackOffset(self):
+		clip = self.soundclipmanager.load('tests/data/left_right_test.ogg')
+		sound = self.soundmanager.createEmitter()
+		sound.setSoundClip(clip)
+		self.soundmanager.setListenerPosition(fife.AudioSpaceCoordinate(0, 0, 0))
+		self.soundmanager.setListenerMaxDistance(10)
+		# starts out of range, so the playback is virtual
+		sound.setPosition(fife.AudioSpaceCoordinate(1000, 0, 0))
+		sound.play()
+		self.engine.initializePumping()
+		start = time.time()
+		while time.time() - start < 1.0:
+			self.engine.pump()
+		self.assertFalse(sound.isActive())
+		# in range it gets a source and resumes where the virtual playback is
+		sound.setPosition(fife.AudioSpaceCoordinate(1, 0, 0))
+		self.engine.pump()
+		self.assertTrue(sound.isActive())
+		self.assertTrue(sound.getCursor(fife.SD_TIME_POS) >= 0.9)
+		self.engine.finalizePumping()
+
 TEST_CLASSES = [TestAudio]
 
 if __name__ == '__main__':
@@ -45,6 +45,40 @@ class TestImgMgr(unittest.TestCase):
 		self.assertEqual(imgMgr.getTotalResourcesLoaded(), 1)
 		self.assertEqual(imgMgr.getTotalResourcesCreated(), 0)
 
+	def testImageImgMgrBudget(self):
+		imgMgr = self.engine.getImageManager()
+		img = imgMgr.load('tests/data/beach_e1.png')
+		img2 = imgMgr.load('tests/data/earth_1.png')
+		self.assertEqual(imgMgr.getTotalResourcesLoaded(), 2)
+		imgMgr.setMemoryBudget(1)
+		# both images are still referenced
+		imgMgr.enforceMemoryBudget()
+		self.assertEqual(imgMgr.getLastEvictionCount(), 0)
+		del img
+		imgMgr.enforceMemoryBudget()
+		self.assertEqual(imgMgr.getLastEvictionCount(), 1)
+		self.assertEqual(imgMgr.getEvictionCount(), 1)
+		self.assertEqual(imgMgr.getTotalResourcesLoaded(), 1)
+		imgMgr.resetEvictionStatistics()
+		self.assertEqual(imgMgr.getEvictionCount(), 0)
+
+	def testImageAtlasPacker(self):
+		imgMgr = self.engine.getImageManager()
+		packer = fife.AtlasPacker('tests/data/packed', 512, 512)
+		img = imgMgr.load('tests/data/beach_e1.png')
+		img2 = imgMgr.load('tests/data/mushroom_007.png')
+		self.assert_(packer.addImage(img))
+		self.assert_(packer.addImage(img2))
+		# duplicates are ignored
+		self.assert_(not packer.addImage(img))
+		packer.pack()
+		self.assertEqual(packer.getSourceTextureCount(), 2)
+		self.assertEqual(packer.getPageCount(), 1)
+		self.assert_(img.isSharedImage())
+		self.assert_(img2.isSharedImage())
+		self.assert_(packer.getOccupancy() > 0.0)
+		self.assertEqual(packer.getImageRegion(0).w, img.getWidth())
+
 	def testImageImgMgrFail(self):
 		imgMgr = self.engine.getImageManager()
 #		TODO: This test fails as imgMgr.load doesn't throw an exception as expected
@@ -0,0 +1,112 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+# ####################################################################
+#  Copyright (C) 2005-2019 by the FIFE team
+#  http://www.fifengine.net
+#  This file is part of FIFE.
+#
+#  FIFE is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU Lesser General Public
+#  License as published by the Free Software Foundation; either
+#  version 2.1 of the License, or (at your option) any later version.
+#
+#  This library is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+#  Lesser General Public License for more details.
+#
+#  You should have received a copy of the GNU Lesser General Public
+#  License along with this library; if not, write to the
+#  Free Software Foundation, Inc.,
+#  51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+# ####################################################################
+
+""" Packs the images of FIFE objects into atlas pages.
+
+Usage: atlas_packer.py [options] <object directory> <atlas xml>
+
+All object files found in the object directory are loaded, the static images
+and the animation frames of all actions are packed into as few pages as possible.
+The pages are saved as png files next to the atlas xml file, which can be used
+as an import file for maps or be loaded with the AtlasLoader.
+"""
+
+from __future__ import print_function
+import os, sys
+from optparse import OptionParser
+
+fife_path = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'engine', 'python')
+if os.path.isdir(fife_path) and fife_path not in sys.path:
+	sys.path.insert(0, fife_path)
+
+from fife import fife
+from fife.extensions.serializers.xmlobject import XMLObjectLoader
+from fife.extensions.serializers.xml_loader_tools import loadImportDirRec
+
+def createEngine():
+	engine = fife.Engine()
+	settings = engine.getSettings()
+	settings.setRenderBackend('OpenGL')
+	settings.setScreenWidth(1)
+	settings.setScreenHeight(1)
+	engine.init()
+	return engine
+
+def collectImages(engine, packer):
+	""" adds the static images and the action animations of all objects to the packer """
+	model = engine.getModel()
+	imagemanager = engine.getImageManager()
+	for namespace in model.getNamespaces():
+		for obj in model.getObjects(namespace):
+			visual = obj.get2dGfxVisual()
+			if visual:
+				for angle in range(360):
+					index = visual.getStaticImageIndexByAngle(angle)
+					if index != -1:
+						packer.addImage(imagemanager.get(index))
+			for actionId in obj.getActionIds():
+				actionVisual = obj.getAction(actionId).get2dGfxVisual()
+				if not actionVisual:
+					continue
+				for angle in range(360):
+					animation = actionVisual.getAnimationByAngle(angle)
+					if animation:
+						packer.addAnimation(animation)
+
+def main():
+	parser = OptionParser(usage="%prog [options] <object directory> <atlas xml>")
+	parser.add_option("-W", "--width", type="int", dest="width", default=1024,
+		help="maximal page width [default: %default]")
+	parser.add_option("-H", "--height", type="int", dest="height", default=1024,
+		help="maximal page height [default: %default]")
+	parser.add_option("-n", "--npot", action="store_false", dest="pot", default=True,
+		help="do not round the page sizes up to a power of two")
+	(options, args) = parser.parse_args()
+	if len(args) != 2:
+		parser.error("an object directory and the atlas file are required")
+
+	objectDir, atlasFile = args
+	engine = createEngine()
+	loadImportDirRec(XMLObjectLoader(engine), objectDir, engine)
+
+	name = os.path.splitext(os.path.basename(atlasFile))[0]
+	packer = fife.AtlasPacker(name, options.width, options.height)
+	collectImages(engine, packer)
+	if packer.getImageCount() == 0:
+		print("No images found in", objectDir)
+		engine.destroy()
+		return 1
+
+	packer.pack(options.pot)
+	fife.AtlasSaver(packer).save(atlasFile)
+
+	print("Packed images:  ", packer.getImageCount())
+	print("Textures before:", packer.getSourceTextureCount())
+	print("Textures after: ", packer.getPageCount())
+	print("Occupancy:       %.1f%%" % (packer.getOccupancy() * 100.0))
+	engine.destroy()
+	return 0
+
+if __name__ == '__main__':
+	sys.exit(main())